@@ -41,6 +41,14 @@ class Frame {
 
     std::string function_name;
 
+    /*
+     * Base of the module containing the function the frame was pushed for.
+     * Set when the frame is pushed by a call whose target was already
+     * resolved, and otherwise found by the name of the function the first time
+     * it is needed.
+     */
+    uint8_t const* jump_base;
+
     inline auto ret_address() const -> uint8_t const*
     {
         return return_address;
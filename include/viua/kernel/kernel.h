@@ -23,6 +23,7 @@
 #include <dlfcn.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -32,6 +33,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -43,6 +45,7 @@
 
 #include <viua/bytecode/bytetypedef.h>
 #include <viua/include/module.h>
+#include <viua/loader.h>
 #include <viua/process.h>
 #include <viua/runtime/imports.h>
 
@@ -67,17 +70,64 @@ struct IO_interaction;
 
 
 namespace viua { namespace kernel {
+/*
+ * Any number of processes may send messages to a mailbox at the same time, but
+ * only its owner receives them. Messages are kept in an intrusive
+ * multi-producer/single-consumer queue (Dmitry Vyukov's design): sending is
+ * one atomic exchange and one store, so senders never wait for each other or
+ * for the receiver.
+ *
+ * A message whose sender has exchanged the head but not yet linked its node may
+ * not be visible to the receiver. It is picked up by the next receive.
+ */
 class Mailbox {
-    mutable std::mutex mailbox_mutex;
-    std::vector<std::unique_ptr<viua::types::Value>> messages;
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::unique_ptr<viua::types::Value> message;
+    };
+
+    /*
+     * Senders push at the head, the receiver pops from the tail. The tail
+     * always points to a node whose message was already taken (or to the
+     * initial empty node). Keep them on separate cache lines, as they are
+     * written by different threads.
+     */
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) Node* tail;
+
+    /*
+     * The scheduler on which the receiver is parked waiting for a message. It
+     * is taken by the first sender after the receiver asked to be woken up, so
+     * the receiver is woken up at most once for each time it asks.
+     */
+    std::atomic<viua::scheduler::Process_scheduler*> waiting{nullptr};
 
   public:
-    auto send(std::unique_ptr<viua::types::Value>) -> void;
+    /*
+     * Returns the scheduler which must be told to wake the receiver up, if the
+     * receiver is waiting for a message.
+     */
+    auto send(std::unique_ptr<viua::types::Value>)
+        -> viua::scheduler::Process_scheduler*;
     auto receive(std::queue<std::unique_ptr<viua::types::Value>>&) -> void;
-    auto size() const -> decltype(messages)::size_type;
 
-    Mailbox() = default;
-    Mailbox(Mailbox&&);
+    /*
+     * Only the receiver may call this. Returns false if a message arrived in
+     * the meantime, in which case the receiver should not wait.
+     */
+    auto wake_up_on_send(viua::scheduler::Process_scheduler*) -> bool;
+
+    /*
+     * Only the receiver may call this.
+     */
+    auto size() const -> size_t;
+
+    Mailbox();
+    Mailbox(Mailbox const&) = delete;
+    Mailbox(Mailbox&&)      = delete;
+    auto operator=(Mailbox const&) -> Mailbox& = delete;
+    auto operator=(Mailbox&&) -> Mailbox&      = delete;
+    ~Mailbox();
 };
 
 class Process_result {
@@ -137,7 +187,7 @@ class Kernel {
      * Bytecode pointer is a pointer to program's code. Size and executable
      * offset are metadata exported from bytecode dump.
      */
-    std::unique_ptr<uint8_t[]> bytecode;
+    Bytecode_image bytecode;
     viua::bytecode::codec::bytecode_size_type bytecode_size;
     viua::bytecode::codec::bytecode_size_type executable_offset;
 
@@ -148,15 +198,24 @@ class Kernel {
     std::map<std::string, viua::bytecode::codec::bytecode_size_type>
         block_addresses;
 
-    std::map<std::string, std::pair<std::string, uint8_t*>> linked_functions;
-    std::map<std::string, std::pair<std::string, uint8_t*>> linked_blocks;
+    std::map<std::string, std::pair<std::string, uint8_t const*>>
+        linked_functions;
+    std::map<std::string, std::pair<std::string, uint8_t const*>>
+        linked_blocks;
     std::map<std::string,
              std::pair<viua::bytecode::codec::bytecode_size_type,
-                       std::unique_ptr<uint8_t[]>>>
+                       Bytecode_image>>
         linked_modules;
 
     std::map<std::string, std::string> loaded_module_paths;
 
+    /*
+     * Bumped every time a function is mapped, linked, or registered (or
+     * removed) so that call targets resolved and cached by process schedulers
+     * can be recognised as stale.
+     */
+    std::atomic<uint64_t> link_generations{0};
+
     int return_code{-1};
 
     /*
@@ -173,17 +232,19 @@ class Kernel {
         process_schedulers;
 
     /*
-     * This condition variable is used to signal that there is a process
-     * available to be stolen. A signal for work stealing algorithm to kick in
-     * and do its job.
+     * Process schedulers with nothing to run and nothing to steal go to sleep
+     * until more work is announced (a process is spawned, or a parked process
+     * is woken up and put back on a run queue), or until there are no
+     * processes left in the VM. The counter of announcements lets a scheduler
+     * notice that work was announced between its last look for work and going
+     * to sleep; the counter of sleeping schedulers lets the kernel skip taking
+     * the mutex when nobody sleeps.
      */
-    std::condition_variable process_spawned_cv;
-    std::mutex process_spawned_mtx;
-    // FIXME Maybe use a ring buffer instead of a deque to make the size of
-    // the "who spawned a process" list bounded? If all schedulers are populated
-    // and don't need to steal work this list could otherwise get uncomfortably
-    // long really quick.
-    std::deque<viua::scheduler::Process_scheduler*> process_spawned_by;
+    std::atomic<uint64_t> work_announcements{0};
+    std::atomic<size_t> idle_schedulers{0};
+    std::mutex idle_schedulers_mtx;
+    std::condition_variable idle_schedulers_cv;
+    auto wake_idle_schedulers(bool const) -> void;
 
     /*
      * FFI MODULES
@@ -211,11 +272,18 @@ class Kernel {
 
     /*
      * I/O SCHEDULING
+     *
+     * I/O workers wait in epoll(7) so they are notified about new requests and
+     * cancellations with eventfd(2) counters instead of condition variables.
+     * The request counter is incremented once for every request put in the
+     * queue. The same counters are used by workers running the io_uring(7)
+     * engine (selected with VIUA_IO_ENGINE).
      */
     std::deque<std::unique_ptr<viua::scheduler::io::IO_interaction>>
         io_request_queue;
     std::mutex io_request_mutex;
-    std::condition_variable io_request_cv;
+    int io_request_fd = -1;
+    int io_cancel_fd  = -1;
     std::vector<std::unique_ptr<std::thread>> io_workers;
 
   public:
@@ -257,6 +325,17 @@ class Kernel {
     mutable std::mutex io_result_mtx;
     std::map<std::tuple<uint64_t, uint64_t>, IO_result> io_results;
 
+    /*
+     * Processes parked until an I/O request completes, or until a process
+     * stops. Each entry holds the scheduler on which the waiting process is
+     * parked and the PID of the waiting process. Entries are guarded by the
+     * same mutexes as the results they wait for, and removed when the waiting
+     * processes are woken up.
+     */
+    using Waiting_process =
+        std::pair<viua::scheduler::Process_scheduler*, viua::process::PID>;
+    std::multimap<std::tuple<uint64_t, uint64_t>, Waiting_process> io_waiting;
+
     /*
      * PID MANAGEMENT
      */
@@ -272,9 +351,19 @@ class Kernel {
      * make it easier to send and receive messages (just call kernel's routines
      * instead of finding the right scheduler and process). This adds a level of
      * indirection but in this case I think it is justified.
+     *
+     * Mailboxes are sharded by PID. A sender takes a shared lock on a single
+     * shard, so senders do not block each other and are blocked only while a
+     * mailbox in the same shard is being created or deleted. Processes keep a
+     * reference to their own mailbox and receive from it directly.
      */
-    std::map<viua::process::PID, Mailbox> mailboxes;
-    mutable std::mutex mailbox_mutex;
+    struct Mailbox_shard {
+        std::shared_mutex mtx;
+        std::map<viua::process::PID, std::shared_ptr<Mailbox>> mailboxes;
+    };
+    static constexpr auto MAILBOX_SHARDS = size_t{64};
+    std::array<Mailbox_shard, MAILBOX_SHARDS> mailbox_shards;
+    auto mailbox_shard_of(viua::process::PID const) -> Mailbox_shard&;
 
     /*
      * Only processes that were not disowned have an entry here.
@@ -283,6 +372,7 @@ class Kernel {
      * prevent return value leaks.
      */
     std::map<viua::process::PID, Process_result> process_results;
+    std::multimap<viua::process::PID, Waiting_process> join_waiting;
     mutable std::mutex process_results_mutex;
 
   public:
@@ -304,7 +394,7 @@ class Kernel {
      *      * tell the Kernel where to start execution,
      *      * kick the Kernel so it starts running,
      */
-    Kernel& load(std::unique_ptr<uint8_t[]>);
+    Kernel& load(Bytecode_image);
     Kernel& bytes(viua::bytecode::codec::bytecode_size_type);
 
     Kernel& mapfunction(std::string const&,
@@ -330,6 +420,7 @@ class Kernel {
     auto get_entry_point_of(std::string const&) const
         -> std::pair<viua::internals::types::Op_address_type,
                      viua::internals::types::Op_address_type>;
+    auto link_generation() const -> uint64_t;
     auto module_at(uint8_t const* const) const
         -> std::optional<std::pair<std::string, std::string>>;
     auto in_which_function(std::string const, uint64_t const) const
@@ -338,16 +429,20 @@ class Kernel {
     void request_foreign_function_call(std::unique_ptr<Frame>,
                                        viua::process::Process&);
 
-    auto steal_processes()
+    auto steal_processes(viua::scheduler::Process_scheduler*)
         -> std::vector<std::unique_ptr<viua::process::Process>>;
+    auto work_announced() const -> uint64_t;
+    auto wait_for_work(uint64_t const) -> void;
     auto notify_about_process_spawned(viua::scheduler::Process_scheduler*)
         -> void;
+    auto notify_about_process_woken() -> void;
     auto notify_about_process_death() -> void;
     auto process_count() const -> size_t;
 
     auto make_pid() -> viua::process::PID;
 
-    auto create_mailbox(const viua::process::PID) -> size_t;
+    auto create_mailbox(const viua::process::PID)
+        -> std::shared_ptr<Mailbox>;
     auto delete_mailbox(const viua::process::PID) -> size_t;
 
     auto create_result_slot_for(viua::process::PID) -> void;
@@ -360,10 +455,11 @@ class Kernel {
         -> std::unique_ptr<viua::types::Value>;
     auto transfer_result_of(const viua::process::PID)
         -> std::unique_ptr<viua::types::Value>;
+    auto wake_up_on_stop(const viua::process::PID,
+                         viua::scheduler::Process_scheduler*,
+                         const viua::process::PID) -> bool;
 
     void send(const viua::process::PID, std::unique_ptr<viua::types::Value>);
-    void receive(const viua::process::PID,
-                 std::queue<std::unique_ptr<viua::types::Value>>&);
     uint64_t pids() const;
 
     auto schedule_io(std::unique_ptr<viua::scheduler::io::IO_interaction>)
@@ -373,10 +469,14 @@ class Kernel {
     auto io_complete(std::tuple<uint64_t, uint64_t> const) const -> bool;
     auto io_result(std::tuple<uint64_t, uint64_t> const)
         -> std::unique_ptr<viua::types::Value>;
+    auto wake_up_on_io(std::tuple<uint64_t, uint64_t> const,
+                       viua::scheduler::Process_scheduler*,
+                       const viua::process::PID) -> bool;
 
     auto static no_of_process_schedulers() -> size_t;
     auto static no_of_ffi_schedulers() -> size_t;
     auto static no_of_io_schedulers() -> size_t;
+    auto static io_engine() -> std::string;
     auto static is_tracing_enabled() -> bool;
 
     int run();
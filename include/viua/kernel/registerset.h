@@ -20,7 +20,9 @@
 #ifndef VIUA_REGISTERSET_H
 #define VIUA_REGISTERSET_H
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <viua/bytecode/codec.h>
@@ -36,14 +38,72 @@ enum REGISTER_MASKS : mask_type {
 
 
 namespace viua { namespace kernel {
+/*
+ * Integers, floats, and booleans kept in registers without being boxed into
+ * values allocated on the heap. Conversions behave the same as those of the
+ * boxed values.
+ */
+class Immediate {
+  public:
+    enum class Kind : uint8_t {
+        Integer,
+        Float,
+        Boolean,
+    };
+
+  private:
+    Kind held;
+    union {
+        int64_t i;
+        double f;
+        bool b;
+    };
+
+  public:
+    auto kind() const -> Kind;
+    auto is_number() const -> bool;
+
+    auto as_integer() const -> int64_t;
+    auto as_float() const -> double;
+    auto boolean() const -> bool;
+
+    auto box() const -> std::unique_ptr<viua::types::Value>;
+
+    /*
+     * Nothing if the value is not an integer, a float, or a boolean.
+     */
+    static auto unbox(viua::types::Value const*) -> std::optional<Immediate>;
+
+    explicit Immediate(int64_t const);
+    explicit Immediate(double const);
+    explicit Immediate(bool const);
+};
+
 class Register {
-    std::unique_ptr<viua::types::Value> value;
+    /*
+     * A register holds either a value, or an immediate (or nothing at all).
+     * Immediates are boxed the moment anybody asks the register for a value,
+     * even through a const accessor, which is why both are mutable.
+     */
+    mutable std::unique_ptr<viua::types::Value> value;
+    mutable std::optional<Immediate> immediate;
     mask_type mask;
 
+    auto box() const -> void;
+
   public:
     auto reset(std::unique_ptr<viua::types::Value>) -> void;
+    auto reset(Immediate const) -> void;
     auto empty() const -> bool;
 
+    /*
+     * Access to integers, floats, and booleans held by the register without
+     * boxing them. The first function returns them whether they are boxed or
+     * not; the second one tells if the register holds an immediate.
+     */
+    auto unboxed() const -> std::optional<Immediate>;
+    auto holds_immediate() const -> bool;
+
     auto get() -> viua::types::Value*;
     auto get() const -> viua::types::Value const*;
     auto release() -> viua::types::Value*;
@@ -67,6 +127,7 @@ class Register {
     auto operator=(Register const&) -> Register& = delete;
     auto operator                                =(Register &&) -> Register&;
     auto operator=(decltype(value)&&) -> Register&;
+    auto operator=(Immediate const) -> Register&;
 };
 
 class Register_set {
@@ -21,30 +21,72 @@
 #define VIUA_LOADER_H
 
 #include <cstdint>
-#include <fstream>
 #include <map>
 #include <memory>
 #include <string>
-#include <tuple>
+#include <string_view>
 #include <vector>
 
 #include <viua/bytecode/codec.h>
 #include <viua/machine.h>
 
-using IdToAddressMapping = std::tuple<
-    std::vector<std::string>,
-    std::map<std::string, viua::bytecode::codec::bytecode_size_type>>;
 
-template<class T> void readinto(std::ifstream& in, T* object)
-{
-    in.read(reinterpret_cast<char*>(object), sizeof(T));
-}
+/*
+ * A bytecode file mapped into memory, read-only. Modules are executed straight
+ * from their mappings so pages of code are only read from disk when they are
+ * touched, and are shared by all VMs running the same modules on a host.
+ */
+class Mapped_file {
+    void* base;
+    size_t length;
+
+  public:
+    auto data() const -> uint8_t const*;
+    auto size() const -> size_t;
+
+    explicit Mapped_file(std::string const&);
+    Mapped_file(Mapped_file const&) = delete;
+    auto operator=(Mapped_file const&) -> Mapped_file& = delete;
+    ~Mapped_file();
+};
+
+/*
+ * Bytecode of a loaded module. Keeps the mapping the code lives in alive.
+ */
+class Bytecode_image {
+    std::shared_ptr<Mapped_file const> mapping;
+    uint8_t const* code;
+    viua::bytecode::codec::bytecode_size_type length;
+
+  public:
+    auto get() const -> uint8_t const*;
+    auto size() const -> viua::bytecode::codec::bytecode_size_type;
+    explicit operator bool() const;
+
+    Bytecode_image();
+    Bytecode_image(std::shared_ptr<Mapped_file const>,
+                   uint8_t const*,
+                   viua::bytecode::codec::bytecode_size_type const);
+};
+
+/*
+ * A function or a block and its address, read in place from the symbol map of
+ * a mapped file. The name is only valid for as long as the loader lives.
+ */
+struct Symbol {
+    std::string_view name;
+    viua::bytecode::codec::bytecode_size_type address;
+};
 
 class Loader {
     std::string path;
+    std::shared_ptr<Mapped_file const> mapping;
+
+    uint8_t const* cursor;
+    uint8_t const* end;
 
     viua::bytecode::codec::bytecode_size_type size;
-    std::unique_ptr<uint8_t[]> bytecode;
+    uint8_t const* bytecode;
 
     std::vector<viua::bytecode::codec::bytecode_size_type> jumps;
 
@@ -55,32 +97,28 @@ class Loader {
 
     std::vector<std::string> dynamic_linked_modules;
 
-    std::map<std::string, viua::bytecode::codec::bytecode_size_type>
-        function_addresses;
-    std::map<std::string, viua::bytecode::codec::bytecode_size_type>
-        function_sizes;
-    std::vector<std::string> functions;
-    std::map<std::string, viua::bytecode::codec::bytecode_size_type>
-        block_addresses;
-    std::vector<std::string> blocks;
+    std::vector<Symbol> function_symbols;
+    std::vector<Symbol> block_symbols;
+
+    auto take(uint64_t const) -> uint8_t const*;
+    auto take_size() -> uint64_t;
+    auto load_symbols() -> std::vector<Symbol>;
+    auto load_strings() -> std::vector<std::string>;
 
-    IdToAddressMapping loadmap(
-        char*,
-        viua::bytecode::codec::bytecode_size_type const&);
-    void calculate_function_sizes();
+    void map_file();
 
-    void load_magic_number(std::ifstream&);
-    void assume_binary_type(std::ifstream&, Viua_binary_type);
+    void load_magic_number();
+    void assume_binary_type(Viua_binary_type);
 
-    void load_meta_information(std::ifstream&);
+    void load_meta_information();
 
-    void load_external_signatures(std::ifstream&);
-    void load_external_block_signatures(std::ifstream&);
-    auto load_dynamic_imports_section(std::ifstream&) -> void;
-    void load_jump_table(std::ifstream&);
-    void load_functions_map(std::ifstream&);
-    void load_blocks_map(std::ifstream&);
-    void load_bytecode(std::ifstream&);
+    void load_external_signatures();
+    void load_external_block_signatures();
+    auto load_dynamic_imports_section() -> void;
+    void load_jump_table();
+    void load_functions_map();
+    void load_blocks_map();
+    void load_bytecode();
 
   public:
     Loader& load();
@@ -89,6 +127,11 @@ class Loader {
     viua::bytecode::codec::bytecode_size_type get_bytecode_size();
     std::unique_ptr<uint8_t[]> get_bytecode();
 
+    /*
+     * The bytecode in place, without copying it out of the mapped file.
+     */
+    auto bytecode_image() const -> Bytecode_image;
+
     std::vector<viua::bytecode::codec::bytecode_size_type> get_jumps();
 
     std::map<std::string, std::string> get_meta_information();
@@ -96,6 +139,9 @@ class Loader {
     std::vector<std::string> get_external_signatures();
     std::vector<std::string> get_external_block_signatures();
 
+    auto functions_index() const -> std::vector<Symbol> const&;
+    auto blocks_index() const -> std::vector<Symbol> const&;
+
     std::map<std::string, viua::bytecode::codec::bytecode_size_type>
     get_function_addresses();
     std::map<std::string, viua::bytecode::codec::bytecode_size_type>
@@ -108,7 +154,12 @@ class Loader {
 
     auto dynamic_imports() const -> std::vector<std::string>;
 
-    Loader(std::string pth) : path(pth), size(0), bytecode(nullptr)
+    Loader(std::string pth)
+            : path(pth)
+            , cursor(nullptr)
+            , end(nullptr)
+            , size(0)
+            , bytecode(nullptr)
     {}
     ~Loader()
     {}
@@ -20,7 +20,9 @@
 #ifndef VIUA_PID_H
 #define VIUA_PID_H
 
+#include <cstdint>
 #include <string>
+#include <tuple>
 
 
 namespace viua { namespace process {
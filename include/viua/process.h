@@ -26,6 +26,7 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <set>
 #include <stack>
@@ -38,6 +39,7 @@
 #include <viua/kernel/registerset.h>
 #include <viua/kernel/tryframe.h>
 #include <viua/pid.h>
+#include <viua/scheduler/call_site_cache.h>
 #include <viua/scheduler/io/interactions.h>
 #include <viua/types/exception.h>
 #include <viua/types/value.h>
@@ -52,6 +54,7 @@ class Halt_exception : public std::runtime_error {
 
 namespace viua::types {
 struct IO_interaction;
+class Function;
 }
 
 
@@ -59,6 +62,10 @@ namespace viua { namespace scheduler {
 class Process_scheduler;
 }}  // namespace viua::scheduler
 
+namespace viua { namespace kernel {
+class Mailbox;
+}}  // namespace viua::kernel
+
 namespace viua { namespace process {
 class Process;
 
@@ -180,6 +187,7 @@ class Stack {
         -> viua::internals::types::Op_address_type;
     auto adjust_jump_base_for(std::string const&)
         -> viua::internals::types::Op_address_type;
+    auto restore_jump_base() -> void;
     auto unwind() -> void;
 
     Stack(std::string,
@@ -263,6 +271,14 @@ struct Decoder_adapter {
                      viua::bytecode::codec::register_index_type>;
     auto fetch_value(Op_address_type&, Process&) const -> viua::types::Value*;
 
+    /*
+     * Fetch the register holding the value of an operand, so that integers,
+     * floats, and booleans can be read from it without boxing them. Returns
+     * nullptr for operands dereferencing pointers.
+     */
+    auto fetch_value_register(Op_address_type&, Process&) const
+        -> viua::kernel::Register*;
+
     auto fetch_string(Op_address_type&) const -> std::string;
     auto fetch_bits_string(Op_address_type&) const -> std::vector<uint8_t>;
     auto fetch_timeout(Op_address_type&) const
@@ -377,10 +393,11 @@ class Process {
 
     /*
      * Messages which the process already has locally. To avoid synchronisation
-     * with the kernel on every receive operation, messages are buffered locally
-     * and fetched from the kernel-held mailbox in batches.
+     * with senders on every receive operation, messages are buffered locally
+     * and fetched from the mailbox in batches.
      */
     std::queue<std::unique_ptr<viua::types::Value>> message_queue;
+    std::shared_ptr<viua::kernel::Mailbox> mailbox;
 
     /*  Methods dealing with stack and frame manipulation, and
      *  function calls.
@@ -394,11 +411,21 @@ class Process {
         -> viua::internals::types::Op_address_type;
     auto adjust_jump_base_for(std::string const&)
         -> viua::internals::types::Op_address_type;
+    /*
+     * Find out which function a call, tail call, or defer instruction calls.
+     * Advances the address past the operand naming the function, and gives
+     * back the function value if the function was taken from a register.
+     * Throws an exception beginning with the given message if the function
+     * is not defined.
+     */
+    auto resolve_call_target(Op_address_type&,
+                             viua::types::Function*&,
+                             char const* const)
+        -> viua::scheduler::Call_target const&;
     // call native (i.e. written in Viua) function
     auto call_native(Op_address_type,
-                     std::string const&,
-                     viua::kernel::Register* const,
-                     std::string const&) -> Op_address_type;
+                     viua::scheduler::Call_target const&,
+                     viua::kernel::Register* const) -> Op_address_type;
     // call foreign (i.e. from a C++ extension) function
     auto call_foreign(Op_address_type,
                       std::string const&,
@@ -428,6 +455,14 @@ class Process {
     bool timeout_active      = false;
     bool wait_until_infinity = false;
 
+    /*
+     * Set by an instruction that cannot complete yet (receive, join, I/O wait)
+     * after it has arranged for the process to be woken up. The scheduler then
+     * parks the process instead of spinning on the instruction. Cleared at the
+     * start of every tick.
+     */
+    bool is_blocked = false;
+
     /*  Methods implementing individual instructions.
      */
     auto opizero(Op_address_type) -> Op_address_type;
@@ -611,6 +646,11 @@ class Process {
     void wakeup();
     bool suspended() const;
 
+    auto block() -> void;
+    auto blocked() const -> bool;
+    auto wakeup_deadline() const
+        -> std::optional<std::chrono::steady_clock::time_point>;
+
     auto parent() const -> viua::process::Process*;
     auto starting_function() const -> std::string;
 
@@ -629,6 +669,7 @@ class Process {
     auto handle_active_exception() -> void;
 
     auto migrate_to(viua::scheduler::Process_scheduler*) -> void;
+    auto attach_mailbox(std::shared_ptr<viua::kernel::Mailbox>) -> void;
 
     auto get_return_value() -> std::unique_ptr<viua::types::Value>;
 
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIUA_SCHEDULER_CALL_SITE_CACHE_H
+#define VIUA_SCHEDULER_CALL_SITE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <viua/bytecode/bytetypedef.h>
+
+
+namespace viua { namespace scheduler {
+/*
+ * The function a call site resolved to. Native functions are described by
+ * their entry point and the base of the module they live in; foreign ones only
+ * by their name.
+ *
+ * The next address is the address just past the operand naming the function.
+ * Call sites naming the function statically do not have to decode the name
+ * again after they have been resolved once.
+ */
+struct Call_target {
+    std::string name;
+    viua::internals::types::Op_address_type entry_point = nullptr;
+    viua::internals::types::Op_address_type jump_base   = nullptr;
+    bool foreign                                        = false;
+    viua::internals::types::Op_address_type next        = nullptr;
+};
+
+/*
+ * Call targets resolved the first time each call site was executed, keyed by
+ * the address of the operand naming the function. Call sites taking the
+ * function from a register keep only the last function they called
+ * (a monomorphic inline cache), and are resolved again when a different one
+ * comes along.
+ *
+ * Targets become stale when modules are linked so the cache is told the link
+ * generation of the kernel on every lookup and is emptied when it changes.
+ *
+ * The cache is not synchronised. It is owned by a single process scheduler and
+ * only used by processes running on that scheduler's thread.
+ */
+class Call_site_cache {
+  public:
+    using address_type    = viua::internals::types::Op_address_type;
+    using generation_type = uint64_t;
+
+  private:
+    std::unordered_map<address_type, Call_target> sites;
+    generation_type generation = 0;
+
+  public:
+    auto find(address_type const, generation_type const)
+        -> Call_target const*;
+    auto insert(address_type const, Call_target) -> Call_target const&;
+};
+}}  // namespace viua::scheduler
+
+#endif
@@ -20,7 +20,6 @@
 #ifndef VIUA_SCHEDULER_IO_H
 #define VIUA_SCHEDULER_IO_H
 
-#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -44,7 +43,20 @@ void io_scheduler(
     viua::kernel::Kernel&,
     std::deque<std::unique_ptr<viua::scheduler::io::IO_interaction>>& requests,
     std::mutex& mtx,
-    std::condition_variable& cv);
+    int const request_fd,
+    int const cancel_fd);
+
+/*
+ * Same as io_scheduler() but using io_uring(7) instead of epoll(7). Falls back
+ * to io_scheduler() if the kernel does not support io_uring(7).
+ */
+void io_uring_scheduler(
+    uint64_t const,
+    viua::kernel::Kernel&,
+    std::deque<std::unique_ptr<viua::scheduler::io::IO_interaction>>& requests,
+    std::mutex& mtx,
+    int const request_fd,
+    int const cancel_fd);
 }}}  // namespace viua::scheduler::io
 
 
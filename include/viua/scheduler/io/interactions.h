@@ -21,7 +21,10 @@
 #define VIUA_SCHEDULER_IO_INTERACTIONS_H
 
 #include <atomic>
+#include <cstdint>
 #include <optional>
+#include <string>
+#include <utility>
 
 namespace viua { namespace scheduler { namespace io {
 enum class IO_kind : uint8_t {
@@ -100,6 +103,20 @@ struct IO_interaction {
     };
     virtual auto interact() -> Interaction_result = 0;
 
+    /*
+     * I/O engines which perform the operation on behalf of the interaction
+     * (e.g. the io_uring(7) one) use these two functions instead of interact().
+     * The operation reads into, or writes from, the memory returned by
+     * transfer_buffer(). Its result (the number of bytes transferred, or
+     * a negated errno value) is turned into the result of the interaction by
+     * finish().
+     */
+    virtual auto transfer_buffer() -> std::pair<char*, size_t>
+    {
+        return {nullptr, 0};
+    }
+    virtual auto finish(int64_t const) -> Interaction_result = 0;
+
     auto id() const -> id_type;
     virtual auto fd() const -> std::optional<fd_type>
     {
@@ -121,6 +138,7 @@ struct IO_interaction {
 };
 struct IO_empty_interaction : public IO_interaction {
     auto interact() -> Interaction_result override;
+    auto finish(int64_t const) -> Interaction_result override;
 
     std::optional<fd_type> fd() const override
     {
@@ -138,6 +156,8 @@ struct IO_read_interaction : public IO_interaction {
     std::string buffer;
 
     auto interact() -> Interaction_result override;
+    auto transfer_buffer() -> std::pair<char*, size_t> override;
+    auto finish(int64_t const) -> Interaction_result override;
 
     std::optional<fd_type> fd() const override
     {
@@ -152,9 +172,11 @@ struct IO_read_interaction : public IO_interaction {
 };
 struct IO_write_interaction : public IO_interaction {
     int const file_descriptor;
-    std::string const buffer;
+    std::string buffer;
 
     auto interact() -> Interaction_result override;
+    auto transfer_buffer() -> std::pair<char*, size_t> override;
+    auto finish(int64_t const) -> Interaction_result override;
 
     std::optional<fd_type> fd() const override
     {
@@ -171,6 +193,7 @@ struct IO_close_interaction : public IO_interaction {
     int const file_descriptor;
 
     auto interact() -> Interaction_result override;
+    auto finish(int64_t const) -> Interaction_result override;
 
     std::optional<fd_type> fd() const override
     {
@@ -21,16 +21,22 @@
 #define VIUA_SCHEDULER_PROCESS_H
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <map>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <set>
 #include <thread>
 #include <vector>
 
 #include <viua/kernel/frame.h>
 #include <viua/pid.h>
+#include <viua/scheduler/call_site_cache.h>
 #include <viua/scheduler/io/interactions.h>
+#include <viua/scheduler/timer_wheel.h>
+#include <viua/scheduler/work_stealing_deque.h>
 
 namespace viua {
 namespace process {
@@ -70,19 +76,62 @@ class Process_scheduler {
     process_type* main_process = nullptr;
 
     /*
-     * The set of processes running on this scheduler. It may be modified either
-     * when a new process is spawned, or when the work stealing algorithm kicks
-     * in (two schedulers' process queues are modified then), or when the load
-     * balancing algorithm kicks in (possibly many schedulers are affected when
-     * this happens).
+     * Processes ready to run on this scheduler. Only the scheduler's own thread
+     * pushes processes into the queue, but any scheduler may steal them (and
+     * the scheduler itself takes processes from the same end as thieves do so
+     * processes are run in a round-robin fashion).
+     *
+     * Pinned processes must not be stolen so they wait in a separate queue
+     * which is only ever touched by the scheduler's own thread. The countdown
+     * says how many processes from the run queue should be run before the
+     * first pinned process gets its turn.
+     */
+    Work_stealing_deque<process_type> run_queue;
+    process_queue_type pinned_queue;
+    size_type pinned_turn_in = 0;
+
+    /*
+     * Processes waiting for something to happen: a message to arrive, another
+     * process to stop, an I/O request or an FFI call to complete. They are not
+     * in the run queue so they are neither run nor stolen by other schedulers,
+     * and are put back into the run queue when woken up or when their timeouts
+     * pass.
+     *
+     * Wake-ups come from other threads which must not push into the run queue
+     * so woken processes wait in a separate queue until the scheduler picks
+     * them up.
+     *
+     * A wake-up may arrive before the scheduler had the chance to park the
+     * process (it is still running its last burst). Such wake-ups are kept
+     * as pending so the process is not parked at all.
+     *
+     * All of these are guarded by the process queue mutex. The atomics let the
+     * scheduler skip taking the mutex when there is nothing to look at.
      */
-    process_queue_type process_queue;
     mutable std::mutex process_queue_mtx;
+    std::condition_variable process_queue_cv;
+    std::map<viua::process::PID, std::unique_ptr<process_type>>
+        parked_processes;
+    process_queue_type woken_processes;
+    std::atomic<bool> any_woken{false};
+    std::set<viua::process::PID> pending_wakeups;
+    std::atomic<bool> any_pending{false};
+    Timer_wheel timeouts;
+
+    /*
+     * Call targets resolved by processes running on this scheduler.
+     */
+    Call_site_cache call_sites;
 
     auto push(std::unique_ptr<process_type>) -> void;
     auto pop() -> std::unique_ptr<process_type>;
-    auto size() const -> size_type;
-    auto empty() const -> bool;
+
+    auto park(std::unique_ptr<process_type>) -> void;
+    auto expire_timeouts() -> bool;
+    auto take_woken() -> bool;
+    auto forget_pending_wakeup(viua::process::PID const) -> void;
+    auto any_parked() const -> bool;
+    auto wait_for_wakeup() -> void;
 
     /*
      * Exit code of the scheduler. It is useful only for the scheduler running
@@ -130,7 +179,19 @@ class Process_scheduler {
      * bookkeeping that is needed for correct operation of the VM.
      */
     auto spawn(std::unique_ptr<Frame>, process_type*, bool) -> process_type*;
-    auto give_up_processes() -> std::vector<std::unique_ptr<process_type>>;
+
+    /*
+     * Take a process from this scheduler's run queue. May be called from any
+     * thread. Pinned processes are never given up.
+     */
+    auto steal() -> std::unique_ptr<process_type>;
+    auto stealable() const -> size_type;
+
+    /*
+     * Put a parked process back into the process queue. May be called from any
+     * thread.
+     */
+    auto wake(viua::process::PID const) -> void;
 
     /*
      * Process state inquiry functions.
@@ -147,15 +208,16 @@ class Process_scheduler {
         -> std::unique_ptr<viua::types::Value>;
     auto transfer_result_of(viua::process::PID const) const
         -> std::unique_ptr<viua::types::Value>;
+    auto wake_up_on_stop(viua::process::PID const, viua::process::PID const)
+        -> bool;
 
     /*
      * This is the message exchange interface. It talks to the kernel to push
-     * messages to and pop them from kernel-held queues.
+     * messages to kernel-held queues. Processes receive messages directly from
+     * their own mailboxes.
      */
     auto send(viua::process::PID const, std::unique_ptr<viua::types::Value>)
         -> void;
-    auto receive(viua::process::PID const,
-                 std::queue<std::unique_ptr<viua::types::Value>>&) -> void;
 
     /*
      * FFI gateway for Viua processes. It initiates a call on a FFI scheduler
@@ -190,6 +252,20 @@ class Process_scheduler {
         -> std::pair<viua::internals::types::Op_address_type,
                      viua::internals::types::Op_address_type>;
 
+    /*
+     * Call target resolution for call sites. The first function returns the
+     * target a call site was already resolved to, if any. The second one
+     * returns the target of a call site calling the named function, resolving
+     * it if the call site was not resolved yet or was resolved to a different
+     * function, and nothing if the function is not defined.
+     */
+    auto cached_call_target(viua::internals::types::Op_address_type const)
+        -> Call_target const*;
+    auto resolve_call_target(viua::internals::types::Op_address_type const,
+                             std::string const&,
+                             viua::internals::types::Op_address_type const)
+        -> Call_target const*;
+
     /*
      * Scheduler management interface. Launching, stopping, etc. related to the
      * scheduler itself.
@@ -210,6 +286,8 @@ class Process_scheduler {
     auto io_complete(std::tuple<uint64_t, uint64_t> const) const -> bool;
     auto io_result(std::tuple<uint64_t, uint64_t> const)
         -> std::unique_ptr<viua::types::Value>;
+    auto wake_up_on_io(std::tuple<uint64_t, uint64_t> const,
+                       viua::process::PID const) -> bool;
 };
 }}  // namespace viua::scheduler
 
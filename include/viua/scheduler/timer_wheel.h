@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIUA_SCHEDULER_TIMER_WHEEL_H
+#define VIUA_SCHEDULER_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <viua/pid.h>
+
+
+namespace viua { namespace scheduler {
+/*
+ * Timeouts of processes parked by a process scheduler (waiting for a message,
+ * for another process to stop, or for I/O to complete). Timeouts are given in
+ * milliseconds so the wheel turns once every millisecond. Deadlines further
+ * away than one full turn stay in their slot until the wheel comes around
+ * enough times.
+ *
+ * The wheel is not synchronised. It is owned by a single process scheduler
+ * and only used by that scheduler's own thread.
+ */
+class Timer_wheel {
+  public:
+    using clock_type      = std::chrono::steady_clock;
+    using time_point_type = clock_type::time_point;
+    using size_type       = size_t;
+
+  private:
+    using tick_type = int64_t;
+
+    static constexpr auto SLOTS = size_type{256};
+
+    struct Timer {
+        time_point_type deadline;
+        viua::process::PID pid;
+    };
+    std::array<std::vector<Timer>, SLOTS> slots;
+
+    tick_type current_tick = 0;
+    size_type armed        = 0;
+
+    static auto tick_of(time_point_type const) -> tick_type;
+    static auto slot_of(tick_type const) -> size_type;
+
+  public:
+    auto insert(time_point_type const, viua::process::PID const) -> void;
+
+    /*
+     * Turn the wheel up to the given moment and append PIDs of processes whose
+     * deadlines passed to the given vector. Timers are not cancelled when a
+     * process is woken up by other means so the PIDs may be stale; it is up to
+     * the caller to ignore those.
+     */
+    auto advance(time_point_type const, std::vector<viua::process::PID>&)
+        -> void;
+
+    /*
+     * The moment at which the next timer fires, or at which the wheel should be
+     * turned again to find out. Nothing if no timers are armed.
+     */
+    auto next_expiry() const -> std::optional<time_point_type>;
+
+    auto size() const -> size_type;
+    auto empty() const -> bool;
+};
+}}  // namespace viua::scheduler
+
+#endif
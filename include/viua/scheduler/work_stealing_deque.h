@@ -0,0 +1,195 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIUA_SCHEDULER_WORK_STEALING_DEQUE_H
+#define VIUA_SCHEDULER_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace viua { namespace scheduler {
+/*
+ * Chase-Lev work-stealing deque, with the memory orderings given in "Correct
+ * and Efficient Work-Stealing for Weak Memory Models" (Lê, Pop, Cohen, Zappa
+ * Nardelli; 2013).
+ *
+ * Only the owner of the deque may push() and pop() at the bottom end. Any
+ * thread (the owner included) may steal() from the top end. The deque does not
+ * own the items it holds.
+ *
+ * The deque grows when it is full. Arrays that were grown out of are kept until
+ * the deque is destroyed because thieves may still be reading from them.
+ */
+template<typename T> class Work_stealing_deque {
+  public:
+    using value_type = T*;
+    using size_type  = size_t;
+
+  private:
+    using index_type = int64_t;
+
+    class Array {
+        size_type const mask;
+        std::unique_ptr<std::atomic<value_type>[]> slots;
+
+      public:
+        auto capacity() const -> size_type
+        {
+            return (mask + 1);
+        }
+        auto get(index_type const i) const -> value_type
+        {
+            return slots[static_cast<size_type>(i) & mask].load(
+                std::memory_order_relaxed);
+        }
+        auto put(index_type const i, value_type const x) -> void
+        {
+            slots[static_cast<size_type>(i) & mask].store(
+                x, std::memory_order_relaxed);
+        }
+        auto grow(index_type const top, index_type const bottom) const
+            -> std::unique_ptr<Array>
+        {
+            auto bigger = std::make_unique<Array>(capacity() * 2);
+            for (auto i = top; i < bottom; ++i) {
+                bigger->put(i, get(i));
+            }
+            return bigger;
+        }
+
+        /*
+         * The capacity must be a power of two.
+         */
+        explicit Array(size_type const capacity)
+                : mask{capacity - 1}
+                , slots{std::make_unique<std::atomic<value_type>[]>(capacity)}
+        {}
+    };
+
+    std::atomic<index_type> top{0};
+    std::atomic<index_type> bottom{0};
+    std::atomic<Array*> array{nullptr};
+
+    /*
+     * Only accessed by the owner.
+     */
+    std::vector<std::unique_ptr<Array>> arrays;
+
+  public:
+    auto push(value_type const x) -> void
+    {
+        auto const b = bottom.load(std::memory_order_relaxed);
+        auto const t = top.load(std::memory_order_acquire);
+        auto a       = array.load(std::memory_order_relaxed);
+        if (static_cast<size_type>(b - t) >= a->capacity()) {
+            arrays.push_back(a->grow(t, b));
+            a = arrays.back().get();
+            array.store(a, std::memory_order_release);
+        }
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /*
+     * Take the item pushed most recently. Returns nullptr if the deque is
+     * empty.
+     */
+    auto pop() -> value_type
+    {
+        auto const b = bottom.load(std::memory_order_relaxed) - 1;
+        auto const a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto x = a->get(b);
+        if (t == b) {
+            /*
+             * The last item. Race the thieves for it.
+             */
+            if (not top.compare_exchange_strong(t,
+                                                t + 1,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                x = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    /*
+     * Take the item pushed least recently. Returns nullptr if the deque is
+     * empty. Losing a race for an item to another thread is not a reason to
+     * give up as long as there are items left.
+     */
+    auto steal() -> value_type
+    {
+        while (true) {
+            auto t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto const b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+
+            auto const x = array.load(std::memory_order_acquire)->get(t);
+            if (top.compare_exchange_strong(t,
+                                            t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+                return x;
+            }
+        }
+    }
+
+    /*
+     * Only an estimate if the deque is used concurrently.
+     */
+    auto size() const -> size_type
+    {
+        auto const b = bottom.load(std::memory_order_relaxed);
+        auto const t = top.load(std::memory_order_relaxed);
+        return ((b > t) ? static_cast<size_type>(b - t) : 0);
+    }
+    auto empty() const -> bool
+    {
+        return (size() == 0);
+    }
+
+    explicit Work_stealing_deque(size_type const capacity = 64)
+    {
+        arrays.push_back(std::make_unique<Array>(capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+    Work_stealing_deque(Work_stealing_deque const&) = delete;
+    auto operator=(Work_stealing_deque const&) -> Work_stealing_deque& = delete;
+};
+}}  // namespace viua::scheduler
+
+#endif
@@ -293,8 +293,22 @@ class Function_state {
                      viua::bytecode::codec::Register_set const,
                      std::vector<values::Value_type> const) -> bool;
 
+  private:
+    auto copy_from(Function_state const&) -> void;
+    auto import_value(values::Value_wrapper const&) -> values::Value_wrapper;
+    auto join_values(values::Value_wrapper, values::Value_wrapper const&)
+        -> bool;
+
+  public:
     auto dump(std::ostream&) const -> void;
     auto clone() const -> Function_state;
+    auto reset_to(Function_state const&) -> void;
+
+    /*
+     * Merge the state at the end of another path leading to the same place in
+     * the function into this state. Returns true if this state has changed.
+     */
+    auto join(Function_state const&) -> bool;
 
     auto local_capacity() const -> viua::bytecode::codec::register_index_type;
 
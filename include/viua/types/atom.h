@@ -20,16 +20,40 @@
 #ifndef VIUA_TYPES_ATOM_H
 #define VIUA_TYPES_ATOM_H
 
+#include <cstdint>
+#include <optional>
+#include <string>
+
 #include <viua/types/value.h>
 
 
 namespace viua { namespace types {
 class Atom : public Value {
+  public:
+    /*
+     * Atoms are interned. Every distinct atom gets a small integer ID the first
+     * time it is seen and keeps it for the rest of the VM's life so atoms can
+     * be compared (and used as keys) without looking at their names.
+     */
+    using id_type = uint32_t;
+
+  private:
     std::string const value;
+    id_type const interned;
 
   public:
     constexpr static auto type_name = "Atom";
 
+    static auto intern(std::string const&) -> id_type;
+    /*
+     * Look an atom up without interning it, for names that are only used to
+     * look things up (e.g. struct fields) and may not be atoms at all.
+     */
+    static auto find(std::string const&) -> std::optional<id_type>;
+    static auto name_of(id_type const) -> std::string const&;
+
+    auto id() const -> id_type;
+
     virtual std::string type() const override;
     virtual bool boolean() const override;
 
@@ -42,6 +66,7 @@ class Atom : public Value {
     virtual std::unique_ptr<Value> copy() const override;
 
     Atom(std::string);
+    explicit Atom(id_type const);
     ~Atom() override = default;
 };
 }}  // namespace viua::types
@@ -21,6 +21,7 @@
 #define VIUA_TYPES_BITS_H
 
 #include <cstdint>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -30,11 +31,34 @@
 
 namespace viua { namespace types {
 class Bits : public viua::types::Value {
-    std::vector<bool> underlying_array;
+  public:
+    using word_type = uint64_t;
+    using size_type = size_t;
+
+    constexpr static auto WORD_WIDTH = size_type{sizeof(word_type) * 8};
+
+  private:
+    /*
+     * Bits are packed into words, least significant word first. Bits of the
+     * last word which are above the width of the value are always zero so
+     * whole words can be compared and tested without masking them first.
+     *
+     * Copies share their words until one of them is modified (copy-on-write),
+     * so copying bits, or passing them to another process, takes constant
+     * time no matter how wide they are.
+     */
+    std::shared_ptr<std::vector<word_type>> underlying_array;
+    size_type width;
+
+    /*
+     * Words for modification in place. Shared words are copied first.
+     */
+    auto words() -> std::vector<word_type>&;
+    auto replace(std::vector<word_type>) -> void;
 
   public:
-    using size_type = decltype(underlying_array)::size_type;
     auto size() const -> size_type;
+    auto data() const -> std::vector<word_type> const&;
 
     auto at(size_type) const -> bool;
     auto set(size_type, bool const = true) -> bool;
@@ -93,9 +117,9 @@ class Bits : public viua::types::Value {
 
     std::unique_ptr<Value> copy() const override;
 
-    Bits(std::vector<bool>&&);
     Bits(std::vector<bool> const&);
     Bits(const size_type);
+    Bits(size_type const, std::vector<word_type>);
     Bits(std::vector<uint8_t> const);
 };
 }}  // namespace viua::types
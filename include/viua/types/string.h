@@ -48,8 +48,12 @@ class String : public Value {
      *  Designed to hold strings of bytes.
      *  Strings of bytes do not neccessarily represent human-readable text.
      *  They may represent just "strings of bytes".
+     *
+     *  Strings are immutable so copies share their bytes. Copying a string,
+     *  be it to pass it as a parameter or to keep it after sending it to
+     *  another process, takes constant time no matter how long it is.
      */
-    std::string svalue;
+    std::shared_ptr<std::string const> svalue;
 
   public:
     constexpr static auto type_name = "String";
@@ -72,6 +76,7 @@ class String : public Value {
                         viua::kernel::Kernel*);
 
     String(std::string s = "");
+    String(String const&);
     static auto make(std::string = "") -> std::unique_ptr<String>;
 };
 }}  // namespace viua::types
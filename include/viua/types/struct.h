@@ -20,10 +20,14 @@
 #ifndef VIUA_TYPES_STRUCT_H
 #define VIUA_TYPES_STRUCT_H
 
-#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <viua/types/atom.h>
 #include <viua/types/value.h>
 
 
@@ -33,8 +37,86 @@ class Struct : public Value {
      *
      *  This type is used internally inside the VM.
      */
+  public:
+    using key_type  = Atom::id_type;
+    using size_type = size_t;
+
+    /*
+     * The keys of a struct and the slot each key's value is kept in. Structs
+     * that had the same keys inserted in the same order share a shape, so a
+     * field access is a lookup in the shape followed by an indexed load from
+     * the struct's flat vector of values.
+     *
+     * Shared shapes are immutable and live for as long as the VM does. They
+     * form a tree rooted at the empty shape: inserting a new key moves
+     * a struct along a transition to a child shape, which is created the first
+     * time it is needed.
+     */
+    class Shape {
+        std::vector<key_type> keys;
+
+        /*
+         * Slots in the order of their keys' names. This is the order in which
+         * fields are listed by str() and keys().
+         */
+        std::vector<size_type> ordered;
+
+        /*
+         * Scanning a short vector of integers is faster than hashing. Bigger
+         * shapes are indexed.
+         */
+        constexpr static auto LINEAR_LOOKUP_LIMIT = size_type{8};
+        std::unordered_map<key_type, size_type> index;
+
+        /*
+         * Structs built with keys that differ from struct to struct would
+         * grow the tree without bound. Past this many children a shape stops
+         * sharing and structs that would need a new child get shapes of their
+         * own.
+         */
+        constexpr static auto TRANSITION_LIMIT = size_type{32};
+        mutable std::shared_mutex transitions_mtx;
+        mutable std::unordered_map<key_type, std::unique_ptr<Shape>>
+            transitions;
+
+      public:
+        static auto empty() -> Shape const*;
+
+        auto size() const -> size_type;
+        auto slot_of(key_type const) const -> std::optional<size_type>;
+        auto key_at(size_type const) const -> key_type;
+        auto in_order() const -> std::vector<size_type> const&;
+
+        /*
+         * Shared shapes with a key added, or the key in the given slot
+         * removed. Null if such a shape cannot be shared.
+         */
+        auto with(key_type const) const -> Shape const*;
+        auto without(size_type const) const -> Shape const*;
+
+        /*
+         * Only for shapes owned by a single struct.
+         */
+        auto add(key_type const) -> void;
+        auto remove(size_type const) -> void;
+
+        Shape() = default;
+        Shape(Shape const&);
+    };
+
   private:
-    std::map<std::string, std::unique_ptr<Value>> attributes;
+    /*
+     * Structs used as dictionaries would build a new shared shape for every
+     * key they get, and would never share them. Past this many keys a struct
+     * gets a shape of its own and modifies it in place.
+     */
+    constexpr static auto SHARED_SHAPE_LIMIT = size_type{64};
+
+    Shape const* shape = Shape::empty();
+    std::unique_ptr<Shape> own_shape;
+    std::vector<std::unique_ptr<Value>> values;
+
+    auto slot_of(key_type const) const -> size_type;
 
   public:
     constexpr static auto type_name = "Struct";
@@ -45,12 +127,16 @@ class Struct : public Value {
     auto str() const -> std::string override;
     auto repr() const -> std::string override;
 
-    virtual auto insert(std::string const& key, std::unique_ptr<Value> value)
-        -> void;
-    virtual auto remove(std::string const& key) -> std::unique_ptr<Value>;
-    virtual auto at(std::string const& key) -> Value*;
-    virtual auto at(std::string const& key) const -> Value const*;
-    virtual auto keys() const -> std::vector<std::string>;
+    virtual auto insert(key_type const, std::unique_ptr<Value> value) -> void;
+    virtual auto remove(key_type const) -> std::unique_ptr<Value>;
+    virtual auto at(key_type const) -> Value*;
+    virtual auto at(key_type const) const -> Value const*;
+    virtual auto keys() const -> std::vector<key_type>;
+
+    auto insert(std::string const& key, std::unique_ptr<Value> value) -> void;
+    auto remove(std::string const& key) -> std::unique_ptr<Value>;
+    auto at(std::string const& key) -> Value*;
+    auto at(std::string const& key) const -> Value const*;
 
     auto copy() const -> std::unique_ptr<Value> override;
     auto expire() -> void override;
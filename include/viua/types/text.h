@@ -20,6 +20,7 @@
 #ifndef VIUA_TYPES_TEXT_H
 #define VIUA_TYPES_TEXT_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -44,15 +45,31 @@ class Text : public Value {
     /**
      *  This type is designed to hold UTF-8 encoded text.
      *  Viua becomes tied to Unicode and the UTF-8 encoding.
+     *
+     *  The text is kept encoded, in a single string. To find code points by
+     *  their indexes without decoding the text from the beginning every time,
+     *  byte offsets of every INDEX_SAMPLING-th code point are collected the
+     *  first time a code point is looked up.
+     *
+     *  Texts are immutable so copies share both the encoded text and its
+     *  index (once it is built), and copying a text takes constant time.
      */
   public:
     using Character = std::string;
+    using size_type = std::string::size_type;
 
   private:
-    std::vector<Character> text;
-    std::string text_str;
+    std::shared_ptr<std::string const> text;
+    size_type length;
+    mutable std::shared_ptr<std::vector<size_type> const> index;
 
-    auto parse(std::string) -> decltype(text);
+    constexpr static auto INDEX_SAMPLING = size_type{64};
+
+    static auto width_of(char const) -> size_type;
+    static auto validate(std::string const&) -> size_type;
+    auto offset_of(size_type const) const -> size_type;
+
+    Text(std::string, size_type const);
 
   public:
     constexpr static auto type_name = "Text";
@@ -67,19 +84,18 @@ class Text : public Value {
     auto operator==(Text const&) const -> bool;
     auto operator+(Text const&) const -> Text;
 
-    using size_type = decltype(text)::size_type;
     auto at(const size_type) const -> Character;
     auto signed_size() const -> int64_t;
     auto size() const -> size_type;
-    auto sub(size_type, size_type) const -> decltype(text);
-    auto sub(size_type) const -> decltype(text);
+    auto sub(size_type, size_type) const -> Text;
+    auto sub(size_type) const -> Text;
     auto common_prefix(Text const&) const -> size_type;
     auto common_suffix(Text const&) const -> size_type;
 
     auto data() const -> std::string const&;
 
-    Text(std::vector<Character>);
     Text(std::string);
+    Text(Text const&);
     Text(Text&&);
     ~Text()
     {}
@@ -5,6 +5,7 @@ set -e
 export VIUA_LIBRARY_PATH=./build/stdlib
 export VIUA_PROC_SCHEDULERS=4
 export VIUA_IO_SCHEDULERS=1
+export VIUA_IO_ENGINE=${VIUA_IO_ENGINE:-epoll}
 export VIUA_FFI_SCHEDULERS=4
 
 # ./build/bin/vm/asm --no-sa net_server.asm
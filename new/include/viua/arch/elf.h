@@ -20,14 +20,46 @@
 #ifndef VIUA_ARCH_ELF_H
 #define VIUA_ARCH_ELF_H
 
+#include <elf.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+
 namespace viua::arch::elf {
 enum class R_VIUA : uint8_t {
     R_VIUA_NONE      = 0,
     R_VIUA_JUMP_SLOT = 1,
     R_VIUA_OBJECT    = 2,
 };
+
+/*
+ * ELF only defines the two lowest bits of st_other (the symbol's visibility).
+ * For function symbols Viua uses the remaining six bits to record how many
+ * local registers the function needs, so that the VM does not have to allocate
+ * a full register set for every call frame.
+ *
+ * The size is stored in units of FRAME_SIZE_GRANULE registers, rounded up. Zero
+ * means "unknown" and makes the VM fall back to the full register set, which
+ * keeps ELFs produced before the size was recorded working.
+ */
+inline constexpr auto FRAME_SIZE_GRANULE = size_t{8};
+inline constexpr auto FRAME_SIZE_SHIFT   = uint8_t{2};
+inline constexpr auto FRAME_SIZE_MAX     = size_t{256};
+
+constexpr auto st_frame_size(uint8_t const st_other) -> size_t
+{
+    return (st_other >> FRAME_SIZE_SHIFT) * FRAME_SIZE_GRANULE;
+}
+constexpr auto st_other_with_frame_size(uint8_t const st_other,
+                                        size_t const locals) -> uint8_t
+{
+    auto const units =
+        (std::clamp(locals, size_t{1}, FRAME_SIZE_MAX) + FRAME_SIZE_GRANULE - 1)
+        / FRAME_SIZE_GRANULE;
+    return static_cast<uint8_t>(ELF64_ST_VISIBILITY(st_other)
+                                | (units << FRAME_SIZE_SHIFT));
+}
 }  // namespace viua::arch::elf
 
 #endif
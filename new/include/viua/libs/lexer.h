@@ -23,10 +23,12 @@
 #include <stdint.h>
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 
@@ -99,7 +101,12 @@ struct Lexeme {
     TOKEN token;
     Location location;
 
-    std::optional<std::tuple<std::string, TOKEN, Location>> synthesized_from{};
+    /*
+     * Only a few lexemes are ever synthesized so the original is kept out of
+     * line to keep the lexemes small.
+     */
+    std::shared_ptr<std::tuple<std::string, TOKEN, Location> const>
+        synthesized_from{};
 
     Lexeme() = default;
     inline Lexeme(std::string tx, TOKEN tk, Location ln)
@@ -24,8 +24,13 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <deque>
+#include <filesystem>
 #include <map>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <viua/libs/errors/compile_time.h>
@@ -56,17 +61,41 @@ auto display_error_in_function(std::filesystem::path const source_path,
                                viua::libs::errors::compile_time::Error const& e,
                                std::string_view const fn_name) -> void;
 
-auto save_string_to_strtab(std::vector<uint8_t>&, std::string_view const)
-    -> size_t;
-auto save_buffer_to_rodata(std::vector<uint8_t>&, std::string_view const)
-    -> size_t;
+/*
+ * Contents of a .strtab or .rodata section being built, with an index of the
+ * values already saved in it. Saving a value which is already there gives back
+ * the offset of the existing copy without scanning the whole buffer for it.
+ *
+ * Bytes appended to the buffer directly (eg, the nul at the beginning of
+ * .strtab) are not indexed. The index keys point into copies of the saved
+ * values owned by the index itself so the buffer may be reallocated freely.
+ */
+struct Interned_buffer {
+    std::vector<uint8_t> buffer;
+
+    std::unordered_map<std::string_view, size_t> index;
+    std::deque<std::string> keys;
+
+    Interned_buffer()                       = default;
+    Interned_buffer(Interned_buffer const&) = delete;
+    Interned_buffer(Interned_buffer&&)      = default;
+    auto operator=(Interned_buffer const&) -> Interned_buffer& = delete;
+    auto operator=(Interned_buffer&&) -> Interned_buffer&      = default;
+};
+
+/*
+ * Strings in .strtab are shared with other strings they are tails of (eg,
+ * "foo" with "barfoo") as long as the longer one was saved first.
+ */
+auto save_string_to_strtab(Interned_buffer&, std::string_view const) -> size_t;
+auto save_buffer_to_rodata(Interned_buffer&, std::string_view const) -> size_t;
 auto record_symbol(std::string,
                    Elf64_Sym const,
                    std::vector<Elf64_Sym>& table,
                    std::map<std::string, size_t>& cache) -> size_t;
 
 auto cook_long_immediates(viua::libs::parser::ast::Instruction,
-                          std::vector<uint8_t>&,
+                          Interned_buffer&,
                           std::vector<Elf64_Sym>&,
                           std::map<std::string, size_t>&)
     -> std::vector<viua::libs::parser::ast::Instruction>;
@@ -89,6 +118,49 @@ auto expand_pseudoinstructions(
 
 auto emit_instruction(viua::libs::parser::ast::Instruction const)
     -> viua::arch::instruction_type;
+
+/*
+ * On-disk cache of cooked .text of functions, kept between runs of the
+ * assembler so that functions which did not change do not have to be expanded
+ * and encoded again. Entries are found by a key describing everything their
+ * code was cooked from; it is up to the caller to make the key complete.
+ *
+ * Each entry lives in a file named after a hash of its key. The whole key is
+ * saved in the entry too and compared on lookup, so colliding hashes only cost
+ * a cache miss. Entries are replaced atomically and the cache may be used by
+ * many threads (and processes) at the same time.
+ *
+ * Entries cooked by different builds of the assembler are never reused, so
+ * each build keeps its entries in a directory of its own and removes the
+ * directories of other builds when it opens the cache.
+ *
+ * The cache is an optimisation only: entries which cannot be read are treated
+ * as missing, and entries which cannot be saved are dropped.
+ */
+class Text_cache {
+  public:
+    using text_type = std::vector<viua::arch::instruction_type>;
+
+    struct Entry {
+        text_type text;
+
+        /*
+         * Number of ops each source instruction was cooked into, in order.
+         */
+        std::vector<size_t> sizes;
+    };
+
+  private:
+    std::filesystem::path directory;
+
+    auto path_of(std::string_view const) const -> std::filesystem::path;
+
+  public:
+    Text_cache(std::filesystem::path, std::string_view const assembler_id);
+
+    auto find(std::string_view const) const -> std::optional<Entry>;
+    auto store(std::string_view const, Entry const&) const -> void;
+};
 }  // namespace viua::libs::stage
 
 #endif
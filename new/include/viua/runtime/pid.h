@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <sys/socket.h>
 
+#include <atomic>
 #include <string>
 
 
@@ -47,7 +48,7 @@ struct PID {
 
 struct Pid_emitter {
     in6_addr base{};
-    uint64_t counter{};
+    std::atomic<uint64_t> counter{};
 
     Pid_emitter();
 
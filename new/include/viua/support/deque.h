@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIUA_SUPPORT_DEQUE_H
+#define VIUA_SUPPORT_DEQUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace viua::support {
+/*
+ * Chase-Lev work-stealing deque.
+ *
+ * Only one thread (the owner) may push() and pop(). Any thread may steal().
+ * The owner works on the bottom end of the deque, while thieves take elements
+ * from the top end. Nobody ever takes a lock: the only synchronisation point
+ * is a CAS on the top index which is contended only when the deque holds
+ * a single element, or when several thieves go for the same element.
+ *
+ * The element type must be trivially copyable because slots are read
+ * speculatively by thieves, and a thief that loses the CAS race just drops the
+ * value it read. Pointers are the intended use.
+ *
+ * When the deque fills up the buffer is doubled. Old buffers are kept alive
+ * until the deque is destroyed because a thief may still be reading from them;
+ * since the buffer only ever grows this wastes at most as much memory as the
+ * current buffer uses.
+ */
+template<typename T> class Work_stealing_deque {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    struct Buffer {
+        int64_t const capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Buffer(int64_t const c)
+                : capacity{c}, slots{std::make_unique<std::atomic<T>[]>(c)}
+        {}
+
+        inline auto at(int64_t const i) -> std::atomic<T>&
+        {
+            return slots[i & (capacity - 1)];
+        }
+    };
+
+    std::atomic<int64_t> top{0};
+    std::atomic<int64_t> bottom{0};
+    std::atomic<Buffer*> buffer{nullptr};
+
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    auto grow(Buffer* const old, int64_t const b, int64_t const t) -> Buffer*
+    {
+        auto fresh = std::make_unique<Buffer>(old->capacity * 2);
+        for (auto i = t; i < b; ++i) {
+            fresh->at(i).store(old->at(i).load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+        }
+
+        auto const p = fresh.get();
+        buffers.push_back(std::move(fresh));
+        buffer.store(p, std::memory_order_release);
+        return p;
+    }
+
+  public:
+    using value_type = T;
+
+    inline static constexpr auto INITIAL_CAPACITY = int64_t{64};
+
+    explicit Work_stealing_deque(int64_t const capacity = INITIAL_CAPACITY)
+    {
+        buffers.push_back(std::make_unique<Buffer>(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+    Work_stealing_deque(Work_stealing_deque const&) = delete;
+    Work_stealing_deque(Work_stealing_deque&&)      = delete;
+    auto operator=(Work_stealing_deque const&) -> Work_stealing_deque& = delete;
+    auto operator=(Work_stealing_deque&&) -> Work_stealing_deque&      = delete;
+
+    /*
+     * Owner only.
+     */
+    auto push(T const value) -> void
+    {
+        auto const b = bottom.load(std::memory_order_relaxed);
+        auto const t = top.load(std::memory_order_acquire);
+        auto buf     = buffer.load(std::memory_order_relaxed);
+
+        if ((b - t) >= buf->capacity) {
+            buf = grow(buf, b, t);
+        }
+
+        buf->at(b).store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /*
+     * Owner only. Takes the most recently pushed element.
+     */
+    auto pop(T& out) -> bool
+    {
+        auto const b = bottom.load(std::memory_order_relaxed) - 1;
+        auto buf     = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = buf->at(b).load(std::memory_order_relaxed);
+        if (t != b) {
+            return true;
+        }
+
+        /*
+         * Last element. Race the thieves for it.
+         */
+        auto const won = top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    /*
+     * Any thread. Takes the least recently pushed element. May fail spuriously
+     * if another thread took the element first.
+     */
+    auto steal(T& out) -> bool
+    {
+        auto t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto const b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;
+        }
+
+        auto buf = buffer.load(std::memory_order_acquire);
+        out      = buf->at(t).load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /*
+     * Approximate. Only useful as a hint.
+     */
+    auto size() const -> size_t
+    {
+        auto const b = bottom.load(std::memory_order_relaxed);
+        auto const t = top.load(std::memory_order_relaxed);
+        return static_cast<size_t>((b > t) ? (b - t) : 0);
+    }
+    auto empty() const -> bool
+    {
+        return (size() == 0);
+    }
+};
+}  // namespace viua::support
+
+#endif
@@ -23,15 +23,22 @@
 #include <endian.h>
 #include <liburing.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <experimental/memory>
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
+#include <random>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -41,11 +48,49 @@
 #include <vector>
 
 #include <viua/arch/arch.h>
+#include <viua/arch/elf.h>
+#include <viua/arch/ops.h>
 #include <viua/runtime/pid.h>
+#include <viua/support/deque.h>
 #include <viua/vm/elf.h>
 
 
 namespace viua::vm {
+/*
+ * Build with -DVIUA_VM_THREADED_DISPATCH (or VIUA_VM_DISPATCH=threaded passed
+ * to make) to pre-decode modules when they are loaded, and run them using the
+ * direct-threaded interpreter instead of the switch-based one.
+ */
+#ifdef VIUA_VM_THREADED_DISPATCH
+constexpr auto VIUA_THREADED_DISPATCH = true;
+#else
+constexpr auto VIUA_THREADED_DISPATCH = false;
+#endif
+
+/*
+ * Instruction decoded ahead of time, when its module was loaded. The handler
+ * is the address of the code implementing the instruction in the threaded
+ * interpreter. Operands are already unpacked so the instruction does not have
+ * to be decoded again each time it is executed.
+ */
+struct Decoded_instruction {
+    using operands_type = std::variant<viua::arch::ops::N,
+                                       viua::arch::ops::T,
+                                       viua::arch::ops::D,
+                                       viua::arch::ops::S,
+                                       viua::arch::ops::F,
+                                       viua::arch::ops::E,
+                                       viua::arch::ops::R,
+                                       viua::arch::ops::M>;
+
+    void* handler;
+    operands_type operands;
+    bool greedy;
+};
+
+auto predecode(std::vector<viua::arch::instruction_type> const&)
+    -> std::vector<Decoded_instruction>;
+
 struct Module {
     using strtab_type = std::vector<uint8_t>;
     using fntab_type  = std::vector<uint8_t>;
@@ -59,12 +104,45 @@ struct Module {
     text_type const text;
     text_type::value_type const* ip_base;
 
+    using decoded_type = std::vector<Decoded_instruction>;
+    decoded_type const decoded;
+
+    /*
+     * Number of local registers needed by each function, keyed by the
+     * function's offset in .text. The assembler records it in st_other of
+     * function symbols.
+     */
+    using frame_sizes_type = std::unordered_map<uint64_t, size_t>;
+    frame_sizes_type const frame_sizes;
+
+    /*
+     * Atoms are stored in .rodata and, since they can be bigger than 128 bits
+     * and the VM is not able to hold them directly in a register, we need to
+     * use a trick. The register holds a key with which the atom can be
+     * referenced, and the key is the address of the atom's contents in
+     * .rodata.
+     *
+     * The contents of .rodata never change so the table of atoms is built once,
+     * when the module is loaded, from the objects listed in the symbol table.
+     * Executing an ATOM instruction does not have to copy anything, and every
+     * process sees the same atoms. Since identical contents are only stored in
+     * .rodata once, atoms can be compared by key instead of by contents.
+     */
+    using atom_key_type = uint64_t;
+    using atoms_table_type =
+        std::unordered_map<atom_key_type, std::string_view>;
+    atoms_table_type const atoms;
+
     inline Module(std::filesystem::path const ep, viua::vm::elf::Loaded_elf le)
             : elf_path{std::move(ep)}
             , elf{std::move(le)}
             , strings_table{elf.find_fragment(".rodata")->get().data}
             , text{elf.make_text_from(elf.find_fragment(".text")->get().data)}
             , ip_base{text.data()}
+            , decoded{VIUA_THREADED_DISPATCH ? predecode(text)
+                                             : decoded_type{}}
+            , frame_sizes{make_frame_sizes(elf)}
+            , atoms{make_atoms(elf, strings_table)}
     {}
     inline Module(Module const&) = delete;
     inline Module(Module&& m) : Module{std::move(m.elf_path), std::move(m.elf)}
@@ -85,6 +163,65 @@ struct Module {
     {
         return (ip > ip_base) and (ip < (ip_base + text.size()));
     }
+
+    /*
+     * Functions for which the size was not recorded get the full register set.
+     */
+    inline auto frame_size_at(uint64_t const off) const -> size_t
+    {
+        if (auto const fs = frame_sizes.find(off); fs != frame_sizes.end()) {
+            return fs->second;
+        }
+        return viua::arch::elf::FRAME_SIZE_MAX;
+    }
+
+  private:
+    inline static auto make_frame_sizes(viua::vm::elf::Loaded_elf const& elf)
+        -> frame_sizes_type
+    {
+        auto sizes = frame_sizes_type{};
+        for (auto const& sym : elf.symtab) {
+            if (ELF64_ST_TYPE(sym.st_info) != STT_FUNC) {
+                continue;
+            }
+            if (auto const sz = viua::arch::elf::st_frame_size(sym.st_other);
+                sz) {
+                sizes.emplace(sym.st_value, sz);
+            }
+        }
+        return sizes;
+    }
+
+    inline static auto make_atoms(viua::vm::elf::Loaded_elf const& elf,
+                                  strtab_type const& rodata) -> atoms_table_type
+    {
+        auto atoms = atoms_table_type{};
+        for (auto const& sym : elf.symtab) {
+            if (ELF64_ST_TYPE(sym.st_info) != STT_OBJECT) {
+                continue;
+            }
+
+            /*
+             * Each object is preceded by its size, stored as a 64-bit little
+             * endian integer.
+             */
+            auto const offset = sym.st_value;
+            if ((offset < sizeof(uint64_t)) or (offset > rodata.size())) {
+                continue;
+            }
+            auto size = uint64_t{};
+            memcpy(&size, &rodata[offset - sizeof(uint64_t)], sizeof(size));
+            size = le64toh(size);
+            if (size > (rodata.size() - offset)) {
+                continue;
+            }
+
+            auto const data = reinterpret_cast<char const*>(&rodata[offset]);
+            atoms.emplace(reinterpret_cast<atom_key_type>(data),
+                          std::string_view{data, size});
+        }
+        return atoms;
+    }
 };
 
 template<typename> inline constexpr bool always_false_v = false;
@@ -316,11 +453,86 @@ struct Frame {
         uint64_t sbrk{MEM_FIRST_STACK_BREAK};
     } saved;
 
-    inline Frame(size_t const sz, addr_type const e, addr_type const r)
-            : registers(sz), entry_address{e}, return_address{r}
+    inline Frame(std::vector<Register>&& regs,
+                 addr_type const e,
+                 addr_type const r)
+            : registers{std::move(regs)}, entry_address{e}, return_address{r}
     {}
 };
 
+struct Performance_counters {
+    using counter_type = uint64_t;
+    std::atomic<counter_type> total_ops_executed{0};
+    counter_type total_us_elapsed{0};
+
+    /*
+     * I/O requests are submitted in batches. Every request beyond the first
+     * one in a batch is an io_uring_enter(2) call that did not have to be made.
+     */
+    std::atomic<counter_type> io_syscalls_saved{0};
+
+    using time_point_type = std::chrono::time_point<std::chrono::steady_clock>;
+    time_point_type bang{};
+    time_point_type death{};
+
+    inline auto start() -> void
+    {
+        bang = std::chrono::steady_clock::now();
+    }
+    inline auto stop() -> void
+    {
+        death = std::chrono::steady_clock::now();
+    }
+    inline auto duration() const -> auto
+    {
+        return (death - bang);
+    }
+};
+
+/*
+ * Execution profile, collected only when the VM runs with VIUA_VM_PROFILE set.
+ * Each scheduler has its own profile, so nothing has to be synchronised while
+ * processes are running. Profiles are merged when the VM exits.
+ *
+ * Functions are identified by the address of their first instruction. This is
+ * unique even if several modules are loaded.
+ */
+struct Profile {
+    using counter_type = uint64_t;
+    using addr_type    = Frame::addr_type;
+
+    struct Counter {
+        counter_type count{0};
+        counter_type cycles{0};
+    };
+
+    /*
+     * Keyed by opcode, without the greedy bit.
+     */
+    std::unordered_map<viua::arch::opcode_type, Counter> ops;
+
+    /*
+     * Instructions executed by each function and the cycles they took, not
+     * counting callees. Calls are counted separately, when a CALL instruction
+     * pushes a new frame.
+     */
+    std::unordered_map<addr_type, Counter> functions;
+    std::unordered_map<addr_type, counter_type> calls;
+
+    /*
+     * Cycles spent in each call stack, from the outermost function to the
+     * innermost one. This is what a flame graph is drawn from.
+     */
+    std::map<std::vector<addr_type>, counter_type> stacks;
+
+    auto merge(Profile const&) -> void;
+
+    /*
+     * Time stamp counter on x86-64, nanoseconds elsewhere.
+     */
+    static auto now() -> counter_type;
+};
+
 namespace io {
 using buffer_view = std::basic_string_view<uint8_t>;
 }
@@ -346,6 +558,18 @@ struct IO_request {
     };
     Status status{Status::In_flight};
 
+    /*
+     * Result of the operation as reported by the completion queue ie, number
+     * of bytes transferred or a negated errno value.
+     */
+    int32_t result{0};
+
+    /*
+     * PID of the process parked in Core::suspended until this request
+     * completes, if any.
+     */
+    std::optional<viua::runtime::PID> waiter;
+
     inline IO_request(uint8_t* const rp,
                       id_type const i,
                       opcode_type const o,
@@ -371,13 +595,40 @@ struct IO_scheduler {
         std::unordered_map<IO_request::id_type, std::unique_ptr<IO_request>>;
     map_type requests;
 
-    inline IO_scheduler()
+    /*
+     * The ring and the requests map are shared by all scheduler threads.
+     */
+    std::mutex ring_mtx;
+
+    /*
+     * Number of requests handed to the ring whose completions were not reaped
+     * yet.
+     */
+    std::atomic<size_t> in_flight{0};
+
+    /*
+     * The kernel signals this eventfd whenever it posts a completion so that
+     * a scheduler can wait for completions without holding the ring_mtx.
+     */
+    int const completion_fd{-1};
+
+    Performance_counters& perf_counters;
+
+    inline explicit IO_scheduler(Performance_counters& pc)
+            : completion_fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)}
+            , perf_counters{pc}
     {
         io_uring_queue_init(IO_URING_ENTRIES, &ring, 0);
+        if (completion_fd != -1) {
+            io_uring_register_eventfd(&ring, completion_fd);
+        }
     }
     inline ~IO_scheduler()
     {
         io_uring_queue_exit(&ring);
+        if (completion_fd != -1) {
+            close(completion_fd);
+        }
     }
 
     using opcode_type = decltype(io_uring_sqe::opcode);
@@ -386,61 +637,121 @@ struct IO_scheduler {
         -> IO_request::id_type;
     auto schedule(uint8_t* const, int const, opcode_type const, io::buffer_view)
         -> IO_request::id_type;
-};
 
-struct Performance_counters {
-    using counter_type = uint64_t;
-    counter_type total_ops_executed{0};
-    counter_type total_us_elapsed{0};
-
-    using time_point_type = std::chrono::time_point<std::chrono::steady_clock>;
-    time_point_type bang{};
-    time_point_type death{};
+    /*
+     * Scheduling a request only queues an SQE. Queued SQEs are handed over to
+     * the kernel in one go by submit(), which schedulers call once per tick
+     * (and which is also called when the submission queue fills up). The
+     * caller must hold the ring_mtx.
+     */
+    auto submit() -> void;
 
-    inline auto start() -> void
-    {
-        bang = std::chrono::steady_clock::now();
-    }
-    inline auto stop() -> void
-    {
-        death = std::chrono::steady_clock::now();
-    }
-    inline auto duration() const -> auto
-    {
-        return (death - bang);
-    }
+  private:
+    auto queue(std::unique_ptr<IO_request>,
+               int const,
+               void const* const,
+               size_t const) -> IO_request::id_type;
 };
 
 struct Process;
 
+/*
+ * Every scheduler thread owns a local run queue. Processes spawned by a
+ * process running on a scheduler (and processes preempted by it) are put on
+ * that scheduler's queue. Idle schedulers steal processes from random victims.
+ *
+ * The owner takes processes from the same end thieves do, so that the local
+ * queue is FIFO and no process is starved by a busy neighbour that keeps
+ * getting rescheduled.
+ */
+struct Scheduler {
+    using queue_type = viua::support::Work_stealing_deque<Process*>;
+    queue_type run_queue;
+
+    size_t const id;
+    std::minstd_rand victim_rng;
+
+    Profile profile;
+
+    explicit inline Scheduler(size_t const i) : id{i}, victim_rng(i + 1)
+    {}
+};
+
 struct Core {
     std::map<std::string, Module> modules;
 
-    IO_scheduler io;
-
     Performance_counters perf_counters;
+    bool profiling{false};
+
+    IO_scheduler io{perf_counters};
 
     using pid_type = viua::runtime::PID;
     viua::runtime::Pid_emitter pids;
 
+    std::mutex flock_mtx;
     std::map<pid_type, std::unique_ptr<Process>> flock;
+    std::atomic<size_t> live_processes{0};
+    std::atomic<bool> aborted{false};
+
+    /*
+     * Global run queue. Processes spawned from outside of scheduler threads
+     * (eg, the main process) are put here and picked up by whichever
+     * scheduler runs out of local work first.
+     */
+    std::mutex run_queue_mtx;
     std::queue<std::experimental::observer_ptr<Process>> run_queue;
+
+    std::mutex suspended_mtx;
     std::map<pid_type, std::experimental::observer_ptr<Process>> suspended;
 
-    inline auto pop_ready() -> auto
-    {
-        auto proc = std::move(run_queue.front());
-        run_queue.pop();
-        return proc;
-    }
-    inline auto push_ready(std::experimental::observer_ptr<Process> proc)
-        -> void
-    {
-        run_queue.push(std::move(proc));
-    }
+    std::vector<std::unique_ptr<Scheduler>> schedulers;
+    inline static thread_local Scheduler* this_scheduler{nullptr};
+
+    /*
+     * Schedulers with nothing to run go to sleep until more work is announced
+     * (a process is put on a run queue), or until there are no live processes
+     * left. The counter of announcements lets a scheduler notice work that was
+     * announced between its last look for work and going to sleep; the counter
+     * of sleeping schedulers lets the announcer skip the mutex when nobody
+     * sleeps.
+     */
+    std::atomic<uint64_t> work_announcements{0};
+    std::atomic<size_t> idle_schedulers{0};
+
+    /*
+     * Set while one of the idle schedulers waits for completions of I/O
+     * requests in flight. Only one does - the others go to sleep and are
+     * woken up when the completions make processes ready to run.
+     */
+    std::atomic<bool> io_poller{false};
+    std::mutex idle_schedulers_mtx;
+    std::condition_variable idle_schedulers_cv;
+
+    auto work_announced() const -> uint64_t;
+    auto wait_for_work(uint64_t const) -> void;
+    auto wake_idle_schedulers(bool const) -> void;
+
+    auto make_schedulers(size_t const) -> void;
+    auto pop_ready() -> std::experimental::observer_ptr<Process>;
+    auto push_ready(std::experimental::observer_ptr<Process>) -> void;
     auto find(pid_type const) -> std::experimental::observer_ptr<Process>;
 
     auto spawn(std::string, uint64_t const) -> pid_type;
+
+    auto suspend(std::experimental::observer_ptr<Process>) -> void;
+
+    /*
+     * Submit queued I/O requests and reap completions. Called by schedulers
+     * between quanta.
+     */
+    auto poll_io() -> void;
+
+    /*
+     * Submit queued I/O requests and wait until at least one completion is
+     * posted (or for a short while, if none is), then reap completions. Called
+     * by an idle scheduler while I/O requests are in flight.
+     */
+    auto wait_for_io() -> void;
 };
 
 struct Stack {
@@ -453,6 +764,13 @@ struct Stack {
     std::vector<Frame> frames;
     std::vector<Register> args;
 
+    /*
+     * Register sets of popped frames are kept here and reused by frames pushed
+     * later. Once a process has reached its usual call depth calls no longer
+     * allocate memory for registers.
+     */
+    std::vector<std::vector<Register>> spare_registers;
+
     explicit inline Stack(Process& p) : proc{&p}
     {}
 
@@ -464,7 +782,24 @@ struct Stack {
     inline auto push(size_t const sz, addr_type const e, addr_type const r)
         -> void
     {
-        frames.emplace_back(sz, e, r);
+        auto regs = std::vector<Register>{};
+        if (not spare_registers.empty()) {
+            regs = std::move(spare_registers.back());
+            spare_registers.pop_back();
+        }
+        regs.resize(sz);
+        frames.emplace_back(std::move(regs), e, r);
+    }
+    inline auto pop() -> Frame
+    {
+        auto fr = std::move(frames.back());
+        frames.pop_back();
+        return fr;
+    }
+    inline auto recycle(Frame& fr) -> void
+    {
+        fr.registers.clear();
+        spare_registers.push_back(std::move(fr.registers));
     }
 
     inline auto back() -> decltype(frames)::reference
@@ -484,33 +819,54 @@ struct Stack {
 inline constexpr auto MEM_LINE_SIZE = size_t{16};
 inline constexpr auto MEM_PAGE_SIZE = MEM_LINE_SIZE * 16;
 
-struct Page {
-    using unit_type    = uint8_t;
-    using storage_type = std::array<unit_type, MEM_PAGE_SIZE>;
+/*
+ * Memory of a process. The stack grows down from MEM_FIRST_STACK_BREAK.
+ *
+ * The whole stack segment is reserved up front as a single anonymous mapping.
+ * The kernel backs its pages with RAM only when they are first touched, so
+ * memory is committed on demand as the stack grows. The segment never moves
+ * so host pointers into it (eg, buffers of in-flight I/O requests) stay valid.
+ *
+ * Since the segment is contiguous, translating a VM address to a host pointer
+ * is a single subtraction. Bounds are only checked against the stack break,
+ * and AA refuses to move the break past the end of the segment.
+ */
+struct Memory {
+    inline static constexpr auto STACK_SIZE = size_t{8 * 1024 * 1024};
 
-    alignas(uint64_t) storage_type storage;
+    uint8_t* segment{nullptr};
+    size_t const size{STACK_SIZE};
 
-    inline constexpr auto data() -> uint8_t*
-    {
-        return storage.data();
-    }
-    inline constexpr auto data() const -> uint8_t const*
+    /*
+     * Most bytes of the stack that were ever in use. Memory dumps do not need
+     * to show anything beyond that.
+     */
+    size_t high_water{0};
+
+    Memory();
+    ~Memory();
+    Memory(Memory const&)                    = delete;
+    Memory(Memory&&)                         = delete;
+    auto operator=(Memory const&) -> Memory& = delete;
+    auto operator=(Memory&&) -> Memory&      = delete;
+
+    inline auto lowest_address() const -> uint64_t
     {
-        return storage.data();
+        return (MEM_FIRST_STACK_BREAK + 1 - size);
     }
-
-    inline constexpr auto at(size_t const i) -> uint8_t&
+    inline auto at(uint64_t const addr) -> uint8_t*
     {
-        return storage.at(i);
+        return (segment + (addr - lowest_address()));
     }
-    inline constexpr auto at(size_t const i) const -> uint8_t
+    inline auto at(uint64_t const addr) const -> uint8_t const*
     {
-        return storage.at(i);
+        return (segment + (addr - lowest_address()));
     }
 
-    inline constexpr auto size() const -> size_t
+    inline auto grown_to(uint64_t const stack_break) -> void
     {
-        return storage.size();
+        high_water =
+            std::max(high_water, (MEM_FIRST_STACK_BREAK + 1 - stack_break));
     }
 };
 
@@ -528,20 +884,6 @@ struct Pointer {
      */
     uintptr_t ptr{0};
 
-    /*
-     * The page() and offset() functions only make sense for VM pointers, where
-     * the pointer is really an offset into the vector of pages allocated for a
-     * process' stack.
-     */
-    inline auto page() const -> size_t
-    {
-        return (ptr / MEM_PAGE_SIZE);
-    }
-    inline auto offset() const -> size_t
-    {
-        return (ptr % MEM_PAGE_SIZE);
-    }
-
     /*
      * For foreign pointers: 0.
      * For VM pointers: size of the area pointed to.
@@ -577,6 +919,33 @@ struct Pointer {
     }
 };
 
+/*
+ * Stack pointers are created in stack order ie, at ever lower addresses, and
+ * are invalidated in bulk when a frame is popped and the stack break moves
+ * back up. They are kept in a flat vector sorted by address in descending
+ * order so that the pointers to prune are always at the back, and pruning is
+ * just truncating the vector. Lookups are a binary search.
+ *
+ * Foreign pointers are never pruned and live in a separate vector (sorted in
+ * the same order) so they do not get in the way.
+ */
+struct Pointer_table {
+    using id_type      = Pointer::id_type;
+    using storage_type = std::vector<Pointer>;
+    storage_type local;
+    storage_type foreign;
+
+    auto record(Pointer const) -> void;
+    auto forget(Pointer const) -> void;
+    auto find(id_type const) const -> Pointer const*;
+    auto prune(uint64_t const stack_break) -> void;
+
+    inline auto size() const -> size_t
+    {
+        return (local.size() + foreign.size());
+    }
+};
+
 struct Process {
     using pid_type = viua::runtime::PID;
     pid_type const pid;
@@ -587,22 +956,9 @@ struct Process {
     Module::strtab_type const* strtab;
 
     /*
-     * Atoms are stored in .rodata and only instantiated when first referenced
-     * by an instruction executed by the process. Since they can be bigger than
-     * 128 bits and the VM is not able to hold them directly in a register, we
-     * need to use a trick.
-     *
-     * What we really do when executing an ATOM instruction is we create a
-     * useful object representing the atom, stash it aside, and store the key
-     * with which it can be referenced in the register.
-     *
-     * We can easily check if the atom was already instantiated so there is no
-     * need to produce multiple copies of it. When comparing atoms we can also
-     * do it by key and we do not need to compare their text contents.
+     * Atoms are not owned by processes. See Module::atoms.
      */
-    using atom_key_type  = Register::atom_type::key_type;
-    using atoms_map_type = std::map<atom_key_type, std::string>;
-    atoms_map_type atoms;
+    using atom_key_type = Register::atom_type::key_type;
 
     using globals_map_type = std::map<atom_key_type, Register>;
     globals_map_type globals;
@@ -610,8 +966,16 @@ struct Process {
     using stack_type = Stack;
     stack_type stack;
 
-    std::vector<Page> memory;
-    std::map<Pointer::id_type, Pointer> pointers;
+    /*
+     * Set by IO_WAIT when the awaited request is still in flight. The
+     * scheduler ends the quantum early and parks the process in
+     * Core::suspended until the request completes; then the process is put
+     * back in a run queue and re-executes the IO_WAIT.
+     */
+    std::optional<IO_request::id_type> awaited_io;
+
+    Memory memory;
+    Pointer_table pointers;
     uint64_t frame_pointer{MEM_FIRST_STACK_BREAK + 1};
     uint64_t stack_break{MEM_FIRST_STACK_BREAK + 1};
 
@@ -623,9 +987,7 @@ struct Process {
 
     explicit inline Process(pid_type const p, Core* c, Module const& m)
             : pid{p}, core{c}, module{m}, strtab{&m.strings_table}, stack{*this}
-    {
-        memory.emplace_back();
-    }
+    {}
 
     inline auto push_frame(size_t const locals,
                            stack_type::addr_type const entry_ip,
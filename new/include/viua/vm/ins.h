@@ -97,7 +97,7 @@ Work_instruction(EBREAK);
 Work_instruction(ECALL);
 
 Work_instruction(IO_SUBMIT);
-Work_instruction(IO_WAIT);
+Flow_instruction(IO_WAIT);
 Work_instruction(IO_SHUTDOWN);
 Work_instruction(IO_CTL);
 Work_instruction(IO_PEEK);
@@ -122,6 +122,14 @@ using register_type = viua::vm::Register;
 
 auto execute(viua::vm::Stack&, ip_type const) -> ip_type;
 
+/*
+ * Run the process owning the stack using the threaded interpreter until it
+ * executes budget instructions (greedy bundles are never interrupted), its IP
+ * leaves .text, or it has to wait for I/O. Requires the module to be
+ * pre-decoded ie, VIUA_THREADED_DISPATCH.
+ */
+auto run_threaded(viua::vm::Stack&, size_t const, uint64_t&) -> ip_type;
+
 /*
  * Utility functions. Used in implementation of EBREAK, but also accessed by the
  * repl-debugger combo to dump backtraces and register dumps. Reuse makes
@@ -130,9 +138,9 @@ auto execute(viua::vm::Stack&, ip_type const) -> ip_type;
 auto print_backtrace(viua::vm::Stack const&,
                      std::optional<size_t> const = std::nullopt) -> void;
 auto dump_registers(std::vector<register_type> const&,
-                    Process::atoms_map_type const&,
+                    Module::atoms_table_type const&,
                     std::string_view const) -> void;
-auto dump_memory(std::vector<Page> const&) -> void;
+auto dump_memory(Memory const&) -> void;
 
 struct Immutable_proxy {
     register_type const& target;
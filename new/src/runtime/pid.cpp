@@ -73,8 +73,9 @@ Pid_emitter::Pid_emitter() : base{{{0xfe, 0x80, 0x00}}}, counter{0}
                 "VIUA_VM_PID_SEED must contain an IPv6 address"};
         }
 
-        memcpy(&counter, base.s6_addr + 8, sizeof(counter));
-        counter = be64toh(counter);
+        auto c = uint64_t{};
+        memcpy(&c, base.s6_addr + 8, sizeof(c));
+        counter = be64toh(c);
     } else {
         std::random_device rd;
         counter = std::uniform_int_distribution<uint64_t>{
@@ -84,7 +85,7 @@ Pid_emitter::Pid_emitter() : base{{{0xfe, 0x80, 0x00}}}, counter{0}
 
 auto Pid_emitter::emit() -> PID
 {
-    auto c = htobe64(counter++);
+    auto c = htobe64(counter.fetch_add(1));
     auto p = base;
 
     memcpy(p.s6_addr + 8, &c, sizeof(c));
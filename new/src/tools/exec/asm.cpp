@@ -28,8 +28,10 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <charconv>
 #include <chrono>
+#include <exception>
 #include <experimental/memory>
 #include <filesystem>
 #include <functional>
@@ -42,8 +44,10 @@
 #include <optional>
 #include <ranges>
 #include <set>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <thread>
 #include <type_traits>
 #include <utility>
@@ -69,6 +73,7 @@ constexpr auto DEBUG_LEX                        = true;
 constexpr auto DEBUG_PARSE                      = true;
 constexpr auto DEBUG_EXPANSION [[maybe_unused]] = false;
 
+using viua::libs::stage::Interned_buffer;
 using viua::libs::stage::save_buffer_to_rodata;
 using viua::libs::stage::save_string_to_strtab;
 using viua::support::string::quote_fancy;
@@ -988,7 +993,7 @@ auto parse(viua::support::vector_view<Lexeme> lexemes)
 }
 
 auto make_symbol(std::string_view const name,
-                 std::vector<uint8_t>& string_table) -> Elf64_Sym
+                 Interned_buffer& string_table) -> Elf64_Sym
 {
     auto const name_off =
         name.empty() ? 0 : save_string_to_strtab(string_table, name);
@@ -998,7 +1003,7 @@ auto make_symbol(std::string_view const name,
     return sym;
 }
 auto make_symbol(viua::libs::lexer::Lexeme const& name,
-                 std::vector<uint8_t>& string_table) -> Elf64_Sym
+                 Interned_buffer& string_table) -> Elf64_Sym
 {
     auto const& unquoted_name = make_name_from_lexeme(name);
     auto const name_off =
@@ -1015,7 +1020,7 @@ using Decl_map =
     std::vector<std::pair<ast::Symbol const&, ast::Section const&>>;
 
 auto save_declared_symbols(std::vector<std::unique_ptr<ast::Node>> const& nodes,
-                           std::vector<uint8_t>& string_table,
+                           Interned_buffer& string_table,
                            std::vector<Elf64_Sym>& symbol_table,
                            std::map<std::string, size_t>& symbol_map,
                            Decl_map& declarations) -> void
@@ -1144,8 +1149,8 @@ auto save_declared_symbols(std::vector<std::unique_ptr<ast::Node>> const& nodes,
 }
 
 auto save_objects(std::vector<std::unique_ptr<ast::Node>>& nodes,
-                  std::vector<uint8_t>& rodata_buf,
-                  std::vector<uint8_t>& string_table,
+                  Interned_buffer& rodata_buf,
+                  Interned_buffer& string_table,
                   std::vector<Elf64_Sym>& symbol_table,
                   std::map<std::string, size_t>& symbol_map,
                   Decl_map const& declared_symbols) -> void
@@ -1253,10 +1258,10 @@ auto save_objects(std::vector<std::unique_ptr<ast::Node>>& nodes,
 
             std::cerr << "recording object label " << active_label << " at "
                       << "[.rodata+0x" << std::hex << std::setfill('0')
-                      << std::setw(16) << rodata_buf.size() << std::dec
+                      << std::setw(16) << rodata_buf.buffer.size() << std::dec
                       << std::setfill(' ') << "]\n";
 
-            active_symbol->st_value = rodata_buf.size();
+            active_symbol->st_value = rodata_buf.buffer.size();
             continue;
         }
 
@@ -1357,7 +1362,7 @@ auto save_objects(std::vector<std::unique_ptr<ast::Node>>& nodes,
                 if (active_symbol) {
                     active_symbol->st_value = value_off;
                     active_symbol->st_size =
-                        (rodata_buf.size() - active_symbol->st_value);
+                        (rodata_buf.buffer.size() - active_symbol->st_value);
                 }
 
                 std::cerr << "allocated " << active_symbol->st_size
@@ -1645,7 +1650,7 @@ auto save_objects(std::vector<std::unique_ptr<ast::Node>>& nodes,
 }
 
 auto cache_function_labels(std::vector<std::unique_ptr<ast::Node>> const& nodes,
-                           std::vector<uint8_t>& string_table,
+                           Interned_buffer& string_table,
                            std::vector<Elf64_Sym>& symbol_table,
                            std::map<std::string, size_t>& symbol_map) -> void
 {
@@ -1870,6 +1875,18 @@ auto emit_instruction(ast::Instruction const insn)
     }
 }
 
+/*
+ * Functions are cooked on many threads at the same time so whatever is said
+ * while expanding their instructions is collected, and printed in order once
+ * all of them are done.
+ */
+thread_local auto cooking_log_stream =
+    std::experimental::observer_ptr<std::ostream>{};
+auto cooking_log() -> std::ostream&
+{
+    return (cooking_log_stream ? *cooking_log_stream : std::cerr);
+}
+
 using Text = std::vector<viua::arch::instruction_type>;
 auto expand_li(ast::Instruction const& raw, bool const force_full = false)
     -> Text
@@ -1912,21 +1929,21 @@ auto expand_li(ast::Instruction const& raw, bool const force_full = false)
     auto const is_greedy = (raw.leader.text.find("g.") == 0);
     auto const full_form = raw.has_attr("full") or force_full;
 
-    std::cerr << "EXPANDING" << (is_unsigned ? " UNSIGNED" : "") << " LI OF "
-              << raw_value.text << " => " << std::hex << std::setfill('0')
-              << std::setw(16) << value << std::dec << std::setfill(' ')
-              << " (";
+    auto& log = cooking_log();
+    log << "EXPANDING" << (is_unsigned ? " UNSIGNED" : "") << " LI OF "
+        << raw_value.text << " => " << std::hex << std::setfill('0')
+        << std::setw(16) << value << std::dec << std::setfill(' ') << " (";
     if (is_unsigned) {
-        std::cerr << value;
+        log << value;
     } else {
-        std::cerr << static_cast<int64_t>(value);
+        log << static_cast<int64_t>(value);
     }
-    std::cerr << ")"
-              << "\n";
-    std::cerr << "  HI " << std::hex << std::setfill('0') << std::setw(8) << hi
-              << "\n";
-    std::cerr << "  LO " << std::setw(8) << lo << "\n";
-    std::cerr << std::setfill(' ') << std::dec;
+    log << ")"
+        << "\n";
+    log << "  HI " << std::hex << std::setfill('0') << std::setw(8) << hi
+        << "\n";
+    log << "  LO " << std::setw(8) << lo << "\n";
+    log << std::setfill(' ') << std::dec;
 
     auto const important_hi = is_unsigned ? hi
                                           : (hi != static_cast<uint32_t>(-1));
@@ -2037,7 +2054,7 @@ auto expand_li(ast::Instruction const& raw, bool const force_full = false)
         cooked.push_back(emit_instruction(synth));
     }
 
-    std::cerr << "        cooked into " << cooked.size() << " op(s)\n";
+    cooking_log() << "        cooked into " << cooked.size() << " op(s)\n";
 
     return cooked;
 }
@@ -2058,9 +2075,10 @@ auto expand_delete(ast::Instruction const& raw) -> Text
     return {emit_instruction(synth)};
 }
 auto expand_flow_control(ast::Instruction const& raw,
-                         std::vector<Elf64_Sym>& symbol_table,
+                         std::vector<Elf64_Sym> const& symbol_table,
                          std::map<std::string, size_t> const& symbol_map,
-                         Decl_map const& decl_map) -> Text
+                         Decl_map const& decl_map,
+                         uint8_t const scratch) -> Text
 {
     using viua::libs::lexer::TOKEN;
     auto const jump_addr_already_loaded =
@@ -2080,7 +2098,8 @@ auto expand_flow_control(ast::Instruction const& raw,
         auto const& lx = target.ingredients.front();
         jmp_offset.ingredients.push_back(lx.make_synth("$", TOKEN::DOLLAR));
         jmp_offset.ingredients.push_back(
-            lx.make_synth("253", TOKEN::LITERAL_INTEGER));
+            lx.make_synth(std::to_string(static_cast<unsigned>(scratch)),
+                          TOKEN::LITERAL_INTEGER));
         jmp_offset.ingredients.push_back(lx.make_synth(".", TOKEN::DOT));
         jmp_offset.ingredients.push_back(
             lx.make_synth("l", TOKEN::LITERAL_ATOM));
@@ -2121,8 +2140,9 @@ auto expand_flow_control(ast::Instruction const& raw,
                 .add(raw.leader);
         }
 
-        auto const is_jump_label = (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
-                                   and (sym.st_other == STV_HIDDEN);
+        auto const is_jump_label =
+            (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
+            and (ELF64_ST_VISIBILITY(sym.st_other) == STV_HIDDEN);
         if (not is_jump_label) {
             using viua::libs::errors::compile_time::Cause;
             using viua::libs::errors::compile_time::Error;
@@ -2159,13 +2179,14 @@ auto expand_flow_control(ast::Instruction const& raw,
     }
     cooked.push_back(emit_instruction(jmp));
 
-    std::cerr << "        cooked into " << cooked.size() << " ops\n";
+    cooking_log() << "        cooked into " << cooked.size() << " ops\n";
 
     return cooked;
 }
 auto expand_call(ast::Instruction const& raw,
-                 std::vector<Elf64_Sym>& symbol_table,
-                 std::map<std::string, size_t> const& symbol_map) -> Text
+                 std::vector<Elf64_Sym> const& symbol_table,
+                 std::map<std::string, size_t> const& symbol_map,
+                 uint8_t const scratch) -> Text
 {
     using viua::libs::lexer::TOKEN;
     auto const call_addr_already_loaded =
@@ -2205,17 +2226,17 @@ auto expand_call(ast::Instruction const& raw,
     if (ret.ingredients.front() == "void") {
         /*
          * If the return register is void we need a completely synthetic
-         * register to store the function offset. The li
-         * pseudoinstruction uses at most three registers to do its job
-         * so we can use register 253 as the base to avoid disturbing
-         * user code.
+         * register to store the function offset. The scratch register
+         * lies above all the locals the function uses so it does not
+         * disturb user code.
          */
         fn_offset = ast::Operand{};
 
         auto const& lx = ret.ingredients.front();
         fn_offset.ingredients.push_back(lx.make_synth("$", TOKEN::DOLLAR));
         fn_offset.ingredients.push_back(
-            lx.make_synth("253", TOKEN::LITERAL_INTEGER));
+            lx.make_synth(std::to_string(static_cast<unsigned>(scratch)),
+                          TOKEN::LITERAL_INTEGER));
         fn_offset.ingredients.push_back(lx.make_synth(".", TOKEN::DOT));
         fn_offset.ingredients.push_back(
             lx.make_synth("l", TOKEN::LITERAL_ATOM));
@@ -2262,8 +2283,9 @@ auto expand_call(ast::Instruction const& raw,
                 .add(raw.leader);
         }
 
-        auto const is_jump_label = (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
-                                   and (sym.st_other == STV_HIDDEN);
+        auto const is_jump_label =
+            (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
+            and (ELF64_ST_VISIBILITY(sym.st_other) == STV_HIDDEN);
         if (is_jump_label) {
             using viua::libs::errors::compile_time::Cause;
             using viua::libs::errors::compile_time::Error;
@@ -2302,7 +2324,7 @@ auto expand_call(ast::Instruction const& raw,
     }
     cooked.push_back(emit_instruction(call));
 
-    std::cerr << "        cooked into " << cooked.size() << " ops\n";
+    cooking_log() << "        cooked into " << cooked.size() << " ops\n";
 
     return cooked;
 }
@@ -2339,7 +2361,7 @@ auto expand_atom(ast::Instruction const& raw) -> Text
     synth.operands.pop_back();
     cooked.push_back(emit_instruction(synth));
 
-    std::cerr << "        cooked into " << cooked.size() << " ops\n";
+    cooking_log() << "        cooked into " << cooked.size() << " ops\n";
 
     return cooked;
 }
@@ -2376,7 +2398,7 @@ auto expand_double(ast::Instruction const& raw) -> Text
     synth.operands.pop_back();
     cooked.push_back(emit_instruction(synth));
 
-    std::cerr << "        cooked into " << cooked.size() << " ops\n";
+    cooking_log() << "        cooked into " << cooked.size() << " ops\n";
 
     return cooked;
 }
@@ -2510,9 +2532,10 @@ auto expand_cast(ast::Instruction const& raw) -> Text
 }
 
 auto expand_instruction(ast::Instruction const& raw,
-                        std::vector<Elf64_Sym>& symbol_table,
+                        std::vector<Elf64_Sym> const& symbol_table,
                         std::map<std::string, size_t> const& symbol_map,
-                        Decl_map const& decl_map) -> Text
+                        Decl_map const& decl_map,
+                        uint8_t const scratch) -> Text
 {
     auto const memory_access = std::set<std::string_view>{
         /*
@@ -2578,9 +2601,10 @@ auto expand_instruction(ast::Instruction const& raw,
     } else if (opcode == "delete") {
         return expand_delete(raw);
     } else if (opcode == "if") {
-        return expand_flow_control(raw, symbol_table, symbol_map, decl_map);
+        return expand_flow_control(
+            raw, symbol_table, symbol_map, decl_map, scratch);
     } else if (opcode == "call" or opcode == "actor") {
-        return expand_call(raw, symbol_table, symbol_map);
+        return expand_call(raw, symbol_table, symbol_map, scratch);
     } else if (opcode == "return") {
         return expand_return(raw);
     } else if (opcode == "atom") {
@@ -2598,28 +2622,421 @@ auto expand_instruction(ast::Instruction const& raw,
     }
 }
 
-auto cook_instructions(std::vector<std::unique_ptr<ast::Node>> const& nodes,
-                       std::vector<uint8_t> const& rodata_buf,
-                       std::vector<uint8_t> const& string_table,
-                       std::vector<Elf64_Sym>& symbol_table,
-                       std::map<std::string, size_t> const& symbol_map,
-                       Decl_map const& decl_map) -> Text
+/*
+ * Some pseudoinstructions need a register which is invisible to user code eg,
+ * to hold the address of a jump target. Use the first local register above
+ * all the locals used by the function, so that the function's frame does not
+ * have to be any bigger than necessary.
+ */
+constexpr auto SCRATCH_REGISTER_MAX = uint8_t{253};
+auto pick_scratch_register(std::vector<std::unique_ptr<ast::Node>> const& nodes,
+                           size_t const function_label,
+                           std::vector<Elf64_Sym> const& symbol_table,
+                           std::map<std::string, size_t> const& symbol_map)
+    -> uint8_t
 {
-    enum class SECTION {
-        NONE,
-        RODATA,
-        TEXT,
+    using viua::libs::lexer::TOKEN;
+
+    auto count = size_t{0};
+    for (auto i = (function_label + 1); i < nodes.size(); ++i) {
+        auto const& each = *nodes.at(i);
+
+        if (each.leader.token == TOKEN::SWITCH_TO_SECTION) {
+            break;
+        }
+        if (each.leader.token == TOKEN::DEFINE_LABEL) {
+            auto const& lab = static_cast<ast::Label const&>(each);
+            auto const name = make_name_from_lexeme(lab.name);
+            if (not symbol_map.contains(name)) {
+                break;
+            }
+            auto const& sym = symbol_table.at(symbol_map.at(name));
+            auto const is_jump_label =
+                (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
+                and (ELF64_ST_VISIBILITY(sym.st_other) == STV_HIDDEN);
+            if (not is_jump_label) {
+                break;
+            }
+            continue;
+        }
+        if (each.leader.token != TOKEN::OPCODE) {
+            continue;
+        }
+
+        auto const& insn = static_cast<ast::Instruction const&>(each);
+        for (auto const& op : insn.operands) {
+            if (op.ingredients.empty()
+                or op.ingredients.front() != TOKEN::DOLLAR) {
+                continue;
+            }
+            if (auto const r = op.make_access();
+                r.set == viua::arch::REGISTER_SET::LOCAL) {
+                count = std::max(count, static_cast<size_t>(r.index) + 1);
+            }
+        }
+    }
+
+    return static_cast<uint8_t>(
+        std::min(count, static_cast<size_t>(SCRATCH_REGISTER_MAX)));
+}
+
+/*
+ * Count local registers used by the instructions in text[from...]. The result
+ * is one past the highest local register index accessed, and is recorded in the
+ * function's symbol so that the VM can allocate call frames of the right size.
+ */
+auto count_local_registers(Text const& text, size_t const from) -> size_t
+{
+    using viua::arch::Register_access;
+    using viua::arch::ops::FORMAT;
+    using viua::arch::ops::FORMAT_MASK;
+    using viua::arch::ops::OPCODE_MASK;
+
+    auto count = size_t{0};
+    auto const see = [&count](Register_access const r) -> void {
+        if (r.set == viua::arch::REGISTER_SET::LOCAL) {
+            count = std::max(count, static_cast<size_t>(r.index) + 1);
+        }
     };
-    auto active_section = SECTION::NONE;
-    auto activator      = std::experimental::observer_ptr<ast::Section const>{};
 
-    auto active_function = std::experimental::observer_ptr<Elf64_Sym>{};
-    auto function_label  = std::experimental::observer_ptr<ast::Label const>{};
+    for (auto i = from; i < text.size(); ++i) {
+        auto const ip = text.at(i);
+        auto const opcode =
+            static_cast<viua::arch::opcode_type>(ip & OPCODE_MASK);
+        switch (static_cast<FORMAT>(opcode & FORMAT_MASK)) {
+            using namespace viua::arch::ops;
+        case FORMAT::T:
+        {
+            auto const op = T::decode(ip);
+            see(op.out);
+            see(op.lhs);
+            see(op.rhs);
+            break;
+        }
+        case FORMAT::D:
+        {
+            auto const op = D::decode(ip);
+            see(op.out);
+            see(op.in);
+            break;
+        }
+        case FORMAT::S:
+            see(S::decode(ip).out);
+            break;
+        case FORMAT::F:
+            see(F::decode(ip).out);
+            break;
+        case FORMAT::E:
+            see(E::decode(ip).out);
+            break;
+        case FORMAT::R:
+        {
+            auto const op = R::decode(ip);
+            see(op.out);
+            see(op.in);
+            break;
+        }
+        case FORMAT::M:
+        {
+            auto const op = M::decode(ip);
+            see(op.out);
+            see(op.in);
+            break;
+        }
+        case FORMAT::N:
+            break;
+        }
+    }
 
-    auto active_symbol = std::experimental::observer_ptr<Elf64_Sym>{};
-    auto active_label  = std::string{};
-    auto labeller      = std::experimental::observer_ptr<ast::Label const>{};
+    return count;
+}
+
+/*
+ * Body of a function: its label, and the labels and instructions which follow
+ * it up to the label of the next function. Instructions which come before the
+ * first function label make up a body without a function.
+ *
+ * Bodies do not depend on each other after all symbols are known (jumps and
+ * calls go through the symbol table) so they are cooked independently, and
+ * are only glued together into .text at the end.
+ */
+struct Function_body {
+    std::experimental::observer_ptr<ast::Label const> label;
+    size_t here = 0;
+    std::vector<std::experimental::observer_ptr<ast::Node const>> nodes;
+
+    uint8_t scratch = SCRATCH_REGISTER_MAX;
+
+    Text text;
+    std::vector<size_t> sizes;
+    std::vector<std::string> logs;
+    bool from_cache = false;
+
+    std::exception_ptr error;
+};
+
+/*
+ * Describe everything the cooked body depends on: the assembler which cooked
+ * it, the scratch register, and the instructions with their attributes and
+ * operands. Names of symbols are resolved to their indexes and kinds as those
+ * end up in the cooked code. Labels are left out since they do not produce any
+ * code; their addresses are recalculated every time.
+ *
+ * Texts are prefixed with their lengths so that the key is unambiguous whatever
+ * they contain.
+ */
+auto make_cache_key(Function_body const& body,
+                    std::string_view const assembler_id,
+                    std::vector<Elf64_Sym> const& symbol_table,
+                    std::map<std::string, size_t> const& symbol_map)
+    -> std::string
+{
+    using viua::libs::lexer::TOKEN;
+
+    auto key        = std::string{};
+    auto const push = [&key](std::string_view const sv) -> void {
+        key += std::to_string(sv.size());
+        key += ':';
+        key += sv;
+    };
+    auto const push_attrs = [&push](ast::Node const& node) -> void {
+        for (auto const& [name, value] : node.attributes) {
+            push(name.text);
+            push(value.has_value() ? value->text : std::string{});
+        }
+    };
+
+    push(assembler_id);
+    key += "scratch=" + std::to_string(static_cast<unsigned>(body.scratch))
+           + '\n';
+
+    for (auto const& each : body.nodes) {
+        if (each->leader.token != TOKEN::OPCODE) {
+            continue;
+        }
+
+        auto const& insn = static_cast<ast::Instruction const&>(*each);
+        push(insn.leader.text);
+        push_attrs(insn);
+        for (auto const& op : insn.operands) {
+            key += '(';
+            push_attrs(op);
+            for (auto const& lx : op.ingredients) {
+                key += std::to_string(static_cast<int>(lx.token)) + ' ';
+                push(lx.text);
+
+                auto const is_name = (lx == TOKEN::LITERAL_ATOM)
+                                     or (lx == TOKEN::LITERAL_STRING);
+                if (not is_name) {
+                    continue;
+                }
+                if (auto const sym = symbol_map.find(make_name_from_lexeme(lx));
+                    sym != symbol_map.end()) {
+                    auto const& s = symbol_table.at(sym->second);
+                    key += '@' + std::to_string(sym->second) + ','
+                           + std::to_string(static_cast<unsigned>(s.st_info))
+                           + ','
+                           + std::to_string(static_cast<unsigned>(s.st_other));
+                }
+            }
+            key += ')';
+        }
+        key += '\n';
+    }
+
+    return key;
+}
+
+auto cook_function_body(
+    Function_body& body,
+    std::vector<std::unique_ptr<ast::Node>> const& nodes,
+    std::vector<Elf64_Sym> const& symbol_table,
+    std::map<std::string, size_t> const& symbol_map,
+    Decl_map const& decl_map,
+    std::experimental::observer_ptr<viua::libs::stage::Text_cache const> cache,
+    std::string_view const assembler_id) -> void
+{
+    using viua::libs::lexer::TOKEN;
+
+    auto log = std::ostringstream{};
+    cooking_log_stream.reset(&log);
+
+    try {
+        if (body.label) {
+            body.scratch = pick_scratch_register(
+                nodes, body.here, symbol_table, symbol_map);
+        }
+
+        auto const instructions = static_cast<size_t>(
+            std::ranges::count_if(body.nodes, [](auto const& each) -> bool {
+                return (each->leader.token == TOKEN::OPCODE);
+            }));
+
+        auto key = std::string{};
+        if (cache) {
+            key = make_cache_key(body, assembler_id, symbol_table, symbol_map);
+            if (auto entry = cache->find(key);
+                entry.has_value() and (entry->sizes.size() == instructions)
+                and (std::accumulate(
+                         entry->sizes.begin(), entry->sizes.end(), size_t{0})
+                     == entry->text.size())) {
+                body.text       = std::move(entry->text);
+                body.sizes      = std::move(entry->sizes);
+                body.from_cache = true;
+                cooking_log_stream.reset();
+                return;
+            }
+        }
+
+        for (auto const& each : body.nodes) {
+            if (each->leader.token != TOKEN::OPCODE) {
+                continue;
+            }
+
+            auto const& raw_instr = static_cast<ast::Instruction const&>(*each);
+            log.str({});
+            auto const cooked = expand_instruction(
+                raw_instr, symbol_table, symbol_map, decl_map, body.scratch);
+            body.logs.push_back(log.str());
+
+            body.sizes.push_back(cooked.size());
+            std::ranges::copy(cooked, std::back_inserter(body.text));
+        }
+
+        if (cache) {
+            cache->store(key,
+                         viua::libs::stage::Text_cache::Entry{body.text,
+                                                              body.sizes});
+        }
+    } catch (...) {
+        body.logs.push_back(log.str());
+        body.error = std::current_exception();
+    }
+
+    cooking_log_stream.reset();
+}
+
+auto cook_instructions(
+    std::vector<std::unique_ptr<ast::Node>> const& nodes,
+    std::vector<Elf64_Sym>& symbol_table,
+    std::map<std::string, size_t> const& symbol_map,
+    Decl_map const& decl_map,
+    std::experimental::observer_ptr<viua::libs::stage::Text_cache const> cache,
+    std::string_view const assembler_id,
+    size_t const jobs) -> Text
+{
+    /*
+     * First, split .text into bodies of functions. Addresses of labels are not
+     * known yet; they will be once all the bodies are cooked.
+     *
+     * An error found here does not stop the bodies seen so far from being
+     * cooked. Errors in them come first in the source, and should be reported
+     * first.
+     */
+    auto bodies        = std::vector<Function_body>(1);
+    auto section_error = std::exception_ptr{};
+    try {
+        enum class SECTION {
+            NONE,
+            RODATA,
+            TEXT,
+        };
+        auto active_section = SECTION::NONE;
+
+        for (auto const& each : nodes) {
+            using viua::libs::lexer::TOKEN;
+
+            if (each->leader.token == TOKEN::SWITCH_TO_SECTION) {
+                auto const& sec = static_cast<ast::Section const&>(*each);
+                auto const name = sec.which();
+                if (name == std::string_view{".rodata"}) {
+                    active_section = SECTION::RODATA;
+                } else if (name == std::string_view{".text"}) {
+                    active_section = SECTION::TEXT;
+                } else {
+                    using viua::libs::errors::compile_time::Cause;
+                    using viua::libs::errors::compile_time::Error;
+                    throw Error{sec.name,
+                                Cause::None,
+                                "unknown section: " + quote_fancy(name)};
+                }
+                continue;
+            }
+
+            auto const is_label = (each->leader.token == TOKEN::DEFINE_LABEL);
+            auto const is_instruction = (each->leader.token == TOKEN::OPCODE);
+            if (auto const is_interesting = is_label or is_instruction;
+                not is_interesting) {
+                continue;
+            }
+
+            if (active_section == SECTION::NONE) {
+                using viua::libs::errors::compile_time::Cause;
+                using viua::libs::errors::compile_time::Error;
+                throw Error{each->leader, Cause::None, "no active section"};
+            }
+            if (active_section == SECTION::RODATA) {
+                continue;
+            }
+
+            if (is_label) {
+                auto const& lab  = static_cast<ast::Label const&>(*each);
+                auto const label = make_name_from_lexeme(lab.name);
+                if (not symbol_map.contains(label)) {
+                    using viua::libs::errors::compile_time::Cause;
+                    using viua::libs::errors::compile_time::Error;
+                    throw Error{lab.name,
+                                Cause::None,
+                                "text label without attached symbol"};
+                }
+
+                auto const& sym = symbol_table.at(symbol_map.at(label));
+                auto const is_jump_label =
+                    (ELF64_ST_BIND(sym.st_info) == STB_LOCAL)
+                    and (ELF64_ST_VISIBILITY(sym.st_other) == STV_HIDDEN);
+                if (not is_jump_label) {
+                    auto& body = bodies.emplace_back();
+                    body.label.reset(&lab);
+                    body.here = static_cast<size_t>(&each - &nodes.front());
+                }
+            }
+
+            bodies.back().nodes.emplace_back(each.get());
+        }
+    } catch (...) {
+        section_error = std::current_exception();
+    }
+
+    /*
+     * Then, cook the bodies. Each thread takes the next body no one is working
+     * on until there are none left.
+     */
+    {
+        auto next       = std::atomic<size_t>{0};
+        auto const work = [&]() -> void {
+            for (auto i = next++; i < bodies.size(); i = next++) {
+                cook_function_body(bodies[i],
+                                   nodes,
+                                   symbol_table,
+                                   symbol_map,
+                                   decl_map,
+                                   cache,
+                                   assembler_id);
+            }
+        };
+
+        auto const threads = std::min(jobs, bodies.size());
+        auto workers       = std::vector<std::jthread>{};
+        for (auto i = size_t{1}; i < threads; ++i) {
+            workers.emplace_back(work);
+        }
+        work();
+    }
 
+    /*
+     * Finally, glue the bodies together in the order in which they appear in
+     * the source, and fill in addresses and sizes of labels and functions.
+     */
     auto text = Text{};
     {
         using viua::arch::instruction_type;
@@ -2629,8 +3046,8 @@ auto cook_instructions(std::vector<std::unique_ptr<ast::Node>> const& nodes,
             N{static_cast<instruction_type>(OPCODE::HALT)}.encode());
     }
 
-    (void)rodata_buf;
-    (void)string_table;
+    auto active_function = std::experimental::observer_ptr<Elf64_Sym>{};
+    auto function_label  = std::experimental::observer_ptr<ast::Label const>{};
 
     auto const save_size_of_active_function =
         [&text, &af = active_function, &function_label]() -> void {
@@ -2638,6 +3055,13 @@ auto cook_instructions(std::vector<std::unique_ptr<ast::Node>> const& nodes,
             af->st_size = ((text.size() * sizeof(viua::arch::instruction_type))
                            - af->st_value);
 
+            auto const locals = count_local_registers(
+                text, (af->st_value / sizeof(viua::arch::instruction_type)));
+            af->st_other =
+                viua::arch::elf::st_other_with_frame_size(af->st_other, locals);
+            std::cerr << "  function " << function_label->name.text
+                      << " uses " << locals << " local register(s)\n";
+
             std::cerr << "  size of function " << function_label->name.text
                       << " is " << af->st_size << " bytes\n";
             std::cerr << "  span of function " << function_label->name.text
@@ -2650,117 +3074,71 @@ auto cook_instructions(std::vector<std::unique_ptr<ast::Node>> const& nodes,
         }
     };
 
-    for (auto const& each : nodes) {
+    for (auto const& body : bodies) {
         using viua::libs::lexer::TOKEN;
 
-        if (each->leader.token == TOKEN::SWITCH_TO_SECTION) {
-            activator.reset(static_cast<ast::Section const*>(each.get()));
-            auto const& sec = *activator;
-            auto const name = sec.which();
-            if (name == std::string_view{".rodata"}) {
-                active_section = SECTION::RODATA;
-            } else if (name == std::string_view{".text"}) {
-                active_section = SECTION::TEXT;
-            } else {
-                using viua::libs::errors::compile_time::Cause;
-                using viua::libs::errors::compile_time::Error;
-                throw Error{sec.name,
-                            Cause::None,
-                            "unknown section: " + quote_fancy(name)};
-            }
-            continue;
-        }
-
-        auto const is_label       = (each->leader.token == TOKEN::DEFINE_LABEL);
-        auto const is_instruction = (each->leader.token == TOKEN::OPCODE);
-        if (auto const is_interesting = is_label or is_instruction;
-            not is_interesting) {
-            continue;
-        }
-
-        if (active_section == SECTION::NONE) {
-            using viua::libs::errors::compile_time::Cause;
-            using viua::libs::errors::compile_time::Error;
-            throw Error{each->leader, Cause::None, "no active section"};
-        }
-        if (active_section == SECTION::RODATA) {
-            continue;
-        }
+        auto cooked = body.text.begin();
+        auto n      = size_t{0};
+        for (auto const& each : body.nodes) {
+            if (each->leader.token == TOKEN::DEFINE_LABEL) {
+                auto const& lab = static_cast<ast::Label const&>(*each);
+                auto const active_label = make_name_from_lexeme(lab.name);
+                auto const labelled_symbol =
+                    std::experimental::make_observer(
+                        &symbol_table.at(symbol_map.at(active_label)));
+
+                labelled_symbol->st_value =
+                    (text.size() * sizeof(viua::arch::instruction_type));
+
+                auto const is_jump_label = (&lab != body.label.get());
+                if (not is_jump_label) {
+                    save_size_of_active_function();
+                    active_function = labelled_symbol;
+                    function_label  = body.label;
+                }
 
-        if (is_label) {
-            auto const& lab = static_cast<ast::Label&>(*each);
-            labeller.reset(&lab);
-            active_label = make_name_from_lexeme(lab.name);
+                std::cerr << (is_jump_label ? "  " : "") << "recording "
+                          << (is_jump_label ? "jump" : "call") << " label "
+                          << active_label << " at "
+                          << "[.text+0x" << std::hex << std::setfill('0')
+                          << std::setw(16)
+                          << (text.size()
+                              * sizeof(viua::arch::instruction_type))
+                          << std::dec << std::setfill(' ') << "]\n";
+                std::cerr << "      .text has " << text.size() << " op(s)\n";
+                if ((not is_jump_label) and body.from_cache) {
+                    std::cerr << "  body of function " << active_label
+                              << " found in cache\n";
+                }
 
-            auto labelled_symbol = std::experimental::observer_ptr<Elf64_Sym>{};
-            if (symbol_map.contains(active_label)) {
-                labelled_symbol.reset(
-                    &symbol_table.at(symbol_map.at(active_label)));
-            } else {
-                using viua::libs::errors::compile_time::Cause;
-                using viua::libs::errors::compile_time::Error;
-                throw Error{lab.name,
-                            Cause::None,
-                            "text label without attached symbol"};
+                continue;
             }
 
-            /*
-             * The st_value can be set now, because we know for sure that it
-             * will contain the right physical address since all the
-             * instructions that preceded it were already expanded to their full
-             * form.
-             */
-            labelled_symbol->st_value =
-                (text.size() * sizeof(viua::arch::instruction_type));
-
-            auto const is_jump_label =
-                (ELF64_ST_BIND(labelled_symbol->st_info) == STB_LOCAL)
-                and (labelled_symbol->st_other == STV_HIDDEN);
-            auto const is_function_label = not is_jump_label;
-            if (is_function_label) {
-                save_size_of_active_function();
-                active_function = labelled_symbol;
-                function_label.reset(&lab);
+            std::cerr << "    cooking " << each->leader.text << "\n";
+            if (n < body.logs.size()) {
+                std::cerr << body.logs[n];
+            }
+            if (body.error and (n == body.sizes.size())) {
+                std::rethrow_exception(body.error);
             }
 
-            std::cerr << (is_jump_label ? "  " : "") << "recording "
-                      << (is_jump_label ? "jump" : "call") << " label "
-                      << active_label << " at "
-                      << "[.text+0x" << std::hex << std::setfill('0')
-                      << std::setw(16)
-                      << (text.size() * sizeof(viua::arch::instruction_type))
-                      << std::dec << std::setfill(' ') << "]\n";
-            std::cerr << "      .text has " << text.size() << " op(s)\n";
-
-            active_symbol = labelled_symbol;
+            auto const size = static_cast<Text::difference_type>(body.sizes[n]);
+            std::copy(cooked, (cooked + size), std::back_inserter(text));
+            cooked += size;
+            ++n;
 
-            continue;
+            std::cerr << "      .text has " << text.size() << " op(s)\n";
         }
 
-        if (is_instruction) {
-            auto const& raw_instr = static_cast<ast::Instruction&>(*each);
-            std::cerr << "    cooking " << raw_instr.leader.text << "\n";
-
-            // 1. expand the raw instruction
-            // 2. append the resulting sequence to text
-            //
-            // The trick is that we do not have to care about physical addresses
-            // right now, and thus can expand as we go and disregard the
-            // difference between physical and logical index of each individual
-            // instruction.
-            //
-            // Since IF branches are mandaded to point to labels there is no
-            // risk of accidentally inserting a physical address at this stage.
-            // Just insert the index pointing to the symbol table, and fill it
-            // in in the next step.
-
-            std::ranges::copy(
-                expand_instruction(
-                    raw_instr, symbol_table, symbol_map, decl_map),
-                std::back_inserter(text));
-            std::cerr << "      .text has " << text.size() << " op(s)\n";
+        if (body.error) {
+            std::rethrow_exception(body.error);
         }
     }
+
+    if (section_error) {
+        std::rethrow_exception(section_error);
+    }
+
     save_size_of_active_function();
 
     {
@@ -2774,6 +3152,30 @@ auto cook_instructions(std::vector<std::unique_ptr<ast::Node>> const& nodes,
     return text;
 }
 
+/*
+ * Identify the build of the assembler, so that code cooked by one build is not
+ * reused by another. The version alone is not enough since it does not change
+ * when the assembler is rebuilt from a modified tree.
+ */
+auto make_assembler_id() -> std::optional<std::string>
+{
+    auto const self = std::filesystem::path{"/proc/self/exe"};
+    auto ec         = std::error_code{};
+
+    auto const mtime = std::filesystem::last_write_time(self, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    auto const size = std::filesystem::file_size(self, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+
+    return (std::string{VIUAVM_VERSION_FULL} + ' '
+            + std::to_string(mtime.time_since_epoch().count()) + ' '
+            + std::to_string(size));
+}
+
 auto find_entry_point(std::vector<std::unique_ptr<ast::Node>> const& nodes,
                       std::vector<Elf64_Sym>& symbol_table,
                       std::map<std::string, size_t>& symbol_map)
@@ -2811,7 +3213,8 @@ auto find_entry_point(std::vector<std::unique_ptr<ast::Node>> const& nodes,
             auto const sym =
                 symbol_table.at(symbol_map.at(entry_point_fn->text));
             auto const not_global  = (ELF64_ST_BIND(sym.st_info) != STB_GLOBAL);
-            auto const not_visible = (sym.st_other != STV_DEFAULT);
+            auto const not_visible =
+                (ELF64_ST_VISIBILITY(sym.st_other) != STV_DEFAULT);
             auto const not_function = (ELF64_ST_TYPE(sym.st_info) != STT_FUNC);
             if (not_function) {
                 using viua::libs::errors::compile_time::Cause;
@@ -3410,6 +3813,8 @@ auto main(int argc, char* argv[]) -> int
     }
 
     auto preferred_output_path = std::optional<std::filesystem::path>{};
+    auto cache_dir             = std::optional<std::filesystem::path>{};
+    auto jobs                  = size_t{std::thread::hardware_concurrency()};
     auto verbosity_level       = 0;
     auto show_version          = false;
     auto show_help             = false;
@@ -3426,6 +3831,17 @@ auto main(int argc, char* argv[]) -> int
          */
         else if (each == "-o") {
             preferred_output_path = std::filesystem::path{args.at(++i)};
+        } else if (each == "-j") {
+            try {
+                jobs = std::stoul(args.at(++i));
+            } catch (std::logic_error const&) {
+                std::cerr << esc(2, COLOR_FG_RED) << "error"
+                          << esc(2, ATTR_RESET)
+                          << ": -j must be given a positive integer\n";
+                return 1;
+            }
+        } else if (each == "--cache-dir") {
+            cache_dir = std::filesystem::path{args.at(++i)};
         }
         /*
          * Common options.
@@ -3534,6 +3950,16 @@ auto main(int argc, char* argv[]) -> int
             return o;
         }());
 
+    /*
+     * Cooked bodies of functions are only cached if asked to, in the given
+     * directory.
+     */
+    auto text_cache         = std::optional<viua::libs::stage::Text_cache>{};
+    auto const assembler_id = make_assembler_id();
+    if (cache_dir.has_value() and assembler_id.has_value()) {
+        text_cache.emplace(*cache_dir, *assembler_id);
+    }
+
     /*
      * Lexical analysis (lexing).
      *
@@ -3569,8 +3995,8 @@ auto main(int argc, char* argv[]) -> int
     }
 
     auto declared_symbols = Decl_map{};
-    auto rodata_contents  = std::vector<uint8_t>{};
-    auto string_table     = std::vector<uint8_t>{};
+    auto rodata_contents  = Interned_buffer{};
+    auto string_table     = Interned_buffer{};
     auto symbol_table     = std::vector<Elf64_Sym>{};
     auto symbol_map       = std::map<std::string, size_t>{};
     auto fn_offsets       = std::map<std::string, size_t>{};
@@ -3579,12 +4005,12 @@ auto main(int argc, char* argv[]) -> int
      * Allocate the first 64 bits of .rodata to prevent any local values from
      * having address of 0.
      */
-    rodata_contents.resize(8);
+    rodata_contents.buffer.resize(8);
 
     /*
      * ELF standard requires the first byte in the string table to be zero.
      */
-    string_table.push_back('\0');
+    string_table.buffer.push_back('\0');
 
     {
         auto empty     = Elf64_Sym{};
@@ -3623,11 +4049,15 @@ auto main(int argc, char* argv[]) -> int
     auto text = Text{};
     try {
         text = cook_instructions(nodes,
-                                 rodata_contents,
-                                 string_table,
                                  symbol_table,
                                  symbol_map,
-                                 declared_symbols);
+                                 declared_symbols,
+                                 (text_cache.has_value()
+                                      ? std::experimental::make_observer(
+                                          &std::as_const(*text_cache))
+                                      : nullptr),
+                                 assembler_id.value_or(""),
+                                 std::max(jobs, size_t{1}));
     } catch (viua::libs::errors::compile_time::Error const& e) {
         viua::libs::stage::display_error_and_exit(source_path, source_text, e);
     }
@@ -3635,7 +4065,7 @@ auto main(int argc, char* argv[]) -> int
     /*
      * ELF standard requires the last byte in the string table to be zero.
      */
-    string_table.push_back('\0');
+    string_table.buffer.push_back('\0');
 
     /*
      * Detect entry point function.
@@ -3705,8 +4135,8 @@ auto main(int argc, char* argv[]) -> int
              : std::nullopt),
         text,
         reloc_table,
-        rodata_contents,
-        string_table,
+        rodata_contents.buffer,
+        string_table.buffer,
         symbol_table);
 
     return 0;
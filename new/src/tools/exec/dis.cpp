@@ -134,7 +134,7 @@ auto is_jump_label(Elf64_Sym const sym) -> bool
     if (ELF64_ST_BIND(sym.st_info) != STB_LOCAL) {
         return false;
     }
-    if (sym.st_other != STV_HIDDEN) {
+    if (ELF64_ST_VISIBILITY(sym.st_other) != STV_HIDDEN) {
         return false;
     }
     return true;
@@ -1065,7 +1065,7 @@ auto main(int argc, char* argv[]) -> int
                 << data_size << " byte" << (data_size == 1 ? "" : "s") << ")\n";
 
             auto const sym_bind = ELF64_ST_BIND(sym.st_info);
-            auto const sym_vis  = sym.st_other;
+            auto const sym_vis  = ELF64_ST_VISIBILITY(sym.st_other);
             auto const sym_is_unit_local =
                 (sym_bind == STB_LOCAL and sym_vis == STV_DEFAULT);
             auto const sym_is_module_local =
@@ -1125,7 +1125,7 @@ auto main(int argc, char* argv[]) -> int
         if (ELF64_ST_BIND(sym.st_info) != STB_LOCAL) {
             return false;
         }
-        if (sym.st_other != STV_HIDDEN) {
+        if (ELF64_ST_VISIBILITY(sym.st_other) != STV_HIDDEN) {
             return false;
         }
         return true;
@@ -1162,7 +1162,7 @@ auto main(int argc, char* argv[]) -> int
         auto const safe_name = match_atom(name) ? name : ('"' + name + '"');
 
         auto const sym_bind = ELF64_ST_BIND(sym.st_info);
-        auto const sym_vis  = sym.st_other;
+        auto const sym_vis  = ELF64_ST_VISIBILITY(sym.st_other);
         auto const sym_is_unit_local =
             (sym_bind == STB_LOCAL and sym_vis == STV_DEFAULT);
         auto const sym_is_module_local =
@@ -1212,7 +1212,7 @@ auto main(int argc, char* argv[]) -> int
                           if (ELF64_ST_BIND(sym.st_info) != STB_LOCAL) {
                               return;
                           }
-                          if (sym.st_other != STV_HIDDEN) {
+                          if (ELF64_ST_VISIBILITY(sym.st_other) != STV_HIDDEN) {
                               return;
                           }
                           if (sym.st_value < addr) {
@@ -755,7 +755,7 @@ auto main(int argc, char** argv) -> int
      */
     auto text   = std::vector<viua::arch::instruction_type>{};
     auto rodata = std::vector<uint8_t>{};
-    auto strtab = std::vector<uint8_t>{};
+    auto strtab = viua::libs::stage::Interned_buffer{};
     auto symtab = std::vector<Elf64_Sym>{};
 
     /*
@@ -806,14 +806,14 @@ auto main(int argc, char** argv) -> int
                 lnk_module.find_fragment(".strtab")->get().data.size();
             needed_strtab_size += (lnk_strtab_size - 2);
         }
-        strtab.reserve(needed_strtab_size);
+        strtab.buffer.reserve(needed_strtab_size);
 
         if (dump_strtab) {
             std::cerr << "[.strtab] reserved size: " << needed_strtab_size
                       << " bytes\n";
         }
     }
-    strtab.push_back('\0');
+    strtab.buffer.push_back('\0');
 
     /*
      * Ensure that the glued-together .symtab begins with the special empty
@@ -865,25 +865,19 @@ auto main(int argc, char** argv) -> int
     auto is_defined = [&strtab, &symtab_cache, &anonymous_symtab_cache](
                           Elf64_Sym const sym) -> bool {
         auto const sym_name = std::string_view{
-            reinterpret_cast<char const*>(strtab.data()) + sym.st_name};
+            reinterpret_cast<char const*>(strtab.buffer.data()) + sym.st_name};
         return (sym.st_name ? symtab_cache.count(sym_name)
                             : anonymous_symtab_cache.count(sym.st_value));
     };
     auto get_symtab_index = [&strtab, &symtab_cache, &anonymous_symtab_cache](
                                 Elf64_Sym const sym) -> size_t {
         auto const sym_name = std::string_view{
-            reinterpret_cast<char const*>(strtab.data()) + sym.st_name};
+            reinterpret_cast<char const*>(strtab.buffer.data()) + sym.st_name};
         return (sym_name.empty() ? anonymous_symtab_cache.at(sym.st_value)
                                  : symtab_cache.at(sym_name))
             .first;
     };
 
-    /*
-     * Map from symbol's name to its offset in .strtab to make adjusting st_name
-     * fields faster.
-     */
-    auto strtab_cache = std::map<std::string_view, size_t>{};
-
     /*
      * Map of relocation offsets (Elf64_Rel.r_offset) which were initially
      * pointing to undefined symbols (ie, those which were not defined in the
@@ -996,14 +990,13 @@ auto main(int argc, char** argv) -> int
 
             sym.st_name         = save_string_to_strtab(strtab, lnk_sym_name);
             auto const sym_name = std::string_view{
-                reinterpret_cast<char const*>(strtab.data()) + sym.st_name};
+                reinterpret_cast<char const*>(strtab.buffer.data())
+                    + sym.st_name};
             if (verbosity_level and sym.st_name) {
                 std::cerr << "    global sym name: " << sym_name << "\n";
                 std::cerr << "    global .st_name: " << sym.st_name << "\n";
             }
 
-            strtab_cache.emplace(sym_name, sym.st_name);
-
             /*
              * Just put the name of the file in .symtab and continue. This is a
              * special entry that will tell us from what file the following
@@ -1104,7 +1097,8 @@ auto main(int argc, char** argv) -> int
             auto const sym_ndx  = ELF64_R_SYM(rel.r_info);
             auto const lnk_sym  = lnk_symtab.at(sym_ndx);
             auto const sym_name = std::string_view{
-                reinterpret_cast<char const*>(strtab.data()) + lnk_sym.st_name};
+                reinterpret_cast<char const*>(strtab.buffer.data())
+                    + lnk_sym.st_name};
 
             if (verbosity_level) {
                 std::cerr << "  rel at " << rel.r_offset
@@ -1176,7 +1170,7 @@ auto main(int argc, char** argv) -> int
      * Ensure that the glued-together .strtab ends with the special case nul
      * terminator, as mandated by ELF.
      */
-    strtab.push_back('\0');
+    strtab.buffer.push_back('\0');
 
     if (verbosity_level) {
         std::cerr << "applying relocations (" << relocations.size() << ")\n";
@@ -1236,7 +1230,8 @@ auto main(int argc, char** argv) -> int
             auto const sym_ndx  = ELF64_R_SYM(rel.r_info);
             auto const sym      = symtab.at(sym_ndx);
             auto const sym_name = std::string_view{
-                reinterpret_cast<char const*>(strtab.data()) + sym.st_name};
+                reinterpret_cast<char const*>(strtab.buffer.data())
+                    + sym.st_name};
 
             if (verbosity_level) {
                 std::cerr << "    symbol: " << show_or_anonymous(sym_name)
@@ -1286,11 +1281,11 @@ auto main(int argc, char** argv) -> int
     }
 
     if (dump_strtab) {
-        std::cerr << "[.strtab] allocated size: " << strtab.size()
+        std::cerr << "[.strtab] allocated size: " << strtab.buffer.size()
                   << " bytes\n";
-        for (auto i = size_t{0}; i < strtab.size(); ++i) {
+        for (auto i = size_t{0}; i < strtab.buffer.size(); ++i) {
             auto const sv = std::string_view{
-                reinterpret_cast<char const*>(strtab.data() + i)};
+                reinterpret_cast<char const*>(strtab.buffer.data() + i)};
             std::cout << "[.strtab+0x" << std::hex << std::setfill('0')
                       << std::setw(16) << i << std::dec << std::setfill(' ')
                       << "] = " << quote_fancy(sv) << "\n";
@@ -1306,7 +1301,7 @@ auto main(int argc, char** argv) -> int
         text,
         (as_executable ? std::nullopt : std::optional{std::move(relocations)}),
         rodata,
-        strtab,
+        strtab.buffer,
         symtab);
 
     return 0;
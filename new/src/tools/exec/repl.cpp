@@ -231,7 +231,7 @@ auto hints(char const* buf, int* const color, int* const bold) -> char*
 }
 
 namespace viua {
-auto TRACE_STREAM = viua::support::fdstream{2};
+thread_local auto TRACE_STREAM = viua::support::fdstream{2};
 }
 
 /*
@@ -546,10 +546,11 @@ auto repl_eval(std::vector<std::string_view> const parts) -> bool
             auto const physical_frame_index =
                 proc->stack.frames.size() - user_frame_index - 1;
             auto const& frame = proc->stack.frames.at(physical_frame_index);
+            auto const& atoms = proc->module.atoms;
             viua::vm::ins::print_backtrace(proc->stack, physical_frame_index);
-            viua::vm::ins::dump_registers(frame.parameters, proc->atoms, "p");
-            viua::vm::ins::dump_registers(frame.registers, proc->atoms, "l");
-            viua::vm::ins::dump_registers(proc->stack.args, proc->atoms, "a");
+            viua::vm::ins::dump_registers(frame.parameters, atoms, "p");
+            viua::vm::ins::dump_registers(frame.registers, atoms, "l");
+            viua::vm::ins::dump_registers(proc->stack.args, atoms, "a");
             viua::vm::ins::dump_memory(proc->memory);
         } else if (p(1).value_or("") == "ip") {
             if (not REPL_STATE->selected_pid) {
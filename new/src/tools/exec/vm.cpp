@@ -27,12 +27,17 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -57,24 +62,212 @@
 constexpr auto VIUA_SLOW_CYCLES = false;
 
 namespace viua {
-auto TRACE_STREAM = viua::support::fdstream{2};
+/*
+ * Every scheduler thread gets its own trace stream so that lines are assembled
+ * privately and written out whole. All of them write to the same descriptor.
+ */
+auto TRACE_FD = viua::support::fdstream::fd_type{2};
+thread_local auto TRACE_STREAM = viua::support::fdstream{TRACE_FD};
 }
 
 
 namespace {
-auto run_instruction(viua::vm::Stack& stack)
+auto run_instruction(viua::vm::Stack& stack, uint64_t& ops_executed)
     -> viua::arch::instruction_type const*
 {
     auto instruction = viua::arch::instruction_type{};
     do {
         instruction = *stack.ip;
         stack.ip    = viua::vm::ins::execute(stack, stack.ip);
-        ++stack.proc->core->perf_counters.total_ops_executed;
-    } while ((stack.ip != nullptr) and (instruction & viua::arch::ops::GREEDY));
+        ++ops_executed;
+    } while ((stack.ip != nullptr) and (instruction & viua::arch::ops::GREEDY)
+             and (not stack.proc->awaited_io.has_value()));
 
     return stack.ip;
 }
 
+/*
+ * Run a process the same way run() does, but one instruction at a time, and
+ * charge every instruction to its opcode, the function executing it, and the
+ * call stack leading to that function. Used only when profiling is enabled so
+ * the normal interpreter loop does not pay for it.
+ */
+auto run_profiled(viua::vm::Process& proc,
+                  size_t const budget,
+                  uint64_t& ops_executed) -> void
+{
+    using viua::vm::Profile;
+
+    auto& profile = viua::vm::Core::this_scheduler->profile;
+    auto& stack   = proc.stack;
+
+    /*
+     * Counters of the function on top of the stack, looked up again only when
+     * the stack changes.
+     */
+    auto depth         = size_t{0};
+    auto entry         = Profile::addr_type{nullptr};
+    auto fn_counter    = static_cast<Profile::Counter*>(nullptr);
+    auto stack_counter = static_cast<Profile::counter_type*>(nullptr);
+    auto const refresh = [&]() -> void {
+        depth = stack.frames.size();
+        entry = stack.frames.back().entry_address;
+
+        auto key = std::vector<Profile::addr_type>{};
+        key.reserve(depth);
+        for (auto const& each : stack.frames) {
+            key.push_back(each.entry_address);
+        }
+
+        fn_counter    = &profile.functions[entry];
+        stack_counter = &profile.stacks[key];
+    };
+
+    auto greedy = false;
+    for (auto i = size_t{0}; (greedy or (i < budget))
+                             and proc.module.ip_in_valid_range(stack.ip)
+                             and (not stack.frames.empty())
+                             and (not proc.awaited_io.has_value());
+         ++i) {
+        if ((stack.frames.size() != depth)
+            or (stack.frames.back().entry_address != entry)) {
+            refresh();
+        }
+
+        auto const instruction = *stack.ip;
+        auto const opcode      = static_cast<viua::arch::opcode_type>(
+            instruction & viua::arch::ops::OPCODE_MASK);
+        auto const frames_before = stack.frames.size();
+
+        auto const start = Profile::now();
+        stack.ip         = viua::vm::ins::execute(stack, stack.ip);
+        auto const spent = (Profile::now() - start);
+        ++ops_executed;
+
+        auto& op = profile.ops[opcode];
+        ++op.count;
+        op.cycles += spent;
+        ++fn_counter->count;
+        fn_counter->cycles += spent;
+        *stack_counter += spent;
+
+        if (stack.frames.size() > frames_before) {
+            ++profile.calls[stack.frames.back().entry_address];
+        }
+
+        greedy = (instruction & viua::arch::ops::GREEDY);
+    }
+}
+
+auto function_name(viua::vm::Core const& core,
+                   viua::vm::Profile::addr_type const addr) -> std::string
+{
+    for (auto const& [_, mod] : core.modules) {
+        if ((addr < mod.ip_base) or (addr >= (mod.ip_base + mod.text.size()))) {
+            continue;
+        }
+
+        auto const off = static_cast<size_t>(addr - mod.ip_base)
+                         * sizeof(viua::arch::instruction_type);
+        for (auto const& sym : mod.elf.symtab) {
+            if ((ELF64_ST_TYPE(sym.st_info) == STT_FUNC)
+                and (sym.st_value == off)) {
+                return std::string{mod.elf.str_at(sym.st_name)};
+            }
+        }
+
+        auto out = std::ostringstream{};
+        out << "[.text+0x" << std::hex << std::setw(16) << std::setfill('0')
+            << off << "]";
+        return out.str();
+    }
+    return "??";
+}
+
+/*
+ * Write a report sorted by cycles to the given path, and call stacks in the
+ * folded format (one "outer;inner cycles" line per stack, as understood by
+ * flamegraph.pl and similar tools) to the same path with ".folded" appended.
+ */
+auto write_profile(viua::vm::Core const& core,
+                   std::filesystem::path const& path) -> void
+{
+    using viua::vm::Profile;
+
+    auto profile = Profile{};
+    for (auto const& each : core.schedulers) {
+        profile.merge(each->profile);
+    }
+
+    auto total_cycles = Profile::counter_type{0};
+    for (auto const& [_, c] : profile.ops) {
+        total_cycles += c.cycles;
+    }
+    auto const share = [total_cycles](Profile::counter_type const c) -> double {
+        return total_cycles
+                   ? ((static_cast<double>(c) * 100.0)
+                      / static_cast<double>(total_cycles))
+                   : 0.0;
+    };
+
+    auto report = std::ofstream{path};
+    report << std::fixed << std::setprecision(2);
+
+    {
+        auto ops = std::vector<std::pair<viua::arch::opcode_type,
+                                         Profile::Counter>>{
+            profile.ops.begin(), profile.ops.end()};
+        std::sort(ops.begin(), ops.end(), [](auto const& a, auto const& b) {
+            return (a.second.cycles > b.second.cycles);
+        });
+
+        report << "# opcodes\n";
+        report << "#" << std::setw(15) << "executed" << std::setw(16)
+               << "cycles" << std::setw(8) << "%" << std::setw(12)
+               << "cycles/op"
+               << "  opcode\n";
+        for (auto const& [opcode, c] : ops) {
+            report << std::setw(16) << c.count << std::setw(16) << c.cycles
+                   << std::setw(8) << share(c.cycles) << std::setw(12)
+                   << (static_cast<double>(c.cycles)
+                       / static_cast<double>(c.count))
+                   << "  " << viua::arch::ops::to_string(opcode) << "\n";
+        }
+    }
+
+    {
+        auto fns = std::vector<std::pair<Profile::addr_type, Profile::Counter>>{
+            profile.functions.begin(), profile.functions.end()};
+        std::sort(fns.begin(), fns.end(), [](auto const& a, auto const& b) {
+            return (a.second.cycles > b.second.cycles);
+        });
+
+        report << "\n# functions (self)\n";
+        report << "#" << std::setw(11) << "calls" << std::setw(16)
+               << "executed" << std::setw(16) << "cycles" << std::setw(8)
+               << "%"
+               << "  function\n";
+        for (auto const& [fn, c] : fns) {
+            auto const calls = profile.calls.find(fn);
+            report << std::setw(12)
+                   << ((calls == profile.calls.end()) ? 0 : calls->second)
+                   << std::setw(16) << c.count << std::setw(16) << c.cycles
+                   << std::setw(8) << share(c.cycles) << "  "
+                   << function_name(core, fn) << "\n";
+        }
+    }
+
+    auto folded = std::ofstream{path.native() + ".folded"};
+    for (auto const& [stack, cycles] : profile.stacks) {
+        auto sep = "";
+        for (auto const fn : stack) {
+            folded << sep << function_name(core, fn);
+            sep = ";";
+        }
+        folded << ' ' << cycles << '\n';
+    }
+}
+
 auto format_time(std::chrono::microseconds const us) -> std::string
 {
     auto out = std::ostringstream{};
@@ -117,28 +310,45 @@ auto run(viua::vm::Process& proc) -> bool
                            << proc.pid.to_string() << viua::TRACE_STREAM.endl;
     }
 
-    constexpr auto PREEMPTION_THRESHOLD = size_t{42};
-    for (auto i = size_t{0}; i < PREEMPTION_THRESHOLD and ip_ok(); ++i) {
-        /*
-         * This is needed to detect greedy bundles and adjust preemption
-         * counter appropriately. If a greedy bundle contains more
-         * instructions than the preemption threshold allows the process
-         * will be suspended immediately.
-         */
-        auto const greedy    = (*proc.stack.ip & viua::arch::ops::GREEDY);
-        auto const bundle_ip = proc.stack.ip;
-
-        proc.stack.ip = run_instruction(proc.stack);
+    /*
+     * Count executed ops locally and publish them once per quantum. The
+     * counter is shared by all schedulers and bumping it for every op would
+     * make the cache line bounce between cores.
+     */
+    auto ops_executed = uint64_t{0};
 
-        /*
-         * If the instruction was a greedy bundle instead of a single
-         * one, the preemption counter has to be adjusted. It may be the
-         * case that the bundle already hit the preemption threshold.
-         */
-        if (greedy and ip_ok()) {
-            i += (proc.stack.ip - bundle_ip) - 1;
+    constexpr auto PREEMPTION_THRESHOLD = size_t{42};
+    if (proc.core->profiling) {
+        run_profiled(proc, PREEMPTION_THRESHOLD, ops_executed);
+    } else if constexpr (viua::vm::VIUA_THREADED_DISPATCH) {
+        proc.stack.ip = viua::vm::ins::run_threaded(
+            proc.stack, PREEMPTION_THRESHOLD, ops_executed);
+    } else {
+        for (auto i = size_t{0}; i < PREEMPTION_THRESHOLD and ip_ok()
+                                 and (not proc.awaited_io.has_value());
+             ++i) {
+            /*
+             * This is needed to detect greedy bundles and adjust preemption
+             * counter appropriately. If a greedy bundle contains more
+             * instructions than the preemption threshold allows the process
+             * will be suspended immediately.
+             */
+            auto const greedy    = (*proc.stack.ip & viua::arch::ops::GREEDY);
+            auto const bundle_ip = proc.stack.ip;
+
+            proc.stack.ip = run_instruction(proc.stack, ops_executed);
+
+            /*
+             * If the instruction was a greedy bundle instead of a single
+             * one, the preemption counter has to be adjusted. It may be the
+             * case that the bundle already hit the preemption threshold.
+             */
+            if (greedy and ip_ok()) {
+                i += (proc.stack.ip - bundle_ip) - 1;
+            }
         }
     }
+    proc.core->perf_counters.total_ops_executed += ops_executed;
 
     if (proc.stack.frames.empty()) {
         viua::TRACE_STREAM << "[vm:sched:proc] process " << proc.pid.to_string()
@@ -165,33 +375,99 @@ auto run(viua::vm::Process& proc) -> bool
 
     return true;
 }
-auto run(viua::vm::Core& core) -> void
+auto run(viua::vm::Core& core, viua::vm::Scheduler& sched) -> void
 {
-    core.perf_counters.start();
+    viua::vm::Core::this_scheduler = &sched;
 
-    while (not core.run_queue.empty()) {
-        auto proc = core.pop_ready();
+    while (core.live_processes and not core.aborted) {
+        /*
+         * Submit I/O requests scheduled during the previous quantum, and move
+         * processes whose I/O completed back to run queues before picking the
+         * next process to run.
+         */
+        core.poll_io();
+
+        auto const seen = core.work_announced();
+        auto proc       = core.pop_ready();
+        if (not proc) {
+            if (core.io.in_flight.load() != 0
+                and not core.io_poller.exchange(true)) {
+                core.wait_for_io();
+                core.io_poller = false;
+                continue;
+            }
+            core.wait_for_work(seen);
+            continue;
+        }
 
         auto const state = run(*proc);
 
-        if (state) {
+        if (state and proc->awaited_io.has_value()) {
+            core.suspend(std::move(proc));
+        } else if (state) {
             core.push_ready(std::move(proc));
         } else {
             viua::TRACE_STREAM << "[vm:sched:proc] process "
                                << proc->pid.to_string() << " exited"
                                << viua::TRACE_STREAM.endl;
+            if (--core.live_processes == 0) {
+                core.wake_idle_schedulers(true);
+            }
         }
     }
 
+    viua::vm::Core::this_scheduler = nullptr;
+}
+auto run(viua::vm::Core& core) -> void
+{
+    core.perf_counters.start();
+
+    /*
+     * The first exception thrown by any scheduler stops all the others and is
+     * rethrown on the main thread, so that the abort report is printed the
+     * same way regardless of which thread the failing process was running on.
+     */
+    auto first_exception = std::exception_ptr{};
+    auto exception_mtx   = std::mutex{};
+    auto const guarded   = [&core, &first_exception, &exception_mtx](
+                             viua::vm::Scheduler& sched) -> void {
+        try {
+            run(core, sched);
+        } catch (...) {
+            std::lock_guard<std::mutex> lck{exception_mtx};
+            if (not first_exception) {
+                first_exception = std::current_exception();
+            }
+            core.aborted = true;
+            core.wake_idle_schedulers(true);
+            viua::vm::Core::this_scheduler = nullptr;
+        }
+    };
+
+    {
+        auto threads = std::vector<std::jthread>{};
+        for (auto i = size_t{1}; i < core.schedulers.size(); ++i) {
+            threads.emplace_back(guarded, std::ref(*core.schedulers.at(i)));
+        }
+        guarded(*core.schedulers.front());
+    }
+
+    if (first_exception) {
+        std::rethrow_exception(first_exception);
+    }
+
     core.perf_counters.stop();
     {
-        auto const total_ops = core.perf_counters.total_ops_executed;
+        auto const total_ops = core.perf_counters.total_ops_executed.load();
         auto const total_us =
             std::chrono::duration_cast<std::chrono::microseconds>(
                 core.perf_counters.duration());
         auto const approx_hz = (1e6 / static_cast<double>(total_us.count()))
                                * static_cast<double>(total_ops);
         viua::TRACE_STREAM << std::setfill(' ') << std::dec;
+        viua::TRACE_STREAM << "[vm:perf] io_uring syscalls saved by batching "
+                           << core.perf_counters.io_syscalls_saved.load()
+                           << viua::TRACE_STREAM.endl;
         viua::TRACE_STREAM << "[vm:perf] executed ops " << total_ops
                            << ", run time " << format_time(total_us)
                            << viua::TRACE_STREAM.endl;
@@ -395,18 +671,40 @@ auto main(int argc, char* argv[]) -> int
                 /*
                  * Assume an file descriptor opened for writing was received.
                  */
-                viua::TRACE_STREAM =
-                    viua::support::fdstream{std::stoi(trace_fd)};
+                viua::TRACE_FD = std::stoi(trace_fd);
             } catch (std::invalid_argument const&) {
                 /*
                  * Otherwise, treat the thing received as a filename and open it
                  * for writing.
                  */
-                viua::TRACE_STREAM = viua::support::fdstream{
-                    open(trace_fd, O_WRONLY | O_CLOEXEC)};
+                viua::TRACE_FD = open(trace_fd, O_WRONLY | O_CLOEXEC);
             }
+            viua::TRACE_STREAM = viua::support::fdstream{viua::TRACE_FD};
+        }
+    }
+
+    /*
+     * Tracing output of several schedulers running at the same time is not
+     * very readable so when tracing is compiled in we default to a single
+     * scheduler. The user can still ask for more.
+     */
+    auto no_of_schedulers = viua::vm::ins::VIUA_TRACE_CYCLES
+                                ? size_t{1}
+                                : size_t{std::thread::hardware_concurrency()};
+    if (auto const n = getenv("VIUA_VM_PROC_SCHEDULERS"); n) {
+        try {
+            no_of_schedulers = std::stoul(n);
+        } catch (std::logic_error const&) {
+            std::cerr << esc(2, COLOR_FG_RED) << "error" << esc(2, ATTR_RESET)
+                      << ": VIUA_VM_PROC_SCHEDULERS must be a positive integer"
+                      << "\n";
+            return 1;
         }
     }
+    core.make_schedulers(std::max(no_of_schedulers, size_t{1}));
+
+    auto const profile_path = getenv("VIUA_VM_PROFILE");
+    core.profiling          = (profile_path != nullptr);
 
     try {
         run(core);
@@ -420,6 +718,9 @@ auto main(int argc, char* argv[]) -> int
         std::cerr << "Aborted instruction: " << std::hex << std::setfill('0')
                   << "0x" << std::setw(16) << *e.stack.ip << std::dec << "\n";
         viua::vm::ins::print_backtrace(e.stack);
+        if (core.profiling) {
+            write_profile(core, profile_path);
+        }
         if constexpr (true) {
             throw;
         } else {
@@ -427,5 +728,9 @@ auto main(int argc, char* argv[]) -> int
         }
     }
 
+    if (core.profiling) {
+        write_profile(core, profile_path);
+    }
+
     return 0;
 }
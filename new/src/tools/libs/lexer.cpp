@@ -19,10 +19,11 @@
 
 #include <assert.h>
 
-#include <iomanip>
+#include <array>
 #include <iostream>
-#include <regex>
 #include <set>
+#include <string>
+#include <utility>
 #include <string_view>
 #include <vector>
 
@@ -47,12 +48,14 @@ auto Lexeme::make_synth(std::string sv, TOKEN const tk) const -> Lexeme
     auto sy             = *this;
     sy.text             = std::move(sv);
     sy.token            = tk;
-    sy.synthesized_from = {text, token, location};
+    sy.synthesized_from =
+        std::make_shared<std::tuple<std::string, TOKEN, Location> const>(
+            text, token, location);
     return sy;
 }
 auto Lexeme::is_synth() const -> bool
 {
-    return synthesized_from.has_value();
+    return (synthesized_from != nullptr);
 }
 auto Lexeme::synthed_from() const -> Lexeme
 {
@@ -127,49 +130,243 @@ auto to_string(TOKEN const token) -> std::string
     assert(0);
 }
 
-const auto COMMENT = std::regex{"^[;#].*"};
+namespace {
+/*
+ * The scanner is a set of small hand-written automata, one for each kind of
+ * lexeme. Each of them looks at the source text starting at the current
+ * position and returns the length of the lexeme it recognised, or 0 if the text
+ * does not start with a lexeme of its kind. They are tried in a fixed order and
+ * the first one to recognise something wins, so the order in which they are
+ * tried matters.
+ *
+ * Characters are classified with a lookup table instead of a chain of
+ * comparisons. A character may belong to several classes.
+ */
+namespace char_class {
+using type = uint16_t;
+
+constexpr auto WORD  = type{0x001}; /* [A-Za-z0-9_], as in \b */
+constexpr auto LOWER = type{0x002}; /* [a-z_] */
+constexpr auto ALPHA = type{0x004}; /* [A-Za-z_] */
+constexpr auto DIGIT = type{0x008}; /* [0-9] */
+constexpr auto HEX   = type{0x010}; /* [a-f0-9] */
+constexpr auto OCT   = type{0x020}; /* [0-7] */
+constexpr auto BIN   = type{0x040}; /* [01] */
+constexpr auto BLANK = type{0x080}; /* [ \t] */
+constexpr auto EOL   = type{0x100}; /* [\n\r] */
+
+constexpr auto TABLE = []() -> std::array<type, 256> {
+    auto table = std::array<type, 256>{};
+    auto const mark = [&table](char const lo, char const hi, type const cls) {
+        for (auto c = lo; c <= hi; ++c) {
+            table[static_cast<uint8_t>(c)] |= cls;
+        }
+    };
+    mark('a', 'z', WORD | LOWER | ALPHA);
+    mark('A', 'Z', WORD | ALPHA);
+    mark('_', '_', WORD | LOWER | ALPHA);
+    mark('0', '9', WORD | DIGIT | HEX);
+    mark('a', 'f', HEX);
+    mark('0', '7', OCT);
+    mark('0', '1', BIN);
+    mark(' ', ' ', BLANK);
+    mark('\t', '\t', BLANK);
+    mark('\n', '\n', EOL);
+    mark('\r', '\r', EOL);
+    return table;
+}();
+}  // namespace char_class
+
+auto is(std::string_view const sv, size_t const i, char_class::type const cls)
+    -> bool
+{
+    return (i < sv.size())
+           and (char_class::TABLE[static_cast<uint8_t>(sv[i])] & cls);
+}
+auto skip(std::string_view const sv, size_t i, char_class::type const cls)
+    -> size_t
+{
+    while (is(sv, i, cls)) {
+        ++i;
+    }
+    return i;
+}
 
-const auto WHITESPACE = std::regex{"^[ \t]+"};
+/*
+ * Word boundary between sv[i - 1] and sv[i], with the end of text counting as a
+ * non-word character.
+ */
+auto at_word_boundary(std::string_view const sv, size_t const i) -> bool
+{
+    return (is(sv, i - 1, char_class::WORD) != is(sv, i, char_class::WORD));
+}
+
+/*
+ * [ \t]+
+ */
+auto scan_whitespace(std::string_view const sv) -> size_t
+{
+    return skip(sv, 0, char_class::BLANK);
+}
+
+/*
+ * [;#].* where the dot does not match line terminators.
+ */
+auto scan_comment(std::string_view const sv) -> size_t
+{
+    if (sv.front() != ';' and sv.front() != '#') {
+        return 0;
+    }
+    auto i = size_t{1};
+    while (i < sv.size() and not is(sv, i, char_class::EOL)) {
+        ++i;
+    }
+    return i;
+}
 
-const auto DIR_TEXT    = std::regex{"^\\.text\\b"};
-const auto DIR_RODATA  = std::regex{"^\\.rodata\\b"};
-const auto DIR_SECTION = std::regex{"^\\.section\\b"};
+/*
+ * A keyword (eg, ".text" or "void") followed by a word boundary.
+ */
+auto scan_keyword(std::string_view const sv, std::string_view const keyword)
+    -> size_t
+{
+    if (sv.starts_with(keyword) and at_word_boundary(sv, keyword.size())) {
+        return keyword.size();
+    }
+    return 0;
+}
 
-const auto DIR_SYMBOL = std::regex{"^\\.symbol\\b"};
-const auto DIR_LABEL  = std::regex{"^\\.label\\b"};
-const auto DIR_BEGIN  = std::regex{"^\\.begin\\b"};
-const auto DIR_END    = std::regex{"^\\.end\\b"};
-const auto DIR_OBJECT = std::regex{"^\\.object\\b"};
+/*
+ * Directives are keywords beginning with a dot. At most one of them can match
+ * because each must be followed by a word boundary.
+ */
+constexpr auto DIRECTIVES = std::array<std::pair<std::string_view, TOKEN>, 8>{{
+    {".text", TOKEN::SWITCH_TO_TEXT},
+    {".rodata", TOKEN::SWITCH_TO_RODATA},
+    {".section", TOKEN::SWITCH_TO_SECTION},
+    {".symbol", TOKEN::DECLARE_SYMBOL},
+    {".label", TOKEN::DEFINE_LABEL},
+    {".begin", TOKEN::BEGIN},
+    {".end", TOKEN::END},
+    {".object", TOKEN::ALLOCATE_OBJECT},
+}};
+auto scan_directive(std::string_view const sv) -> std::pair<size_t, TOKEN>
+{
+    if (sv.front() == '.') {
+        for (auto const& [name, token] : DIRECTIVES) {
+            if (auto const n = scan_keyword(sv, name); n) {
+                return {n, token};
+            }
+        }
+    }
+    return {0, TOKEN::INVALID};
+}
 
-const auto SECTION_NAME = std::regex{"^(\\.[A-Za-z][A-Za-z0-9_]+)+\\b"};
+/*
+ * -?(?:0|[1-9][0-9]*)?\.[0-9]+
+ */
+auto scan_float(std::string_view const sv) -> size_t
+{
+    auto i = size_t{(sv.front() == '-') ? 1u : 0u};
+    if (is(sv, i, char_class::DIGIT)) {
+        i = ((sv[i] == '0') ? (i + 1) : skip(sv, i, char_class::DIGIT));
+    }
+    if (i < sv.size() and sv[i] == '.' and is(sv, i + 1, char_class::DIGIT)) {
+        return skip(sv, i + 1, char_class::DIGIT);
+    }
+    return 0;
+}
 
 /*
- * The regex for register indexes will catch ANYTHING up until word boundary,
- * not only valid index names. This is a better choice for error reporting since
- * it allows the assembler to quickly see what's wrong; if the regex only
- * accepted valid names the errors could get weird, and it would be much more
- * difficult to provide sane diagnostics.
+ * [-+]?(?:0x[a-f0-9]+|0o[0-7]+|0b[01]+|0|[1-9][0-9]*)u?
  */
-const auto VOID = std::regex{"^\\bvoid\\b"};
+auto scan_integer(std::string_view const sv) -> size_t
+{
+    auto i = size_t{(sv.front() == '-' or sv.front() == '+') ? 1u : 0u};
+    if (not is(sv, i, char_class::DIGIT)) {
+        return 0;
+    }
 
-const auto LITERAL_ATOM = std::regex{pattern::LITERAL_ATOM};
-const auto LITERAL_INTEGER =
-    std::regex{"^[-+]?(?:0x[a-f0-9]+|0o[0-7]+|0b[01]+|0|[1-9][0-9]*)u?"};
-const auto LITERAL_FLOAT = std::regex{"^-?(?:0|[1-9][0-9]*)?\\.[0-9]+"};
+    auto const prefixed = [sv, i](char const base) -> bool {
+        return ((i + 1) < sv.size()) and (sv[i] == '0') and (sv[i + 1] == base);
+    };
 
-const auto COMMA           = std::regex{"^,"};
-const auto ELLIPSIS        = std::regex{"^\\.\\.\\."};
-const auto DOT             = std::regex{"^\\."};
-const auto EQ              = std::regex{"^="};
-const auto AT              = std::regex{"^@"};
-const auto DOLLAR          = std::regex{"^\\$"};
-const auto STAR            = std::regex{"^\\*"};
-const auto ATTR_LIST_OPEN  = std::regex{"^\\[\\["};
-const auto ATTR_LIST_CLOSE = std::regex{"^\\]\\]"};
+    if (prefixed('x') and is(sv, i + 2, char_class::HEX)) {
+        i = skip(sv, i + 2, char_class::HEX);
+    } else if (prefixed('o') and is(sv, i + 2, char_class::OCT)) {
+        i = skip(sv, i + 2, char_class::OCT);
+    } else if (prefixed('b') and is(sv, i + 2, char_class::BIN)) {
+        i = skip(sv, i + 2, char_class::BIN);
+    } else if (sv[i] == '0') {
+        i += 1;
+    } else {
+        i = skip(sv, i, char_class::DIGIT);
+    }
 
-const auto OPCODE = std::regex{"^(?:g.)?[a-z_]+(?:.[stw])?\\b"};
+    if (i < sv.size() and sv[i] == 'u') {
+        ++i;
+    }
+    return i;
+}
+
+/*
+ * (?:g.)?[a-z_]+(?:.[stw])?\b where the dots do not match line terminators.
+ *
+ * Unlike the rest this pattern is ambiguous, so alternatives are tried in the
+ * order a backtracking regular expression engine would try them. The run of
+ * [a-z_] characters is bounded so this is still linear in the length of the
+ * lexeme.
+ */
+auto scan_opcode(std::string_view const sv) -> size_t
+{
+    auto const any_at = [sv](size_t const n) -> bool {
+        return (n < sv.size()) and not is(sv, n, char_class::EOL);
+    };
+    auto const width_at = [sv](size_t const n) -> bool {
+        return (n < sv.size())
+               and (sv[n] == 's' or sv[n] == 't' or sv[n] == 'w');
+    };
+
+    auto const greedy = (sv.front() == 'g' and any_at(1));
+    for (auto const start : {size_t{2}, size_t{0}}) {
+        if (start == 2 and not greedy) {
+            continue;
+        }
+
+        auto const run = (skip(sv, start, char_class::LOWER) - start);
+        for (auto end = (start + run); end > start; --end) {
+            if (any_at(end) and width_at(end + 1)
+                and at_word_boundary(sv, end + 2)) {
+                return (end + 2);
+            }
+            if (at_word_boundary(sv, end)) {
+                return end;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * [A-Za-z_][A-Za-z0-9_]*\b
+ */
+auto scan_atom(std::string_view const sv) -> size_t
+{
+    if (not is(sv, 0, char_class::ALPHA)) {
+        return 0;
+    }
+    return skip(sv, 1, char_class::WORD);
+}
+
+/*
+ * Fixed strings of punctuation.
+ */
+auto scan_literal(std::string_view const sv, std::string_view const what)
+    -> size_t
+{
+    return (sv.starts_with(what) ? what.size() : 0);
+}
 
-namespace {
 auto match_lookbehind [[maybe_unused]] (std::vector<Lexeme> const& lexemes,
                                         std::vector<TOKEN> const pattern)
 -> bool
@@ -216,24 +413,33 @@ auto synth_lookbehind [[maybe_unused]] (std::vector<Lexeme> const& lexemes,
 
 auto lex(std::string_view source_text) -> std::vector<Lexeme>
 {
+    /*
+     * Typical source code has about one lexeme per every three or four bytes,
+     * whitespace included. Reserve for the lower estimate to avoid moving the
+     * lexemes around as the vector grows.
+     */
     auto lexemes = std::vector<Lexeme>{};
+    lexemes.reserve(source_text.size() / 4);
 
     auto line      = size_t{};
     auto character = size_t{};
     auto offset    = size_t{};
 
     auto const try_match = [&lexemes, &source_text, &line, &character, &offset](
-                               std::regex const& re, TOKEN const tt) -> bool {
-        std::cmatch m;
-        if (regex_search(source_text.data(), m, re)) {
-            lexemes.emplace_back(
-                m.str(), tt, Location{line, character, offset});
-
-            character += lexemes.back().text.size();
-            offset += lexemes.back().text.size();
-            source_text.remove_prefix(lexemes.back().text.size());
+                               size_t const n, TOKEN const tt) -> bool {
+        if (n == 0) {
+            return false;
         }
-        return (not m.empty());
+
+        lexemes.emplace_back(std::string{source_text.substr(0, n)},
+                             tt,
+                             Location{line, character, offset});
+
+        character += n;
+        offset += n;
+        source_text.remove_prefix(n);
+
+        return true;
     };
 
     while (not source_text.empty()) {
@@ -270,163 +476,93 @@ auto lex(std::string_view source_text) -> std::vector<Lexeme>
             continue;
         }
         if (source_text[0] == '"') {
-            if constexpr (false) {
-                auto ss = std::stringstream{};
-                ss << std::string_view{
-                    source_text.begin(),
-                    std::find(source_text.begin(), source_text.end(), '\n')};
-
-                /*
-                 * Use a null byte as an "escape character" because it should
-                 * not appear in a string - it will be encoded as \x00 (with
-                 * four characters), \0 (with two characters) or something else.
-                 * The important thing is that it will not appear as ITSELF.
-                 *
-                 * If we used the \ ie, the backslash character, all hell would
-                 * break loose and the code would stop working because
-                 * std::quoted() would remove it, even if it appeared as a part
-                 * of an escape sequence - for example \n.
-                 *
-                 * Why, though? I think this is clearly a broken behaviour. If
-                 * the std::quoted() does not escape characters other than "
-                 * then why would it "unescape" them?
-                 */
-                auto extracted_string = std::string{};
-                ss >> std::quoted(extracted_string, '"', '\x00');
-
-                /*
-                 * We need to add 2 to the amount to shift the head of
-                 * std::string_view by, because std::quoted() does not extract
-                 * the quotes.
-                 */
-                auto const shift_by = (extracted_string.size() + 2);
-
-                lexemes.emplace_back(Lexeme{std::move(extracted_string),
-                                            TOKEN::LITERAL_STRING,
-                                            Location{line, character, offset}});
-
-                character += shift_by;
-                offset += shift_by;
-                source_text.remove_prefix(shift_by);
-            }
-
-            auto ss                  = std::ostringstream{};
+            /*
+             * The string runs up to the first delimiter which is not escaped,
+             * or to the end of the source text if there is no such delimiter.
+             * The delimiters are a part of the lexeme.
+             */
             auto escaped             = bool{false};
             constexpr auto DELIMITER = '"';
 
-            ss << source_text.front();
-            for (auto i = size_t{1}; i < source_text.size(); ++i) {
+            auto i = size_t{1};
+            for (; i < source_text.size(); ++i) {
                 auto const c = source_text[i];
-                ss << c;
-
                 if (c == DELIMITER and not escaped) {
+                    ++i;
                     break;
                 }
 
                 escaped = (c == '\\') ? (not escaped) : false;
             }
 
-            auto extracted_string = ss.str();
-            auto const shift_by   = extracted_string.size();
-
-            lexemes.emplace_back(std::move(extracted_string),
-                                 TOKEN::LITERAL_STRING,
-                                 Location{line, character, offset});
-
-            character += shift_by;
-            offset += shift_by;
-            source_text.remove_prefix(shift_by);
-
+            try_match(i, TOKEN::LITERAL_STRING);
             continue;
         }
 
-        if (try_match(WHITESPACE, TOKEN::WHITESPACE)) {
-            continue;
-        }
-        if (try_match(COMMENT, TOKEN::COMMENT)) {
+        if (try_match(scan_whitespace(source_text), TOKEN::WHITESPACE)) {
             continue;
         }
-        if (try_match(DIR_TEXT, TOKEN::SWITCH_TO_TEXT)) {
+        if (try_match(scan_comment(source_text), TOKEN::COMMENT)) {
             continue;
         }
-        if (try_match(DIR_RODATA, TOKEN::SWITCH_TO_RODATA)) {
-            continue;
-        }
-        if (try_match(DIR_SECTION, TOKEN::SWITCH_TO_SECTION)) {
-            continue;
-        }
-        if (try_match(DIR_SYMBOL, TOKEN::DECLARE_SYMBOL)) {
-            continue;
-        }
-        if (try_match(DIR_LABEL, TOKEN::DEFINE_LABEL)) {
-            continue;
-        }
-        if (try_match(DIR_BEGIN, TOKEN::BEGIN)) {
-            continue;
-        }
-        if (try_match(DIR_END, TOKEN::END)) {
-            continue;
-        }
-        if (try_match(DIR_OBJECT, TOKEN::ALLOCATE_OBJECT)) {
+        if (auto const [n, tt] = scan_directive(source_text);
+            try_match(n, tt)) {
             continue;
         }
 
-        if (try_match(LITERAL_FLOAT, TOKEN::LITERAL_FLOAT)) {
+        if (try_match(scan_float(source_text), TOKEN::LITERAL_FLOAT)) {
             continue;
         }
-        if (try_match(LITERAL_INTEGER, TOKEN::LITERAL_INTEGER)) {
+        if (try_match(scan_integer(source_text), TOKEN::LITERAL_INTEGER)) {
             continue;
         }
 
-        if (try_match(VOID, TOKEN::VOID)) {
+        if (try_match(scan_keyword(source_text, "void"), TOKEN::VOID)) {
             continue;
         }
 
-        if (try_match(OPCODE, TOKEN::OPCODE)) {
-            auto const not_really_an_opcode =
-                not OPCODE_NAMES.contains(lexemes.back().text);
-            auto const looks_atomish = [&lexemes]() -> bool {
-                std::smatch m;
-                return std::regex_match(lexemes.back().text, m, LITERAL_ATOM);
-            }();
-            if (not_really_an_opcode and looks_atomish) {
-                auto lx = std::move(lexemes.back());
-                lexemes.pop_back();
-
-                lexemes.emplace_back(lx.text, TOKEN::LITERAL_ATOM, lx.location);
-            }
+        if (auto const n = scan_opcode(source_text); n) {
+            auto const text = source_text.substr(0, n);
+            auto const not_really_an_opcode = not OPCODE_NAMES.contains(text);
+            auto const looks_atomish        = (scan_atom(text) == n);
+            try_match(n,
+                      (not_really_an_opcode and looks_atomish)
+                          ? TOKEN::LITERAL_ATOM
+                          : TOKEN::OPCODE);
             continue;
         }
-        if (try_match(LITERAL_ATOM, TOKEN::LITERAL_ATOM)) {
+        if (try_match(scan_atom(source_text), TOKEN::LITERAL_ATOM)) {
             continue;
         }
 
-        if (try_match(ATTR_LIST_OPEN, TOKEN::ATTR_LIST_OPEN)) {
+        if (try_match(scan_literal(source_text, "[["),
+                      TOKEN::ATTR_LIST_OPEN)) {
             continue;
         }
-        if (try_match(ATTR_LIST_CLOSE, TOKEN::ATTR_LIST_CLOSE)) {
+        if (try_match(scan_literal(source_text, "]]"),
+                      TOKEN::ATTR_LIST_CLOSE)) {
             continue;
         }
 
-        if (try_match(COMMA, TOKEN::COMMA)) {
+        if (try_match(scan_literal(source_text, ","), TOKEN::COMMA)) {
             continue;
         }
-        if (try_match(ELLIPSIS, TOKEN::ELLIPSIS)) {
+        if (try_match(scan_literal(source_text, "..."), TOKEN::ELLIPSIS)) {
             continue;
         }
-        if (try_match(EQ, TOKEN::EQ)) {
+        if (try_match(scan_literal(source_text, "="), TOKEN::EQ)) {
             continue;
         }
-        if (try_match(DOT, TOKEN::DOT)) {
+        if (try_match(scan_literal(source_text, "."), TOKEN::DOT)) {
             continue;
         }
-        if (try_match(DOLLAR, TOKEN::DOLLAR)) {
+        if (try_match(scan_literal(source_text, "$"), TOKEN::DOLLAR)) {
             continue;
         }
-        if (try_match(STAR, TOKEN::STAR)) {
+        if (try_match(scan_literal(source_text, "*"), TOKEN::STAR)) {
             continue;
         }
-        if (try_match(AT, TOKEN::AT)) {
+        if (try_match(scan_literal(source_text, "@"), TOKEN::AT)) {
             continue;
         }
 
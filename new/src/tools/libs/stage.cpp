@@ -417,7 +417,7 @@ auto record_symbol(std::string name,
     return sym_ndx;
 }
 auto cook_long_immediates(viua::libs::parser::ast::Instruction insn,
-                          std::vector<uint8_t>& rodata_buf,
+                          Interned_buffer& rodata_buf,
                           std::vector<Elf64_Sym>& symbol_table,
                           std::map<std::string, size_t>& symbol_map)
     -> std::vector<viua::libs::parser::ast::Instruction>
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <endian.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <viua/libs/stage.h>
+
+
+namespace viua::libs::stage {
+namespace {
+/*
+ * FNV-1a. It is only used to name the files so it does not have to be strong;
+ * the keys are compared in full anyway.
+ */
+auto hash_of(std::string_view const key) -> uint64_t
+{
+    auto h = uint64_t{0xcbf29ce484222325};
+    for (auto const each : key) {
+        h ^= static_cast<uint8_t>(each);
+        h *= uint64_t{0x100000001b3};
+    }
+    return h;
+}
+
+auto append_u64(std::string& buf, uint64_t const value) -> void
+{
+    auto const le = htole64(value);
+    buf.append(reinterpret_cast<char const*>(&le), sizeof(le));
+}
+auto take_u64(std::string_view& buf) -> std::optional<uint64_t>
+{
+    auto le = uint64_t{};
+    if (buf.size() < sizeof(le)) {
+        return std::nullopt;
+    }
+    memcpy(&le, buf.data(), sizeof(le));
+    buf.remove_prefix(sizeof(le));
+    return le64toh(le);
+}
+
+auto write_all(int const fd, std::string_view data) -> bool
+{
+    while (not data.empty()) {
+        auto const n = write(fd, data.data(), data.size());
+        if (n == -1) {
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+auto read_all(int const fd) -> std::optional<std::string>
+{
+    struct stat st {};
+    if (fstat(fd, &st) == -1) {
+        return std::nullopt;
+    }
+
+    auto data = std::string(static_cast<size_t>(st.st_size), '\0');
+    auto done = size_t{0};
+    while (done < data.size()) {
+        auto const n = read(fd, (data.data() + done), (data.size() - done));
+        if (n <= 0) {
+            return std::nullopt;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return data;
+}
+
+auto name_of(std::string_view const key) -> std::string
+{
+    char name[17];
+    snprintf(name,
+             sizeof(name),
+             "%016llx",
+             static_cast<unsigned long long>(hash_of(key)));
+    return name;
+}
+}  // namespace
+
+Text_cache::Text_cache(std::filesystem::path root,
+                       std::string_view const assembler_id)
+        : directory{root / name_of(assembler_id)}
+{
+    auto ec = std::error_code{};
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        return;
+    }
+
+    /*
+     * Entries of other builds of the assembler will never be used again, so
+     * their directories are removed. Only directories named like the ones the
+     * cache creates are touched, as the cache may be kept in a directory that
+     * holds other files too. Failing to remove them only wastes disk space.
+     */
+    auto each = std::filesystem::directory_iterator{root, ec};
+    for (; (not ec) and each != std::filesystem::directory_iterator{};
+         each.increment(ec)) {
+        auto const name = each->path().filename().native();
+        auto const is_build_dir =
+            (name.size() == 16)
+            and (name.find_first_not_of("0123456789abcdef")
+                 == std::string::npos)
+            and each->is_directory(ec);
+        if (is_build_dir and each->path() != directory) {
+            auto removal_ec = std::error_code{};
+            std::filesystem::remove_all(each->path(), removal_ec);
+        }
+    }
+}
+
+auto Text_cache::path_of(std::string_view const key) const
+    -> std::filesystem::path
+{
+    return directory / name_of(key);
+}
+
+/*
+ * Entries are laid out like this, with all numbers stored as 64-bit little
+ * endian integers:
+ *
+ *      key-size key
+ *      sizes-count size...
+ *      ops-count op...
+ */
+auto Text_cache::find(std::string_view const key) const -> std::optional<Entry>
+{
+    auto const fd = open(path_of(key).c_str(), O_RDONLY);
+    if (fd == -1) {
+        return std::nullopt;
+    }
+    auto const data = read_all(fd);
+    close(fd);
+    if (not data.has_value()) {
+        return std::nullopt;
+    }
+
+    auto buf = std::string_view{*data};
+
+    auto const key_size = take_u64(buf);
+    if ((not key_size) or (*key_size > buf.size())
+        or (buf.substr(0, *key_size) != key)) {
+        return std::nullopt;
+    }
+    buf.remove_prefix(*key_size);
+
+    auto entry = Entry{};
+
+    auto const sizes_count = take_u64(buf);
+    if ((not sizes_count) or (*sizes_count > (buf.size() / sizeof(uint64_t)))) {
+        return std::nullopt;
+    }
+    entry.sizes.reserve(*sizes_count);
+    for (auto i = uint64_t{0}; i < *sizes_count; ++i) {
+        entry.sizes.push_back(*take_u64(buf));
+    }
+
+    auto const ops_count = take_u64(buf);
+    if ((not ops_count) or (*ops_count != (buf.size() / sizeof(uint64_t)))
+        or (buf.size() % sizeof(uint64_t))) {
+        return std::nullopt;
+    }
+    entry.text.reserve(*ops_count);
+    for (auto i = uint64_t{0}; i < *ops_count; ++i) {
+        entry.text.push_back(*take_u64(buf));
+    }
+
+    return entry;
+}
+
+auto Text_cache::store(std::string_view const key, Entry const& entry) const
+    -> void
+{
+    auto data = std::string{};
+    data.reserve(key.size()
+                 + ((3 + entry.sizes.size() + entry.text.size())
+                    * sizeof(uint64_t)));
+
+    append_u64(data, key.size());
+    data.append(key);
+    append_u64(data, entry.sizes.size());
+    for (auto const each : entry.sizes) {
+        append_u64(data, each);
+    }
+    append_u64(data, entry.text.size());
+    for (auto const each : entry.text) {
+        append_u64(data, each);
+    }
+
+    /*
+     * Write the entry under a temporary name and move it into place so that
+     * readers never see a partially written entry.
+     */
+    auto const final_path = path_of(key);
+    auto temp_path        = final_path.native() + ".XXXXXX";
+    auto const fd         = mkstemp(temp_path.data());
+    if (fd == -1) {
+        return;
+    }
+    auto const written = write_all(fd, data);
+    close(fd);
+
+    if ((not written)
+        or (rename(temp_path.c_str(), final_path.c_str()) == -1)) {
+        unlink(temp_path.c_str());
+    }
+}
+}  // namespace viua::libs::stage
@@ -32,78 +32,59 @@
 
 
 namespace viua::libs::stage {
-auto save_string_to_strtab(std::vector<uint8_t>& tab,
-                           std::string_view const data) -> size_t
+auto save_string_to_strtab(Interned_buffer& tab, std::string_view const data)
+    -> size_t
 {
-    {
+    if (data.empty()) {
         /*
-         * Scan the strings table to see if the requested data is already there.
-         * There is no reason to store extra copies of the same value in .rodata
-         * so let's deduplicate.
-         *
-         * FIXME This is ridiculously slow. Maybe add some cache instead of
-         * linearly browsing through the whole table every time?
+         * Every string in the table ends with a nul so the empty string is
+         * wherever the first nul is, usually right at the beginning.
          */
-        auto i = size_t{0};
-        while ((i + data.size()) < tab.size()) {
-            auto const existing = std::string_view{
-                reinterpret_cast<char const*>(tab.data() + i), data.size()};
-
-            auto const content_matches = (existing == data);
-            auto const nul_matches = (*(tab.data() + i + data.size()) == '\0');
-            if (content_matches and nul_matches) {
-                return i;
-            }
-
-            ++i;
+        auto const nul = std::find(tab.buffer.begin(), tab.buffer.end(), '\0');
+        if (nul != tab.buffer.end()) {
+            return static_cast<size_t>(nul - tab.buffer.begin());
         }
+    } else if (auto const existing = tab.index.find(data);
+               existing != tab.index.end()) {
+        return existing->second;
     }
 
-    auto const saved_location = tab.size();
+    auto const saved_location = tab.buffer.size();
 
-    std::copy(data.begin(), data.end(), std::back_inserter(tab));
-    tab.push_back('\0');
+    std::copy(data.begin(), data.end(), std::back_inserter(tab.buffer));
+    tab.buffer.push_back('\0');
+
+    /*
+     * Index every tail of the string so that names which are suffixes of names
+     * already in the table do not take any extra space. Tails which are
+     * already indexed are left alone, and keep pointing to their first copy.
+     */
+    auto const& key = tab.keys.emplace_back(data);
+    for (auto i = size_t{0}; i < key.size(); ++i) {
+        tab.index.try_emplace(std::string_view{key}.substr(i),
+                              saved_location + i);
+    }
 
     return saved_location;
 }
-auto save_buffer_to_rodata(std::vector<uint8_t>& strings,
+auto save_buffer_to_rodata(Interned_buffer& strings,
                            std::string_view const data) -> size_t
 {
-    {
-        /*
-         * Scan the strings table to see if the requested data is already there.
-         * There is no reason to store extra copies of the same value in .rodata
-         * so let's deduplicate.
-         *
-         * FIXME This is ridiculously slow. Maybe add some cache instead of
-         * linearly browsing through the whole table every time?
-         */
-        auto i = size_t{0};
-        while (i < strings.size()) {
-            auto data_size = uint64_t{};
-            memcpy(&data_size, strings.data() + i, sizeof(data_size));
-            data_size = le64toh(data_size);
-
-            i += sizeof(data_size);
-
-            auto const existing = std::string_view{
-                reinterpret_cast<char const*>(strings.data() + i), data_size};
-            if (existing == data) {
-                return i;
-            }
-
-            i += data_size;
-        }
+    if (auto const existing = strings.index.find(data);
+        existing != strings.index.end()) {
+        return existing->second;
     }
 
     auto const data_size = htole64(data.size());
-    strings.resize(strings.size() + sizeof(data_size));
-    memcpy((strings.data() + strings.size() - sizeof(data_size)),
+    strings.buffer.resize(strings.buffer.size() + sizeof(data_size));
+    memcpy((strings.buffer.data() + strings.buffer.size() - sizeof(data_size)),
            &data_size,
            sizeof(data_size));
 
-    auto const saved_location = strings.size();
-    std::copy(data.begin(), data.end(), std::back_inserter(strings));
+    auto const saved_location = strings.buffer.size();
+    std::copy(data.begin(), data.end(), std::back_inserter(strings.buffer));
+
+    strings.index.emplace(strings.keys.emplace_back(data), saved_location);
 
     return saved_location;
 }
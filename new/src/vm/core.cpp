@@ -17,71 +17,244 @@
  *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <poll.h>
+#include <sys/mman.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <memory>
+#include <mutex>
 
 #include <viua/support/fdstream.h>
 #include <viua/vm/core.h>
 
 namespace viua {
-extern viua::support::fdstream TRACE_STREAM;
+extern thread_local viua::support::fdstream TRACE_STREAM;
 }
 
 namespace viua::vm {
-auto IO_scheduler::schedule(int const fd,
-                            opcode_type const opcode,
-                            buffer_type buffer) -> IO_request::id_type
+auto IO_scheduler::queue(std::unique_ptr<IO_request> req,
+                         int const fd,
+                         void const* const data,
+                         size_t const size) -> IO_request::id_type
 {
-    auto const req_id = next_id.fetch_add(1);
-    auto req          = std::make_unique<IO_request>(
-        nullptr, req_id, opcode, std::move(buffer));
+    auto const req_id = req->id;
 
-    io_uring_sqe* sqe{};
-    sqe = io_uring_get_sqe(&ring);
+    std::lock_guard<std::mutex> lck{ring_mtx};
 
-    sqe->opcode = opcode;
-    sqe->fd     = fd;
+    auto sqe = io_uring_get_sqe(&ring);
+    if (sqe == nullptr) {
+        /*
+         * The submission queue is full. Flush it to make room for the new
+         * request.
+         */
+        submit();
+        sqe = io_uring_get_sqe(&ring);
+    }
+    if (sqe == nullptr) {
+        /*
+         * The kernel did not consume any entries (eg, because the completion
+         * queue is overflowing) so there is still no room. Fail the request
+         * instead of blocking the scheduler; whoever waits for it will see the
+         * error immediately.
+         */
+        req->status      = IO_request::Status::Error;
+        req->result      = -EBUSY;
+        requests[req_id] = std::move(req);
+        return req_id;
+    }
+    ++in_flight;
 
-    auto& buf      = std::get<decltype(buffer)>(req->buffer);
-    sqe->addr      = reinterpret_cast<decltype(io_uring_sqe::addr)>(buf.data());
-    sqe->len       = buf.size();
+    sqe->opcode    = req->opcode;
+    sqe->fd        = fd;
+    sqe->addr      = reinterpret_cast<decltype(io_uring_sqe::addr)>(data);
+    sqe->len       = size;
     sqe->user_data = req_id;
 
-    io_uring_submit(&ring);
-
     requests[req_id] = std::move(req);
 
     return req_id;
 }
+auto IO_scheduler::schedule(int const fd,
+                            opcode_type const opcode,
+                            buffer_type buffer) -> IO_request::id_type
+{
+    auto req = std::make_unique<IO_request>(
+        nullptr, next_id.fetch_add(1), opcode, std::move(buffer));
+
+    auto const& buf = std::get<buffer_type>(req->buffer);
+    auto const data = buf.data();
+    auto const size = buf.size();
+    return queue(std::move(req), fd, data, size);
+}
 auto IO_scheduler::schedule(uint8_t* const req_ptr,
                             int const fd,
                             opcode_type const opcode,
                             io::buffer_view buffer) -> IO_request::id_type
 {
-    auto const req_id = next_id.fetch_add(1);
-    auto req          = std::make_unique<IO_request>(
-        req_ptr, req_id, opcode, std::move(buffer));
+    auto req = std::make_unique<IO_request>(
+        req_ptr, next_id.fetch_add(1), opcode, std::move(buffer));
 
-    io_uring_sqe* sqe{};
-    sqe = io_uring_get_sqe(&ring);
+    auto const& buf = std::get<io::buffer_view>(req->buffer);
+    auto const data = buf.data();
+    auto const size = buf.size();
+    return queue(std::move(req), fd, data, size);
+}
+auto IO_scheduler::submit() -> void
+{
+    if (io_uring_sq_ready(&ring) == 0) {
+        return;
+    }
 
-    sqe->opcode = opcode;
-    sqe->fd     = fd;
+    if (auto const n = io_uring_submit(&ring); n > 1) {
+        perf_counters.io_syscalls_saved += static_cast<uint64_t>(n - 1);
+    }
+}
 
-    auto& buf      = std::get<decltype(buffer)>(req->buffer);
-    sqe->addr      = reinterpret_cast<decltype(io_uring_sqe::addr)>(buf.data());
-    sqe->len       = buf.size();
-    sqe->user_data = req_id;
+auto Profile::merge(Profile const& other) -> void
+{
+    for (auto const& [opcode, c] : other.ops) {
+        auto& each = ops[opcode];
+        each.count += c.count;
+        each.cycles += c.cycles;
+    }
+    for (auto const& [fn, c] : other.functions) {
+        auto& each = functions[fn];
+        each.count += c.count;
+        each.cycles += c.cycles;
+    }
+    for (auto const& [fn, n] : other.calls) {
+        calls[fn] += n;
+    }
+    for (auto const& [stack, cycles] : other.stacks) {
+        stacks[stack] += cycles;
+    }
+}
+auto Profile::now() -> counter_type
+{
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return static_cast<counter_type>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
 
-    io_uring_submit(&ring);
+auto Core::make_schedulers(size_t const n) -> void
+{
+    schedulers.clear();
+    for (auto i = size_t{0}; i < n; ++i) {
+        schedulers.push_back(std::make_unique<Scheduler>(i));
+    }
+}
+auto Core::pop_ready() -> std::experimental::observer_ptr<Process>
+{
+    using std::experimental::make_observer;
 
-    requests[req_id] = std::move(req);
+    auto proc = static_cast<Process*>(nullptr);
 
-    return req_id;
+    if (this_scheduler and this_scheduler->run_queue.steal(proc)) {
+        return make_observer(proc);
+    }
+
+    {
+        std::lock_guard<std::mutex> lck{run_queue_mtx};
+        if (not run_queue.empty()) {
+            auto p = run_queue.front();
+            run_queue.pop();
+            return p;
+        }
+    }
+
+    if (this_scheduler == nullptr or schedulers.size() < 2) {
+        return nullptr;
+    }
+
+    /*
+     * Start at a random victim to avoid every idle scheduler hammering the
+     * same queue, and then try everyone else once.
+     */
+    auto const n     = schedulers.size();
+    auto const first = (this_scheduler->victim_rng() % n);
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto& victim = *schedulers[(first + i) % n];
+        if (&victim == this_scheduler) {
+            continue;
+        }
+        if (victim.run_queue.steal(proc)) {
+            return make_observer(proc);
+        }
+    }
+
+    return nullptr;
+}
+auto Core::push_ready(std::experimental::observer_ptr<Process> proc) -> void
+{
+    if (this_scheduler) {
+        this_scheduler->run_queue.push(proc.get());
+    } else {
+        std::lock_guard<std::mutex> lck{run_queue_mtx};
+        run_queue.push(proc);
+    }
+
+    ++work_announcements;
+    if (idle_schedulers.load() != 0) {
+        wake_idle_schedulers(false);
+    }
+}
+auto Core::work_announced() const -> uint64_t
+{
+    return work_announcements.load();
+}
+auto Core::wait_for_work(uint64_t const seen) -> void
+{
+    ++idle_schedulers;
+    {
+        std::unique_lock<std::mutex> lck{idle_schedulers_mtx};
+        idle_schedulers_cv.wait(lck, [this, seen]() -> bool {
+            return (work_announcements.load() != seen)
+                   or (live_processes.load() == 0) or aborted.load();
+        });
+    }
+    --idle_schedulers;
+}
+auto Core::wake_idle_schedulers(bool const all) -> void
+{
+    /*
+     * Taking the mutex (even for a moment) makes sure that a scheduler which
+     * is just about to go to sleep either sees the change, or is already
+     * waiting and gets the notification.
+     */
+    {
+        std::lock_guard<std::mutex> lck{idle_schedulers_mtx};
+    }
+    if (all) {
+        idle_schedulers_cv.notify_all();
+
+        /*
+         * Interrupt the scheduler waiting for I/O completions, if any, so it
+         * notices that the VM is shutting down.
+         */
+        if (io.completion_fd != -1) {
+            auto const one = uint64_t{1};
+            auto const written [[maybe_unused]] =
+                write(io.completion_fd, &one, sizeof(one));
+        }
+    } else {
+        idle_schedulers_cv.notify_one();
+    }
 }
 
 auto Core::find(pid_type const p) -> std::experimental::observer_ptr<Process>
 {
     using std::experimental::make_observer;
+    std::lock_guard<std::mutex> lck{flock_mtx};
     return flock.count(p) ? make_observer<Process>(flock.at(p).get()) : nullptr;
 }
 
@@ -91,14 +264,122 @@ auto Core::spawn(std::string mod_name, uint64_t const entry) -> pid_type
 
     auto const pid = pids.emit();
     auto proc      = std::make_unique<Process>(pid, this, mod);
-    proc->push_frame(256, (mod.ip_base + entry), nullptr);
+    proc->push_frame(
+        mod.frame_size_at(entry * sizeof(viua::arch::instruction_type)),
+        (mod.ip_base + entry),
+        nullptr);
+
+    auto const observer = std::experimental::make_observer<Process>(proc.get());
+    {
+        std::lock_guard<std::mutex> lck{flock_mtx};
+        flock.insert({pid, std::move(proc)});
+    }
 
-    run_queue.push(std::experimental::make_observer<Process>(proc.get()));
-    flock.insert({pid, std::move(proc)});
+    ++live_processes;
+    push_ready(observer);
 
     return pid;
 }
 
+auto Core::suspend(std::experimental::observer_ptr<Process> proc) -> void
+{
+    auto const id = *proc->awaited_io;
+    proc->awaited_io.reset();
+
+    /*
+     * Completions are reaped under the ring lock so holding it here
+     * guarantees that we either see the request completed, or the reaper sees
+     * the process parked. Either way, the wakeup is not lost.
+     */
+    std::lock_guard<std::mutex> lck{io.ring_mtx};
+    if (auto req = io.requests.find(id);
+        req != io.requests.end()
+        and req->second->status == IO_request::Status::In_flight) {
+        req->second->waiter.emplace(proc->pid);
+
+        std::lock_guard<std::mutex> slck{suspended_mtx};
+        suspended.insert({proc->pid, proc});
+        return;
+    }
+
+    push_ready(proc);
+}
+auto Core::poll_io() -> void
+{
+    /*
+     * Somebody else is already polling (or scheduling a request). There is no
+     * need to wait for them - any completions will be picked up by them or
+     * during the next quantum.
+     */
+    std::unique_lock<std::mutex> lck{io.ring_mtx, std::try_to_lock};
+    if (not lck.owns_lock()) {
+        return;
+    }
+
+    io.submit();
+
+    constexpr auto CQE_BATCH_SIZE = size_t{64};
+    auto cqes = std::array<io_uring_cqe*, CQE_BATCH_SIZE>{};
+
+    auto n = unsigned{0};
+    while ((n = io_uring_peek_batch_cqe(&io.ring, cqes.data(), cqes.size()))
+           > 0) {
+        for (auto i = unsigned{0}; i < n; ++i) {
+            auto const cqe = cqes[i];
+
+            auto req = io.requests.find(cqe->user_data);
+            if (req == io.requests.end()) {
+                continue;
+            }
+
+            auto& rd  = *req->second;
+            rd.result = cqe->res;
+            rd.status = (cqe->res < 0) ? IO_request::Status::Error
+                                       : IO_request::Status::Success;
+
+            if (rd.waiter.has_value()) {
+                std::lock_guard<std::mutex> slck{suspended_mtx};
+                if (auto p = suspended.find(*rd.waiter); p != suspended.end()) {
+                    push_ready(p->second);
+                    suspended.erase(p);
+                }
+                rd.waiter.reset();
+            }
+        }
+
+        io_uring_cq_advance(&io.ring, n);
+        io.in_flight -= n;
+    }
+}
+auto Core::wait_for_io() -> void
+{
+    {
+        std::lock_guard<std::mutex> lck{io.ring_mtx};
+        io.submit();
+    }
+
+    /*
+     * Drain the eventfd before checking the completion queue so that
+     * a completion posted in between is not missed: it either is already in
+     * the queue, or signals the eventfd again. The timeout only matters if
+     * the eventfd could not be registered, or if the requests in flight are
+     * never completed.
+     */
+    constexpr auto WAIT_TIMEOUT_MS = 10;
+    if (io.completion_fd != -1) {
+        auto counter = uint64_t{};
+        auto const drained [[maybe_unused]] =
+            read(io.completion_fd, &counter, sizeof(counter));
+    }
+    if (io_uring_cq_ready(&io.ring) == 0 and not aborted
+        and live_processes != 0) {
+        auto pfd = pollfd{io.completion_fd, POLLIN, 0};
+        poll(&pfd, 1, WAIT_TIMEOUT_MS);
+    }
+
+    poll_io();
+}
+
 auto Register::as_memory() const -> undefined_type
 {
     if (std::holds_alternative<undefined_type>(value)) {
@@ -136,48 +417,107 @@ auto Register::as_memory() const -> undefined_type
     return raw;
 }
 
+Memory::Memory()
+{
+    auto const p = mmap(nullptr,
+                        size,
+                        (PROT_READ | PROT_WRITE),
+                        (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE),
+                        -1,
+                        0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc{};
+    }
+    segment = static_cast<uint8_t*>(p);
+}
+Memory::~Memory()
+{
+    munmap(segment, size);
+}
+
 auto Process::memory_at(size_t const ptr) -> uint8_t*
 {
-    if (ptr < stack_break) {
+    if (ptr < stack_break or ptr > MEM_FIRST_STACK_BREAK) {
         return nullptr;
     }
+    return memory.at(ptr);
+}
+namespace {
+template<typename Table>
+auto pointer_slot(Table& table, Pointer_table::id_type const id)
+{
+    return std::lower_bound(
+        table.begin(), table.end(), id, [](Pointer const& p, auto const i) {
+            return p.id() > i;
+        });
+}
+}  // namespace
+auto Pointer_table::record(Pointer const ptr) -> void
+{
+    auto& table = (ptr.foreign ? foreign : local);
 
-    auto const offset = (MEM_FIRST_STACK_BREAK - ptr);
-    if (offset >= (MEM_PAGE_SIZE * memory.size())) {
-        return nullptr;
+    /*
+     * Fast path: a fresh allocation is always below everything else that was
+     * allocated on the stack.
+     */
+    if (table.empty() or table.back().id() > ptr.id()) {
+        table.push_back(ptr);
+        return;
     }
 
-    auto& page = memory.front();
-    return (page.data() + page.size() - 1) - offset;
+    if (auto slot = pointer_slot(table, ptr.id());
+        slot != table.end() and slot->id() == ptr.id()) {
+        *slot = ptr;
+    } else {
+        table.insert(slot, ptr);
+    }
 }
+auto Pointer_table::forget(Pointer const ptr) -> void
+{
+    auto& table = (ptr.foreign ? foreign : local);
+    if (auto slot = pointer_slot(table, ptr.id());
+        slot != table.end() and slot->id() == ptr.id()) {
+        table.erase(slot);
+    }
+}
+auto Pointer_table::find(id_type const id) const -> Pointer const*
+{
+    for (auto const table : {&local, &foreign}) {
+        if (auto slot = pointer_slot(*table, id);
+            slot != table->end() and slot->id() == id) {
+            return &*slot;
+        }
+    }
+    return nullptr;
+}
+auto Pointer_table::prune(uint64_t const stack_break) -> void
+{
+    /*
+     * Forget all pointers whose base is below the current stack break. They
+     * are invalid because they point to deallocated memory.
+     */
+    while ((not local.empty()) and local.back().ptr < stack_break) {
+        local.pop_back();
+    }
+}
+
 auto Process::record_pointer(Pointer ptr) -> void
 {
-    pointers[ptr.id()] = ptr;
+    pointers.record(ptr);
 }
 auto Process::forget_pointer(Pointer ptr) -> void
 {
-    pointers.erase(ptr.id());
+    pointers.forget(ptr);
 }
 auto Process::get_pointer(uint64_t addr) const -> std::optional<Pointer>
 {
-    if (pointers.contains(addr)) {
-        return pointers.at(addr);
+    if (auto const p = pointers.find(addr); p) {
+        return *p;
     }
     return std::nullopt;
 }
 auto Process::prune_pointers() -> void
 {
-    auto tmp = decltype(pointers){};
-    for (auto& [k, v] : pointers) {
-        /*
-         * Forget all pointers whose base is greater than current stack
-         * break. They are invalid because they point to deallocated memory.
-         */
-        if ((not v.foreign) and v.ptr < stack_break) {
-            continue;
-        }
-        tmp[k] = v;
-    }
-    pointers = std::move(tmp);
+    pointers.prune(stack_break);
 }
 }  // namespace viua::vm
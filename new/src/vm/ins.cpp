@@ -25,17 +25,20 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <viua/arch/arch.h>
+#include <viua/arch/ops.h>
 #include <viua/support/fdstream.h>
 #include <viua/vm/ins.h>
 
 
 namespace viua {
-extern viua::support::fdstream TRACE_STREAM;
+extern thread_local viua::support::fdstream TRACE_STREAM;
 }
 
 namespace viua::vm::ins {
@@ -71,6 +74,9 @@ auto execute(viua::vm::Stack& stack,
     case OPCODE_T::OP:                       \
         execute(OP{instruction}, stack, ip); \
         break
+#define Flow(OP)       \
+    case OPCODE_T::OP: \
+        return execute(OP{instruction}, stack, ip)
             Work(ADD);
             Work(SUB);
             Work(MUL);
@@ -91,10 +97,16 @@ auto execute(viua::vm::Stack& stack,
             Work(AND);
             Work(OR);
             Work(IO_SUBMIT);
-            Work(IO_WAIT);
+            /*
+             * Wait is a special instruction. If the request is not complete
+             * yet it leaves the IP where it is so that the instruction is
+             * executed again after the process is woken up.
+             */
+            Flow(IO_WAIT);
             Work(IO_SHUTDOWN);
             Work(IO_CTL);
 #undef Work
+#undef Flow
         }
         break;
     }
@@ -941,19 +953,16 @@ auto execute(ATOM const op, Stack& stack, ip_type const) -> void
     if (not data_offset.has_value()) {
         throw abort_execution{stack, "invalid operand for atom constructor"};
     }
-    auto const data_size = [&strtab, data_offset]() -> uint64_t {
-        auto const size_offset = (*data_offset - sizeof(uint64_t));
-        auto tmp               = uint64_t{};
-        memcpy(&tmp, &strtab[size_offset], sizeof(uint64_t));
-        return le64toh(tmp);
-    }();
 
-    auto const data_address =
-        reinterpret_cast<char const*>(&strtab[0] + *data_offset);
-    auto const key         = reinterpret_cast<uint64_t>(data_address);
-    auto value             = std::string{data_address, data_size};
-    stack.proc->atoms[key] = std::move(value);
-    target                 = register_type::atom_type{key};
+    /*
+     * Atoms are instantiated when the module is loaded so the only thing left
+     * to do is to check if the offset really points to one.
+     */
+    auto const key = (reinterpret_cast<uint64_t>(strtab.data()) + *data_offset);
+    if (not stack.proc->module.atoms.contains(key)) {
+        throw abort_execution{stack, "invalid operand for atom constructor"};
+    }
+    target = register_type::atom_type{key};
 }
 
 auto execute(FRAME const op, Stack& stack, ip_type const) -> void
@@ -1015,8 +1024,7 @@ auto execute(CALL const op, Stack& stack, ip_type const) -> ip_type
     auto const fr_entry  = (stack.proc->module.ip_base
                            + (fn_addr / sizeof(viua::arch::instruction_type)));
 
-    stack.frames.emplace_back(
-        viua::arch::MAX_REGISTER_INDEX, fr_entry, fr_return);
+    stack.push(stack.proc->module.frame_size_at(fn_addr), fr_entry, fr_return);
     stack.frames.back().parameters = std::move(stack.args);
     stack.frames.back().result_to  = op.instruction.out;
 
@@ -1034,8 +1042,7 @@ auto execute(CALL const op, Stack& stack, ip_type const) -> ip_type
 
 auto execute(RETURN const op, Stack& stack, ip_type const) -> ip_type
 {
-    auto fr = std::move(stack.frames.back());
-    stack.frames.pop_back();
+    auto fr = stack.pop();
 
     if (stack.frames.empty()) {
         return fr.return_address;
@@ -1062,6 +1069,8 @@ auto execute(RETURN const op, Stack& stack, ip_type const) -> ip_type
     stack.proc->stack_break   = stack.frames.back().saved.sbrk;
     stack.proc->prune_pointers();
 
+    stack.recycle(fr);
+
     return fr.return_address;
 }
 
@@ -1365,7 +1374,7 @@ auto execute(IO_SUBMIT const op, Stack& stack, ip_type const) -> void
     }
     }
 }
-auto execute(IO_WAIT const op, Stack& stack, ip_type const) -> void
+auto execute(IO_WAIT const op, Stack& stack, ip_type const ip) -> ip_type
 {
     auto dst = mutable_proxy(stack, op.instruction.out);
     auto req = mutable_proxy(stack, op.instruction.lhs);
@@ -1375,38 +1384,37 @@ auto execute(IO_WAIT const op, Stack& stack, ip_type const) -> void
     }
 
     auto const want_id = *req.get<uint64_t>();
-    if (stack.proc->core->io.requests.contains(want_id)) {
-        io_uring_cqe* cqe{};
-        do {
-            io_uring_wait_cqe(&stack.proc->core->io.ring, &cqe);
-
-            if (cqe->res == -1) {
-                stack.proc->core->io.requests[cqe->user_data]->status =
-                    IO_request::Status::Error;
-            } else {
-                auto& rd  = *stack.proc->core->io.requests[cqe->user_data];
-                rd.status = IO_request::Status::Success;
-
-                if (rd.opcode == IORING_OP_READ) {
-                    auto const size_ptr =
-                        stack.proc->memory_at(
-                            reinterpret_cast<uint64_t>(rd.req_ptr))
-                        + (sizeof(uint64_t) * 2);
-                    auto const buffer_size = htole64(cqe->res);
-                    memcpy(size_ptr, &buffer_size, sizeof(buffer_size));
-
-                    dst = register_type::pointer_type{
-                        reinterpret_cast<uint64_t>(rd.req_ptr)};
-                } else if (rd.opcode == IORING_OP_WRITE) {
-                    /* ignore */
-                }
-            }
 
-            io_uring_cqe_seen(&stack.proc->core->io.ring, cqe);
-        } while (cqe->user_data != want_id);
+    auto& io = stack.proc->core->io;
+    std::lock_guard<std::mutex> lck{io.ring_mtx};
+    if (auto r = io.requests.find(want_id); r != io.requests.end()) {
+        auto const& rd = *r->second;
+
+        /*
+         * Do not block the whole scheduler. Tell it to park this process
+         * until the completion is reaped, and try again when we are woken up.
+         */
+        if (rd.status == IO_request::Status::In_flight) {
+            stack.proc->awaited_io = want_id;
+            return ip;
+        }
+
+        if (rd.status == IO_request::Status::Success
+            and rd.opcode == IORING_OP_READ) {
+            auto const size_ptr =
+                stack.proc->memory_at(reinterpret_cast<uint64_t>(rd.req_ptr))
+                + (sizeof(uint64_t) * 2);
+            auto const buffer_size = htole64(static_cast<uint64_t>(rd.result));
+            memcpy(size_ptr, &buffer_size, sizeof(buffer_size));
+
+            dst = register_type::pointer_type{
+                reinterpret_cast<uint64_t>(rd.req_ptr)};
+        }
+
+        io.requests.erase(r);
     }
 
-    stack.proc->core->io.requests.erase(want_id);
+    return (ip + 1);
 }
 auto execute(IO_SHUTDOWN const, Stack&, ip_type const) -> void
 {}
@@ -1443,7 +1451,7 @@ auto execute(SELF const op, Stack& stack, ip_type const) -> void
 }
 
 auto dump_registers(std::vector<register_type> const& registers,
-                    Process::atoms_map_type const& atoms,
+                    Module::atoms_table_type const& atoms,
                     std::string_view const suffix) -> void
 {
     for (auto i = size_t{0}; i < registers.size(); ++i) {
@@ -1559,13 +1567,19 @@ auto print_backtrace(Stack const& stack, std::optional<size_t> const only_for)
         }
     }
 }
-auto dump_memory(std::vector<Page> const& memory) -> void
+auto dump_memory(Memory const& memory) -> void
 {
     viua::TRACE_STREAM << "  memory:" << viua::TRACE_STREAM.endl;
 
+    /*
+     * Always show at least one page, and then only as much as the process has
+     * ever used. The stack segment is far too big to be dumped whole.
+     */
+    auto const used  = std::max(memory.high_water, MEM_PAGE_SIZE);
+    auto const lines = ((used + MEM_LINE_SIZE - 1) / MEM_LINE_SIZE);
+
     viua::TRACE_STREAM << std::hex << std::setfill('0');
-    for (auto line = size_t{0}; line < (memory.front().size() / MEM_LINE_SIZE);
-         ++line) {
+    for (auto line = size_t{0}; line < lines; ++line) {
         viua::TRACE_STREAM << "    ";
         viua::TRACE_STREAM
             << std::setw(16)
@@ -1575,10 +1589,9 @@ auto dump_memory(std::vector<Page> const& memory) -> void
                 & 0x00000000000000ff)
             << "  ";
 
-        auto const& page = memory.front();
-        auto at          = [&page, line](size_t const n) -> uint8_t {
-            return *((page.data() + page.size() - 1)
-                     - (line * MEM_LINE_SIZE + n));
+        auto at = [&memory, line](size_t const n) -> uint8_t {
+            return *memory.at(MEM_FIRST_STACK_BREAK
+                              - (line * MEM_LINE_SIZE + n));
         };
         for (auto i = MEM_LINE_SIZE; i; --i) {
             viua::TRACE_STREAM << std::setw(2) << static_cast<int>(at(i - 1))
@@ -1596,7 +1609,7 @@ auto dump_globals(Stack const& stack) -> void
 {
     viua::TRACE_STREAM << "  globals:" << viua::TRACE_STREAM.endl;
 
-    auto const& atoms   = stack.proc->atoms;
+    auto const& atoms   = stack.proc->module.atoms;
     auto const& globals = stack.proc->globals;
 
     for (auto const& [key, each] : globals) {
@@ -1670,10 +1683,10 @@ auto execute(EBREAK const, Stack& stack, ip_type const) -> void
                      << "iu " << std::hex << std::setw(16) << std::setfill('0')
                      << sbrk << " " << std::dec << sbrk << '\n';
 
-        dump_registers(each.parameters, stack.proc->atoms, "p");
-        dump_registers(each.registers, stack.proc->atoms, "l");
+        dump_registers(each.parameters, stack.proc->module.atoms, "p");
+        dump_registers(each.registers, stack.proc->module.atoms, "l");
     }
-    dump_registers(stack.args, stack.proc->atoms, "a");
+    dump_registers(stack.args, stack.proc->module.atoms, "a");
 
     dump_memory(stack.proc->memory);
 
@@ -1712,9 +1725,12 @@ auto execute(GTL const op, Stack& stack, ip_type const) -> void
 
     auto& gt = stack.proc->globals;
     if (not gt.contains(key->key)) {
-        throw abort_execution{stack,
-                              ("key not present in globals table: "
-                               + stack.proc->atoms[key->key])};
+        auto const& atoms = stack.proc->module.atoms;
+        auto const name   = atoms.find(key->key);
+        throw abort_execution{
+            stack,
+            ("key not present in globals table: "
+             + std::string{(name == atoms.end()) ? "" : name->second})};
     }
 
     value = gt[key->key];
@@ -1829,3 +1845,304 @@ auto execute(AD const, Stack&, ip_type const) -> void
 auto execute(PTR const, Stack&, ip_type const) -> void
 {}
 }  // namespace viua::vm::ins
+
+/*
+ * Direct-threaded interpreter.
+ *
+ * When a module is loaded its .text is decoded once into a stream of
+ * Decoded_instruction entries (one for every instruction, so the IP can still
+ * be used to index it). Every entry carries the address of the code which
+ * implements its instruction in interpret(), and every instruction's code ends
+ * with a jump straight to the code of the next instruction. There is no
+ * central dispatch switch, and no decoding happens during execution.
+ *
+ * Labels-as-values are a GNU extension (supported by both GCC and Clang), so
+ * -Wpedantic must be silenced for this part of the file.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+/*
+ * Instructions with operands, as (format, kind, name). Work instructions always
+ * move the IP to the next instruction, flow instructions decide where it goes.
+ * NOOP and HALT are handled separately.
+ */
+#define VIUA_THREADED_INSTRUCTIONS(X) \
+    X(N, Work, EBREAK)                \
+    X(N, Work, ECALL)                 \
+    X(T, Work, ADD)                   \
+    X(T, Work, SUB)                   \
+    X(T, Work, MUL)                   \
+    X(T, Work, DIV)                   \
+    X(T, Work, MOD)                   \
+    X(T, Work, BITSHL)                \
+    X(T, Work, BITSHR)                \
+    X(T, Work, BITASHR)               \
+    X(T, Work, BITROL)                \
+    X(T, Work, BITROR)                \
+    X(T, Work, BITAND)                \
+    X(T, Work, BITOR)                 \
+    X(T, Work, BITXOR)                \
+    X(T, Work, EQ)                    \
+    X(T, Work, LT)                    \
+    X(T, Work, GT)                    \
+    X(T, Work, CMP)                   \
+    X(T, Work, AND)                   \
+    X(T, Work, OR)                    \
+    X(T, Work, IO_SUBMIT)             \
+    X(T, Flow, IO_WAIT)               \
+    X(T, Work, IO_SHUTDOWN)           \
+    X(T, Work, IO_CTL)                \
+    X(D, Flow, CALL)                  \
+    X(D, Work, BITNOT)                \
+    X(D, Work, NOT)                   \
+    X(D, Work, COPY)                  \
+    X(D, Work, MOVE)                  \
+    X(D, Work, SWAP)                  \
+    X(D, Flow, IF)                    \
+    X(D, Work, IO_PEEK)               \
+    X(D, Work, ACTOR)                 \
+    X(D, Work, GTS)                   \
+    X(D, Work, GTL)                   \
+    X(S, Work, FRAME)                 \
+    X(S, Flow, RETURN)                \
+    X(S, Work, ATOM)                  \
+    X(S, Work, DOUBLE)                \
+    X(S, Work, SELF)                  \
+    X(F, Work, LUI)                   \
+    X(F, Work, LUIU)                  \
+    X(F, Work, LLI)                   \
+    X(F, Work, FLOAT)                 \
+    X(E, Work, CAST)                  \
+    X(E, Work, ARODP)                 \
+    X(E, Work, ATXTP)                 \
+    X(R, Work, ADDI)                  \
+    X(R, Work, ADDIU)                 \
+    X(R, Work, SUBI)                  \
+    X(R, Work, SUBIU)                 \
+    X(R, Work, MULI)                  \
+    X(R, Work, MULIU)                 \
+    X(R, Work, DIVI)                  \
+    X(R, Work, DIVIU)                 \
+    X(M, Work, SM)                    \
+    X(M, Work, LM)                    \
+    X(M, Work, AA)                    \
+    X(M, Work, AD)                    \
+    X(M, Work, PTR)
+
+namespace viua::vm::ins {
+namespace {
+enum class Handler : size_t {
+#define Make_entry(FORMAT, KIND, OP) OP,
+    VIUA_THREADED_INSTRUCTIONS(Make_entry)
+#undef Make_entry
+    NOOP,
+    HALT,
+};
+
+/*
+ * Set by interpret() when it is called without a stack. Indexed by Handler.
+ */
+void* const* handlers_table = nullptr;
+
+template<typename Format> auto trace(Format const& instruction) -> void
+{
+    if constexpr (VIUA_TRACE_CYCLES) {
+        viua::TRACE_STREAM << "    " << instruction.to_string()
+                           << viua::TRACE_STREAM.endl;
+    }
+}
+template<> auto trace(viua::arch::ops::N const& instruction) -> void
+{
+    if constexpr (VIUA_TRACE_CYCLES) {
+        viua::TRACE_STREAM << "    "
+                           << viua::arch::ops::to_string(
+                                  instruction.opcode
+                                  & viua::arch::ops::OPCODE_MASK)
+                           << viua::TRACE_STREAM.endl;
+    }
+}
+
+auto interpret(Stack* const stack_ptr,
+               size_t const budget,
+               uint64_t& ops_executed) -> ip_type
+{
+    static void* const handlers[] = {
+#define Make_entry(FORMAT, KIND, OP) &&op_##OP,
+        VIUA_THREADED_INSTRUCTIONS(Make_entry)
+#undef Make_entry
+        &&op_NOOP,
+        &&op_HALT,
+    };
+    if (stack_ptr == nullptr) {
+        handlers_table = handlers;
+        return nullptr;
+    }
+
+    auto& stack         = *stack_ptr;
+    auto const& module  = stack.proc->module;
+    auto const ip_base  = module.ip_base;
+    auto const* decoded = module.decoded.data();
+    auto const* d       = decoded;
+    auto executed       = size_t{0};
+
+    /*
+     * Stop when the IP leaves .text, when the process has to wait for I/O, or
+     * when the budget runs out. Greedy bundles are never interrupted.
+     */
+#define Dispatch()                                             \
+    do {                                                       \
+        ++ops_executed;                                        \
+        ++executed;                                            \
+        if ((not module.ip_in_valid_range(stack.ip))           \
+            or stack.proc->awaited_io.has_value()) {           \
+            return stack.ip;                                   \
+        }                                                      \
+        if ((not d->greedy) and (executed >= budget)) {        \
+            return stack.ip;                                   \
+        }                                                      \
+        d = (decoded + (stack.ip - ip_base));                  \
+        goto* d->handler;                                      \
+    } while (false)
+
+    if ((not module.ip_in_valid_range(stack.ip))
+        or stack.proc->awaited_io.has_value()) {
+        return stack.ip;
+    }
+    d = (decoded + (stack.ip - ip_base));
+    goto* d->handler;
+
+#define Work(FORMAT, OP)                                       \
+    op_##OP:                                                   \
+    {                                                          \
+        auto const& instruction =                              \
+            std::get<viua::arch::ops::FORMAT>(d->operands);    \
+        trace(instruction);                                    \
+        auto const ip = stack.ip;                              \
+        execute(OP{instruction}, stack, ip);                   \
+        stack.ip = (ip + 1);                                   \
+    }                                                          \
+    Dispatch();
+#define Flow(FORMAT, OP)                                       \
+    op_##OP:                                                   \
+    {                                                          \
+        auto const& instruction =                              \
+            std::get<viua::arch::ops::FORMAT>(d->operands);    \
+        trace(instruction);                                    \
+        stack.ip = execute(OP{instruction}, stack, stack.ip);  \
+    }                                                          \
+    Dispatch();
+#define Make_handler(FORMAT, KIND, OP) KIND(FORMAT, OP)
+    VIUA_THREADED_INSTRUCTIONS(Make_handler)
+#undef Make_handler
+#undef Flow
+#undef Work
+
+op_NOOP:
+    trace(std::get<viua::arch::ops::N>(d->operands));
+    stack.ip += 1;
+    Dispatch();
+
+op_HALT:
+    trace(std::get<viua::arch::ops::N>(d->operands));
+    stack.ip = nullptr;
+    ++ops_executed;
+    return stack.ip;
+
+#undef Dispatch
+}
+}  // namespace
+
+auto run_threaded(Stack& stack, size_t const budget, uint64_t& ops_executed)
+    -> ip_type
+{
+    return interpret(&stack, budget, ops_executed);
+}
+}  // namespace viua::vm::ins
+
+#pragma GCC diagnostic pop
+
+namespace viua::vm {
+auto predecode(Module::text_type const& text) -> Module::decoded_type
+{
+    using viua::vm::ins::Handler;
+
+    if (viua::vm::ins::handlers_table == nullptr) {
+        auto unused = uint64_t{0};
+        viua::vm::ins::interpret(nullptr, 0, unused);
+    }
+    auto const handler_of = [](Handler const h) -> void* {
+        return viua::vm::ins::handlers_table[static_cast<size_t>(h)];
+    };
+
+    auto decoded = Module::decoded_type{};
+    decoded.reserve(text.size());
+
+    for (auto const raw : text) {
+        using viua::arch::ops::FORMAT;
+        using viua::arch::ops::OPCODE;
+
+        auto const opcode = static_cast<viua::arch::opcode_type>(
+            raw & viua::arch::ops::OPCODE_MASK);
+        auto const format =
+            static_cast<FORMAT>(opcode & viua::arch::ops::FORMAT_MASK);
+        auto const greedy = static_cast<bool>(raw & viua::arch::ops::GREEDY);
+
+        auto operands = Decoded_instruction::operands_type{
+            viua::arch::ops::N::decode(raw)};
+        switch (format) {
+            using namespace viua::arch::ops;
+        case FORMAT::N:
+            break;
+        case FORMAT::T:
+            operands.emplace<T>(T::decode(raw));
+            break;
+        case FORMAT::D:
+            operands.emplace<D>(D::decode(raw));
+            break;
+        case FORMAT::S:
+            operands.emplace<S>(S::decode(raw));
+            break;
+        case FORMAT::F:
+            operands.emplace<F>(F::decode(raw));
+            break;
+        case FORMAT::E:
+            operands.emplace<E>(E::decode(raw));
+            break;
+        case FORMAT::R:
+            operands.emplace<R>(R::decode(raw));
+            break;
+        case FORMAT::M:
+            operands.emplace<M>(M::decode(raw));
+            break;
+        }
+
+        /*
+         * Unknown opcodes are skipped, the same as the switch interpreter does.
+         * They are decoded as N so that tracing them works.
+         */
+        auto handler = handler_of(Handler::NOOP);
+        switch (static_cast<OPCODE>(opcode)) {
+        case OPCODE::NOOP:
+            break;
+        case OPCODE::HALT:
+            handler = handler_of(Handler::HALT);
+            break;
+#define Make_case(FORMAT, KIND, OP)        \
+    case OPCODE::OP:                       \
+        handler = handler_of(Handler::OP); \
+        break;
+            VIUA_THREADED_INSTRUCTIONS(Make_case)
+#undef Make_case
+        default:
+            operands.emplace<viua::arch::ops::N>(
+                viua::arch::ops::N::decode(raw));
+            break;
+        }
+
+        decoded.push_back(Decoded_instruction{handler, operands, greedy});
+    }
+
+    return decoded;
+}
+}  // namespace viua::vm
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <sstream>
 #include <utility>
 #include <vector>
 
@@ -35,7 +36,7 @@
 
 
 namespace viua {
-extern viua::support::fdstream TRACE_STREAM;
+extern thread_local viua::support::fdstream TRACE_STREAM;
 }
 
 namespace viua::vm::ins {
@@ -52,13 +53,20 @@ auto execute(AA const op, Stack& stack, ip_type const) -> void
         throw abort_execution{stack, "invalid operand type for aa instruction"};
     }
 
-    // FIXME Ensure that enough memory is available to satisfy both size and
-    // alignment request.
-    auto size = (*base * alignment);
+    auto& proc           = *stack.proc;
+    auto const available = (proc.stack_break - proc.memory.lowest_address());
+    if (*base > (available / alignment)) {
+        auto o = std::ostringstream{};
+        o << "stack overflow: cannot allocate " << *base << " * " << alignment
+          << " byte(s) with " << available << " byte(s) available";
+        throw abort_execution{stack, o.str()};
+    }
+    auto const size = (*base * alignment);
 
-    stack.proc->stack_break -= size;
-    stack.frames.back().saved.sbrk = stack.proc->stack_break;
-    auto const pointer_address     = stack.proc->stack_break;
+    proc.stack_break -= size;
+    proc.memory.grown_to(proc.stack_break);
+    stack.frames.back().saved.sbrk = proc.stack_break;
+    auto const pointer_address     = proc.stack_break;
 
     mutable_proxy(stack, op.instruction.out) =
         register_type::pointer_type{pointer_address};
@@ -68,7 +76,6 @@ auto execute(AA const op, Stack& stack, ip_type const) -> void
     pointer_info.size = size;
     stack.proc->record_pointer(pointer_info);
 
-    // FIXME check if there is enough memory to accomodate size
-    memset(stack.proc->memory_at(pointer_address), 0, size);
+    memset(proc.memory_at(pointer_address), 0, size);
 }
 }  // namespace viua::vm::ins
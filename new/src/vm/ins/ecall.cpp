@@ -35,7 +35,7 @@
 
 
 namespace viua {
-extern viua::support::fdstream TRACE_STREAM;
+extern thread_local viua::support::fdstream TRACE_STREAM;
 }
 
 namespace viua::vm::ins {
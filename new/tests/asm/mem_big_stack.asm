@@ -0,0 +1,16 @@
+.section ".text"
+
+.symbol [[entry_point]] main
+.label main
+    li $1.l, 128u
+    amda $1.l, $1.l, 0
+
+    li $2.l, 0x1122334455667788u
+    sd $2.l, $1.l, 0
+
+    li $3.l, 1016u
+    add $3.l, $1.l, $3.l
+    sd $2.l, $3.l, 0
+
+    ebreak
+    return
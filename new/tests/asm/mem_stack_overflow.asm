@@ -0,0 +1,7 @@
+.section ".text"
+
+.symbol [[entry_point]] main
+.label main
+    li $1.l, 0x200000u
+    amda $1.l, $1.l, 0
+    return
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throughput benchmark of the lexer.
+ *
+ * Generates a synthetic source file of the requested size (50 MB by default)
+ * made of functions using all kinds of lexemes, runs the lexer over it, and
+ * reports throughput in MB/s. Build without sanitisers or they will dominate
+ * the result:
+ *
+ *   $ make CXXFLAGS_SANITISER= bench-lexer
+ *   $ ./build/tests/bench/lexer 50
+ *
+ * The source is lexed in chunks of about 1 MB (cut at line boundaries) so
+ * that lexemes of the whole file do not have to fit in memory at the same
+ * time.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <viua/libs/lexer.h>
+
+
+namespace {
+auto make_source(size_t const target_size) -> std::string
+{
+    auto source = std::string{};
+    source.reserve(target_size + 4096);
+
+    for (auto i = size_t{0}; source.size() < target_size; ++i) {
+        auto const n = std::to_string(i);
+
+        source += "; function number " + n + "\n";
+        source += ".section \".rodata\"\n";
+        source += ".symbol greeting_" + n + "\n";
+        source += ".label greeting_" + n + "\n";
+        source += ".object string \"Hello, World! \\\"" + n + "\\\"\\n\"\n";
+        source += "\n";
+        source += ".section \".text\"\n";
+        source += ".symbol [[local]] fn_" + n + "\n";
+        source += ".label fn_" + n + "\n";
+        source += "    li $1, " + n + "u\n";
+        source += "    li $2, -0x" + n + "\n";
+        source += "    double $3, -" + n + ".25\n";
+        source += "    g.add $4.l, $1.l, $2.a\n";
+        source += "    atom $5, some_atom_" + n + "\n";
+        source += "    arodp $6, greeting_" + n + "\n";
+        source += "    frame $2.a\n";
+        source += "    copy $0.a, $5.l   # the argument\n";
+        source += "    call $7, other_function_" + n + "\n";
+        source += "    if $7, fn_" + n + "\n";
+        source += "    delete $7\n";
+        source += "    return void\n";
+        source += "\n";
+    }
+
+    return source;
+}
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    auto const megabytes = size_t{(argc > 1) ? std::stoul(argv[1]) : 50};
+    auto const source = make_source(megabytes * 1024 * 1024);
+
+    constexpr auto CHUNK_SIZE = size_t{1024 * 1024};
+
+    auto lexemes  = size_t{0};
+    auto const t0 = std::chrono::steady_clock::now();
+    for (auto offset = size_t{0}; offset < source.size();) {
+        auto const cut = std::min(offset + CHUNK_SIZE, source.size());
+        auto end       = source.find('\n', cut);
+        end            = ((end == std::string::npos) ? source.size() : end + 1);
+
+        auto const chunk =
+            std::string_view{source}.substr(offset, (end - offset));
+        lexemes += viua::libs::lexer::lex(chunk).size();
+
+        offset = end;
+    }
+    auto const t1 = std::chrono::steady_clock::now();
+
+    auto const seconds = std::chrono::duration<double>(t1 - t0).count();
+    auto const mb      = (static_cast<double>(source.size()) / (1024 * 1024));
+
+    std::cout << "lexed " << mb << " MB (" << lexemes << " lexemes) in "
+              << seconds << " s: " << (mb / seconds) << " MB/s\n";
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+; Microbenchmark of pointer bookkeeping.
+;
+; Every iteration calls a function which allocates memory on the stack, derives
+; a few pointers from the allocation, stores and loads through them, and
+; returns (which prunes the pointers). Compare the "approximate frequency"
+; reported by the VM before and after changing the pointer table. Build the VM
+; with VIUA_TRACE_CYCLES set to false, or the tracing will dominate the result.
+;
+;   $ ./build/tools/exec/asm -o pointers.o tests/bench/pointers.asm
+;   $ ./build/tools/exec/ld -o pointers.elf pointers.o
+;   $ VIUA_VM_PROC_SCHEDULERS=1 ./build/tools/exec/vm pointers.elf
+
+.section ".text"
+
+.symbol [[entry_point]] main
+.label main
+    ; Keep some pointers alive in the outer frame so that the table is not
+    ; trivially small.
+    li $1, 4u
+    amda $1.l, $1.l, 0
+    li $2, 8u
+    add $2.l, $1.l, $2.l
+    li $3, 16u
+    add $3.l, $1.l, $3.l
+    li $4, 24u
+    add $4.l, $1.l, $4.l
+
+    li $5, 0u
+    li $6, 20000u
+.label "main::loop"
+    eq $7.l, $5.l, $6.l
+    if $7.l, "main::end"
+    call void, "work"
+    addi $5.l, $5.l, 1u
+    if void, "main::loop"
+.label "main::end"
+    return
+
+.symbol "work"
+.label "work"
+    li $1, 2u
+    amda $1.l, $1.l, 0
+    li $2, 8u
+    add $2.l, $1.l, $2.l
+
+    li $3, 42u
+    sd $3.l, $1.l, 0
+    sd $3.l, $2.l, 0
+    ld $4.l, $1.l, 0
+    ld $5.l, $2.l, 0
+
+    li $1, 2u
+    amda $1.l, $1.l, 0
+    li $2, 8u
+    add $2.l, $1.l, $2.l
+    sd $3.l, $1.l, 0
+    sd $3.l, $2.l, 0
+    ld $4.l, $1.l, 0
+    ld $5.l, $2.l, 0
+    return
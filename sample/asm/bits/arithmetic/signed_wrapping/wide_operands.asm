@@ -0,0 +1,43 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: main/0
+    allocate_registers %5 local
+
+    ; Operands wider than a machine word, so that carries, borrows, and partial
+    ; products have to cross word boundaries.
+    bits (.name: %iota lhs) local 0b000000001111111111111111111111111111111111111111111111111111111111111111
+    bits (.name: %iota rhs) local 0b000000000000000000000000000000000000000000000000000000000000000000000001
+    bits (.name: %iota factor) local 0b000000010000000000000000000000000000000000000000000000000000000000000000
+
+    wrapadd (.name: %iota result) local %lhs local %rhs local
+    print %result local
+
+    wrapsub %result local %result local %rhs local
+    print %result local
+
+    wrapmul %result local %result local %factor local
+    print %result local
+
+    wrapdiv %result local %result local %factor local
+    print %result local
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,39 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: main/0
+    allocate_registers %5 local
+
+    bits (.name: %iota original) local 0b10000000
+
+    copy (.name: %iota set) local %original local
+    integer (.name: %iota index) local 0
+    bitset %set local %index local true
+
+    copy (.name: %iota incremented) local %original local
+    wrapincrement %incremented local
+    wrapincrement %incremented local
+
+    print %original local
+    print %set local
+    print %incremented local
+
+    izero %0 local
+    return
+.end
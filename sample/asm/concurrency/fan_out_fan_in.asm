@@ -0,0 +1,92 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: worker/1
+    allocate_registers %2 local
+
+    .name: %iota n
+    move %n local %0 parameters
+    add %0 local %n local %n local
+    return
+.end
+
+.function: fan_out/1
+    allocate_registers %4 local
+
+    .name: %iota limit
+    .name: %iota pids
+    .name: %iota pid
+    move %limit local %0 parameters
+    vector %pids local
+
+    ; spawn "limit" workers and collect their PIDs
+    .mark: loop
+    if %limit local +1 done
+    frame ^[(copy %0 arguments %limit local)]
+    process %pid local worker/1
+    vpush %pids local %pid local
+    idec %limit local
+    jump loop
+
+    .mark: done
+    move %0 local %pids local
+    return
+.end
+
+.function: fan_in/1
+    allocate_registers %6 local
+
+    .name: %iota pids
+    .name: %iota sum
+    .name: %iota pid
+    .name: %iota result
+    .name: %iota length
+    move %pids local %0 parameters
+    izero %sum local
+
+    ; join the workers and add up their results
+    .mark: loop
+    if (vlen %length local %pids local) local +1 done
+    vpop %pid local %pids local
+    join %result local %pid local
+    add %sum local %sum local %result local
+    jump loop
+
+    .mark: done
+    move %0 local %sum local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+
+    .name: %iota pids
+    .name: %iota sum
+
+    ; every worker returns its number doubled so the expected sum is
+    ; 2 * (1 + 2 + ... + 64) = 4160
+    frame ^[(move %0 arguments (integer %pids local 64) local)]
+    call %pids local fan_out/1
+
+    frame ^[(move %0 arguments %pids local)]
+    print (call %sum local fan_in/1) local
+
+    izero %0 local
+    return
+.end
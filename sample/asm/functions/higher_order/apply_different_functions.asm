@@ -0,0 +1,68 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: square/1
+    allocate_registers %2 local
+
+    mul %0 local (move %1 local %0 parameters) %1 local
+    return
+.end
+
+.function: increment/1
+    allocate_registers %1 local
+
+    move %0 local %0 parameters
+    iinc %0 local
+    return
+.end
+
+.function: apply/2
+    ; the same call site calls whatever function it is given so it must not
+    ; keep calling the first one it saw
+    allocate_registers %4 local
+
+    .name: 1 func
+    .name: 2 parameter
+
+    frame ^[(move %0 arguments (move %parameter local %1 parameters) local)]
+    call %3 local (move %func local %0 parameters) local
+
+    move %0 local %3 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+
+    integer %1 local 5
+    function %2 local square/1
+    function %3 local increment/1
+
+    frame ^[(copy %0 arguments %2 local) (copy %1 arguments %1 local)]
+    print (call %4 local apply/2) local
+
+    frame ^[(copy %0 arguments %3 local) (copy %1 arguments %1 local)]
+    print (call %4 local apply/2) local
+
+    frame ^[(copy %0 arguments %2 local) (copy %1 arguments %1 local)]
+    print (call %4 local apply/2) local
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,45 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: main/0
+    allocate_registers %6 local
+
+    integer %1 local 0
+    integer %2 local 10
+
+    ; taking a pointer boxes the integer, which must then be incremented in
+    ; place for the pointer to stay valid
+    ptr %3 local %1 local
+.mark: loop
+    if (gte %4 local %1 local %2 local) local end +1
+    iinc *3 local
+    jump loop
+.mark: end
+    print %1 local
+    print (ptrlive %5 local %3 local) local
+
+    ; arithmetic replaces the value in the target register so the pointer
+    ; expires
+    add %1 local %1 local %2 local
+    print %1 local
+    print (ptrlive %5 local %3 local) local
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,57 @@
+;
+;   Copyright (C) 2018 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+; Standard input is an empty, non-blocking pipe so the read fails with EAGAIN
+; and the I/O worker waits for the descriptor to become readable. The read is
+; cancelled while the worker waits and must be reported as cancelled.
+
+.function: main/0
+    allocate_registers %5 local
+
+    integer %1 local 0
+    integer %2 local 42
+    io_read %3 local %1 local %2 local
+
+    try
+    catch "Exception" .block: timed_out
+        draw void local
+        leave
+    .end
+    enter .block: wait_for_the_poll
+        io_wait void %3 local 10ms
+        leave
+    .end
+
+    io_cancel %3 local
+
+    try
+    catch "IO_cancel" .block: cancelled
+        draw %4 local
+        print %4 local
+        leave
+    .end
+    enter .block: wait_for_the_cancellation
+        io_wait %4 local %3 local infinity
+        print %4 local
+        leave
+    .end
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,50 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: main/0
+    allocate_registers %5 local
+
+    struct (.name: %iota container) local
+
+    atom (.name: %iota key) local 'c'
+    integer (.name: %iota value) local 3
+    structinsert %container local %key local %value local
+
+    atom %key local 'a'
+    integer %value local 1
+    structinsert %container local %key local %value local
+
+    atom %key local 'b'
+    integer %value local 2
+    structinsert %container local %key local %value local
+
+    atom %key local 'a'
+    structremove void %container local %key local
+    print %container local
+
+    atom %key local 'c'
+    structat (.name: %iota field) local %container local %key local
+    print *field local
+
+    structkeys %value local %container local
+    print %value local
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,164 @@
+;
+;   Copyright (C) 2018 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+; Every struct gets a key no other struct has so the shared shapes would grow
+; without bound. Past a limit structs get shapes of their own, both when a key
+; is inserted and when one is removed, and they must behave the same way.
+
+.function: with_key/1
+    allocate_registers %5 local
+
+    struct (.name: %iota container) local
+    atom (.name: %iota common) local 'common'
+    move (.name: %iota distinct) local %0 parameters
+
+    structinsert %container local %common local (integer %4 local 1) local
+    structinsert %container local %distinct local (integer %4 local 2) local
+    structremove void %container local %common local
+    print %container local
+
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+
+    frame ^[(move %0 arguments (atom %1 local 'key_00') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_01') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_02') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_03') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_04') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_05') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_06') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_07') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_08') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_09') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_10') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_11') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_12') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_13') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_14') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_15') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_16') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_17') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_18') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_19') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_20') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_21') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_22') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_23') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_24') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_25') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_26') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_27') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_28') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_29') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_30') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_31') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_32') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_33') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_34') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_35') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_36') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_37') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_38') local)]
+    call void with_key/1
+
+    frame ^[(move %0 arguments (atom %1 local 'key_39') local)]
+    call void with_key/1
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,39 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: main/0
+    allocate_registers %9 local
+
+    ; long enough for code points to be looked up with the help of the index
+    text (.name: %iota long_text) local "Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. "
+    print (textlength %iota local %long_text local) local
+
+    integer (.name: %iota i) local 100
+    print (textat %iota local %long_text local %i local) local
+
+    integer %i local -2
+    print (textat %iota local %long_text local %i local) local
+
+    integer (.name: %iota first_index) local 61
+    integer (.name: %iota last_index) local 69
+    print (textsub %iota local %long_text local %first_index local %last_index local) local
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,127 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+; Bits benchmark. Runs the operations covered by the bits tests on bit strings
+; as wide as the first command line argument says, as many times as the second
+; argument says. Run it with scripts/bench_bits.sh to time it at several widths.
+;
+; Operands are chosen so that checked arithmetic does not overflow, and
+; quotients are small.
+
+.function: main/1
+    allocate_registers %16 local
+
+    .name: 1 argv
+    .name: 2 width
+    .name: 3 iterations
+    .name: 4 lhs
+    .name: 5 rhs
+    .name: 6 divisor
+    .name: 7 result
+    .name: 8 offset
+    .name: 9 i
+    .name: 10 done
+    .name: 11 index
+    .name: 12 limit
+    .name: 13 argument
+    .name: 14 negative
+    move %argv local %0 parameters
+
+    integer %index local 1
+    stoi %width local *(vat %argument local %argv local %index local) local
+    iinc %index local
+    stoi %iterations local *(vat %argument local %argv local %index local) local
+
+    ; The lowest quarter of the bits of the left-hand side operand is set.
+    bits %lhs local %width local
+    integer %limit local 4
+    div %limit local %width local %limit local
+    integer %index local 0
+    .mark: fill_lhs
+    lt %done local %index local %limit local
+    not %done local
+    if %done local filled_lhs
+    bitset %lhs local %index local true
+    iinc %index local
+    jump fill_lhs
+    .mark: filled_lhs
+
+    ; The right-hand side operand is 2, and the divisor is a quarter of the
+    ; left-hand side operand. Checked subtraction only accepts operands whose
+    ; difference has the same sign as the right-hand side one so -2 is
+    ; subtracted instead of 2.
+    bits %rhs local %width local
+    integer %index local 1
+    bitset %rhs local %index local true
+    bits %negative local %width local
+    wrapsub %negative local %negative local %rhs local
+    integer %offset local 2
+    copy %divisor local %lhs local
+    shr void %divisor local %offset local
+
+    copy %result local %lhs local
+    integer %i local 0
+    .mark: loop
+    lt %done local %i local %iterations local
+    not %done local
+    if %done local finished
+
+    wrapadd %result local %lhs local %rhs local
+    wrapsub %result local %lhs local %rhs local
+    wrapmul %result local %lhs local %rhs local
+    wrapdiv %result local %lhs local %divisor local
+
+    checkedsadd %result local %lhs local %rhs local
+    checkedssub %result local %lhs local %negative local
+    checkedsmul %result local %lhs local %rhs local
+    checkedsdiv %result local %lhs local %divisor local
+
+    saturatingsadd %result local %lhs local %rhs local
+    saturatingssub %result local %lhs local %negative local
+    saturatingsmul %result local %lhs local %rhs local
+    saturatingsdiv %result local %lhs local %divisor local
+
+    bitand %result local %lhs local %rhs local
+    bitor %result local %lhs local %rhs local
+    bitxor %result local %lhs local %rhs local
+    bitnot %result local %lhs local
+
+    copy %result local %lhs local
+    wrapincrement %result local
+    wrapdecrement %result local
+    checkedsincrement %result local
+    checkedsdecrement %result local
+    saturatingsincrement %result local
+    saturatingsdecrement %result local
+
+    shl void %result local %offset local
+    shr void %result local %offset local
+    ashl void %result local %offset local
+    ashr void %result local %offset local
+    rol %result local %offset local
+    ror %result local %offset local
+
+    iinc %i local
+    jump loop
+
+    .mark: finished
+    print %result local
+    izero %0 local
+    return
+.end
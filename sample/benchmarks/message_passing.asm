@@ -0,0 +1,85 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+; Message passing benchmark. Several producer processes flood the main process
+; with messages, and the main process receives all of them. Run it with
+; scripts/bench_message_passing.sh to get the number of messages per second.
+
+.function: producer/2
+    allocate_registers %6 local
+
+    .name: %1 consumer
+    .name: %2 messages
+    .name: %3 i
+    .name: %4 done
+    move %consumer local %0 parameters
+    move %messages local %1 parameters
+    integer %i local 0
+
+    .mark: loop
+    lt %done local %i local %messages local
+    not %done local
+    if %done local finished
+    send %consumer local (copy %5 local %i local) local
+    iinc %i local
+    jump loop
+
+    .mark: finished
+    return
+.end
+
+.function: main/1
+    allocate_registers %8 local
+
+    .name: %1 producers
+    .name: %2 messages
+    .name: %3 i
+    .name: %4 done
+    .name: %5 total
+    integer %producers local 8
+    integer %messages local 25000
+
+    integer %i local 0
+    .mark: spawn_loop
+    lt %done local %i local %producers local
+    not %done local
+    if %done local spawned
+    frame %2
+    move %0 arguments (self %6 local) local
+    copy %1 arguments %messages local
+    process void producer/2
+    iinc %i local
+    jump spawn_loop
+
+    .mark: spawned
+    mul %total local %producers local %messages local
+    integer %i local 0
+    .mark: receive_loop
+    lt %done local %i local %total local
+    not %done local
+    if %done local received
+    receive void infinity
+    iinc %i local
+    jump receive_loop
+
+    .mark: received
+    print %total local
+    izero %0 local
+    return
+.end
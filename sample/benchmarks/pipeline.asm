@@ -0,0 +1,111 @@
+;
+;   Copyright (C) 2023 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+; Pipeline benchmark. The main process pushes 64 KB frames through a chain of
+; five stages and waits for them to come out of the other end. Every stage
+; passes a copy of each frame to a function before forwarding it. Run it with
+; scripts/bench_pipeline.sh to get the number of frames per second.
+
+.function: inspect/1
+    allocate_registers %1 local
+    return
+.end
+
+.function: stage/2
+    allocate_registers %6 local
+
+    .name: %1 next
+    .name: %2 frames
+    .name: %3 i
+    .name: %4 done
+    .name: %5 payload
+    move %next local %0 parameters
+    move %frames local %1 parameters
+    integer %i local 0
+
+    .mark: loop
+    lt %done local %i local %frames local
+    not %done local
+    if %done local finished
+    receive %payload local infinity
+    frame %1
+    copy %0 arguments %payload local
+    call void inspect/1
+    send %next local %payload local
+    iinc %i local
+    jump loop
+
+    .mark: finished
+    return
+.end
+
+.function: main/0
+    allocate_registers %9 local
+
+    .name: %1 stages
+    .name: %2 frames
+    .name: %3 i
+    .name: %4 done
+    .name: %5 next
+    .name: %6 width
+    .name: %7 payload
+    .name: %8 copied
+    integer %stages local 5
+    integer %frames local 2000
+
+    self %next local
+    integer %i local 0
+    .mark: spawn_loop
+    lt %done local %i local %stages local
+    not %done local
+    if %done local spawned
+    frame %2
+    move %0 arguments %next local
+    copy %1 arguments %frames local
+    process %next local stage/2
+    iinc %i local
+    jump spawn_loop
+
+    .mark: spawned
+    integer %width local 524288
+    bits %payload local %width local
+    integer %i local 0
+    .mark: send_loop
+    lt %done local %i local %frames local
+    not %done local
+    if %done local sent
+    send %next local (copy %copied local %payload local) local
+    iinc %i local
+    jump send_loop
+
+    .mark: sent
+    integer %i local 0
+    .mark: receive_loop
+    lt %done local %i local %frames local
+    not %done local
+    if %done local received
+    receive void infinity
+    iinc %i local
+    jump receive_loop
+
+    .mark: received
+    print %frames local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,46 @@
+;
+;   Copyright (C) 2018 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: countdown/1
+    allocate_registers %2 local
+
+    move %1 local %0 parameters
+    if %1 local decrement increment
+
+    .mark: increment
+    iinc %1 local
+
+    .mark: decrement
+    idec %1 local
+    frame %1 arguments
+    move %0 arguments %1 local
+    call void countdown/1
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+
+    integer %1 local 10
+    frame %1 arguments
+    move %0 arguments %1 local
+    call void countdown/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,49 @@
+;
+;   Copyright (C) 2018 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: print_n/1
+    allocate_registers %5 local
+
+    integer %1 local 0
+    move %2 local %0 parameters
+    string %3 local "Hello World!"
+
+    .mark: loop
+    lt %4 local %1 local %2 local
+    if %4 local +1 done
+    print %3 local
+    delete %3 local
+    iinc %1 local
+    jump loop
+
+    .mark: done
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+
+    frame %1 arguments
+    integer %1 local 10
+    move %0 arguments %1 local
+    call void print_n/1
+
+    izero %0 local
+    return
+.end
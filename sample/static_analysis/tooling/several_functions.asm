@@ -0,0 +1,68 @@
+;
+;   Copyright (C) 2018 Marek Marecki
+;
+;   This file is part of Viua VM.
+;
+;   Viua VM is free software: you can redistribute it and/or modify
+;   it under the terms of the GNU General Public License as published by
+;   the Free Software Foundation, either version 3 of the License, or
+;   (at your option) any later version.
+;
+;   Viua VM is distributed in the hope that it will be useful,
+;   but WITHOUT ANY WARRANTY; without even the implied warranty of
+;   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;   GNU General Public License for more details.
+;
+;   You should have received a copy of the GNU General Public License
+;   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+;
+
+.function: answer/0
+    allocate_registers %1 local
+
+    integer %0 local 42
+    return
+.end
+
+.function: greet/1
+    allocate_registers %2 local
+
+    move %1 local %0 parameters
+    print %1 local
+    return
+.end
+
+.function: count/1
+    allocate_registers %4 local
+
+    move %1 local %0 parameters
+    integer %2 local 10
+
+    .mark: loop
+    lt %3 local %1 local %2 local
+    if %3 local +1 done
+    iinc %1 local
+    jump loop
+
+    .mark: done
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+
+    frame %0 arguments
+    call %1 local answer/0
+
+    frame %1 arguments
+    move %0 arguments %1 local
+    call void count/1
+
+    frame %1 arguments
+    string %1 local "Hello World!"
+    move %0 arguments %1 local
+    call void greet/1
+
+    izero %0 local
+    return
+.end
@@ -0,0 +1,46 @@
+#!/usr/bin/bash
+
+#
+#   Copyright (C) 2023 Marek Marecki
+#
+#   This file is part of Viua VM.
+#
+#   Viua VM is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Viua VM is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+set -e
+
+# Measure how long bits arithmetic and manipulation take at several widths.
+# Pass a different kernel binary as the first argument to compare builds, and
+# the number of iterations as the second.
+
+KERNEL=${1:-./build/bin/vm/kernel}
+ITERATIONS=${2:-1000}
+SOURCE=./sample/benchmarks/bits.asm
+BYTECODE=$(mktemp --suffix=.bc)
+trap "rm -f $BYTECODE" EXIT
+
+# Results of most operations are thrown away, which the static analyser
+# rejects.
+./build/bin/vm/asm --no-sa -o $BYTECODE $SOURCE
+
+for WIDTH in 64 256 4096; do
+    START=$(date +%s%N)
+    $KERNEL $BYTECODE $WIDTH $ITERATIONS > /dev/null
+    END=$(date +%s%N)
+
+    ELAPSED_US=$(( (END - START) / 1000 ))
+    echo "$WIDTH bits: $ITERATIONS iteration(s) in $(( ELAPSED_US / 1000 )) ms," \
+        "$(( ELAPSED_US / ITERATIONS )) us per iteration"
+done
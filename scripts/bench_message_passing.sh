@@ -0,0 +1,40 @@
+#!/usr/bin/bash
+
+#
+#   Copyright (C) 2023 Marek Marecki
+#
+#   This file is part of Viua VM.
+#
+#   Viua VM is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Viua VM is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+set -e
+
+# Measure how many messages per second the kernel delivers. Pass a different
+# kernel binary as the first argument to compare builds.
+
+KERNEL=${1:-./build/bin/vm/kernel}
+SOURCE=./sample/benchmarks/message_passing.asm
+BYTECODE=$(mktemp --suffix=.bc)
+trap "rm -f $BYTECODE" EXIT
+
+./build/bin/vm/asm -o $BYTECODE $SOURCE
+
+START=$(date +%s%N)
+MESSAGES=$($KERNEL $BYTECODE)
+END=$(date +%s%N)
+
+ELAPSED_US=$(( (END - START) / 1000 ))
+echo "delivered $MESSAGES message(s) in $(( ELAPSED_US / 1000 )) ms"
+echo "$(( MESSAGES * 1000000 / ELAPSED_US )) message(s) per second"
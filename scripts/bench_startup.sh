@@ -0,0 +1,63 @@
+#!/usr/bin/bash
+
+#
+#   Copyright (C) 2023 Marek Marecki
+#
+#   This file is part of Viua VM.
+#
+#   Viua VM is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Viua VM is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+set -e
+
+# Measure how long the kernel takes to start a program which imports many
+# modules. Pass a different kernel binary as the first argument to compare
+# builds, the number of modules as the second, and the number of functions in
+# each module as the third.
+
+KERNEL=${1:-./build/bin/vm/kernel}
+MODULES=${2:-100}
+FUNCTIONS=${3:-50}
+WORKDIR=$(mktemp -d)
+trap "rm -rf $WORKDIR" EXIT
+
+MAIN=$WORKDIR/main.asm
+echo '.function: main/0' > $MAIN
+echo '    allocate_registers %1 local' >> $MAIN
+
+for M in $(seq 1 $MODULES); do
+    MODULE=$WORKDIR/module_$M.asm
+    : > $MODULE
+    for F in $(seq 1 $FUNCTIONS); do
+        echo ".function: module_$M::function_$F/0" >> $MODULE
+        echo '    allocate_registers %1 local' >> $MODULE
+        echo '    return' >> $MODULE
+        echo '.end' >> $MODULE
+    done
+    ./build/bin/vm/asm --lib -o $WORKDIR/module_$M.module $MODULE
+    echo "    import module_$M" >> $MAIN
+done
+
+echo '    izero %0 local' >> $MAIN
+echo '    return' >> $MAIN
+echo '.end' >> $MAIN
+./build/bin/vm/asm -o $WORKDIR/main.bc $MAIN
+
+START=$(date +%s%N)
+VIUA_LIBRARY_PATH=$WORKDIR $KERNEL $WORKDIR/main.bc
+END=$(date +%s%N)
+
+ELAPSED_US=$(( (END - START) / 1000 ))
+echo "started with $MODULES module(s) of $FUNCTIONS function(s) in" \
+    "$(( ELAPSED_US / 1000 )) ms"
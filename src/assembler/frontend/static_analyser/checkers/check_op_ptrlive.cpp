@@ -45,8 +45,20 @@ auto check_op_ptrlive(Register_usage_profile& register_usage_profile,
     }
 
     check_use_of_register(register_usage_profile, *operand, "pointer from");
-    assert_type_of_register<Value_types::POINTER>(register_usage_profile,
-                                                  *operand);
+
+    /*
+     * Pointers to values of any type can be checked for liveness, so only
+     * registers which are not known to hold a pointer must be checked.
+     */
+    auto const holds_pointer =
+        register_usage_profile.defined(Register(*operand))
+        and static_cast<bool>(
+            register_usage_profile.at(Register(*operand)).second.value_type
+            & Value_types::POINTER);
+    if (not holds_pointer) {
+        assert_type_of_register<Value_types::POINTER>(register_usage_profile,
+                                                      *operand);
+    }
 
     auto val       = Register(*result);
     val.value_type = viua::internals::Value_types::BOOLEAN;
@@ -171,5 +171,12 @@ auto assembler::operands::hexadecimal_to_binary_literal(std::string const s)
     for (auto const c : s.substr(2)) {
         oss << lookup.at(c);
     }
-    return strip_leading_zeroes(oss.str());
+
+    /*
+     * Leading zeroes are kept, as they are in binary literals, because they
+     * set the width of the bits. Every hexadecimal digit is exactly four bits
+     * so the disassembler prints bits of any width as hexadecimal literals
+     * that are assembled back to the same width.
+     */
+    return oss.str();
 }
@@ -34,14 +34,13 @@ void viua::front::vm::initialise(viua::kernel::Kernel& kernel,
     }
 
     auto const bytes = loader.get_bytecode_size();
-    auto bytecode    = loader.get_bytecode();
+    auto bytecode    = loader.bytecode_image();
 
-    auto const function_address_mapping = loader.get_function_addresses();
-    for (auto const& p : function_address_mapping) {
-        kernel.mapfunction(p.first, p.second);
+    for (auto const& each : loader.functions_index()) {
+        kernel.mapfunction(std::string{each.name}, each.address);
     }
-    for (auto const& p : loader.get_block_addresses()) {
-        kernel.mapblock(p.first, p.second);
+    for (auto const& each : loader.blocks_index()) {
+        kernel.mapblock(std::string{each.name}, each.address);
     }
 
     kernel.commandline_arguments = args;
@@ -41,6 +41,7 @@ Frame::Frame(uint8_t const* const ra,
         , arguments{nullptr}
         , local_register_set{nullptr}
         , return_register{nullptr}
+        , jump_base{nullptr}
 {
     arguments = std::make_unique<viua::kernel::Register_set>(argsize);
 }
@@ -19,12 +19,15 @@
 
 #include <assert.h>
 #include <dlfcn.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include <chrono>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <regex>
 #include <vector>
 
@@ -55,31 +58,69 @@
 constexpr auto MAIN_MODULE = "<main>";
 
 
-viua::kernel::Mailbox::Mailbox(Mailbox&& that)
-        : messages(std::move(that.messages))
+viua::kernel::Mailbox::Mailbox() : head{new Node{}}, tail{head.load()}
 {}
+viua::kernel::Mailbox::~Mailbox()
+{
+    while (tail) {
+        auto const next = tail->next.load(std::memory_order_relaxed);
+        delete tail;
+        tail = next;
+    }
+}
 
 auto viua::kernel::Mailbox::send(std::unique_ptr<viua::types::Value> message)
-    -> void
+    -> viua::scheduler::Process_scheduler*
 {
-    std::unique_lock<std::mutex> lck{mailbox_mutex};
-    messages.push_back(std::move(message));
+    auto node     = new Node{};
+    node->message = std::move(message);
+
+    /*
+     * Linking the node and checking for a waiting receiver must not be
+     * reordered, or the receiver could miss both the message and the wake-up
+     * (see wake_up_on_send()).
+     */
+    auto const prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_seq_cst);
+
+    return waiting.exchange(nullptr, std::memory_order_seq_cst);
 }
 
 auto viua::kernel::Mailbox::receive(
     std::queue<std::unique_ptr<viua::types::Value>>& mq) -> void
 {
-    std::unique_lock<std::mutex> lck{mailbox_mutex};
-    for (auto& message : messages) {
-        mq.push(std::move(message));
+    auto received = false;
+    while (auto const next = tail->next.load(std::memory_order_acquire)) {
+        mq.push(std::move(next->message));
+        delete tail;
+        tail     = next;
+        received = true;
+    }
+
+    /*
+     * The receiver got what it was waiting for so there is no need to wake it
+     * up when the next message arrives.
+     */
+    if (received) {
+        waiting.store(nullptr, std::memory_order_relaxed);
     }
-    messages.clear();
 }
 
-auto viua::kernel::Mailbox::size() const -> decltype(messages)::size_type
+auto viua::kernel::Mailbox::wake_up_on_send(
+    viua::scheduler::Process_scheduler* scheduler) -> bool
 {
-    std::unique_lock<std::mutex> lck{mailbox_mutex};
-    return messages.size();
+    waiting.store(scheduler, std::memory_order_seq_cst);
+    return (tail->next.load(std::memory_order_seq_cst) == nullptr);
+}
+
+auto viua::kernel::Mailbox::size() const -> size_t
+{
+    auto n = size_t{0};
+    for (auto each = tail->next.load(std::memory_order_acquire); each;
+         each      = each->next.load(std::memory_order_acquire)) {
+        ++n;
+    }
+    return n;
 }
 
 
@@ -136,16 +177,15 @@ auto viua::kernel::Process_result::transfer_result()
 }
 
 
-viua::kernel::Kernel& viua::kernel::Kernel::load(std::unique_ptr<uint8_t[]> bc)
+viua::kernel::Kernel& viua::kernel::Kernel::load(Bytecode_image bc)
 {
     /*  Load bytecode into the viua::kernel::Kernel.
-     *  viua::kernel::Kernel becomes owner of loaded bytecode - meaning it will
-     * consider itself responsible for proper destruction of it, so make sure
-     * you have a copy of the bytecode.
+     *  viua::kernel::Kernel keeps the image (and the file it is mapped from)
+     * alive for as long as it runs.
      *
-     *  Any previously loaded bytecode is freed.
-     *  To free bytecode without loading anything new it is possible to call
-     * .load(nullptr).
+     *  Any previously loaded bytecode is released.
+     *  To release bytecode without loading anything new it is possible to call
+     * .load(Bytecode_image{}).
      */
     bytecode = std::move(bc);
     return (*this);
@@ -169,6 +209,7 @@ viua::kernel::Kernel& viua::kernel::Kernel::mapfunction(
     /** Maps function name to bytecode address.
      */
     function_addresses[name] = address;
+    ++link_generations;
     return (*this);
 }
 
@@ -190,6 +231,7 @@ viua::kernel::Kernel& viua::kernel::Kernel::register_external_function(
      */
     std::unique_lock<std::mutex> lock(foreign_functions_mutex);
     foreign_functions[name] = function_ptr;
+    ++link_generations;
     return (*this);
 }
 
@@ -230,26 +272,30 @@ void viua::kernel::Kernel::load_bytecode_module(
     Loader loader(module_path);
     loader.load();
 
-    std::unique_ptr<uint8_t[]> lnk_btcd{loader.get_bytecode()};
+    /*
+     * The module's code is executed in place, from the file mapped by the
+     * loader. Symbols are read straight from the mapped symbol maps.
+     */
+    auto lnk_btcd = loader.bytecode_image();
 
-    auto const fn_names = loader.get_functions();
-    auto const fn_addrs = loader.get_function_addresses();
-    for (auto const& fn_linkname : fn_names) {
-        linked_functions[fn_linkname] = std::pair<std::string, uint8_t*>(
-            module_name, (lnk_btcd.get() + fn_addrs.at(fn_linkname)));
+    for (auto const& fn : loader.functions_index()) {
+        linked_functions.insert_or_assign(
+            std::string{fn.name},
+            std::pair<std::string, uint8_t const*>(
+                module_name, (lnk_btcd.get() + fn.address)));
     }
 
-    auto const bl_names = loader.get_blocks();
-    auto const bl_addrs = loader.get_block_addresses();
-    for (auto const& bl_linkname : bl_names) {
-        linked_blocks[bl_linkname] = std::pair<std::string, uint8_t*>(
-            module_name, (lnk_btcd.get() + bl_addrs.at(bl_linkname)));
+    for (auto const& bl : loader.blocks_index()) {
+        linked_blocks.insert_or_assign(
+            std::string{bl.name},
+            std::pair<std::string, uint8_t const*>(
+                module_name, (lnk_btcd.get() + bl.address)));
     }
 
     linked_modules[std::string{module_name}] =
-        std::pair<viua::bytecode::codec::bytecode_size_type,
-                  std::unique_ptr<uint8_t[]>>(loader.get_bytecode_size(),
-                                              std::move(lnk_btcd));
+        std::pair<viua::bytecode::codec::bytecode_size_type, Bytecode_image>(
+            lnk_btcd.size(), std::move(lnk_btcd));
+    ++link_generations;
 }
 void viua::kernel::Kernel::load_native_module(
     std::string_view const module_name,
@@ -411,6 +457,11 @@ auto viua::kernel::Kernel::get_entry_point_of(std::string const& name) const
                                                               module_base);
 }
 
+auto viua::kernel::Kernel::link_generation() const -> uint64_t
+{
+    return link_generations.load(std::memory_order_acquire);
+}
+
 void viua::kernel::Kernel::request_foreign_function_call(
     std::unique_ptr<Frame> frame,
     viua::process::Process& requesting_process)
@@ -426,53 +477,98 @@ void viua::kernel::Kernel::request_foreign_function_call(
     foreign_call_queue_condition.notify_one();
 }
 
-auto viua::kernel::Kernel::steal_processes()
+auto viua::kernel::Kernel::steal_processes(
+    viua::scheduler::Process_scheduler* thief)
     -> std::vector<std::unique_ptr<viua::process::Process>>
 {
-    std::unique_lock<std::mutex> lock{process_spawned_mtx};
-
-    /*
-     * If any scheduler spawned a process recently, let's try to steal some work
-     * from it.
-     */
-    if (not process_spawned_by.empty()) {
-        auto sched = std::move(process_spawned_by.front());
-        process_spawned_by.pop_front();
-        return sched->give_up_processes();
+    auto stolen = std::vector<std::unique_ptr<viua::process::Process>>{};
+    if (process_schedulers.size() < 2) {
+        return stolen;
     }
 
     /*
-     * If no scheduler spawned a process recently, let's wait for a bit and
-     * check again.
+     * Start looking for work at a random victim so that idle schedulers do
+     * not all go after the same one. Take half of the victim's processes (but
+     * at least one) so the thief does not have to come back right away.
      */
-    auto const STEAL_WAIT_PERIOD = std::chrono::milliseconds{16};
-    process_spawned_cv.wait_for(lock, STEAL_WAIT_PERIOD);
+    thread_local auto random_victim = std::minstd_rand{
+        std::hash<std::thread::id>{}(std::this_thread::get_id())};
+    auto const n     = process_schedulers.size();
+    auto const start = (random_victim() % n);
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto& victim = *process_schedulers[(start + i) % n];
+        if (&victim == thief) {
+            continue;
+        }
 
-    /*
-     * Make sure that we don't accidentaly try to use empty std::queue.
-     */
-    if (not process_spawned_by.empty()) {
-        auto sched = std::move(process_spawned_by.front());
-        process_spawned_by.pop_front();
-        return sched->give_up_processes();
+        auto const limit = std::max(size_t{1}, (victim.stealable() / 2));
+        while (stolen.size() < limit) {
+            auto proc = victim.steal();
+            if (not proc) {
+                break;
+            }
+            stolen.push_back(std::move(proc));
+        }
+        if (not stolen.empty()) {
+            break;
+        }
     }
 
-    auto stolen = std::vector<std::unique_ptr<viua::process::Process>>{};
     return stolen;
 }
-auto viua::kernel::Kernel::notify_about_process_spawned(
-    viua::scheduler::Process_scheduler* sched) -> void
+auto viua::kernel::Kernel::work_announced() const -> uint64_t
+{
+    return work_announcements.load();
+}
+auto viua::kernel::Kernel::wait_for_work(uint64_t const seen) -> void
 {
+    ++idle_schedulers;
     {
-        std::unique_lock<std::mutex> lck{process_spawned_mtx};
-        process_spawned_by.push_back(sched);
+        std::unique_lock<std::mutex> lck{idle_schedulers_mtx};
+        idle_schedulers_cv.wait(lck, [this, seen]() -> bool {
+            return (work_announcements.load() != seen)
+                   or (running_processes.load() == 0);
+        });
     }
+    --idle_schedulers;
+}
+auto viua::kernel::Kernel::wake_idle_schedulers(bool const all) -> void
+{
+    /*
+     * Taking the mutex (even for a moment) makes sure that a scheduler which
+     * is just about to go to sleep either sees the change, or is already
+     * waiting and gets the notification.
+     */
+    {
+        std::lock_guard<std::mutex> lck{idle_schedulers_mtx};
+    }
+    if (all) {
+        idle_schedulers_cv.notify_all();
+    } else {
+        idle_schedulers_cv.notify_one();
+    }
+}
+auto viua::kernel::Kernel::notify_about_process_spawned(
+    viua::scheduler::Process_scheduler*) -> void
+{
     ++running_processes;
-    process_spawned_cv.notify_one();
+    ++work_announcements;
+    if (idle_schedulers.load() != 0) {
+        wake_idle_schedulers(false);
+    }
+}
+auto viua::kernel::Kernel::notify_about_process_woken() -> void
+{
+    ++work_announcements;
+    if (idle_schedulers.load() != 0) {
+        wake_idle_schedulers(false);
+    }
 }
 auto viua::kernel::Kernel::notify_about_process_death() -> void
 {
-    --running_processes;
+    if (--running_processes == 0) {
+        wake_idle_schedulers(true);
+    }
 }
 auto viua::kernel::Kernel::process_count() const -> size_t
 {
@@ -485,26 +581,48 @@ auto viua::kernel::Kernel::make_pid() -> viua::process::PID
     return viua::process::PID{pid_sequence.emit()};
 }
 
+auto viua::kernel::Kernel::mailbox_shard_of(const viua::process::PID pid)
+    -> Mailbox_shard&
+{
+    /*
+     * The sequential parts of a PID change with every process spawned so
+     * consecutive processes land in different shards.
+     */
+    auto const [base, big, small, n, m] = pid.get();
+    auto const h = (big ^ (uint64_t{small} << 16) ^ m) * 0x9e3779b97f4a7c15;
+    return mailbox_shards[(h >> 32) % MAILBOX_SHARDS];
+}
 auto viua::kernel::Kernel::create_mailbox(const viua::process::PID pid)
-    -> size_t
+    -> std::shared_ptr<Mailbox>
 {
-    std::unique_lock<std::mutex> lck(mailbox_mutex);
+    auto mailbox = std::make_shared<Mailbox>();
+    {
+        auto& shard = mailbox_shard_of(pid);
+        std::unique_lock<std::shared_mutex> lck{shard.mtx};
 #if VIUA_VM_DEBUG_LOG
-    std::cerr << "[kernel:mailbox:create] pid = " << pid.get() << std::endl;
+        std::cerr << "[kernel:mailbox:create] pid = " << pid.get() << std::endl;
 #endif
-    mailboxes.emplace(pid, Mailbox{});
-    return ++running_processes;
+        shard.mailboxes.emplace(pid, mailbox);
+    }
+    ++running_processes;
+    return mailbox;
 }
 auto viua::kernel::Kernel::delete_mailbox(const viua::process::PID pid)
     -> size_t
 {
-    std::unique_lock<std::mutex> lck(mailbox_mutex);
+    auto& shard = mailbox_shard_of(pid);
+    std::unique_lock<std::shared_mutex> lck{shard.mtx};
 #if VIUA_VM_DEBUG_LOG
     std::cerr << "[kernel:mailbox:delete] pid = " << pid.get()
-              << ", queued messages = " << mailboxes[pid].size() << std::endl;
+              << ", queued messages = " << shard.mailboxes.at(pid)->size()
+              << std::endl;
 #endif
-    mailboxes.erase(pid);
-    return --running_processes;
+    shard.mailboxes.erase(pid);
+    auto const left = --running_processes;
+    if (left == 0) {
+        wake_idle_schedulers(true);
+    }
+    return left;
 }
 auto viua::kernel::Kernel::create_result_slot_for(viua::process::PID pid)
     -> void
@@ -540,6 +658,18 @@ auto viua::kernel::Kernel::record_process_result(
         process_results.at(done_process->pid())
             .resolve(done_process->get_return_value());
     }
+
+    auto waiting = std::vector<Waiting_process>{};
+    auto const [first, last] = join_waiting.equal_range(done_process->pid());
+    for (auto each = first; each != last; ++each) {
+        waiting.push_back(each->second);
+    }
+    join_waiting.erase(first, last);
+    lck.unlock();
+
+    for (auto const& [scheduler, pid] : waiting) {
+        scheduler->wake(pid);
+    }
 }
 auto viua::kernel::Kernel::is_process_joinable(
     const viua::process::PID pid) const -> bool
@@ -575,40 +705,42 @@ auto viua::kernel::Kernel::transfer_result_of(const viua::process::PID pid)
     process_results.erase(pid);
     return tmp;
 }
+auto viua::kernel::Kernel::wake_up_on_stop(
+    const viua::process::PID pid,
+    viua::scheduler::Process_scheduler* scheduler,
+    const viua::process::PID waiting) -> bool
+{
+    std::unique_lock<std::mutex> lck{process_results_mutex};
+    if (process_results.at(pid).stopped()) {
+        return false;
+    }
+    join_waiting.emplace(pid, Waiting_process{scheduler, waiting});
+    return true;
+}
 
 void viua::kernel::Kernel::send(const viua::process::PID pid,
                                 std::unique_ptr<viua::types::Value> message)
 {
-    std::unique_lock<std::mutex> lck(mailbox_mutex);
-    if (mailboxes.count(pid) == 0) {
+    /*
+     * The shared lock is held while the message is enqueued so that the
+     * mailbox cannot be deleted under the sender's feet. Enqueueing never
+     * blocks so the lock is held only briefly.
+     */
+    auto& shard = mailbox_shard_of(pid);
+    std::shared_lock<std::shared_mutex> lck{shard.mtx};
+    auto const mailbox = shard.mailboxes.find(pid);
+    if (mailbox == shard.mailboxes.end()) {
         // sending a message to an unknown address just drops the message
         // instead of crashing the sending process
         return;
     }
 #if VIUA_VM_DEBUG_LOG
-    cerr << "[kernel:receive:send] pid = " << pid.get()
-         << ", queued messages = " << mailboxes[pid].size() << "+1" << endl;
+    cerr << "[kernel:receive:send] pid = " << pid.get() << endl;
 #endif
-    mailboxes[pid].send(std::move(message));
-}
-void viua::kernel::Kernel::receive(
-    const viua::process::PID pid,
-    std::queue<std::unique_ptr<viua::types::Value>>& message_queue)
-{
-    std::unique_lock<std::mutex> lck(mailbox_mutex);
-    if (mailboxes.count(pid) == 0) {
-        throw std::make_unique<viua::types::Exception>("invalid PID");
+    if (auto const waiting = mailbox->second->send(std::move(message));
+        waiting) {
+        waiting->wake(pid);
     }
-
-#if VIUA_VM_DEBUG_LOG
-    cerr << "[kernel:receive:pre] pid = " << pid.get()
-         << ", queued messages = " << message_queue.size() << endl;
-#endif
-    mailboxes[pid].receive(message_queue);
-#if VIUA_VM_DEBUG_LOG
-    cerr << "[kernel:receive:post] pid = " << pid.get()
-         << ", queued messages = " << message_queue.size() << endl;
-#endif
 }
 
 uint64_t viua::kernel::Kernel::pids() const
@@ -627,7 +759,7 @@ auto viua::kernel::Kernel::schedule_io(
         std::unique_lock<std::mutex> lck{io_request_mutex};
         io_request_queue.push_back(std::move(i));
     }
-    io_request_cv.notify_one();
+    eventfd_write(io_request_fd, 1);
 }
 auto viua::kernel::Kernel::cancel_io(
     std::tuple<uint64_t, uint64_t> const interaction_id) -> void
@@ -644,6 +776,7 @@ auto viua::kernel::Kernel::cancel_io(
     // after the process has waited for the request in question?
     if (io_requests.count(interaction_id)) {
         io_requests.at(interaction_id)->cancel();
+        eventfd_write(io_cancel_fd, 1);
     }
 }
 auto viua::kernel::Kernel::io_complete(
@@ -665,6 +798,30 @@ auto viua::kernel::Kernel::complete_io(
     }
     std::unique_lock<std::mutex> lck{io_result_mtx};
     io_results.insert({interaction_id, std::move(result)});
+
+    auto waiting = std::vector<Waiting_process>{};
+    auto const [first, last] = io_waiting.equal_range(interaction_id);
+    for (auto each = first; each != last; ++each) {
+        waiting.push_back(each->second);
+    }
+    io_waiting.erase(first, last);
+    lck.unlock();
+
+    for (auto const& [scheduler, pid] : waiting) {
+        scheduler->wake(pid);
+    }
+}
+auto viua::kernel::Kernel::wake_up_on_io(
+    std::tuple<uint64_t, uint64_t> const interaction_id,
+    viua::scheduler::Process_scheduler* scheduler,
+    const viua::process::PID waiting) -> bool
+{
+    std::unique_lock<std::mutex> lck{io_result_mtx};
+    if (io_results.count(interaction_id)) {
+        return false;
+    }
+    io_waiting.emplace(interaction_id, Waiting_process{scheduler, waiting});
+    return true;
 }
 auto viua::kernel::Kernel::io_result(
     std::tuple<uint64_t, uint64_t> const interaction_id)
@@ -678,7 +835,18 @@ auto viua::kernel::Kernel::io_result(
     if (result.is_successful) {
         return std::move(result.value);
     }
-    throw std::move(result.error);
+
+    /*
+     * Processes only catch exceptions so errors must be thrown as ones to be
+     * catchable by user code. Failed interactions report the error number; it
+     * is wrapped in an exception.
+     */
+    if (dynamic_cast<viua::types::Exception*>(result.error.get())) {
+        throw std::unique_ptr<viua::types::Exception>{
+            static_cast<viua::types::Exception*>(result.error.release())};
+    }
+    throw std::make_unique<viua::types::Exception>(
+        viua::types::Exception::Tag{"IO_error"}, std::move(result.error));
 }
 
 viua::kernel::Kernel::IO_result::IO_result(
@@ -735,6 +903,15 @@ auto viua::kernel::Kernel::no_of_io_schedulers() -> size_t
     return no_of_schedulers("VIUA_IO_SCHEDULERS",
                             static_cast<size_t>(default_value));
 }
+auto viua::kernel::Kernel::io_engine() -> std::string
+{
+    if (auto const env_text = getenv("VIUA_IO_ENGINE"); env_text != nullptr) {
+        if (auto const engine = std::string{env_text}; engine == "uring") {
+            return engine;
+        }
+    }
+    return "epoll";
+}
 auto viua::kernel::Kernel::is_tracing_enabled() -> bool
 {
     auto viua_enable_tracing = std::string{};
@@ -834,7 +1011,7 @@ int viua::kernel::Kernel::run()
 }
 
 viua::kernel::Kernel::Kernel()
-        : bytecode(nullptr)
+        : bytecode()
         , bytecode_size(0)
         , executable_offset(0)
         , return_code(0)
@@ -855,15 +1032,21 @@ viua::kernel::Kernel::Kernel()
             ("ffi." + std::to_string(ffi_schedulers_limit - i)).c_str());
     }
 
+    io_request_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    io_cancel_fd  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     auto const io_schedulers_limit = no_of_io_schedulers();
+    auto const io_scheduler = ((io_engine() == "uring")
+                                   ? viua::scheduler::io::io_uring_scheduler
+                                   : viua::scheduler::io::io_scheduler);
     for (auto i = io_schedulers_limit; i; --i) {
         io_workers.emplace_back(
-            std::make_unique<std::thread>(viua::scheduler::io::io_scheduler,
+            std::make_unique<std::thread>(io_scheduler,
                                           (io_schedulers_limit - i),
                                           std::ref(*this),
                                           std::ref(io_request_queue),
                                           std::ref(io_request_mutex),
-                                          std::ref(io_request_cv)));
+                                          io_request_fd,
+                                          io_cancel_fd));
     }
 }
 
@@ -908,13 +1091,15 @@ viua::kernel::Kernel::~Kernel()
                 io_request_queue.push_back(nullptr);
             }
         }
-        io_request_cv.notify_all();
+        eventfd_write(io_request_fd, io_workers.size());
         for (auto& each : io_workers) {
             if constexpr ((false)) {
                 std::cerr << "[kernel] waiting for I/O worker\n";
             }
             each->join();
         }
+        close(io_request_fd);
+        close(io_cancel_fd);
         if constexpr ((false)) {
             std::cerr << "[kernel] done with I/O shutdown\n";
         }
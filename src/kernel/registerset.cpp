@@ -23,43 +23,160 @@
 #include <string>
 
 #include <viua/kernel/registerset.h>
+#include <viua/types/boolean.h>
 #include <viua/types/exception.h>
+#include <viua/types/float.h>
 #include <viua/types/integer.h>
 #include <viua/types/reference.h>
 #include <viua/types/value.h>
 
 
+auto viua::kernel::Immediate::kind() const -> Kind
+{
+    return held;
+}
+auto viua::kernel::Immediate::is_number() const -> bool
+{
+    return (held == Kind::Integer or held == Kind::Float);
+}
+
+auto viua::kernel::Immediate::as_integer() const -> int64_t
+{
+    switch (held) {
+    case Kind::Integer:
+        return i;
+    case Kind::Float:
+        return static_cast<int64_t>(f);
+    case Kind::Boolean:
+    default:
+        return b;
+    }
+}
+auto viua::kernel::Immediate::as_float() const -> double
+{
+    switch (held) {
+    case Kind::Integer:
+        return static_cast<double>(i);
+    case Kind::Float:
+        return f;
+    case Kind::Boolean:
+    default:
+        return b;
+    }
+}
+auto viua::kernel::Immediate::boolean() const -> bool
+{
+    switch (held) {
+    case Kind::Integer:
+        return (i != 0);
+    case Kind::Float:
+        return (f != 0);
+    case Kind::Boolean:
+    default:
+        return b;
+    }
+}
+
+auto viua::kernel::Immediate::box() const -> std::unique_ptr<viua::types::Value>
+{
+    switch (held) {
+    case Kind::Integer:
+        return std::make_unique<viua::types::Integer>(i);
+    case Kind::Float:
+        return std::make_unique<viua::types::Float>(f);
+    case Kind::Boolean:
+    default:
+        return std::make_unique<viua::types::Boolean>(b);
+    }
+}
+auto viua::kernel::Immediate::unbox(viua::types::Value const* const v)
+    -> std::optional<Immediate>
+{
+    if (auto const x = dynamic_cast<viua::types::Integer const*>(v)) {
+        return Immediate{x->as_integer()};
+    }
+    if (auto const x = dynamic_cast<viua::types::Float const*>(v)) {
+        return Immediate{x->as_float()};
+    }
+    if (auto const x = dynamic_cast<viua::types::Boolean const*>(v)) {
+        return Immediate{x->boolean()};
+    }
+    return {};
+}
+
+viua::kernel::Immediate::Immediate(int64_t const x) : held{Kind::Integer}, i{x}
+{}
+viua::kernel::Immediate::Immediate(double const x) : held{Kind::Float}, f{x}
+{}
+viua::kernel::Immediate::Immediate(bool const x) : held{Kind::Boolean}, b{x}
+{}
+
+
+auto viua::kernel::Register::box() const -> void
+{
+    if (immediate) {
+        value = immediate->box();
+        immediate.reset();
+    }
+}
+
 void viua::kernel::Register::reset(std::unique_ptr<viua::types::Value> o)
 {
     if (auto ref = dynamic_cast<viua::types::Reference*>(value.get()); ref) {
         ref->rebind(o.release());
     } else {
         value = std::move(o);
+        immediate.reset();
+    }
+}
+auto viua::kernel::Register::reset(Immediate const x) -> void
+{
+    if (auto ref = dynamic_cast<viua::types::Reference*>(value.get()); ref) {
+        ref->rebind(x.box().release());
+    } else {
+        value.reset();
+        immediate = x;
     }
 }
 
 bool viua::kernel::Register::empty() const
 {
-    return value == nullptr;
+    return (value == nullptr and not immediate);
+}
+
+auto viua::kernel::Register::unboxed() const -> std::optional<Immediate>
+{
+    if (immediate) {
+        return immediate;
+    }
+    return Immediate::unbox(value.get());
+}
+auto viua::kernel::Register::holds_immediate() const -> bool
+{
+    return immediate.has_value();
 }
 
 auto viua::kernel::Register::get() -> viua::types::Value*
 {
+    box();
     return value.get();
 }
 auto viua::kernel::Register::get() const -> viua::types::Value const*
 {
+    box();
     return value.get();
 }
 
 viua::types::Value* viua::kernel::Register::release()
 {
+    box();
     mask = 0;
     return value.release();
 }
 
 std::unique_ptr<viua::types::Value> viua::kernel::Register::give()
 {
+    box();
     mask = 0;
     return std::move(value);
 }
@@ -67,6 +184,7 @@ std::unique_ptr<viua::types::Value> viua::kernel::Register::give()
 void viua::kernel::Register::swap(Register& that)
 {
     value.swap(that.value);
+    immediate.swap(that.immediate);
     // FIXME are masks still used?
     auto tmp  = mask;
     mask      = that.mask;
@@ -112,8 +230,11 @@ viua::kernel::Register::Register(std::unique_ptr<viua::types::Value> o)
 {}
 
 viua::kernel::Register::Register(Register&& that)
-        : value(std::move(that.value)), mask(that.mask)
+        : value(std::move(that.value))
+        , immediate(std::move(that.immediate))
+        , mask(that.mask)
 {
+    that.immediate.reset();
     that.mask = 0;
 }
 
@@ -124,7 +245,12 @@ viua::kernel::Register::operator bool() const
 
 auto viua::kernel::Register::operator=(Register&& that) -> Register&
 {
-    reset(std::move(that.value));
+    if (that.immediate) {
+        reset(*that.immediate);
+        that.immediate.reset();
+    } else {
+        reset(std::move(that.value));
+    }
     mask      = that.mask;
     that.mask = 0;
     return *this;
@@ -136,6 +262,12 @@ auto viua::kernel::Register::operator=(decltype(value)&& o) -> Register&
     mask = 0;
     return *this;
 }
+auto viua::kernel::Register::operator=(Immediate const x) -> Register&
+{
+    reset(x);
+    mask = 0;
+    return *this;
+}
 
 
 void viua::kernel::Register_set::put(size_type const index,
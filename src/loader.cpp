@@ -17,17 +17,18 @@
  *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <endian.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <array>
 #include <cstdint>
-#include <fstream>
-#include <iostream>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
-#include <tuple>
 #include <vector>
 
 #include <viua/bytecode/bytetypedef.h>
@@ -38,53 +39,155 @@
 using viua::util::memory::aligned_read;
 
 
-IdToAddressMapping Loader::loadmap(char* bytedump,
-                                   uint64_t const& bytedump_size)
+Mapped_file::Mapped_file(std::string const& path) : base(nullptr), length(0)
 {
-    auto order = std::vector<std::string>{};
-    std::map<std::string, uint64_t> mapping;
+    auto const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw("failed to open file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw("failed to open file: " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+
+    /*
+     * Empty files cannot be mapped. They are not valid modules either, but it
+     * is the loader's job to say what is wrong with them.
+     */
+    if (length) {
+        base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw("failed to map file: " + path);
+    }
+}
+Mapped_file::~Mapped_file()
+{
+    if (base) {
+        munmap(base, length);
+    }
+}
+auto Mapped_file::data() const -> uint8_t const*
+{
+    return static_cast<uint8_t const*>(base);
+}
+auto Mapped_file::size() const -> size_t
+{
+    return length;
+}
+
+
+Bytecode_image::Bytecode_image() : mapping{}, code{nullptr}, length{0}
+{}
+Bytecode_image::Bytecode_image(
+    std::shared_ptr<Mapped_file const> m,
+    uint8_t const* c,
+    viua::bytecode::codec::bytecode_size_type const n)
+        : mapping{std::move(m)}, code{c}, length{n}
+{}
+auto Bytecode_image::get() const -> uint8_t const*
+{
+    return code;
+}
+auto Bytecode_image::size() const -> viua::bytecode::codec::bytecode_size_type
+{
+    return length;
+}
+Bytecode_image::operator bool() const
+{
+    return (code != nullptr);
+}
 
-    char* lib_function_ids_map = bytedump;
 
-    long unsigned i  = 0;
-    auto lib_fn_name = std::string{};
-    uint64_t lib_fn_address;
-    while (i < bytedump_size) {
-        lib_fn_name = std::string(lib_function_ids_map);
-        i += lib_fn_name.size() + 1;  // one for null character
-        aligned_read(lib_fn_address) = (bytedump + i);
-        i += sizeof(decltype(lib_fn_address));
-        lib_function_ids_map = bytedump + i;
-        mapping[lib_fn_name] = lib_fn_address;
-        order.emplace_back(lib_fn_name);
+auto Loader::take(uint64_t const n) -> uint8_t const*
+{
+    if (n > static_cast<uint64_t>(end - cursor)) {
+        throw("truncated file: " + path);
     }
+    auto const taken = cursor;
+    cursor += n;
+    return taken;
+}
+auto Loader::take_size() -> uint64_t
+{
+    auto n = uint64_t{0};
+    aligned_read(n) = take(sizeof(n));
+    return n;
+}
 
-    return IdToAddressMapping(order, mapping);
+/*
+ * Names in string sections are NUL-terminated, one after another.
+ */
+static auto next_string(char const* const section,
+                        uint64_t const section_size,
+                        uint64_t& i,
+                        std::string const& path) -> std::string_view
+{
+    auto const terminator = static_cast<char const*>(
+        std::memchr(section + i, '\0', section_size - i));
+    if (terminator == nullptr) {
+        throw("truncated file: " + path);
+    }
+    auto const s = std::string_view{
+        section + i, static_cast<size_t>(terminator - (section + i))};
+    i += (s.size() + 1);
+    return s;
 }
-void Loader::calculate_function_sizes()
+
+auto Loader::load_symbols() -> std::vector<Symbol>
 {
-    for (unsigned i = 0; i < functions.size(); ++i) {
-        std::string name = functions[i];
-        uint64_t el_size = 0;
+    auto const section_size = take_size();
+    auto const section = reinterpret_cast<char const*>(take(section_size));
 
-        if (i < (functions.size() - 1)) {
-            uint64_t a = function_addresses[name];
-            uint64_t b = function_addresses[functions[i + 1]];
-            el_size    = (b - a);
-        } else {
-            uint64_t a = function_addresses[name];
-            uint64_t b = size;
-            el_size    = (b - a);
+    auto symbols = std::vector<Symbol>{};
+    auto i       = uint64_t{0};
+    while (i < section_size) {
+        auto const name = next_string(section, section_size, i, path);
+
+        auto address = viua::bytecode::codec::bytecode_size_type{0};
+        if ((section_size - i) < sizeof(address)) {
+            throw("truncated file: " + path);
         }
+        aligned_read(address) = (section + i);
+        i += sizeof(address);
 
-        function_sizes[name] = el_size;
+        symbols.push_back(Symbol{name, address});
     }
+
+    return symbols;
 }
+auto Loader::load_strings() -> std::vector<std::string>
+{
+    auto const section_size = take_size();
+    auto const section = reinterpret_cast<char const*>(take(section_size));
+
+    auto strings_list = std::vector<std::string>{};
+    auto i            = uint64_t{0};
+    while (i < section_size) {
+        strings_list.emplace_back(next_string(section, section_size, i, path));
+    }
 
-void Loader::load_magic_number(std::ifstream& in)
+    return strings_list;
+}
+
+void Loader::map_file()
 {
-    std::array<char, 5> magic_number {};
-    in.read(magic_number.data(), magic_number.size());
+    mapping = std::make_shared<Mapped_file const>(path);
+    cursor  = mapping->data();
+    end     = (cursor + mapping->size());
+}
+
+void Loader::load_magic_number()
+{
+    std::array<char, 5> magic_number{};
+    std::memcpy(
+        magic_number.data(), take(magic_number.size()), magic_number.size());
     if (magic_number.back() != '\0') {
         throw "invalid magic number";
     }
@@ -94,11 +197,9 @@ void Loader::load_magic_number(std::ifstream& in)
     }
 }
 
-void Loader::assume_binary_type(std::ifstream& in,
-                                Viua_binary_type assumed_binary_type)
+void Loader::assume_binary_type(Viua_binary_type assumed_binary_type)
 {
-    char bt;
-    in.read(&bt, sizeof(decltype(bt)));
+    auto const bt = static_cast<char>(*take(1));
     if (bt != assumed_binary_type) {
         std::ostringstream error;
         error << "not a "
@@ -109,179 +210,99 @@ void Loader::assume_binary_type(std::ifstream& in,
     }
 }
 
-static std::map<std::string, std::string> load_meta_information_map(
-    std::ifstream& in)
+void Loader::load_meta_information()
 {
-    uint64_t meta_information_map_size = 0;
-    readinto(in, &meta_information_map_size);
-
-    auto meta_information_map_buffer =
-        std::make_unique<char[]>(meta_information_map_size);
-    in.read(meta_information_map_buffer.get(),
-            static_cast<std::streamsize>(meta_information_map_size));
-
-    std::map<std::string, std::string> meta_information_map;
-
-    char* buffer = meta_information_map_buffer.get();
-    uint64_t i   = 0;
-    std::string key, value;
-    while (i < meta_information_map_size) {
-        key = std::string(buffer + i);
-        i += (key.size() + 1);
-        value = std::string(buffer + i);
-        i += (value.size() + 1);
-        meta_information_map[key] = value;
+    auto const section_size = take_size();
+    auto const section = reinterpret_cast<char const*>(take(section_size));
+
+    auto i = uint64_t{0};
+    while (i < section_size) {
+        auto const key   = next_string(section, section_size, i, path);
+        auto const value = next_string(section, section_size, i, path);
+        meta_information[std::string{key}] = std::string{value};
     }
-
-    return meta_information_map;
 }
-void Loader::load_meta_information(std::ifstream& in)
-{
-    meta_information = load_meta_information_map(in);
-}
-
-static std::vector<std::string> load_string_list(std::ifstream& in)
-{
-    uint64_t signatures_section_size = 0;
-    readinto(in, &signatures_section_size);
-
-    auto signatures_section_buffer =
-        std::make_unique<char[]>(signatures_section_size);
-    in.read(signatures_section_buffer.get(),
-            static_cast<std::streamsize>(signatures_section_size));
-
-    uint64_t i        = 0;
-    char* buffer      = signatures_section_buffer.get();
-    auto sig          = std::string{};
-    auto strings_list = std::vector<std::string>{};
-    while (i < signatures_section_size) {
-        sig = std::string(buffer + i);
-        i += (sig.size() + 1);
-        strings_list.emplace_back(sig);
-    }
 
-    return strings_list;
-}
-void Loader::load_external_signatures(std::ifstream& in)
+void Loader::load_external_signatures()
 {
-    external_signatures = load_string_list(in);
+    external_signatures = load_strings();
 }
-void Loader::load_external_block_signatures(std::ifstream& in)
+void Loader::load_external_block_signatures()
 {
-    external_signatures_block = load_string_list(in);
+    external_signatures_block = load_strings();
 }
-auto Loader::load_dynamic_imports_section(std::ifstream& in) -> void
+auto Loader::load_dynamic_imports_section() -> void
 {
-    dynamic_linked_modules = load_string_list(in);
+    dynamic_linked_modules = load_strings();
 }
 
-void Loader::load_jump_table(std::ifstream& in)
+void Loader::load_jump_table()
 {
-    // load jump table
-    uint64_t lib_total_jumps;
-    readinto(in, &lib_total_jumps);
+    auto const lib_total_jumps = take_size();
+    auto const table = take(lib_total_jumps * sizeof(uint64_t));
 
-    uint64_t lib_jmp;
+    jumps.reserve(lib_total_jumps);
     for (uint64_t i = 0; i < lib_total_jumps; ++i) {
-        readinto(in, &lib_jmp);
+        uint64_t lib_jmp;
+        aligned_read(lib_jmp) = (table + (i * sizeof(uint64_t)));
         jumps.push_back(lib_jmp);
     }
 }
-void Loader::load_functions_map(std::ifstream& in)
+void Loader::load_functions_map()
 {
-    uint64_t lib_function_ids_section_size = 0;
-    readinto(in, &lib_function_ids_section_size);
-
-    auto lib_buffer_function_ids =
-        std::make_unique<char[]>(lib_function_ids_section_size);
-    in.read(lib_buffer_function_ids.get(),
-            static_cast<std::streamsize>(lib_function_ids_section_size));
-
-    auto order = std::vector<std::string>{};
-    std::map<std::string, uint64_t> mapping;
-
-    tie(order, mapping) =
-        loadmap(lib_buffer_function_ids.get(), lib_function_ids_section_size);
-
-    for (std::string p : order) {
-        functions.emplace_back(p);
-        function_addresses[p] = mapping[p];
-    }
+    function_symbols = load_symbols();
 }
-void Loader::load_blocks_map(std::ifstream& in)
+void Loader::load_blocks_map()
 {
-    uint64_t lib_block_ids_section_size = 0;
-    readinto(in, &lib_block_ids_section_size);
-
-    auto lib_buffer_block_ids =
-        std::make_unique<char[]>(lib_block_ids_section_size);
-    in.read(lib_buffer_block_ids.get(),
-            static_cast<std::streamsize>(lib_block_ids_section_size));
-
-    auto order = std::vector<std::string>{};
-    std::map<std::string, uint64_t> mapping;
-
-    tie(order, mapping) =
-        loadmap(lib_buffer_block_ids.get(), lib_block_ids_section_size);
-
-    for (std::string p : order) {
-        blocks.emplace_back(p);
-        block_addresses[p] = mapping[p];
-    }
+    block_symbols = load_symbols();
 }
-void Loader::load_bytecode(std::ifstream& in)
+void Loader::load_bytecode()
 {
-    in.read(reinterpret_cast<char*>(&size), sizeof(decltype(size)));
-    bytecode = std::make_unique<uint8_t[]>(size);
-    in.read(reinterpret_cast<char*>(bytecode.get()),
-            static_cast<std::streamsize>(size));
+    size     = take_size();
+    bytecode = take(size);
 }
 
 Loader& Loader::load()
 {
-    std::ifstream in(path, std::ios::in | std::ios::binary);
-    if (!in) {
-        throw("failed to open file: " + path);
-    }
+    map_file();
 
-    load_magic_number(in);
-    assume_binary_type(in, VIUA_LINKABLE);
+    load_magic_number();
+    assume_binary_type(VIUA_LINKABLE);
 
-    load_meta_information(in);
+    load_meta_information();
 
     // jump table must be loaded if loading a library
-    load_jump_table(in);
+    load_jump_table();
 
-    load_external_signatures(in);
-    load_external_block_signatures(in);
-    load_dynamic_imports_section(in);
-    load_blocks_map(in);
-    load_functions_map(in);
-    load_bytecode(in);
-    calculate_function_sizes();
+    load_external_signatures();
+    load_external_block_signatures();
+    load_dynamic_imports_section();
+    load_blocks_map();
+    load_functions_map();
+    load_bytecode();
 
     return (*this);
 }
 
 Loader& Loader::executable()
 {
-    std::ifstream in(path, std::ios::in | std::ios::binary);
-    if (!in) {
-        throw("fatal: failed to open file: " + path);
+    try {
+        map_file();
+    } catch (std::string const& e) {
+        throw("fatal: " + e);
     }
 
-    load_magic_number(in);
-    assume_binary_type(in, VIUA_EXECUTABLE);
+    load_magic_number();
+    assume_binary_type(VIUA_EXECUTABLE);
 
-    load_meta_information(in);
+    load_meta_information();
 
-    load_external_signatures(in);
-    load_external_block_signatures(in);
-    load_dynamic_imports_section(in);
-    load_blocks_map(in);
-    load_functions_map(in);
-    load_bytecode(in);
-    calculate_function_sizes();
+    load_external_signatures();
+    load_external_block_signatures();
+    load_dynamic_imports_section();
+    load_blocks_map();
+    load_functions_map();
+    load_bytecode();
 
     return (*this);
 }
@@ -293,11 +314,13 @@ uint64_t Loader::get_bytecode_size()
 auto Loader::get_bytecode() -> std::unique_ptr<uint8_t[]>
 {
     auto copy = std::make_unique<uint8_t[]>(size);
-    for (uint64_t i = 0; i < size; ++i) {
-        copy[i] = bytecode[i];
-    }
+    std::memcpy(copy.get(), bytecode, size);
     return copy;
 }
+auto Loader::bytecode_image() const -> Bytecode_image
+{
+    return Bytecode_image{mapping, bytecode, size};
+}
 
 auto Loader::get_jumps() -> std::vector<uint64_t>
 {
@@ -319,26 +342,66 @@ auto Loader::get_external_block_signatures() -> std::vector<std::string>
     return external_signatures_block;
 }
 
+auto Loader::functions_index() const -> std::vector<Symbol> const&
+{
+    return function_symbols;
+}
+auto Loader::blocks_index() const -> std::vector<Symbol> const&
+{
+    return block_symbols;
+}
+
+static auto addresses_of(std::vector<Symbol> const& symbols)
+    -> std::map<std::string, uint64_t>
+{
+    auto addresses = std::map<std::string, uint64_t>{};
+    for (auto const& each : symbols) {
+        addresses[std::string{each.name}] = each.address;
+    }
+    return addresses;
+}
+static auto names_of(std::vector<Symbol> const& symbols)
+    -> std::vector<std::string>
+{
+    auto names = std::vector<std::string>{};
+    for (auto const& each : symbols) {
+        names.emplace_back(each.name);
+    }
+    return names;
+}
+
 auto Loader::get_function_addresses() -> std::map<std::string, uint64_t>
 {
-    return function_addresses;
+    return addresses_of(function_symbols);
 }
 auto Loader::get_function_sizes() -> std::map<std::string, uint64_t>
 {
-    return function_sizes;
+    /*
+     * Functions are laid out one after another, in the order in which they
+     * are listed in the functions map.
+     */
+    auto sizes = std::map<std::string, uint64_t>{};
+    for (auto i = size_t{0}; i < function_symbols.size(); ++i) {
+        auto const a = function_symbols[i].address;
+        auto const b = ((i + 1) < function_symbols.size())
+                           ? function_symbols[i + 1].address
+                           : size;
+        sizes[std::string{function_symbols[i].name}] = (b - a);
+    }
+    return sizes;
 }
 auto Loader::get_functions() -> std::vector<std::string>
 {
-    return functions;
+    return names_of(function_symbols);
 }
 
 auto Loader::get_block_addresses() -> std::map<std::string, uint64_t>
 {
-    return block_addresses;
+    return addresses_of(block_symbols);
 }
 auto Loader::get_blocks() -> std::vector<std::string>
 {
-    return blocks;
+    return names_of(block_symbols);
 }
 
 auto Loader::dynamic_imports() const -> std::vector<std::string>
@@ -205,6 +205,37 @@ auto viua::process::Decoder_adapter::fetch_value(Op_address_type& addr,
     return value;
 }
 
+auto viua::process::Decoder_adapter::fetch_value_register(
+    Op_address_type& addr,
+    Process& proc) const -> viua::kernel::Register*
+{
+    auto [next_addr, reg] = decoder.decode_register(addr);
+
+    addr = next_addr;
+
+    using viua::bytecode::codec::Access_specifier;
+
+    if (std::get<2>(reg) == Access_specifier::Pointer_dereference) {
+        return nullptr;
+    }
+
+    auto slot = proc.register_at(std::get<1>(reg), std::get<0>(reg));
+    if (std::get<2>(reg) == Access_specifier::Register_indirect) {
+        auto const i =
+            static_cast<viua::types::Integer*>(slot->get())->as_integer();
+        if (i < 0) {
+            throw std::make_unique<viua::types::Exception>(
+                viua::types::Exception::Tag{"Invalid_register_index"},
+                "registers cannot be negative");
+        }
+        slot = proc.register_at(
+            static_cast<viua::bytecode::codec::register_index_type>(i),
+            std::get<0>(reg));
+    }
+
+    return slot;
+}
+
 auto viua::process::Decoder_adapter::fetch_string(Op_address_type& addr) const
     -> std::string
 {
@@ -351,12 +382,9 @@ auto viua::process::Process::adjust_jump_base_for(std::string const& call_name)
 }
 auto viua::process::Process::call_native(
     Op_address_type return_address,
-    std::string const& call_name,
-    viua::kernel::Register* return_register,
-    std::string const&) -> Op_address_type
+    viua::scheduler::Call_target const& target,
+    viua::kernel::Register* return_register) -> Op_address_type
 {
-    auto call_address = adjust_jump_base_for(call_name);
-
     if (not stack->frame_new) {
         throw std::make_unique<viua::types::Exception>(
             "function call without a frame: use `frame 0' in source code if "
@@ -364,13 +392,15 @@ auto viua::process::Process::call_native(
             "function takes no parameters");
     }
 
-    stack->frame_new->function_name   = call_name;
+    stack->frame_new->function_name   = target.name;
+    stack->frame_new->jump_base       = target.jump_base;
     stack->frame_new->return_address  = return_address;
     stack->frame_new->return_register = return_register;
 
     push_frame();
 
-    return call_address;
+    stack->jump_base = target.jump_base;
+    return target.entry_point;
 }
 auto viua::process::Process::call_foreign(
     Op_address_type return_address,
@@ -417,6 +447,8 @@ auto viua::process::Process::handle_active_exception() -> void
 }
 auto viua::process::Process::tick() -> Op_address_type
 {
+    is_blocked = false;
+
     Op_address_type previous_instruction_pointer = stack->instruction_pointer;
 
     try {
@@ -490,7 +522,7 @@ auto viua::process::Process::tick() -> Op_address_type
      * - an object has been thrown, as the instruction pointer will be adjusted
      *   by catchers or execution will be halted on unhandled types
      */
-    auto const allowed_unchanged_ops = std::set<OPCODE>{
+    static auto const allowed_unchanged_ops = std::set<OPCODE>{
         RETURN,
         JOIN,
         RECEIVE,
@@ -569,13 +601,38 @@ auto viua::process::Process::suspend() -> void
 }
 auto viua::process::Process::wakeup() -> void
 {
+    /*
+     * The process may be run (and even finish) by its scheduler as soon as it
+     * is no longer suspended so copy everything needed to deliver the wake-up
+     * beforehand.
+     */
+    auto const scheduler = attached_scheduler;
+    auto const id        = pid();
     is_suspended.store(false, std::memory_order_release);
+    scheduler->wake(id);
 }
 auto viua::process::Process::suspended() const -> bool
 {
     return is_suspended.load(std::memory_order_acquire);
 }
 
+auto viua::process::Process::block() -> void
+{
+    is_blocked = true;
+}
+auto viua::process::Process::blocked() const -> bool
+{
+    return is_blocked;
+}
+auto viua::process::Process::wakeup_deadline() const
+    -> std::optional<std::chrono::steady_clock::time_point>
+{
+    if (timeout_active and not wait_until_infinity) {
+        return waiting_until;
+    }
+    return {};
+}
+
 auto viua::process::Process::parent() const -> viua::process::Process*
 {
     return parent_process;
@@ -741,6 +798,11 @@ auto viua::process::Process::migrate_to(viua::scheduler::Process_scheduler* sch)
 {
     attached_scheduler = sch;
 }
+auto viua::process::Process::attach_mailbox(
+    std::shared_ptr<viua::kernel::Mailbox> m) -> void
+{
+    mailbox = std::move(m);
+}
 
 auto viua::process::Process::get_kernel() const -> viua::kernel::Kernel&
 {
@@ -20,6 +20,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <type_traits>
 
 #include <viua/assert.h>
 #include <viua/bytecode/bytetypedef.h>
@@ -41,60 +42,110 @@ using viua::internals::types::Op_address_type;
 template<typename T>
 using dumb_ptr = T*;  // FIXME; use std::experimental::observer_ptr
 
-template<typename OpType, OpType action>
+/*
+ * Arithmetic and comparisons on integers and floats which need not be boxed.
+ * The result has the type of the left-hand side operand, just as the result
+ * of the operators of boxed numbers does.
+ *
+ * Returns false if the operation must be left to the boxed numbers: if either
+ * operand is not a number, or to let them throw on division by zero.
+ */
+template<template<typename> typename Op>
+static auto unboxed_alu_impl(viua::kernel::Register& target,
+                             viua::kernel::Immediate const lhs,
+                             viua::kernel::Immediate const rhs) -> bool
+{
+    using viua::kernel::Immediate;
+
+    if (not(lhs.is_number() and rhs.is_number())) {
+        return false;
+    }
+    if constexpr (std::is_same_v<Op<int64_t>, std::divides<int64_t>>) {
+        if (rhs.as_integer() == 0) {
+            return false;
+        }
+    }
+
+    if (lhs.kind() == Immediate::Kind::Integer) {
+        target = Immediate{Op<int64_t>{}(lhs.as_integer(), rhs.as_integer())};
+    } else {
+        target = Immediate{Op<double>{}(lhs.as_float(), rhs.as_float())};
+    }
+    return true;
+}
+
+template<typename OpType, OpType action, template<typename> typename Op>
 static auto alu_impl(Op_address_type addr, viua::process::Process* process)
     -> Op_address_type
 {
     auto target = process->decoder.fetch_register(addr, *process);
-    auto lhs    = process->decoder.fetch_value_of<Number>(addr, *process);
-    auto rhs    = process->decoder.fetch_value_of<Number>(addr, *process);
 
-    *target = (lhs->*action)(*rhs);
+    auto const operands = addr;
+    auto const lhs = process->decoder.fetch_value_register(addr, *process);
+    auto const rhs = process->decoder.fetch_value_register(addr, *process);
+    if (lhs and rhs) {
+        auto const x = lhs->unboxed();
+        auto const y = rhs->unboxed();
+        if (x and y and unboxed_alu_impl<Op>(*target, *x, *y)) {
+            return addr;
+        }
+    }
+
+    addr           = operands;
+    auto lhs_value = process->decoder.fetch_value_of<Number>(addr, *process);
+    auto rhs_value = process->decoder.fetch_value_of<Number>(addr, *process);
+
+    *target = (lhs_value->*action)(*rhs_value);
 
     return addr;
 }
 
 auto viua::process::Process::opadd(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<ArithmeticOp, (&Number::operator+)>(addr, this);
+    return alu_impl<ArithmeticOp, (&Number::operator+), std::plus>(addr, this);
 }
 
 auto viua::process::Process::opsub(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<ArithmeticOp, (&Number::operator-)>(addr, this);
+    return alu_impl<ArithmeticOp, (&Number::operator-), std::minus>(addr,
+                                                                     this);
 }
 
 auto viua::process::Process::opmul(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<ArithmeticOp, (&Number::operator*)>(addr, this);
+    return alu_impl<ArithmeticOp, (&Number::operator*), std::multiplies>(
+        addr, this);
 }
 
 auto viua::process::Process::opdiv(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<ArithmeticOp, (&Number::operator/)>(addr, this);
+    return alu_impl<ArithmeticOp, (&Number::operator/), std::divides>(addr,
+                                                                      this);
 }
 
 auto viua::process::Process::oplt(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<LogicOp, (&Number::operator<)>(addr, this);
+    return alu_impl<LogicOp, (&Number::operator<), std::less>(addr, this);
 }
 
 auto viua::process::Process::oplte(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<LogicOp, (&Number::operator<=)>(addr, this);
+    return alu_impl<LogicOp, (&Number::operator<=), std::less_equal>(addr,
+                                                                     this);
 }
 
 auto viua::process::Process::opgt(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<LogicOp, ((&Number::operator>))>(addr, this);
+    return alu_impl<LogicOp, ((&Number::operator>)), std::greater>(addr, this);
 }
 
 auto viua::process::Process::opgte(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<LogicOp, (&Number::operator>=)>(addr, this);
+    return alu_impl<LogicOp, (&Number::operator>=), std::greater_equal>(addr,
+                                                                        this);
 }
 
 auto viua::process::Process::opeq(Op_address_type addr) -> Op_address_type
 {
-    return alu_impl<LogicOp, (&Number::operator==)>(addr, this);
+    return alu_impl<LogicOp, (&Number::operator==), std::equal_to>(addr, this);
 }
@@ -40,14 +40,9 @@ auto viua::process::Process::opbits_of_integer(Op_address_type addr)
     auto const n = decoder.fetch_value_of<viua::types::Integer>(addr, *this);
 
     auto const size_in_bits = sizeof(viua::types::Integer::underlying_type) * 8;
-    auto decomposed         = std::vector<bool>(size_in_bits);
-    auto const base_mask    = viua::types::Integer::underlying_type{1};
-    for (auto i = decltype(size_in_bits){0}; i < size_in_bits; ++i) {
-        decomposed.at(i) =
-            (n->as_unsigned() & static_cast<uint64_t>(base_mask << i));
-    }
-
-    *target = std::make_unique<viua::types::Bits>(std::move(decomposed));
+    *target                 = std::make_unique<viua::types::Bits>(
+        size_in_bits,
+        std::vector<viua::types::Bits::word_type>{n->as_unsigned()});
 
     return addr;
 }
@@ -58,17 +53,13 @@ auto viua::process::Process::opinteger_of_bits(Op_address_type addr)
     auto target  = decoder.fetch_register(addr, *this);
     auto const b = decoder.fetch_value_of<viua::types::Bits>(addr, *this);
 
-    auto const size_in_bits = b->size();
-    auto decomposed         = std::vector<bool>(size_in_bits);
-    auto const base_mask    = viua::types::Integer::underlying_type{1};
-    auto n                  = viua::types::Integer::underlying_type{0};
-    for (auto i = decltype(size_in_bits){0}; i < size_in_bits; ++i) {
-        if (b->at(i)) {
-            n = (n | (base_mask << i));
-        }
-    }
+    /*
+     * Only the lowest word fits in an integer.
+     */
+    auto const n = (b->data().empty() ? 0 : b->data().front());
 
-    *target = std::make_unique<viua::types::Integer>(n);
+    *target = std::make_unique<viua::types::Integer>(
+        static_cast<viua::types::Integer::underlying_type>(n));
 
     return addr;
 }
@@ -114,38 +114,67 @@ auto viua::process::Process::opallocate_registers(Op_address_type addr)
     return addr;
 }
 
-auto viua::process::Process::opcall(Op_address_type addr) -> Op_address_type
+auto viua::process::Process::resolve_call_target(
+    Op_address_type& addr,
+    viua::types::Function*& fn,
+    char const* const undefined) -> viua::scheduler::Call_target const&
 {
-    auto const return_register = decoder.fetch_register_or_void(addr, *this);
+    /*
+     * The address of the operand naming the function identifies the call site.
+     */
+    auto const site = addr;
 
-    auto call_name = std::string{};
-    auto ot        = viua::bytecode::codec::main::get_operand_type(addr);
+    auto ot = viua::bytecode::codec::main::get_operand_type(addr);
     if (ot == OT_REGISTER_INDEX or ot == OT_POINTER) {
-        auto const fn =
-            decoder.fetch_value_of<viua::types::Function>(addr, *this);
+        fn = decoder.fetch_value_of<viua::types::Function>(addr, *this);
+
+        auto const call_name = fn->name();
+        auto const target =
+            attached_scheduler->resolve_call_target(site, call_name, addr);
+        if (not target) {
+            throw std::make_unique<viua::types::Exception>(undefined
+                                                           + call_name);
+        }
+        return *target;
+    }
 
-        call_name = fn->name();
+    /*
+     * Functions named by the call site itself never change so the name only
+     * has to be decoded the first time the call site is executed.
+     */
+    fn = nullptr;
+    if (auto const target = attached_scheduler->cached_call_target(site)) {
+        addr = target->next;
+        return *target;
+    }
 
-        if (fn->type() == "Closure") {
-            stack->frame_new->set_local_register_set(
-                static_cast<viua::types::Closure*>(fn)->rs(), false);
-        }
-    } else {
-        call_name = decoder.fetch_string(addr);
+    auto const call_name = decoder.fetch_string(addr);
+    auto const target =
+        attached_scheduler->resolve_call_target(site, call_name, addr);
+    if (not target) {
+        throw std::make_unique<viua::types::Exception>(undefined + call_name);
     }
+    return *target;
+}
 
-    auto const is_native  = attached_scheduler->is_native_function(call_name);
-    auto const is_foreign = attached_scheduler->is_foreign_function(call_name);
+auto viua::process::Process::opcall(Op_address_type addr) -> Op_address_type
+{
+    auto const return_register = decoder.fetch_register_or_void(addr, *this);
 
-    if (not(is_native or is_foreign)) {
-        throw std::make_unique<viua::types::Exception>(
-            "call to undefined function: " + call_name);
+    auto fn = static_cast<viua::types::Function*>(nullptr);
+    auto const& target =
+        resolve_call_target(addr, fn, "call to undefined function: ");
+
+    if (fn and fn->type() == "Closure") {
+        stack->frame_new->set_local_register_set(
+            static_cast<viua::types::Closure*>(fn)->rs(), false);
     }
 
-    auto caller = (is_native ? &viua::process::Process::call_native
-                             : &viua::process::Process::call_foreign);
-    return (this->*caller)(
-        addr, call_name, return_register.value_or(nullptr), "");
+    if (target.foreign) {
+        return call_foreign(
+            addr, target.name, return_register.value_or(nullptr), "");
+    }
+    return call_native(addr, target, return_register.value_or(nullptr));
 }
 
 auto viua::process::Process::optailcall(Op_address_type addr) -> Op_address_type
@@ -170,33 +199,19 @@ auto viua::process::Process::optailcall(Op_address_type addr) -> Op_address_type
 
     stack->state_of(viua::process::Stack::STATE::RUNNING);
 
-    auto call_name = std::string{};
-    auto ot        = viua::bytecode::codec::main::get_operand_type(addr);
-    if (ot == OT_REGISTER_INDEX or ot == OT_POINTER) {
-        auto const fn =
-            decoder.fetch_value_of<viua::types::Function>(addr, *this);
-
-        call_name = fn->name();
+    auto fn = static_cast<viua::types::Function*>(nullptr);
+    auto const& target =
+        resolve_call_target(addr, fn, "tail call to undefined function: ");
 
-        if (fn->type() == "Closure") {
-            stack->back()->local_register_set.reset(
-                static_cast<viua::types::Closure*>(fn)->give());
-        }
-    } else {
-        call_name = decoder.fetch_string(addr);
+    if (fn and fn->type() == "Closure") {
+        stack->back()->local_register_set.reset(
+            static_cast<viua::types::Closure*>(fn)->give());
     }
 
-    auto const is_native  = attached_scheduler->is_native_function(call_name);
-    auto const is_foreign = attached_scheduler->is_foreign_function(call_name);
-
-    if (not(is_native or is_foreign)) {
-        throw std::make_unique<viua::types::Exception>(
-            "tail call to undefined function: " + call_name);
-    }
     // FIXME: make to possible to tail call foreign functions and methods
-    if (not is_native) {
+    if (target.foreign) {
         throw std::make_unique<viua::types::Exception>(
-            "tail call to non-native function: " + call_name);
+            "tail call to non-native function: " + target.name);
     }
 
     // FIXME tailcalled functions should not inherit local register set of the
@@ -207,36 +222,23 @@ auto viua::process::Process::optailcall(Op_address_type addr) -> Op_address_type
     // it's a simulated "push-and-pop" from the stack
     stack->frame_new.reset(nullptr);
 
-    return adjust_jump_base_for(call_name);
+    stack->back()->jump_base = target.jump_base;
+    stack->jump_base         = target.jump_base;
+    return target.entry_point;
 }
 
 auto viua::process::Process::opdefer(Op_address_type addr) -> Op_address_type
 {
-    auto call_name = std::string{};
-    auto ot        = viua::bytecode::codec::main::get_operand_type(addr);
-    if (ot == OT_REGISTER_INDEX or ot == OT_POINTER) {
-        auto const fn =
-            decoder.fetch_value_of<viua::types::Function>(addr, *this);
-
-        call_name = fn->name();
+    auto fn = static_cast<viua::types::Function*>(nullptr);
+    auto const& target =
+        resolve_call_target(addr, fn, "defer of undefined function: ");
 
-        if (fn->type() == "Closure") {
-            stack->back()->local_register_set.reset(
-                static_cast<viua::types::Closure*>(fn)->give());
-        }
-    } else {
-        call_name = decoder.fetch_string(addr);
-    }
-
-    auto const is_native  = attached_scheduler->is_native_function(call_name);
-    auto const is_foreign = attached_scheduler->is_foreign_function(call_name);
-
-    if (not(is_native or is_foreign)) {
-        throw std::make_unique<viua::types::Exception>(
-            "defer of undefined function: " + call_name);
+    if (fn and fn->type() == "Closure") {
+        stack->back()->local_register_set.reset(
+            static_cast<viua::types::Closure*>(fn)->give());
     }
 
-    push_deferred(call_name);
+    push_deferred(target.name);
 
     return addr;
 }
@@ -285,7 +287,7 @@ auto viua::process::Process::opreturn(Op_address_type addr) -> Op_address_type
     }
 
     if (stack->size() > 0) {
-        adjust_jump_base_for(stack->back()->function_name);
+        stack->restore_jump_base();
     }
 
     return addr;
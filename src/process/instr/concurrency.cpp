@@ -128,6 +128,12 @@ auto viua::process::Process::opjoin(Op_address_type addr) -> Op_address_type
         wait_until_infinity = false;
         return_addr         = addr;
         throw std::make_unique<viua::types::Exception>("process did not join");
+    } else if (attached_scheduler->wake_up_on_stop(proc->pid(), pid())) {
+        /*
+         * Get out of the scheduler's way until the joined process stops (or
+         * the timeout passes). If it stopped in the meantime just try again.
+         */
+        block();
     }
 
     return return_addr;
@@ -163,7 +169,7 @@ auto viua::process::Process::opreceive(Op_address_type addr) -> Op_address_type
         timeout_active      = true;
     }
 
-    attached_scheduler->receive(process_id, message_queue);
+    mailbox->receive(message_queue);
 
     if (not message_queue.empty()) {
         if (target) {
@@ -184,6 +190,15 @@ auto viua::process::Process::opreceive(Op_address_type addr) -> Op_address_type
             throw std::make_unique<viua::types::Exception>(
                 "no message received");
         }
+
+        /*
+         * Get out of the scheduler's way until a message arrives (or the
+         * timeout passes). If a message arrived in the meantime just try
+         * again.
+         */
+        if (mailbox->wake_up_on_send(attached_scheduler)) {
+            block();
+        }
     }
 
     return return_addr;
@@ -34,7 +34,7 @@ auto viua::process::Process::opfloat(Op_address_type addr) -> Op_address_type
     auto target      = decoder.fetch_register(addr, *this);
     auto const value = decoder.fetch_float(addr);
 
-    *target = std::make_unique<viua::types::Float>(value);
+    *target = viua::kernel::Immediate{value};
 
     return addr;
 }
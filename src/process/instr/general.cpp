@@ -68,7 +68,15 @@ auto viua::process::Process::opjump(Op_address_type addr) -> Op_address_type
 
 auto viua::process::Process::opif(Op_address_type addr) -> Op_address_type
 {
-    auto const source = decoder.fetch_value(addr, *this)->boolean();
+    auto const operand = addr;
+    auto source        = false;
+    if (auto const r = decoder.fetch_value_register(addr, *this);
+        r and r->holds_immediate()) {
+        source = r->unboxed()->boolean();
+    } else {
+        addr   = operand;
+        source = decoder.fetch_value(addr, *this)->boolean();
+    }
 
     auto addr_true  = decoder.fetch_address(addr);
     auto addr_false = decoder.fetch_address(addr);
@@ -31,8 +31,7 @@
 
 auto viua::process::Process::opizero(Op_address_type addr) -> Op_address_type
 {
-    *decoder.fetch_register(addr, *this) =
-        std::make_unique<viua::types::Integer>(0);
+    *decoder.fetch_register(addr, *this) = viua::kernel::Immediate{int64_t{0}};
     return addr;
 }
 
@@ -41,19 +40,49 @@ auto viua::process::Process::opinteger(Op_address_type addr) -> Op_address_type
     auto target      = decoder.fetch_register(addr, *this);
     auto const value = decoder.fetch_i32(addr);
 
-    *target = std::make_unique<viua::types::Integer>(value);
+    *target = viua::kernel::Immediate{int64_t{value}};
 
     return addr;
 }
 
+/*
+ * Boxed integers are incremented and decremented in place (pointers to them
+ * must stay valid) but immediates can just be replaced.
+ */
+static auto unboxed_step(viua::kernel::Register* const target,
+                         int64_t const step) -> bool
+{
+    if (target == nullptr or not target->holds_immediate()) {
+        return false;
+    }
+    auto const x = target->unboxed();
+    if (x->kind() != viua::kernel::Immediate::Kind::Integer) {
+        return false;
+    }
+    target->reset(viua::kernel::Immediate{x->as_integer() + step});
+    return true;
+}
+
 auto viua::process::Process::opiinc(Op_address_type addr) -> Op_address_type
 {
+    auto const operand = addr;
+    if (unboxed_step(decoder.fetch_value_register(addr, *this), 1)) {
+        return addr;
+    }
+
+    addr = operand;
     decoder.fetch_value_of<viua::types::Integer>(addr, *this)->increment();
     return addr;
 }
 
 auto viua::process::Process::opidec(Op_address_type addr) -> Op_address_type
 {
+    auto const operand = addr;
+    if (unboxed_step(decoder.fetch_value_register(addr, *this), -1)) {
+        return addr;
+    }
+
+    addr = operand;
     decoder.fetch_value_of<viua::types::Integer>(addr, *this)->decrement();
     return addr;
 }
@@ -88,10 +88,9 @@ auto viua::process::Process::op_io_wait(Op_address_type addr) -> Op_address_type
      */
 
     /*
-     * By default return to just before the instruction. This is the same dumb
-     * and inefficient solution that is used to implement timeouts for the
-     * receive instruction. However, this avoids global synchronisation so may
-     * not be that bad after all.
+     * By default return to just before the instruction. The process is parked
+     * until the request completes (or the timeout passes), and then the
+     * instruction is executed again.
      */
     auto return_addr = Op_address_type{addr - 1};
 
@@ -125,6 +124,9 @@ auto viua::process::Process::op_io_wait(Op_address_type addr) -> Op_address_type
             return_addr         = addr;
             throw std::make_unique<viua::types::Exception>("I/O not completed");
         }
+        if (attached_scheduler->wake_up_on_io(request->id(), pid())) {
+            block();
+        }
     }
 
     return return_addr;
@@ -40,7 +40,21 @@ auto viua::process::Process::opmove(Op_address_type addr) -> Op_address_type
 }
 auto viua::process::Process::opcopy(Op_address_type addr) -> Op_address_type
 {
-    auto target       = decoder.fetch_register(addr, *this);
+    auto target = decoder.fetch_register(addr, *this);
+
+    /*
+     * Copies of integers, floats, and booleans need not be boxed, even if the
+     * originals are.
+     */
+    auto const operand = addr;
+    if (auto const r = decoder.fetch_value_register(addr, *this)) {
+        if (auto const x = r->unboxed(); x) {
+            *target = *x;
+            return addr;
+        }
+    }
+
+    addr              = operand;
     auto const source = decoder.fetch_value(addr, *this);
 
     *target = source->copy();
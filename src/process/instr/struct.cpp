@@ -43,9 +43,10 @@ auto viua::process::Process::opstructinsert(Op_address_type addr)
 
     using viua::bytecode::codec::main::get_operand_type;
     if (get_operand_type(addr) == OT_POINTER) {
-        struct_operand->insert(*key, decoder.fetch_value(addr, *this)->copy());
+        struct_operand->insert(key->id(),
+                               decoder.fetch_value(addr, *this)->copy());
     } else {
-        struct_operand->insert(*key,
+        struct_operand->insert(key->id(),
                                decoder.fetch_register(addr, *this)->give());
     }
 
@@ -60,7 +61,7 @@ auto viua::process::Process::opstructremove(Op_address_type addr)
         decoder.fetch_value_of<viua::types::Struct>(addr, *this);
     auto const key = decoder.fetch_value_of<viua::types::Atom>(addr, *this);
 
-    auto result = struct_operand->remove(*key);
+    auto result = struct_operand->remove(key->id());
     if (target.has_value()) {
         **target = std::move(result);
     }
@@ -76,7 +77,7 @@ auto viua::process::Process::opstructat(Op_address_type addr) -> Op_address_type
     auto const key = decoder.fetch_value_of<viua::types::Atom>(addr, *this);
 
     if (target.has_value()) {
-        **target = struct_operand->at(*key)->pointer(this);
+        **target = struct_operand->at(key->id())->pointer(this);
     }
 
     return addr;
@@ -122,7 +122,7 @@ auto viua::process::Process::opleave(Op_address_type addr) -> Op_address_type
     stack->tryframes.pop_back();
 
     if (stack->size() > 0) {
-        adjust_jump_base_for(stack->back()->function_name);
+        stack->restore_jump_base();
     }
     return addr;
 }
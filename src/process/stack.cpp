@@ -184,6 +184,15 @@ auto viua::process::Stack::adjust_jump_base_for(std::string const& call_name)
     jump_base     = ep.second;
     return entry_point;
 }
+auto viua::process::Stack::restore_jump_base() -> void
+{
+    auto& frame = back();
+    if (not frame->jump_base) {
+        adjust_jump_base_for(frame->function_name);
+        frame->jump_base = jump_base;
+    }
+    jump_base = frame->jump_base;
+}
 
 auto viua::process::Stack::adjust_instruction_pointer(
     const Try_frame* tframe,
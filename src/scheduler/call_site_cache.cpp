@@ -0,0 +1,42 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <viua/scheduler/call_site_cache.h>
+
+
+namespace viua { namespace scheduler {
+auto Call_site_cache::find(address_type const site,
+                           generation_type const current) -> Call_target const*
+{
+    if (current != generation) {
+        sites.clear();
+        generation = current;
+        return nullptr;
+    }
+
+    auto const found = sites.find(site);
+    return ((found == sites.end()) ? nullptr : &found->second);
+}
+
+auto Call_site_cache::insert(address_type const site, Call_target target)
+    -> Call_target const&
+{
+    return (sites[site] = std::move(target));
+}
+}}  // namespace viua::scheduler
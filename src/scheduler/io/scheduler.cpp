@@ -18,10 +18,13 @@
  */
 
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <unistd.h>
 
-#include <chrono>
-#include <condition_variable>
+#include <array>
+#include <deque>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -31,6 +34,7 @@
 #include <viua/scheduler/io.h>
 #include <viua/scheduler/io/interactions.h>
 #include <viua/types/exception.h>
+#include <viua/types/integer.h>
 #include <viua/types/io.h>
 
 static auto is_sentinel(
@@ -39,54 +43,168 @@ static auto is_sentinel(
     return (item.get() == nullptr);
 }
 
+using viua::scheduler::io::IO_interaction;
+using viua::scheduler::io::IO_kind;
+
+static auto complete(viua::kernel::Kernel& kernel,
+                     IO_interaction& work,
+                     IO_interaction::Interaction_result result) -> void
+{
+    kernel.complete_io(
+        work.id(),
+        ((result.status == IO_interaction::Status::Success)
+             ? viua::kernel::Kernel::IO_result::make_success
+             : viua::kernel::Kernel::IO_result::make_error)(
+            std::move(result.result)));
+}
+
+/*
+ * Run the interaction and complete it if it finished. Returns true if the
+ * interaction finished.
+ */
+static auto run(viua::kernel::Kernel& kernel, IO_interaction& work) -> bool
+{
+    auto result = work.interact();
+    if (result.state != IO_interaction::State::Complete) {
+        return false;
+    }
+    complete(kernel, work, std::move(result));
+    return true;
+}
+
+static auto events_for(IO_kind const kind) -> uint32_t
+{
+    switch (kind) {
+    case IO_kind::Input:
+        return EPOLLIN;
+    case IO_kind::Output:
+        return EPOLLOUT;
+    case IO_kind::Close:
+    default:
+        return (EPOLLIN | EPOLLOUT);
+    }
+}
+
+namespace {
+/*
+ * Interactions waiting for a single file descriptor to become ready. They are
+ * run in the order in which they were scheduled.
+ */
+struct Waiting_on_fd {
+    std::deque<std::unique_ptr<IO_interaction>> interactions;
+    uint32_t events = 0;
+
+    auto wanted_events() const -> uint32_t
+    {
+        auto e = uint32_t{0};
+        for (auto const& each : interactions) {
+            e |= events_for(each->kind());
+        }
+        return e;
+    }
+};
+}  // namespace
+
 void viua::scheduler::io::io_scheduler(
     uint64_t const scheduler_id,
     viua::kernel::Kernel& kernel,
     std::deque<std::unique_ptr<IO_interaction>>& requests,
     std::mutex& io_request_mutex,
-    std::condition_variable& io_request_cv)
+    int const io_request_fd,
+    int const io_cancel_fd)
 {
     pthread_setname_np(pthread_self(), ("io." + std::to_string(scheduler_id)).c_str());
 
-    auto local_interactions = std::deque<std::unique_ptr<IO_interaction>>{};
+    /*
+     * Every I/O worker owns an epoll(7) instance. File descriptors are watched
+     * for as long as there are interactions waiting for them, and interactions
+     * are only run when their file descriptors become ready, so the cost of
+     * doing I/O follows the number of active file descriptors rather than the
+     * number of open ones.
+     *
+     * New requests are announced on a semaphore-like eventfd(2) shared by all
+     * the workers: every worker that manages to decrement it takes one request
+     * from the queue. Cancellations are announced on another eventfd(2) shared
+     * by all the workers; every worker looks through its own interactions for
+     * the ones that were cancelled.
+     */
+    auto const epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) {
+        std::cerr << ("[io][id=" + std::to_string(scheduler_id)
+                      + "] epoll_create1(2) failed: " + std::to_string(errno)
+                      + "\n");
+        return;
+    }
+    {
+        auto ev    = epoll_event{};
+        ev.events  = EPOLLIN;
+        ev.data.fd = io_request_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, io_request_fd, &ev);
+
+        ev.events  = (EPOLLIN | EPOLLET);
+        ev.data.fd = io_cancel_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, io_cancel_fd, &ev);
+    }
 
-    while (true) {
-        std::unique_ptr<IO_interaction> interaction;
-        {
-            std::unique_lock<std::mutex> lck{io_request_mutex};
+    auto waiting = std::map<int, Waiting_on_fd>{};
 
+    /*
+     * Interactions on file descriptors that cannot be watched (e.g. regular
+     * files, which are always ready) are just run until they finish.
+     */
+    auto always_ready = std::deque<std::unique_ptr<IO_interaction>>{};
+
+    /*
+     * Make the events watched for the file descriptor match what its waiting
+     * interactions want, and forget the descriptor if none are left.
+     */
+    auto const rearm = [epoll_fd, &waiting, &kernel](
+                           std::map<int, Waiting_on_fd>::iterator fd) -> void {
+        auto const wanted = fd->second.wanted_events();
+        if (wanted == fd->second.events) {
+            return;
+        }
+
+        auto ev    = epoll_event{};
+        ev.events  = wanted;
+        ev.data.fd = fd->first;
+        auto const op =
+            (wanted == 0)
+                ? EPOLL_CTL_DEL
+                : ((fd->second.events == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+        if (epoll_ctl(epoll_fd, op, fd->first, &ev) == -1
+            and op != EPOLL_CTL_DEL) {
             /*
-             *             WARNING! ACHTUNG! HERE BE DRAGONS!
-             *
-             * Do not try to simplify the condition by removing the seemingly
-             * redundant `not`s - they are not! With them both removed the
-             * condition encodes the same logic, but for some reason the VM will
-             * hang. It looks like one thread is monopolising the lock (maybe it
-             * is running in too tight a loop?) which leads to starvation of
-             * other threads who never get to lock it... including the main
-             * kernel thread.
+             * The file descriptor cannot be watched. Fail the interactions
+             * the same way they would fail if the I/O operation itself did.
              */
-            auto const timeout =
-                std::chrono::milliseconds{local_interactions.empty() ? 10 : 0};
-            while (not io_request_cv.wait_for(
-                lck, timeout, [&requests, &local_interactions] {
-                    return (
-                        not(requests.empty() and local_interactions.empty()));
-                }))
-                ;
-
-            interaction = std::move(requests.front());
-            requests.pop_front();
+            auto const saved_errno = errno;
+            for (auto& each : fd->second.interactions) {
+                complete(kernel,
+                         *each,
+                         IO_interaction::Interaction_result{
+                             IO_interaction::State::Complete,
+                             IO_interaction::Status::Error,
+                             std::make_unique<viua::types::Integer>(
+                                 saved_errno)});
+            }
+            fd->second.interactions.clear();
+            if (fd->second.events != 0) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd->first, nullptr);
+            }
+            waiting.erase(fd);
+            return;
         }
 
-        if (is_sentinel(interaction)) {
-            if constexpr ((false)) {
-                std::cerr << ("[io][id=" + std::to_string(scheduler_id)
-                              + "] received sentinel\n");
-            }
-            break;
+        fd->second.events = wanted;
+        if (wanted == 0) {
+            waiting.erase(fd);
         }
+    };
 
+    auto const accept = [epoll_fd, &waiting, &always_ready, &kernel, &rearm](
+                            std::unique_ptr<IO_interaction> interaction)
+        -> void {
         if (not interaction->fd().has_value()) {
             /*
              * Do not work with interactions that do not expose file
@@ -99,112 +217,172 @@ void viua::scheduler::io::io_scheduler(
                     std::make_unique<viua::types::Exception>(
                         viua::types::Exception::Tag{"IO_without_fd"},
                         "I/O port did not expose file descriptor")));
-            continue;
+            return;
         }
 
-        {
-            auto& work = *interaction;
-
-            fd_set readfds;
-            fd_set writefds;
-            FD_ZERO(&readfds);
-            FD_ZERO(&writefds);
-
-            auto always_ready = false;
-
-            switch (work.kind()) {
-            case IO_kind::Input:
-                FD_SET(*work.fd(), &readfds);
-                break;
-            case IO_kind::Output:
-                FD_SET(*work.fd(), &writefds);
-                break;
-            case IO_kind::Close:
-                always_ready = true;
-                break;
-            default:
-                /*
-                 * Just set it for both modes, to be on the safe side.
-                 */
-                FD_SET(*work.fd(), &readfds);
-                FD_SET(*work.fd(), &writefds);
-                break;
+        if (interaction->cancelled() and run(kernel, *interaction)) {
+            return;
+        }
+
+        if (interaction->kind() == IO_kind::Close) {
+            if (not run(kernel, *interaction)) {
+                always_ready.push_back(std::move(interaction));
             }
+            return;
+        }
 
-            timeval timeout;
-            memset(&timeout, 0, sizeof(timeout));
-            timeout.tv_sec  = 0;
-            timeout.tv_usec = 1;
-
-            auto const s =
-                select(*work.fd() + 1, &readfds, &writefds, nullptr, &timeout);
-            if (s == -1) {
-                auto const saved_errno = errno;
-                if constexpr ((false)) {
-                    std::cerr << ("[io][id=" + std::to_string(scheduler_id)
-                                  + "] select(3) error: "
-                                  + std::to_string(saved_errno) + "\n");
-                }
-                kernel.schedule_io(std::move(interaction));
+        auto const fd = *interaction->fd();
+        auto [slot, inserted] = waiting.try_emplace(fd);
+        slot->second.interactions.push_back(std::move(interaction));
+        if (inserted) {
+            /*
+             * Check if the file descriptor can be watched at all. epoll(7)
+             * refuses to watch descriptors which are always ready.
+             */
+            auto ev    = epoll_event{};
+            ev.events  = slot->second.wanted_events();
+            ev.data.fd = fd;
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+                slot->second.events = ev.events;
+                return;
+            }
+            if (errno == EPERM) {
+                always_ready.push_back(
+                    std::move(slot->second.interactions.front()));
+                waiting.erase(slot);
+                return;
+            }
+        }
+        rearm(slot);
+    };
+
+    /*
+     * Run interactions waiting for a file descriptor that became ready. Once
+     * an interaction does not finish the ones queued after it (of the same
+     * kind) must wait, or the data they read or write would be reordered.
+     */
+    auto const on_ready = [&waiting, &kernel, &rearm](int const fd,
+                                                      uint32_t const events)
+        -> void {
+        auto slot = waiting.find(fd);
+        if (slot == waiting.end()) {
+            return;
+        }
+
+        auto const failed = (events & (EPOLLERR | EPOLLHUP));
+        auto can_read     = ((events & EPOLLIN) or failed);
+        auto can_write    = ((events & EPOLLOUT) or failed);
+
+        auto& interactions = slot->second.interactions;
+        for (auto each = interactions.begin(); each != interactions.end();) {
+            auto& work = **each;
+            auto& ready =
+                ((work.kind() == IO_kind::Input) ? can_read : can_write);
+            if (not(ready or work.cancelled())) {
+                ++each;
                 continue;
             }
-            if (s == 0 and (not always_ready)) {
-                if constexpr ((false)) {
-                    std::cerr << ("[io][id=" + std::to_string(scheduler_id)
-                                  + "] select(3) returned 0 for "
-                                  + (work.kind() == IO_kind::Input ? "input"
-                                                                   : "output")
-                                  + " interaction on fd "
-                                  + std::to_string(*work.fd()) + "\n");
-                }
-                if (work.cancelled()) {
-                    kernel.complete_io(
-                        work.id(),
-                        viua::kernel::Kernel::IO_result::make_error(
-                            std::make_unique<viua::types::Exception>(
-                                viua::types::Exception::Tag{"IO_cancel"},
-                                "I/O cancelled")));
+            if (run(kernel, work)) {
+                each = interactions.erase(each);
+            } else {
+                ready = false;
+                ++each;
+            }
+        }
+
+        rearm(slot);
+    };
+
+    auto const on_cancel = [&waiting, &kernel, &rearm]() -> void {
+        for (auto slot = waiting.begin(); slot != waiting.end();) {
+            auto const this_slot = slot++;
+            auto& interactions   = this_slot->second.interactions;
+            for (auto each = interactions.begin(); each != interactions.end();) {
+                if ((*each)->cancelled() and run(kernel, **each)) {
+                    each = interactions.erase(each);
                 } else {
-                    kernel.schedule_io(std::move(interaction));
+                    ++each;
                 }
-                continue;
             }
+            rearm(this_slot);
+        }
+    };
 
-            auto is_ready = false;
-            switch (work.kind()) {
-            case IO_kind::Input:
-                is_ready = FD_ISSET(*work.fd(), &readfds);
-                break;
-            case IO_kind::Output:
-                is_ready = FD_ISSET(*work.fd(), &writefds);
-                break;
-            case IO_kind::Close:
-                is_ready = true;
-                break;
-            default:
-                /* It is safe to do nothing in this case. */
-                break;
-            }
+    constexpr auto MAX_EVENTS = size_t{64};
+    auto events               = std::array<epoll_event, MAX_EVENTS>{};
 
-            if (not is_ready) {
-                kernel.schedule_io(std::move(interaction));
-                continue;
+    auto running = true;
+    while (running) {
+        auto const timeout = (always_ready.empty() ? -1 : 0);
+        auto const n       = epoll_wait(
+            epoll_fd, events.data(), static_cast<int>(events.size()), timeout);
+        if (n == -1) {
+            if constexpr ((false)) {
+                std::cerr << ("[io][id=" + std::to_string(scheduler_id)
+                              + "] epoll_wait(2) error: "
+                              + std::to_string(errno) + "\n");
             }
+            continue;
+        }
+
+        for (auto i = size_t{0}; i < static_cast<size_t>(n); ++i) {
+            auto const fd = events[i].data.fd;
+
+            if (fd == io_request_fd) {
+                /*
+                 * Take one request for every time we manage to decrement the
+                 * counter. A failed read means that other workers took the
+                 * remaining requests.
+                 */
+                auto counter = uint64_t{0};
+                while (running
+                       and read(io_request_fd, &counter, sizeof(counter))
+                               == sizeof(counter)) {
+                    std::unique_ptr<IO_interaction> interaction;
+                    {
+                        std::unique_lock<std::mutex> lck{io_request_mutex};
+                        interaction = std::move(requests.front());
+                        requests.pop_front();
+                    }
+
+                    if (is_sentinel(interaction)) {
+                        if constexpr ((false)) {
+                            std::cerr << ("[io][id="
+                                          + std::to_string(scheduler_id)
+                                          + "] received sentinel\n");
+                        }
+                        running = false;
+                        break;
+                    }
 
-            auto result = work.interact();
-            if (result.state == IO_interaction::State::Complete) {
-                kernel.complete_io(
-                    work.id(),
-                    ((result.status == IO_interaction::Status::Success)
-                         ? viua::kernel::Kernel::IO_result::make_success
-                         : viua::kernel::Kernel::IO_result::make_error)(
-                        std::move(result.result)));
+                    accept(std::move(interaction));
+                }
+            } else if (fd == io_cancel_fd) {
+                /*
+                 * The counter is watched edge-triggered so every worker gets
+                 * a notification for every write to it. It must not be reset,
+                 * though: epoll_wait(2) checks if the counter is still
+                 * readable before reporting it, and would drop the
+                 * notifications of workers which did not get to it before the
+                 * counter was reset.
+                 */
+                on_cancel();
             } else {
-                kernel.schedule_io(std::move(interaction));
+                on_ready(fd, events[i].events);
+            }
+        }
+
+        for (auto i = always_ready.size(); i; --i) {
+            auto interaction = std::move(always_ready.front());
+            always_ready.pop_front();
+            if (not run(kernel, *interaction)) {
+                always_ready.push_back(std::move(interaction));
             }
         }
     }
 
+    close(epoll_fd);
+
     if constexpr ((false)) {
         std::cerr << ("[io][id=" + std::to_string(scheduler_id)
                       + "] scheduler shutting down\n");
@@ -0,0 +1,631 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <viua/kernel/kernel.h>
+#include <viua/scheduler/io.h>
+#include <viua/scheduler/io/interactions.h>
+#include <viua/types/exception.h>
+#include <viua/types/io.h>
+
+using viua::scheduler::io::IO_interaction;
+using viua::scheduler::io::IO_kind;
+
+namespace {
+/*
+ * A minimal io_uring(7) instance. There is no liburing dependency; the rings
+ * are mapped and driven directly, as described in io_uring_setup(2) and
+ * io_uring_enter(2).
+ *
+ * The ring is not synchronised. It is owned by a single I/O worker.
+ */
+class Ring {
+    int ring_fd = -1;
+    io_uring_params params{};
+
+    void* sq_ring       = nullptr;
+    size_t sq_ring_size = 0;
+    void* cq_ring       = nullptr;
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes  = nullptr;
+
+    unsigned* sq_head  = nullptr;
+    unsigned* sq_tail  = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask   = 0;
+    unsigned* cq_head  = nullptr;
+    unsigned* cq_tail  = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask   = 0;
+
+    /*
+     * Tail of the submission queue as seen by the worker. It is only
+     * published to the kernel by submit().
+     */
+    unsigned sqe_tail = 0;
+
+    template<typename T> auto at(void* const ring, uint32_t const offset) -> T*
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+    }
+    auto map(size_t const size, uint64_t const offset) -> void*
+    {
+        auto const p = mmap(nullptr,
+                            size,
+                            (PROT_READ | PROT_WRITE),
+                            (MAP_SHARED | MAP_POPULATE),
+                            ring_fd,
+                            static_cast<off_t>(offset));
+        return ((p == MAP_FAILED) ? nullptr : p);
+    }
+
+  public:
+    auto setup(unsigned const entries) -> bool
+    {
+        ring_fd =
+            static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd == -1) {
+            return false;
+        }
+
+        sq_ring_size =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        auto const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+        if (single_mmap) {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+
+        if ((sq_ring = map(sq_ring_size, IORING_OFF_SQ_RING)) == nullptr) {
+            return false;
+        }
+        cq_ring =
+            (single_mmap ? sq_ring : map(cq_ring_size, IORING_OFF_CQ_RING));
+        if (cq_ring == nullptr) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(
+            map(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+        if (sqes == nullptr) {
+            return false;
+        }
+
+        sq_head  = at<unsigned>(sq_ring, params.sq_off.head);
+        sq_tail  = at<unsigned>(sq_ring, params.sq_off.tail);
+        sq_array = at<unsigned>(sq_ring, params.sq_off.array);
+        sq_mask  = *at<unsigned>(sq_ring, params.sq_off.ring_mask);
+        cq_head  = at<unsigned>(cq_ring, params.cq_off.head);
+        cq_tail  = at<unsigned>(cq_ring, params.cq_off.tail);
+        cqes     = at<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+        cq_mask  = *at<unsigned>(cq_ring, params.cq_off.ring_mask);
+        sqe_tail = *sq_tail;
+
+        return true;
+    }
+
+    auto features() const -> uint32_t
+    {
+        return params.features;
+    }
+
+    /*
+     * Get a zeroed submission queue entry, or nullptr if the queue is full and
+     * must be submitted first.
+     */
+    auto next_sqe() -> io_uring_sqe*
+    {
+        auto const head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        if ((sqe_tail - head) >= params.sq_entries) {
+            return nullptr;
+        }
+
+        auto const index = (sqe_tail & sq_mask);
+        ++sqe_tail;
+
+        sq_array[index] = index;
+        sqes[index]     = io_uring_sqe{};
+        return &sqes[index];
+    }
+
+    /*
+     * Submit all prepared entries and wait until the given number of
+     * completions is available.
+     */
+    auto submit(unsigned const wait_for) -> void
+    {
+        __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+        auto const to_submit =
+            (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE));
+        auto const flags = (wait_for ? IORING_ENTER_GETEVENTS : 0u);
+        while (syscall(__NR_io_uring_enter,
+                       ring_fd,
+                       to_submit,
+                       wait_for,
+                       flags,
+                       nullptr,
+                       size_t{0})
+               == -1) {
+            if (errno != EINTR) {
+                /*
+                 * The caller will reap what there is and try again.
+                 */
+                return;
+            }
+        }
+    }
+
+    template<typename Fn> auto reap(Fn&& fn) -> void
+    {
+        auto head = *cq_head;
+        while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            auto const cqe = cqes[head & cq_mask];
+            __atomic_store_n(cq_head, ++head, __ATOMIC_RELEASE);
+            fn(cqe);
+        }
+    }
+
+    Ring()            = default;
+    Ring(Ring const&) = delete;
+    auto operator=(Ring const&) -> Ring& = delete;
+    ~Ring()
+    {
+        if (sqes != nullptr) {
+            munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+        }
+        if (cq_ring != nullptr and cq_ring != sq_ring) {
+            munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring != nullptr) {
+            munmap(sq_ring, sq_ring_size);
+        }
+        if (ring_fd != -1) {
+            close(ring_fd);
+        }
+    }
+};
+
+/*
+ * Interactions waiting for a single file descriptor. Only the first one of
+ * each kind is submitted to the ring at a time so the data they read or write
+ * is not reordered.
+ */
+struct Queued_on_fd {
+    std::deque<std::unique_ptr<IO_interaction>> input;
+    std::deque<std::unique_ptr<IO_interaction>> output;
+
+    auto of(IO_kind const kind) -> std::deque<std::unique_ptr<IO_interaction>>&
+    {
+        return ((kind == IO_kind::Input) ? input : output);
+    }
+};
+}  // namespace
+
+static auto is_sentinel(std::unique_ptr<IO_interaction> const& item) -> bool
+{
+    return (item.get() == nullptr);
+}
+
+static auto complete(viua::kernel::Kernel& kernel,
+                     IO_interaction& work,
+                     IO_interaction::Interaction_result result) -> void
+{
+    kernel.complete_io(
+        work.id(),
+        ((result.status == IO_interaction::Status::Success)
+             ? viua::kernel::Kernel::IO_result::make_success
+             : viua::kernel::Kernel::IO_result::make_error)(
+            std::move(result.result)));
+}
+
+/*
+ * User data of the entries submitted to the ring. Entries for interactions
+ * carry a pointer to the interaction; pointers are aligned so the lowest bit
+ * is free to mark polls waiting for the interaction's file descriptor.
+ */
+constexpr auto REQUEST_TOKEN = uint64_t{1};
+constexpr auto CANCEL_TOKEN  = uint64_t{2};
+constexpr auto IGNORED_TOKEN = uint64_t{3};
+constexpr auto POLL_BIT      = uint64_t{1};
+
+static auto token_of(IO_interaction const& work) -> uint64_t
+{
+    return reinterpret_cast<uint64_t>(&work);
+}
+
+void viua::scheduler::io::io_uring_scheduler(
+    uint64_t const scheduler_id,
+    viua::kernel::Kernel& kernel,
+    std::deque<std::unique_ptr<IO_interaction>>& requests,
+    std::mutex& io_request_mutex,
+    int const io_request_fd,
+    int const io_cancel_fd)
+{
+    /*
+     * The epoll(7) engine takes over if the kernel does not support
+     * io_uring(7), or if it is not allowed to be used.
+     *
+     * Fast poll is required so that reads and writes of descriptors which are
+     * not ready are not punted to kernel worker threads.
+     */
+    constexpr auto QUEUE_DEPTH = 256u;
+    auto ring                  = Ring{};
+    if (not(ring.setup(QUEUE_DEPTH)
+            and (ring.features() & IORING_FEAT_FAST_POLL))) {
+        std::cerr << ("[io][id=" + std::to_string(scheduler_id)
+                      + "] io_uring(7) is not available, using epoll(7)\n");
+        io_scheduler(scheduler_id,
+                     kernel,
+                     requests,
+                     io_request_mutex,
+                     io_request_fd,
+                     io_cancel_fd);
+        return;
+    }
+
+    pthread_setname_np(pthread_self(), ("io." + std::to_string(scheduler_id)).c_str());
+
+    /*
+     * Interactions are submitted to the ring as reads, writes, and closes of
+     * their file descriptors and are completed when the ring reports the
+     * results, so an I/O worker makes one system call per batch of operations
+     * instead of one per readiness notification and one per operation.
+     *
+     * New requests and cancellations are announced on the same eventfd(2)
+     * counters as for the epoll(7) engine; the counters are polled through the
+     * ring. Cancellation of an interaction already submitted to the ring is
+     * requested from the ring, and the interaction is completed when the ring
+     * reports the operation as cancelled (or finished, if it was too late to
+     * cancel it).
+     */
+    auto queued  = std::map<int, Queued_on_fd>{};
+    auto closing = std::map<IO_interaction*, std::unique_ptr<IO_interaction>>{};
+    auto in_flight = size_t{0};
+
+    auto const next_sqe = [&ring]() -> io_uring_sqe* {
+        auto sqe = ring.next_sqe();
+        while (sqe == nullptr) {
+            ring.submit(0);
+            sqe = ring.next_sqe();
+        }
+        return sqe;
+    };
+
+    auto const arm_request_poll = [&next_sqe, io_request_fd]() -> void {
+        auto sqe           = next_sqe();
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = io_request_fd;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data     = REQUEST_TOKEN;
+    };
+
+    /*
+     * The cancellation counter is shared by all the workers and every one of
+     * them must notice every cancellation. A multishot poll reports every
+     * write to the counter, even if another worker already reset it.
+     */
+    auto multishot_cancel_poll = true;
+    auto const arm_cancel_poll =
+        [&next_sqe, &multishot_cancel_poll, io_cancel_fd]() -> void {
+        auto sqe           = next_sqe();
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = io_cancel_fd;
+        sqe->poll32_events = POLLIN;
+        sqe->user_data     = CANCEL_TOKEN;
+        if (multishot_cancel_poll) {
+            sqe->len = IORING_POLL_ADD_MULTI;
+        }
+    };
+
+    auto const submit_operation = [&next_sqe, &in_flight](
+                                      IO_interaction& work) -> void {
+        auto sqe    = next_sqe();
+        sqe->fd     = *work.fd();
+        sqe->opcode = IORING_OP_CLOSE;
+        if (work.kind() != IO_kind::Close) {
+            /*
+             * Offset of -1 means "use the file position", like read(2) and
+             * write(2) do.
+             */
+            auto const [data, size] = work.transfer_buffer();
+            sqe->opcode             = ((work.kind() == IO_kind::Input)
+                                           ? IORING_OP_READ
+                                           : IORING_OP_WRITE);
+            sqe->addr               = reinterpret_cast<uint64_t>(data);
+            sqe->len                = static_cast<uint32_t>(size);
+            sqe->off                = std::numeric_limits<uint64_t>::max();
+        }
+        sqe->user_data = token_of(work);
+        ++in_flight;
+    };
+
+    /*
+     * Descriptors opened in non-blocking mode are not waited for by the ring
+     * so their operations may fail with EAGAIN. Wait for such a descriptor to
+     * become ready before submitting the operation again.
+     */
+    auto const submit_poll = [&next_sqe, &in_flight](IO_interaction& work)
+        -> void {
+        auto sqe           = next_sqe();
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->fd            = *work.fd();
+        sqe->poll32_events =
+            ((work.kind() == IO_kind::Input) ? POLLIN : POLLOUT);
+        sqe->user_data     = (token_of(work) | POLL_BIT);
+        ++in_flight;
+    };
+
+    auto const submit_cancel = [&next_sqe](uint64_t const target) -> void {
+        auto sqe       = next_sqe();
+        sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+        sqe->fd        = -1;
+        sqe->addr      = target;
+        sqe->user_data = IGNORED_TOKEN;
+    };
+    auto const cancel_in_flight = [&submit_cancel](IO_interaction& work)
+        -> void {
+        submit_cancel(token_of(work));
+        submit_cancel(token_of(work) | POLL_BIT);
+    };
+
+    /*
+     * Submit the first interaction waiting in the queue, completing the
+     * cancelled ones on the way. Forget the descriptor if nothing waits for it
+     * anymore.
+     */
+    auto const submit_next =
+        [&queued, &kernel, &submit_operation](
+            std::map<int, Queued_on_fd>::iterator slot,
+            IO_kind const kind) -> void {
+        auto& interactions = slot->second.of(kind);
+        while ((not interactions.empty())
+               and interactions.front()->cancelled()) {
+            complete(kernel,
+                     *interactions.front(),
+                     interactions.front()->interact());
+            interactions.pop_front();
+        }
+        if (not interactions.empty()) {
+            submit_operation(*interactions.front());
+        }
+        if (slot->second.input.empty() and slot->second.output.empty()) {
+            queued.erase(slot);
+        }
+    };
+
+    auto const accept = [&queued, &closing, &kernel, &submit_operation](
+                            std::unique_ptr<IO_interaction> interaction)
+        -> void {
+        if (not interaction->fd().has_value()) {
+            /*
+             * Do not work with interactions that do not expose file
+             * descriptors. Just fail them. Maybe next time they will behave
+             * better.
+             */
+            kernel.complete_io(
+                interaction->id(),
+                viua::kernel::Kernel::IO_result::make_error(
+                    std::make_unique<viua::types::Exception>(
+                        viua::types::Exception::Tag{"IO_without_fd"},
+                        "I/O port did not expose file descriptor")));
+            return;
+        }
+
+        if (interaction->cancelled()) {
+            complete(kernel, *interaction, interaction->interact());
+            return;
+        }
+
+        if (interaction->kind() == IO_kind::Close) {
+            submit_operation(*interaction);
+            auto const key = interaction.get();
+            closing.emplace(key, std::move(interaction));
+            return;
+        }
+
+        auto& interactions =
+            queued[*interaction->fd()].of(interaction->kind());
+        interactions.push_back(std::move(interaction));
+        if (interactions.size() == 1) {
+            submit_operation(*interactions.front());
+        }
+    };
+
+    auto const on_cancel = [&queued, &kernel, &cancel_in_flight]() -> void {
+        for (auto& [fd, slot] : queued) {
+            for (auto const kind : {IO_kind::Input, IO_kind::Output}) {
+                auto& interactions = slot.of(kind);
+                if (interactions.empty()) {
+                    continue;
+                }
+                if (interactions.front()->cancelled()) {
+                    cancel_in_flight(*interactions.front());
+                }
+                for (auto each = std::next(interactions.begin());
+                     each != interactions.end();) {
+                    if ((*each)->cancelled()) {
+                        complete(kernel, **each, (*each)->interact());
+                        each = interactions.erase(each);
+                    } else {
+                        ++each;
+                    }
+                }
+            }
+        }
+    };
+
+    auto running = true;
+
+    auto const on_request = [&]() -> void {
+        /*
+         * Take one request for every time we manage to decrement the counter.
+         * A failed read means that other workers took the remaining requests.
+         */
+        auto counter = uint64_t{0};
+        while (running
+               and read(io_request_fd, &counter, sizeof(counter))
+                       == sizeof(counter)) {
+            std::unique_ptr<IO_interaction> interaction;
+            {
+                std::unique_lock<std::mutex> lck{io_request_mutex};
+                interaction = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            if (is_sentinel(interaction)) {
+                if constexpr ((false)) {
+                    std::cerr << ("[io][id=" + std::to_string(scheduler_id)
+                                  + "] received sentinel\n");
+                }
+                running = false;
+                break;
+            }
+
+            accept(std::move(interaction));
+        }
+    };
+
+    auto const on_completion = [&](io_uring_cqe const& cqe) -> void {
+        if (cqe.user_data == IGNORED_TOKEN) {
+            return;
+        }
+        if (cqe.user_data == REQUEST_TOKEN) {
+            on_request();
+            if (running) {
+                arm_request_poll();
+            }
+            return;
+        }
+        if (cqe.user_data == CANCEL_TOKEN) {
+            if (cqe.res == -EINVAL and multishot_cancel_poll) {
+                /*
+                 * Multishot polls are not supported by the kernel. A
+                 * cancellation may be missed (and only noticed on the next
+                 * one) if another worker resets the counter before the poll is
+                 * armed again, but that is the best we can do.
+                 */
+                multishot_cancel_poll = false;
+            } else if (cqe.res >= 0) {
+                /*
+                 * Reading the counter only keeps it from overflowing.
+                 */
+                auto counter = uint64_t{0};
+                [[maybe_unused]] auto const _ =
+                    read(io_cancel_fd, &counter, sizeof(counter));
+                on_cancel();
+            }
+            if (running and not(cqe.flags & IORING_CQE_F_MORE)) {
+                arm_cancel_poll();
+            }
+            return;
+        }
+
+        --in_flight;
+        if (not running) {
+            /*
+             * The worker is shutting down and is only waiting for the ring to
+             * let go of the interactions' buffers.
+             */
+            return;
+        }
+
+        auto& work =
+            *reinterpret_cast<IO_interaction*>(cqe.user_data & ~POLL_BIT);
+        auto const polled = static_cast<bool>(cqe.user_data & POLL_BIT);
+
+        if (work.kind() == IO_kind::Close) {
+            auto const owner = closing.find(&work);
+            complete(kernel, work, work.finish(cqe.res));
+            closing.erase(owner);
+            return;
+        }
+
+        auto const retry = (polled ? (cqe.res >= 0) : (cqe.res == -EAGAIN));
+        if (retry and not work.cancelled()) {
+            if (polled) {
+                submit_operation(work);
+            } else {
+                submit_poll(work);
+            }
+            return;
+        }
+
+        /*
+         * A cancelled interaction is reported as cancelled no matter what the
+         * ring says. The completion may be the one of its poll, whose result
+         * is a poll mask and not a number of bytes transferred.
+         */
+        auto result = work.finish(work.cancelled() ? -ECANCELED : cqe.res);
+        if (result.state != IO_interaction::State::Complete) {
+            submit_operation(work);
+            return;
+        }
+        complete(kernel, work, std::move(result));
+
+        auto slot = queued.find(*work.fd());
+        auto const kind = work.kind();
+        slot->second.of(kind).pop_front();
+        submit_next(slot, kind);
+    };
+
+    arm_request_poll();
+    arm_cancel_poll();
+
+    while (running) {
+        ring.submit(1);
+        ring.reap(on_completion);
+    }
+
+    /*
+     * The ring may still write to the buffers of interactions that were not
+     * finished so they must not be freed before the ring lets go of them.
+     */
+    for (auto& [fd, slot] : queued) {
+        for (auto const kind : {IO_kind::Input, IO_kind::Output}) {
+            if (not slot.of(kind).empty()) {
+                cancel_in_flight(*slot.of(kind).front());
+            }
+        }
+    }
+    while (in_flight) {
+        ring.submit(1);
+        ring.reap(on_completion);
+    }
+
+    if constexpr ((false)) {
+        std::cerr << ("[io][id=" + std::to_string(scheduler_id)
+                      + "] scheduler shutting down\n");
+    }
+}
@@ -26,6 +26,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 
 #include <viua/kernel/kernel.h>
 #include <viua/machine.h>
@@ -33,6 +34,7 @@
 #include <viua/process.h>
 #include <viua/scheduler/process.h>
 #include <viua/support/env.h>
+#include <viua/types/atom.h>
 #include <viua/types/exception.h>
 #include <viua/types/function.h>
 #include <viua/types/io.h>
@@ -242,25 +244,158 @@ static void print_stack_trace(viua::process::Process& process)
 namespace viua { namespace scheduler {
 auto Process_scheduler::push(std::unique_ptr<process_type> proc) -> void
 {
-    std::lock_guard<std::mutex> lck{process_queue_mtx};
-    process_queue.push_back(std::move(proc));
+    /*
+     * Must only be called from the scheduler's own thread (or before the
+     * scheduler is launched).
+     */
+    if (proc->pinned()) {
+        if (pinned_queue.empty()) {
+            pinned_turn_in = run_queue.size();
+        }
+        pinned_queue.push_back(std::move(proc));
+        return;
+    }
+    run_queue.push(proc.release());
 }
 auto Process_scheduler::pop() -> std::unique_ptr<process_type>
 {
-    std::lock_guard<std::mutex> lck{process_queue_mtx};
-    auto proc = std::move(process_queue.front());
-    process_queue.pop_front();
+    if (any_woken.load(std::memory_order_acquire) or not timeouts.empty()) {
+        auto became_ready = false;
+        {
+            std::lock_guard<std::mutex> lck{process_queue_mtx};
+            if (not timeouts.empty()) {
+                became_ready = expire_timeouts();
+            }
+            became_ready = take_woken() or became_ready;
+        }
+
+        /*
+         * Processes woken up by messages, I/O, or timeouts can be stolen just
+         * like freshly spawned ones so tell the idle schedulers about them.
+         */
+        if (became_ready) {
+            attached_kernel.notify_about_process_woken();
+        }
+    }
+
+    auto proc = std::unique_ptr<process_type>{};
+    if (pinned_queue.empty() or pinned_turn_in) {
+        proc.reset(run_queue.steal());
+    }
+    if (proc) {
+        if (pinned_turn_in) {
+            --pinned_turn_in;
+        }
+    } else if (not pinned_queue.empty()) {
+        proc = std::move(pinned_queue.front());
+        pinned_queue.pop_front();
+        pinned_turn_in = run_queue.size();
+    } else {
+        return nullptr;
+    }
+
+    /*
+     * Any wake-up that arrived before the process starts running is stale: the
+     * process will see whatever it was waiting for when it runs.
+     */
+    forget_pending_wakeup(proc->pid());
+
     return proc;
 }
-auto Process_scheduler::size() const -> size_type
+
+auto Process_scheduler::park(std::unique_ptr<process_type> proc) -> void
+{
+    std::lock_guard<std::mutex> lck{process_queue_mtx};
+    if (pending_wakeups.erase(proc->pid())) {
+        any_pending.store(not pending_wakeups.empty(),
+                          std::memory_order_relaxed);
+        push(std::move(proc));
+        return;
+    }
+
+    if (auto const deadline = proc->wakeup_deadline(); deadline) {
+        timeouts.insert(*deadline, proc->pid());
+    }
+    auto const pid = proc->pid();
+    parked_processes.emplace(pid, std::move(proc));
+}
+auto Process_scheduler::expire_timeouts() -> bool
+{
+    /*
+     * Must be called with the process queue mutex held. Returns true if any
+     * process became ready to run.
+     */
+    auto expired = std::vector<viua::process::PID>{};
+    timeouts.advance(Timer_wheel::clock_type::now(), expired);
+    auto any_expired = false;
+    for (auto const& pid : expired) {
+        /*
+         * Timers are not cancelled when a process is woken up by other means.
+         */
+        auto const proc = parked_processes.find(pid);
+        if (proc == parked_processes.end()) {
+            continue;
+        }
+        push(std::move(proc->second));
+        parked_processes.erase(proc);
+        any_expired = true;
+    }
+    return any_expired;
+}
+auto Process_scheduler::take_woken() -> bool
+{
+    /*
+     * Must be called with the process queue mutex held. Returns true if any
+     * process became ready to run.
+     */
+    auto const any_taken = not woken_processes.empty();
+    for (auto& each : woken_processes) {
+        push(std::move(each));
+    }
+    woken_processes.clear();
+    any_woken.store(false, std::memory_order_relaxed);
+    return any_taken;
+}
+auto Process_scheduler::forget_pending_wakeup(viua::process::PID const pid)
+    -> void
 {
+    if (not any_pending.load(std::memory_order_relaxed)) {
+        return;
+    }
     std::lock_guard<std::mutex> lck{process_queue_mtx};
-    return process_queue.size();
+    pending_wakeups.erase(pid);
+    any_pending.store(not pending_wakeups.empty(), std::memory_order_relaxed);
 }
-auto Process_scheduler::empty() const -> bool
+auto Process_scheduler::any_parked() const -> bool
 {
     std::lock_guard<std::mutex> lck{process_queue_mtx};
-    return process_queue.empty();
+    return not parked_processes.empty();
+}
+auto Process_scheduler::wait_for_wakeup() -> void
+{
+    std::unique_lock<std::mutex> lck{process_queue_mtx};
+    auto const ready = [this] { return not woken_processes.empty(); };
+    if (auto const deadline = timeouts.next_expiry(); deadline) {
+        process_queue_cv.wait_until(lck, *deadline, ready);
+    } else {
+        process_queue_cv.wait(lck, ready);
+    }
+}
+auto Process_scheduler::wake(viua::process::PID const pid) -> void
+{
+    {
+        std::lock_guard<std::mutex> lck{process_queue_mtx};
+        auto const proc = parked_processes.find(pid);
+        if (proc == parked_processes.end()) {
+            pending_wakeups.insert(pid);
+            any_pending.store(true, std::memory_order_relaxed);
+            return;
+        }
+        woken_processes.push_back(std::move(proc->second));
+        parked_processes.erase(proc);
+        any_woken.store(true, std::memory_order_release);
+    }
+    process_queue_cv.notify_one();
 }
 
 Process_scheduler::Process_scheduler(viua::kernel::Kernel& k, id_type const x)
@@ -268,7 +403,11 @@ Process_scheduler::Process_scheduler(viua::kernel::Kernel& k, id_type const x)
 {}
 
 Process_scheduler::~Process_scheduler()
-{}
+{
+    while (auto const proc = run_queue.pop()) {
+        delete proc;
+    }
+}
 
 auto Process_scheduler::id() const -> id_type
 {
@@ -291,6 +430,12 @@ auto Process_scheduler::bootstrap(std::vector<std::string> args) -> void
     main_process = spawn(std::move(initial_frame), nullptr, true);
     main_process->priority(16);
     main_process->pin();
+
+    /*
+     * The main process was put in the run queue before it was pinned. Nothing
+     * runs yet so it can be safely moved to the queue for pinned processes.
+     */
+    push(std::unique_ptr<process_type>{run_queue.pop()});
 }
 
 auto Process_scheduler::spawn(std::unique_ptr<Frame> frame,
@@ -312,7 +457,7 @@ auto Process_scheduler::spawn(std::unique_ptr<Frame> frame,
         process->detach();
     }
 
-    attached_kernel.create_mailbox(pid_of_new_process);
+    process->attach_mailbox(attached_kernel.create_mailbox(pid_of_new_process));
     if (not disown) {
         attached_kernel.create_result_slot_for(pid_of_new_process);
     }
@@ -328,43 +473,17 @@ auto Process_scheduler::spawn(std::unique_ptr<Frame> frame,
 
     return process_ptr;
 }
-auto Process_scheduler::give_up_processes()
-    -> std::vector<std::unique_ptr<process_type>>
+auto Process_scheduler::steal() -> std::unique_ptr<process_type>
 {
-    std::lock_guard<std::mutex> lck{process_queue_mtx};
-
-    /*
-     * If we have no or only one process then do not give up anything. It would
-     * be counterproductive to give up our only process, be left with no work to
-     * do, and go straight into the wait queue to steal some processes...
-     */
-    if (process_queue.empty() or (process_queue.size() == 1)) {
-        return {};
-    }
-
-    auto const give_up_limit =
-        static_cast<int64_t>(((process_queue.size() * 100) / 141)
-                             - process_queue.size())
-        * -1;
-
-    auto given_up = std::vector<std::unique_ptr<process_type>>{};
-    auto saved    = std::vector<std::unique_ptr<process_type>>{};
-
-    for (auto i = 0; i < give_up_limit; ++i) {
-        auto proc = std::move(process_queue.front());
-        process_queue.pop_front();
-        if (proc->pinned()) {
-            saved.push_back(std::move(proc));
-        } else {
-            given_up.push_back(std::move(proc));
-        }
+    auto proc = std::unique_ptr<process_type>{run_queue.steal()};
+    if (proc) {
+        forget_pending_wakeup(proc->pid());
     }
-
-    for (auto& proc : saved) {
-        process_queue.push_back(std::move(proc));
-    }
-
-    return given_up;
+    return proc;
+}
+auto Process_scheduler::stealable() const -> size_type
+{
+    return run_queue.size();
 }
 
 auto Process_scheduler::is_joinable(viua::process::PID const pid) const -> bool
@@ -392,18 +511,19 @@ auto Process_scheduler::transfer_result_of(viua::process::PID const pid) const
     return attached_kernel.transfer_result_of(pid);
 }
 
+auto Process_scheduler::wake_up_on_stop(viua::process::PID const pid,
+                                        viua::process::PID const waiting)
+    -> bool
+{
+    return attached_kernel.wake_up_on_stop(pid, this, waiting);
+}
+
 auto Process_scheduler::send(viua::process::PID const pid,
                              std::unique_ptr<viua::types::Value> message)
     -> void
 {
     attached_kernel.send(pid, std::move(message));
 }
-auto Process_scheduler::receive(
-    viua::process::PID const pid,
-    std::queue<std::unique_ptr<viua::types::Value>>& message_queue) -> void
-{
-    attached_kernel.receive(pid, message_queue);
-}
 
 auto Process_scheduler::request_ffi_call(std::unique_ptr<Frame> frame,
                                          viua::process::Process& p) -> void
@@ -443,6 +563,34 @@ auto Process_scheduler::get_entry_point_of_function(std::string const& name)
 {
     return attached_kernel.get_entry_point_of(name);
 }
+auto Process_scheduler::cached_call_target(
+    viua::internals::types::Op_address_type const site) -> Call_target const*
+{
+    return call_sites.find(site, attached_kernel.link_generation());
+}
+auto Process_scheduler::resolve_call_target(
+    viua::internals::types::Op_address_type const site,
+    std::string const& name,
+    viua::internals::types::Op_address_type const next) -> Call_target const*
+{
+    if (auto const cached = cached_call_target(site);
+        cached and cached->name == name) {
+        return cached;
+    }
+
+    auto target = Call_target{};
+    target.name = name;
+    target.next = next;
+    if (attached_kernel.is_native_function(name)) {
+        std::tie(target.entry_point, target.jump_base) =
+            attached_kernel.get_entry_point_of(name);
+    } else if (attached_kernel.is_foreign_function(name)) {
+        target.foreign = true;
+    } else {
+        return nullptr;
+    }
+    return &call_sites.insert(site, std::move(target));
+}
 
 template<typename T> struct deferred {
     T const& fn_to_call;
@@ -483,8 +631,27 @@ auto Process_scheduler::operator()() -> void
     auto any_active = false;
 
     while (true) {
-        if (empty()) {
-            auto stolen_processes = attached_kernel.steal_processes();
+        auto a_process = pop();
+
+        if (not a_process) {
+            /*
+             * If any processes are parked on this scheduler there is nothing
+             * to do but wait until one of them is woken up or its timeout
+             * passes. Waking up is how the wait ends, and a scheduler that
+             * waits does not use any CPU time.
+             */
+            if (any_parked()) {
+                wait_for_wakeup();
+                continue;
+            }
+
+            /*
+             * Remember how much work was announced before looking for some.
+             * If nothing can be stolen the scheduler goes to sleep until more
+             * work is announced, unless some was announced in the meantime.
+             */
+            auto const seen_work = attached_kernel.work_announced();
+            auto stolen_processes = attached_kernel.steal_processes(this);
             if (stolen_processes.empty()) {
                 /*
                  *  If there are no processes to steal, there is nothing we can
@@ -496,29 +663,25 @@ auto Process_scheduler::operator()() -> void
 
                 /*
                  *  If there are processes running on the VM, but we were not
-                 *  able to steal any of them, let's wait again and see if the
+                 *  able to steal any of them, let's wait and see if the
                  *  situation will change.
                  */
+                attached_kernel.wait_for_work(seen_work);
                 continue;
             }
 
-            {
+            for (auto& each : stolen_processes) {
                 /*
-                 * Obtain the lock once for all of the stolen processes instead
-                 * of using the push() function which would pay the cost of
-                 * acquiring the lock for every process pushed.
+                 * Wake-ups are delivered to the scheduler the process is
+                 * attached to so it must know where it runs now.
                  */
-                std::lock_guard<std::mutex> lck{process_queue_mtx};
-                for (auto& each : stolen_processes) {
-                    process_queue.push_back(std::move(each));
-                }
+                each->migrate_to(this);
+                push(std::move(each));
             }
 
             continue;
         }
 
-        auto a_process = pop();
-
 #if 0
         auto const push_the_process_back = deferred([&a_process, this]{
             process_queue.push_back(std::move(a_process));
@@ -526,8 +689,7 @@ auto Process_scheduler::operator()() -> void
 #endif
 
         if (a_process->suspended()) {
-            // return true in execute_quant()
-            push(std::move(a_process));
+            park(std::move(a_process));
             continue;
         }
 
@@ -550,6 +712,14 @@ auto Process_scheduler::operator()() -> void
             }
 
             a_process->tick();
+
+            if (a_process->blocked()) {
+                /*
+                 * The process waits for something to happen and would only
+                 * spin on the same instruction until it does.
+                 */
+                break;
+            }
         }
 
         any_active =
@@ -587,7 +757,11 @@ auto Process_scheduler::operator()() -> void
              * is waking the process up so as long as the process is suspended
              * it must be considered to be running.
              */
-            push(std::move(a_process));
+            park(std::move(a_process));
+            continue;
+        }
+        if (a_process->blocked()) {
+            park(std::move(a_process));
             continue;
         }
         if (a_process->terminated() and not a_process->joinable()
@@ -640,13 +814,18 @@ auto Process_scheduler::operator()() -> void
                     }
                 }
 
+                using viua::types::Atom;
+                static auto const function_key   = Atom::intern("function");
+                static auto const exception_key  = Atom::intern("exception");
+                static auto const parameters_key = Atom::intern("parameters");
+
                 auto death_message = std::make_unique<viua::types::Struct>();
-                death_message->insert("function",
+                death_message->insert(function_key,
                                       std::make_unique<viua::types::Function>(
                                           tr.at(0)->function_name));
                 auto exc = a_process->transfer_active_exception();
-                death_message->insert("exception", std::move(exc));
-                death_message->insert("parameters", std::move(parameters));
+                death_message->insert(exception_key, std::move(exc));
+                death_message->insert(parameters_key, std::move(parameters));
 
                 auto death_frame = a_process->frame_for_watchdog();
                 death_frame->arguments->set(0, std::move(death_message));
@@ -728,4 +907,11 @@ auto Process_scheduler::io_result(
 {
     return attached_kernel.io_result(interaction_id);
 }
+
+auto Process_scheduler::wake_up_on_io(
+    viua::scheduler::io::IO_interaction::id_type const interaction_id,
+    viua::process::PID const waiting) -> bool
+{
+    return attached_kernel.wake_up_on_io(interaction_id, this, waiting);
+}
 }}  // namespace viua::scheduler
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2023 Marek Marecki
+ *
+ *  This file is part of Viua VM.
+ *
+ *  Viua VM is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Viua VM is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <viua/scheduler/timer_wheel.h>
+
+
+namespace viua { namespace scheduler {
+auto Timer_wheel::tick_of(time_point_type const t) -> tick_type
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               t.time_since_epoch())
+        .count();
+}
+auto Timer_wheel::slot_of(tick_type const t) -> size_type
+{
+    return static_cast<size_type>(t) % SLOTS;
+}
+
+auto Timer_wheel::insert(time_point_type const deadline,
+                         viua::process::PID const pid) -> void
+{
+    /*
+     * Deadlines that already passed go into the current slot so they fire the
+     * next time the wheel is turned.
+     */
+    auto const tick = std::max(tick_of(deadline), current_tick);
+    slots[slot_of(tick)].push_back(Timer{deadline, pid});
+    ++armed;
+}
+
+auto Timer_wheel::advance(time_point_type const now,
+                          std::vector<viua::process::PID>& expired) -> void
+{
+    auto const target = tick_of(now);
+    if (armed == 0) {
+        current_tick = std::max(current_tick, target);
+        return;
+    }
+
+    /*
+     * There is no need to look at any slot twice, even if the wheel was not
+     * turned for longer than a full turn.
+     */
+    auto const turns = std::clamp(
+        target - current_tick + 1, tick_type{1}, static_cast<tick_type>(SLOTS));
+    for (auto i = tick_type{0}; i < turns and armed; ++i) {
+        auto& slot = slots[slot_of(current_tick + i)];
+        if (slot.empty()) {
+            continue;
+        }
+
+        /*
+         * PIDs are not assignable so the timers which are still armed are
+         * moved to a fresh slot instead of being shuffled around in place.
+         */
+        auto still_armed = std::vector<Timer>{};
+        for (auto& each : slot) {
+            if (each.deadline > now) {
+                still_armed.push_back(std::move(each));
+                continue;
+            }
+            expired.push_back(each.pid);
+            --armed;
+        }
+        slot.swap(still_armed);
+    }
+
+    current_tick = std::max(current_tick, target);
+}
+
+auto Timer_wheel::next_expiry() const -> std::optional<time_point_type>
+{
+    if (armed == 0) {
+        return {};
+    }
+
+    for (auto i = tick_type{0}; i < static_cast<tick_type>(SLOTS); ++i) {
+        auto const tick = current_tick + i;
+        auto earliest   = std::optional<time_point_type>{};
+        for (auto const& each : slots[slot_of(tick)]) {
+            if (tick_of(each.deadline) > tick) {
+                continue;
+            }
+            if ((not earliest) or each.deadline < *earliest) {
+                earliest = each.deadline;
+            }
+        }
+        if (earliest) {
+            return earliest;
+        }
+    }
+
+    /*
+     * All armed timers are more than a full turn away.
+     */
+    return time_point_type{std::chrono::milliseconds{
+        current_tick + static_cast<tick_type>(SLOTS)}};
+}
+
+auto Timer_wheel::size() const -> size_type
+{
+    return armed;
+}
+auto Timer_wheel::empty() const -> bool
+{
+    return (armed == 0);
+}
+}}  // namespace viua::scheduler
@@ -436,41 +436,246 @@ auto Function_state::dump(std::ostream& o) const -> void
     o << "  local registers allocated: " << local_registers_allocated
       << std::endl;
     for (auto const& each : register_index_to_name) {
-        std::cout << "  register " << each.first << " named `" << each.second
-                  << "'" << std::endl;
+        o << "  register " << each.first << " named `" << each.second << "'"
+          << std::endl;
     }
     for (auto const& each : defined_registers) {
-        std::cout << "  " << to_string(each.first.second) << " register "
-                  << each.first.first << ": contains "
-                  << to_string(each.second);
-        std::cout << std::endl;
+        o << "  " << to_string(each.first.second) << " register "
+          << each.first.first << ": contains " << to_string(each.second);
+        o << std::endl;
     }
 }
 
+auto Function_state::copy_from(Function_state const& that) -> void
+{
+    local_registers_allocated_where = that.local_registers_allocated_where;
+
+    register_renames       = that.register_renames;
+    register_name_to_index = that.register_name_to_index;
+    register_index_to_name = that.register_index_to_name;
+
+    iota_value = that.iota_value;
+
+    /*
+     * Values are cloned in order so the indexes stay the same, and every
+     * wrapper must then be rebound to point into our own values instead of
+     * the values of the state we are copying.
+     */
+    assigned_values.clear();
+    assigned_values.reserve(that.assigned_values.size());
+    for (auto const& each : that.assigned_values) {
+        assigned_values.emplace_back(
+            values::Value::clone(*each, assigned_values));
+    }
+
+    defined_registers.clear();
+    for (auto const& each : that.defined_registers) {
+        defined_registers.emplace(each.first,
+                                  each.second.rebind(assigned_values));
+    }
+    defined_where = that.defined_where;
+    mutated_where = that.mutated_where;
+    erased_registers.clear();
+    for (auto const& each : that.erased_registers) {
+        erased_registers.emplace(each.first,
+                                 each.second.rebind(assigned_values));
+    }
+    erased_where = that.erased_where;
+}
+
 auto Function_state::clone() const -> Function_state
 {
     auto function_state = Function_state{local_registers_allocated,
                                          local_registers_allocated_where};
+    function_state.copy_from(*this);
+    return function_state;
+}
 
-    function_state.register_renames       = register_renames;
-    function_state.register_name_to_index = register_name_to_index;
-    function_state.register_index_to_name = register_index_to_name;
+auto Function_state::reset_to(Function_state const& that) -> void
+{
+    copy_from(that);
+}
 
-    function_state.iota_value = iota_value;
+auto Function_state::import_value(values::Value_wrapper const& wrapper)
+    -> values::Value_wrapper
+{
+    auto const& value = wrapper.value();
 
-    function_state.assigned_values.reserve(assigned_values.size());
-    for (auto const& each : assigned_values) {
-        function_state.assigned_values.emplace_back(
-            values::Value::clone(*each, function_state.assigned_values));
+    using values::Value_type;
+    if (value.type() == Value_type::Vector) {
+        return make_wrapper(std::make_unique<values::Vector>(import_value(
+            static_cast<values::Vector const&>(value).of())));
     }
+    if (value.type() == Value_type::Pointer) {
+        return make_wrapper(std::make_unique<values::Pointer>(import_value(
+            static_cast<values::Pointer const&>(value).of())));
+    }
+    if (value.type() == Value_type::Struct) {
+        auto imported = std::make_unique<values::Struct>();
+        for (auto const& each :
+             static_cast<values::Struct const&>(value).fields()) {
+            imported->field(each.first, import_value(each.second));
+        }
+        return make_wrapper(std::move(imported));
+    }
+    return make_wrapper(values::Value::clone(value, assigned_values));
+}
 
-    function_state.defined_registers = defined_registers;
-    function_state.defined_where     = defined_where;
-    function_state.mutated_where     = mutated_where;
-    function_state.erased_registers  = erased_registers;
-    function_state.erased_where      = erased_where;
+auto Function_state::join_values(values::Value_wrapper mine,
+                                 values::Value_wrapper const& theirs) -> bool
+{
+    auto const& a = mine.value();
+    auto const& b = theirs.value();
 
-    return function_state;
+    using values::Value_type;
+    if (a.type() == Value_type::Value) {
+        return false;
+    }
+    if (a.type() != b.type()) {
+        mine.value(std::make_unique<values::Value>(Value_type::Value));
+        return true;
+    }
+
+    switch (a.type()) {
+    case Value_type::Integer:
+    {
+        auto const& x = static_cast<values::Integer const&>(a);
+        auto const& y = static_cast<values::Integer const&>(b);
+        if (x.known() and ((not y.known()) or (x.of() != y.of()))) {
+            mine.value(std::make_unique<values::Integer>());
+            return true;
+        }
+        return false;
+    }
+    case Value_type::Atom:
+    {
+        auto const& x = static_cast<values::Atom const&>(a);
+        auto const& y = static_cast<values::Atom const&>(b);
+        if (x.known() and ((not y.known()) or (x.of() != y.of()))) {
+            mine.value(std::make_unique<values::Atom>());
+            return true;
+        }
+        return false;
+    }
+    case Value_type::Vector:
+        return join_values(static_cast<values::Vector const&>(a).of(),
+                           static_cast<values::Vector const&>(b).of());
+    case Value_type::Pointer:
+        return join_values(static_cast<values::Pointer const&>(a).of(),
+                           static_cast<values::Pointer const&>(b).of());
+    case Value_type::Closure:
+    {
+        auto const& x = static_cast<values::Closure const&>(a);
+        auto const& y = static_cast<values::Closure const&>(b);
+        if ((not x.of().empty()) and (x.of() != y.of())) {
+            mine.value(std::make_unique<values::Closure>());
+            return true;
+        }
+        return false;
+    }
+    case Value_type::Function:
+    {
+        auto const& x = static_cast<values::Function const&>(a);
+        auto const& y = static_cast<values::Function const&>(b);
+        if ((not x.of().empty()) and (x.of() != y.of())) {
+            mine.value(std::make_unique<values::Function>());
+            return true;
+        }
+        return false;
+    }
+    case Value_type::Value:
+    case Value_type::Float:
+    case Value_type::String:
+    case Value_type::Text:
+    case Value_type::Boolean:
+    case Value_type::Bits:
+    case Value_type::Pid:
+        return false;
+    case Value_type::Struct:
+    {
+        /*
+         * Only the fields known on both paths are known after they meet.
+         */
+        auto const& x = static_cast<values::Struct const&>(a);
+        auto const& y = static_cast<values::Struct const&>(b);
+
+        auto changed = false;
+        auto dropped = false;
+        auto joined  = std::make_unique<values::Struct>();
+        for (auto const& each : x.fields()) {
+            if (auto const other = y.field(each.first); other.has_value()) {
+                changed = join_values(each.second, *other) or changed;
+                joined->field(each.first, each.second);
+            } else {
+                dropped = true;
+            }
+        }
+        if (dropped) {
+            mine.value(std::move(joined));
+        }
+        return (changed or dropped);
+    }
+    default:
+        return false;
+    }
+}
+
+auto Function_state::join(Function_state const& that) -> bool
+{
+    auto changed = false;
+
+    /*
+     * A register is defined after two paths meet only if it was defined on
+     * both of them, and its value is whatever is common to the values it had
+     * on each path.
+     */
+    for (auto each = defined_registers.begin();
+         each != defined_registers.end();) {
+        auto const other = that.defined_registers.find(each->first);
+        if (other == that.defined_registers.end()) {
+            defined_where.erase(each->first);
+            each    = defined_registers.erase(each);
+            changed = true;
+            continue;
+        }
+        changed = join_values(each->second, other->second) or changed;
+        ++each;
+    }
+
+    /*
+     * A register erased on any of the paths is reported as erased, so that
+     * reads from it can point to the place where it was erased.
+     */
+    for (auto const& each : that.erased_registers) {
+        if (erased_registers.count(each.first)) {
+            continue;
+        }
+        erased_registers.emplace(each.first, import_value(each.second));
+        erased_where.insert_or_assign(each.first,
+                                      that.erased_where.at(each.first));
+        changed = true;
+    }
+
+    for (auto each = register_index_to_name.begin();
+         each != register_index_to_name.end();) {
+        auto const other = that.register_index_to_name.find(each->first);
+        if (other == that.register_index_to_name.end()
+            or other->second != each->second) {
+            register_name_to_index.erase(each->second);
+            register_renames.erase(each->first);
+            each    = register_index_to_name.erase(each);
+            changed = true;
+            continue;
+        }
+        ++each;
+    }
+
+    if (that.iota_value < iota_value) {
+        iota_value = that.iota_value;
+        changed    = true;
+    }
+
+    return changed;
 }
 
 auto Function_state::local_capacity() const
@@ -487,24 +692,9 @@ Function_state::Function_state(
 {}
 
 Function_state::Function_state(Function_state&& that)
-        : local_registers_allocated{std::move(that.local_registers_allocated)}
-        , local_registers_allocated_where{std::move(
-              that.local_registers_allocated_where)}
-        , register_renames{std::move(that.register_renames)}
-        , register_name_to_index{std::move(that.register_name_to_index)}
-        , register_index_to_name{std::move(that.register_index_to_name)}
-        , iota_value{std::move(that.iota_value)}
-        , assigned_values{}
-        , defined_registers{std::move(that.defined_registers)}
-        , defined_where{std::move(that.defined_where)}
-        , mutated_where{std::move(that.mutated_where)}
-        , erased_registers{std::move(that.erased_registers)}
-        , erased_where{std::move(that.erased_where)}
+        : Function_state{that.local_registers_allocated,
+                         that.local_registers_allocated_where}
 {
-    assigned_values.reserve(assigned_values.size());
-    for (auto const& each : that.assigned_values) {
-        assigned_values.emplace_back(
-            values::Value::clone(*each, assigned_values));
-    }
+    copy_from(that);
 }
 }}}}  // namespace viua::tooling::libs::static_analyser
@@ -17,10 +17,20 @@
  *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 
 #include <viua/tooling/errors/compile_time/errors.h>
 #include <viua/tooling/libs/static_analyser/static_analyser.h>
@@ -29,6 +39,27 @@ namespace viua {
     namespace tooling {
         namespace libs {
             namespace static_analyser {
+/*
+ * Functions are analysed in parallel so the output produced while analysing
+ * each of them is collected separately, and printed in the order of functions
+ * after all of them have been analysed. This way the output is the same as if
+ * they were analysed one after another.
+ */
+struct Analysis_log {
+    std::ostringstream out;
+    std::ostringstream err;
+};
+static thread_local Analysis_log* current_analysis_log = nullptr;
+
+static auto analyser_out() -> std::ostream&
+{
+    return (current_analysis_log ? current_analysis_log->out : std::cout);
+}
+static auto analyser_err() -> std::ostream&
+{
+    return (current_analysis_log ? current_analysis_log->err : std::cerr);
+}
+
 static auto to_string(viua::bytecode::codec::Register_set const rs)
     -> std::string
 {
@@ -287,12 +318,305 @@ static auto create_label_map(
     return mapping;
 }
 
-struct Arm_result {
-    Body_line::size_type last_instruction{0};
-    std::set<Body_line::size_type> analysed_lines;
+/*
+ * There may be no branches between a frame spawn point and the call
+ * instruction that follows it. The only allowed instructions between these two
+ * points are `move` and `copy` instructions that have the arguments register
+ * set as destination.
+ *
+ * This is why frames only flow into the next line, and never along branches.
+ */
+struct Frame_state {
+    std::unique_ptr<Frame_representation> spawned_frame;
+    viua::tooling::libs::lexer::Token spawned_frame_where;
+
+    bool spawned_catch_frame = false;
+    viua::tooling::libs::lexer::Token spawned_catch_frame_where;
+
+    auto copy() const -> Frame_state;
+    auto join(Frame_state const&) -> bool;
+};
+auto Frame_state::copy() const -> Frame_state
+{
+    auto frame_state = Frame_state{};
+    if (spawned_frame) {
+        frame_state.spawned_frame =
+            std::make_unique<Frame_representation>(*spawned_frame);
+    }
+    frame_state.spawned_frame_where       = spawned_frame_where;
+    frame_state.spawned_catch_frame       = spawned_catch_frame;
+    frame_state.spawned_catch_frame_where = spawned_catch_frame_where;
+    return frame_state;
+}
+auto Frame_state::join(Frame_state const& that) -> bool
+{
+    auto changed = false;
+
+    if (spawned_frame and not that.spawned_frame) {
+        spawned_frame.reset(nullptr);
+        changed = true;
+    } else if (spawned_frame) {
+        auto& filled = spawned_frame->filled_parameters;
+        for (auto each = filled.begin(); each != filled.end();) {
+            if (that.spawned_frame->filled_parameters.count(each->first)) {
+                ++each;
+                continue;
+            }
+            each    = filled.erase(each);
+            changed = true;
+        }
+    }
+
+    if (spawned_catch_frame and not that.spawned_catch_frame) {
+        spawned_catch_frame = false;
+        changed             = true;
+    }
+
+    return changed;
+}
+
+/*
+ * Bodies of functions and blocks are split into basic blocks: runs of lines
+ * that are always executed together, from the first one to the last one.
+ * A basic block begins at a target of a branch, and ends with a branch or with
+ * an instruction that leaves the function (or the block).
+ */
+enum class Edge_kind {
+    Fallthrough,
+    Jump,
+    True_branch,
+    False_branch,
 };
 
-static auto analyse_single_arm(
+struct Edge {
+    Body_line::size_type to{0};
+    Edge_kind kind{Edge_kind::Fallthrough};
+    viua::tooling::libs::parser::Instruction const* branch{nullptr};
+};
+
+struct Basic_block {
+    Body_line::size_type first{0};
+    Body_line::size_type end{0};
+
+    std::vector<Edge> successors;
+
+    /*
+     * Whether the function (or the block) is left after the last line of the
+     * basic block: by returning, leaving, halting, falling off the end of the
+     * body, or jumping outside of it. Throwing leaves it too, but the state at
+     * the throw point is not the state in which the function is left.
+     */
+    bool exits  = false;
+    bool throws = false;
+};
+
+using operand_index_type =
+    decltype(viua::tooling::libs::parser::Instruction::operands)::size_type;
+
+static auto jump_target(
+    viua::tooling::libs::parser::Instruction const& instruction,
+    operand_index_type const operand,
+    Body_line::size_type const i,
+    std::map<std::string, Body_line> const& label_map)
+    -> std::optional<Body_line::size_type>
+{
+    using viua::tooling::libs::parser::Operand_type;
+
+    auto const& target = *instruction.operands.at(operand);
+    if (target.type() == Operand_type::Jump_offset) {
+        using viua::tooling::libs::parser::Jump_offset;
+
+        auto const& jump_offset = static_cast<Jump_offset const&>(target);
+        return ((jump_offset.value.at(0) == '+')
+                    ? (i + std::stoul(jump_offset.value.substr(1)))
+                    : (i - std::stoul(jump_offset.value.substr(1))));
+    }
+    if (target.type() == Operand_type::Jump_label) {
+        using viua::tooling::libs::parser::Jump_label;
+
+        auto const& jump_label = static_cast<Jump_label const&>(target);
+        if (auto const label = label_map.find(jump_label.value);
+            label != label_map.end()) {
+            return label->second.source_line;
+        }
+        return std::nullopt;
+    }
+    return Body_line::size_type{0};
+}
+
+static auto log_jump_target(
+    viua::tooling::libs::parser::Instruction const& instruction,
+    operand_index_type const operand,
+    Body_line::size_type const i,
+    std::map<std::string, Body_line> const& label_map) -> void
+{
+    using viua::tooling::libs::parser::Operand_type;
+
+    auto const& target = *instruction.operands.at(operand);
+    if (target.type() == Operand_type::Jump_offset) {
+        using viua::tooling::libs::parser::Jump_offset;
+
+        auto const& jump_offset = static_cast<Jump_offset const&>(target);
+        auto const target_line =
+            jump_target(instruction, operand, i, label_map).value();
+        analyser_err() << "  jumping to (offset): " << jump_offset.value
+                       << " (instruction " << target_line << ')' << '\n';
+    } else if (target.type() == Operand_type::Jump_label) {
+        using viua::tooling::libs::parser::Jump_label;
+
+        auto const& jump_label = static_cast<Jump_label const&>(target);
+        auto const& label      = label_map.at(jump_label.value);
+        analyser_err() << "  jumping to (label): " << jump_label.value
+                       << " (instruction " << label.instruction << ')' << '\n';
+    }
+}
+
+static auto build_control_flow_graph(
+    viua::tooling::libs::parser::Cooked_function::body_type const& body,
+    std::vector<Body_line> const& annotated_body,
+    std::map<std::string, Body_line> const& label_map)
+    -> std::vector<Basic_block>
+{
+    using viua::tooling::libs::parser::Fragment_type;
+    using viua::tooling::libs::parser::Instruction;
+
+    auto const size = annotated_body.size();
+
+    auto const instruction_at =
+        [&body, &annotated_body](
+            Body_line::size_type const i) -> Instruction const* {
+        auto const line = body.at(annotated_body.at(i).source_line);
+        return ((line->type() == Fragment_type::Instruction)
+                    ? static_cast<Instruction const*>(line)
+                    : nullptr);
+    };
+
+    auto leaders = std::set<Body_line::size_type>{0};
+    for (auto i = Body_line::size_type{0}; i < size; ++i) {
+        auto const instruction = instruction_at(i);
+        if (not instruction) {
+            continue;
+        }
+
+        auto const opcode = instruction->opcode;
+        if (opcode == JUMP) {
+            if (auto const target = jump_target(*instruction, 0, i, label_map);
+                target.has_value()) {
+                leaders.insert(*target);
+            }
+        } else if (opcode == IF) {
+            for (auto const operand :
+                 {operand_index_type{1}, operand_index_type{2}}) {
+                if (auto const target =
+                        jump_target(*instruction, operand, i, label_map);
+                    target.has_value()) {
+                    leaders.insert(*target);
+                }
+            }
+        } else if (not(opcode == THROW or opcode == LEAVE or opcode == RETURN
+                       or opcode == HALT)) {
+            continue;
+        }
+        leaders.insert(i + 1);
+    }
+    leaders.erase(leaders.lower_bound(size), leaders.end());
+
+    auto blocks   = std::vector<Basic_block>{};
+    auto block_of = std::map<Body_line::size_type, Body_line::size_type>{};
+    for (auto each = leaders.begin(); each != leaders.end(); ++each) {
+        auto const next = std::next(each);
+
+        auto block  = Basic_block{};
+        block.first = *each;
+        block.end   = ((next == leaders.end()) ? size : *next);
+
+        block_of.emplace(block.first, blocks.size());
+        blocks.push_back(std::move(block));
+    }
+
+    for (auto& block : blocks) {
+        auto const add_edge = [&block, &block_of, size](
+                                  std::optional<Body_line::size_type> const
+                                      target,
+                                  Edge_kind const kind,
+                                  Instruction const* branch) -> void {
+            if (not target.has_value()) {
+                /*
+                 * Jumps to undefined labels are reported when the branch is
+                 * analysed.
+                 */
+                return;
+            }
+            if (*target >= size) {
+                block.exits = true;
+                return;
+            }
+            block.successors.push_back(
+                Edge{block_of.at(*target), kind, branch});
+        };
+
+        auto const last        = (block.end - 1);
+        auto const instruction = instruction_at(last);
+        auto const opcode =
+            (instruction ? std::optional<OPCODE>{instruction->opcode}
+                         : std::nullopt);
+
+        if (opcode == JUMP) {
+            add_edge(jump_target(*instruction, 0, last, label_map),
+                     Edge_kind::Jump,
+                     instruction);
+        } else if (opcode == IF) {
+            add_edge(jump_target(*instruction, 1, last, label_map),
+                     Edge_kind::True_branch,
+                     instruction);
+            add_edge(jump_target(*instruction, 2, last, label_map),
+                     Edge_kind::False_branch,
+                     instruction);
+        } else if (opcode == THROW) {
+            block.throws = true;
+        } else if (opcode == LEAVE or opcode == RETURN or opcode == HALT) {
+            block.exits = true;
+        } else {
+            add_edge(block.end, Edge_kind::Fallthrough, nullptr);
+        }
+    }
+
+    return blocks;
+}
+
+/*
+ * Check if every path from the beginning of the function (or the block) to
+ * its end goes through the basic block.
+ */
+static auto on_every_path(std::vector<Basic_block> const& blocks,
+                          Body_line::size_type const block) -> bool
+{
+    if (block == 0) {
+        return true;
+    }
+
+    auto visited  = std::vector<bool>(blocks.size(), false);
+    auto worklist = std::vector<Body_line::size_type>{0};
+    visited.at(0) = true;
+    while (not worklist.empty()) {
+        auto const& each = blocks.at(worklist.back());
+        worklist.pop_back();
+
+        if (each.exits or each.throws) {
+            return false;
+        }
+        for (auto const& edge : each.successors) {
+            if (edge.to != block and not visited.at(edge.to)) {
+                visited.at(edge.to) = true;
+                worklist.push_back(edge.to);
+            }
+        }
+    }
+
+    return true;
+}
+
+static auto analyse_region(
     std::optional<std::reference_wrapper<
         viua::tooling::libs::parser::Cooked_function const>> fn,
     std::optional<
@@ -301,11 +625,25 @@ static auto analyse_single_arm(
     viua::tooling::libs::parser::Cooked_fragments const& fragments,
     Analyser_state& analyser_state,
     Function_state& function_state,
-    bool const after_conditional_branch,
+    std::function<bool()> const& entered_after_conditional_branch,
+    std::vector<Body_line> const& annotated_body,
+    std::map<std::string, Body_line> const& label_map,
+    bool const analyse_all = true) -> void;
+
+static auto analyse_basic_block(
+    std::optional<std::reference_wrapper<
+        viua::tooling::libs::parser::Cooked_function const>> fn,
+    viua::tooling::libs::parser::Cooked_fragments const& fragments,
+    Analyser_state& analyser_state,
+    Function_state& function_state,
+    Frame_state& frame_state,
+    std::function<bool()> const& after_conditional_branch,
+    viua::tooling::libs::parser::Cooked_function::body_type const& body,
     std::vector<Body_line> const& annotated_body,
     std::map<std::string, Body_line> const& label_map,
     viua::tooling::libs::parser::Cooked_function::body_type::size_type i,
-    bool const analyse_all = true) -> Arm_result
+    Body_line::size_type const end,
+    bool const analyse_all) -> void
 {
     using viua::tooling::errors::compile_time::Compile_time_error;
     using viua::tooling::libs::parser::Fragment_type;
@@ -316,33 +654,20 @@ static auto analyse_single_arm(
     auto const analysed_region_name =
         (fn.has_value() ? (fn.value().get().head().function_name + '/'
                            + std::to_string(fn.value().get().head().arity))
-                        : bl.value().get().body().at(0)->tokens().at(0).str());
-
-    auto arm_result = Arm_result{};
+                        : body.at(0)->tokens().at(0).str());
 
-    /*
-     * There may be no branches between a frame spawn point and the call
-     * instruction that follows it. The only allowed instructions
-     * between these two points are `move` and `copy` instructions that
-     * have the arguments register set as destination.
-     */
-    auto spawned_frame       = std::unique_ptr<Frame_representation>();
-    auto spawned_frame_where = viua::tooling::libs::lexer::Token{};
+    auto& spawned_frame       = frame_state.spawned_frame;
+    auto& spawned_frame_where = frame_state.spawned_frame_where;
 
-    auto spawned_catch_frame       = false;
-    auto spawned_catch_frame_where = viua::tooling::libs::lexer::Token{};
+    auto& spawned_catch_frame       = frame_state.spawned_catch_frame;
+    auto& spawned_catch_frame_where = frame_state.spawned_catch_frame_where;
 
-    for (; i < annotated_body.size(); ++i) {
-        arm_result.analysed_lines.insert(i);
-        auto const line =
-            (bl.has_value()
-                 ? bl.value().get().body().at(annotated_body.at(i).source_line)
-                 : fn.value().get().body().at(
-                     annotated_body.at(i).source_line));
+    for (; i < end; ++i) {
+        auto const line = body.at(annotated_body.at(i).source_line);
 
-        std::cout << "analysing: " << line->token(0).str() << " (" << i
-                  << " of " << (annotated_body.size() - 1) << " lines)"
-                  << std::endl;
+        analyser_out() << "analysing: " << line->token(0).str() << " (" << i
+                       << " of " << (annotated_body.size() - 1) << " lines)"
+                       << std::endl;
 
         if (line->type() == Fragment_type::Name_directive) {
             using viua::tooling::libs::parser::Name_directive;
@@ -2877,12 +3202,12 @@ static auto analyse_single_arm(
                     }
                     return "";
                 }();
-                std::cerr << "  calling: " << called_function_name << " from "
-                          << analysed_region_name << '\n';
+                analyser_err() << "  calling: " << called_function_name
+                               << " from " << analysed_region_name << '\n';
                 // FIXME we have to check "history" of block enters because a
                 // function may call itself from inside a block
                 if ((analysed_region_name == called_function_name)
-                    and not after_conditional_branch) {
+                    and not after_conditional_branch()) {
                     throw viua::tooling::errors::compile_time::Error_wrapper{}
                         .append(viua::tooling::errors::compile_time::Error{
                             Compile_time_error::Empty_error  // FIXME add custom
@@ -2890,8 +3215,8 @@ static auto analyse_single_arm(
                             ,
                             line->token(0),
                             "endless recursion detected"}
-                                    .note("this function calls itself on a "
-                                          "path with no conditional branches"));
+                                    .note("every path through this function "
+                                          "leads to this call"));
                 }
 
                 /*
@@ -3074,9 +3399,9 @@ static auto analyse_single_arm(
                     instruction.operands.at(0)->tokens().at(0).str()
                     + instruction.operands.at(0)->tokens().at(1).str()
                     + instruction.operands.at(0)->tokens().at(2).str();
-                std::cerr << "  setting: " << called_function_name
-                          << " as watchdog from " << analysed_region_name
-                          << '\n';
+                analyser_err() << "  setting: " << called_function_name
+                               << " as watchdog from " << analysed_region_name
+                               << '\n';
 
                 if (not spawned_frame) {
                     throw viua::tooling::errors::compile_time::Error_wrapper{}
@@ -3116,188 +3441,21 @@ static auto analyse_single_arm(
             }
             case JUMP:
             {
-                auto target = decltype(i){0};
-
-                if (instruction.operands.at(0)->type()
-                    == Operand_type::Jump_offset) {
-                    using viua::tooling::libs::parser::Jump_offset;
-
-                    auto const& jump_offset = *static_cast<Jump_offset const*>(
-                        instruction.operands.at(0).get());
-                    target =
-                        ((jump_offset.value.at(0) == '+')
-                             ? (i + std::stoul(jump_offset.value.substr(1)))
-                             : (i - std::stoul(jump_offset.value.substr(1))));
-                    std::cerr << "  jumping to (offset): " << jump_offset.value
-                              << " (instruction " << target << ')' << '\n';
-                } else if (instruction.operands.at(0)->type()
-                           == Operand_type::Jump_label) {
-                    using viua::tooling::libs::parser::Jump_label;
-
-                    auto const& jump_label = *static_cast<Jump_label const*>(
-                        instruction.operands.at(0).get());
-                    target = label_map.at(jump_label.value).source_line;
-                    std::cerr << "  jumping to (label): " << jump_label.value
-                              << " (instruction "
-                              << label_map.at(jump_label.value).instruction
-                              << ')' << '\n';
-                }
-
-                try {
-                    analyse_single_arm(fn,
-                                       bl,
-                                       fragments,
-                                       analyser_state,
-                                       function_state,
-                                       after_conditional_branch,
-                                       annotated_body,
-                                       label_map,
-                                       target);
-                } catch (
-                    viua::tooling::errors::compile_time::Error_wrapper& e) {
-                    e.append(viua::tooling::errors::compile_time::Error{
-                        viua::tooling::errors::compile_time::
-                            Compile_time_error::Empty_error,
-                        instruction.tokens().at(0),
-                        "after taking a branch"});
-                    throw;
-                }
+                log_jump_target(instruction, 0, i, label_map);
 
                 /*
-                 * Return instead of break because all the analysis
-                 * that would normally be performed at exit (after
-                 * the final function state and all of its side
-                 * effects (e.g. closure instantiations, function
-                 * calls) are known) will be performed by the nested
-                 * call to analyse_single_arm().
-                 *
-                 * JUMP affects the control flow directrly, and this
-                 * is reflected in the way the analyser operates.
+                 * JUMP affects the control flow directly, and this is
+                 * reflected in the control flow graph of the function. The
+                 * target of the jump is analysed as a successor of this basic
+                 * block.
                  */
-                return arm_result;
+                return;
             }
             case IF:
             {
-                auto true_arm_result = Arm_result{};
-
-                try {
-                    auto target = decltype(i){0};
-
-                    if (instruction.operands.at(1)->type()
-                        == Operand_type::Jump_offset) {
-                        using viua::tooling::libs::parser::Jump_offset;
-
-                        auto const& jump_offset =
-                            *static_cast<Jump_offset const*>(
-                                instruction.operands.at(1).get());
-                        target =
-                            ((jump_offset.value.at(0) == '+')
-                                 ? (i + std::stoul(jump_offset.value.substr(1)))
-                                 : (i
-                                    - std::stoul(jump_offset.value.substr(1))));
-                        std::cerr
-                            << "  jumping to (offset): " << jump_offset.value
-                            << " (instruction " << target << ')' << '\n';
-                    } else if (instruction.operands.at(1)->type()
-                               == Operand_type::Jump_label) {
-                        using viua::tooling::libs::parser::Jump_label;
-
-                        auto const& jump_label =
-                            *static_cast<Jump_label const*>(
-                                instruction.operands.at(1).get());
-                        target = label_map.at(jump_label.value).source_line;
-                        std::cerr
-                            << "  jumping to (label): " << jump_label.value
-                            << " (instruction "
-                            << label_map.at(jump_label.value).instruction << ')'
-                            << '\n';
-                    }
-
-                    auto cloned     = function_state.clone();
-                    true_arm_result = analyse_single_arm(fn,
-                                                         bl,
-                                                         fragments,
-                                                         analyser_state,
-                                                         cloned,
-                                                         true,
-                                                         annotated_body,
-                                                         label_map,
-                                                         target);
-                } catch (
-                    viua::tooling::errors::compile_time::Error_wrapper& e) {
-                    e.append(
-                        viua::tooling::errors::compile_time::Error{
-                            viua::tooling::errors::compile_time::
-                                Compile_time_error::Empty_error,
-                            instruction.tokens().at(0),
-                            "after taking true branch"}
-                            .add(instruction.operands.at(1)->tokens().at(0)));
-                    throw;
-                }
-
-                try {
-                    auto target = decltype(i){0};
-
-                    if (instruction.operands.at(2)->type()
-                        == Operand_type::Jump_offset) {
-                        using viua::tooling::libs::parser::Jump_offset;
-
-                        auto const& jump_offset =
-                            *static_cast<Jump_offset const*>(
-                                instruction.operands.at(2).get());
-                        target =
-                            ((jump_offset.value.at(0) == '+')
-                                 ? (i + std::stoul(jump_offset.value.substr(1)))
-                                 : (i
-                                    - std::stoul(jump_offset.value.substr(1))));
-                        std::cerr
-                            << "  jumping to (offset): " << jump_offset.value
-                            << " (instruction " << target << ')' << '\n';
-                    } else if (instruction.operands.at(2)->type()
-                               == Operand_type::Jump_label) {
-                        using viua::tooling::libs::parser::Jump_label;
-
-                        auto const& jump_label =
-                            *static_cast<Jump_label const*>(
-                                instruction.operands.at(2).get());
-                        target = label_map.at(jump_label.value).source_line;
-                        std::cerr
-                            << "  jumping to (label): " << jump_label.value
-                            << " (instruction "
-                            << label_map.at(jump_label.value).instruction << ')'
-                            << '\n';
-                    }
-
-                    auto cloned = function_state.clone();
-                    analyse_single_arm(
-                        fn,
-                        bl,
-                        fragments,
-                        analyser_state,
-                        cloned,
-                        /*
-                         * False arm is only conditionally executed if the true
-                         * arm did not enter the same path as it. Otherwise, we
-                         * assume that it is executed unconditionally because it
-                         * was executed by both branches of the if instruction.
-                         */
-                        (true_arm_result.analysed_lines.count(target) == 0),
-                        annotated_body,
-                        label_map,
-                        target);
-                } catch (
-                    viua::tooling::errors::compile_time::Error_wrapper& e) {
-                    e.append(
-                        viua::tooling::errors::compile_time::Error{
-                            viua::tooling::errors::compile_time::
-                                Compile_time_error::Empty_error,
-                            instruction.tokens().at(0),
-                            "after taking false branch"}
-                            .add(instruction.operands.at(2)->tokens().at(0)));
-                    throw;
-                }
-
-                return arm_result;
+                log_jump_target(instruction, 1, i, label_map);
+                log_jump_target(instruction, 2, i, label_map);
+                return;
             }
             case THROW:
             {
@@ -3322,7 +3480,7 @@ static auto analyse_single_arm(
                 /*
                  * Return from the function as throwing aborts the normal flow.
                  */
-                return arm_result;
+                return;
             }
             case CATCH:
             {
@@ -3414,19 +3572,20 @@ static auto analyse_single_arm(
                     auto const block_label_map =
                         create_label_map(block_body, block_annotated_body);
 
-                    std::cerr << "entering block: " << block_name << '\n';
+                    analyser_err()
+                        << "entering block: " << block_name << '\n';
 
-                    analyse_single_arm(fn,
-                                       block,
-                                       fragments,
-                                       analyser_state,
-                                       function_state,
-                                       false,
-                                       block_annotated_body,
-                                       block_label_map,
-                                       0);
+                    analyse_region(fn,
+                                   block,
+                                   fragments,
+                                   analyser_state,
+                                   function_state,
+                                   after_conditional_branch,
+                                   block_annotated_body,
+                                   block_label_map);
 
-                    std::cerr << "left block:     " << block_name << '\n';
+                    analyser_err()
+                        << "left block:     " << block_name << '\n';
                 } catch (
                     viua::tooling::errors::compile_time::Error_wrapper& e) {
                     e.append(viua::tooling::errors::compile_time::Error{
@@ -3441,7 +3600,7 @@ static auto analyse_single_arm(
             }
             case LEAVE:
             {
-                return arm_result;
+                return;
             }
             case IMPORT:
             {
@@ -3809,7 +3968,7 @@ static auto analyse_single_arm(
                  * These instructions just cause the analysis to stop as they
                  * halt function's execution.
                  */
-                return arm_result;
+                return;
             }
             default:
             {
@@ -3820,10 +3979,193 @@ static auto analyse_single_arm(
             }
         }
 
-        function_state.dump(std::cout);
+        function_state.dump(analyser_out());
+    }
+}
+
+static auto append_path_to(
+    viua::tooling::errors::compile_time::Error_wrapper& error,
+    Edge const& edge) -> void
+{
+    using viua::tooling::errors::compile_time::Compile_time_error;
+    using viua::tooling::errors::compile_time::Error;
+
+    switch (edge.kind) {
+    case Edge_kind::Jump:
+        error.append(Error{Compile_time_error::Empty_error,
+                           edge.branch->tokens().at(0),
+                           "after taking a branch"});
+        break;
+    case Edge_kind::True_branch:
+        error.append(
+            Error{Compile_time_error::Empty_error,
+                  edge.branch->tokens().at(0),
+                  "after taking true branch"}
+                .add(edge.branch->operands.at(1)->tokens().at(0)));
+        break;
+    case Edge_kind::False_branch:
+        error.append(
+            Error{Compile_time_error::Empty_error,
+                  edge.branch->tokens().at(0),
+                  "after taking false branch"}
+                .add(edge.branch->operands.at(2)->tokens().at(0)));
+        break;
+    case Edge_kind::Fallthrough:
+    default:
+        break;
+    }
+}
+
+/*
+ * Analyse a function (or a block) until the state at the beginning of each of
+ * its basic blocks stops changing. States of paths meeting at a basic block are
+ * joined so that each basic block is analysed only a bounded number of times,
+ * no matter how many paths lead to it or how many times loops are taken.
+ *
+ * After the analysis the function state is replaced by the state in which the
+ * function (or the block) is left.
+ */
+static auto analyse_region(
+    std::optional<std::reference_wrapper<
+        viua::tooling::libs::parser::Cooked_function const>> fn,
+    std::optional<
+        std::reference_wrapper<viua::tooling::libs::parser::Cooked_block const>>
+        bl,
+    viua::tooling::libs::parser::Cooked_fragments const& fragments,
+    Analyser_state& analyser_state,
+    Function_state& function_state,
+    std::function<bool()> const& entered_after_conditional_branch,
+    std::vector<Body_line> const& annotated_body,
+    std::map<std::string, Body_line> const& label_map,
+    bool const analyse_all) -> void
+{
+    auto const body =
+        (bl.has_value() ? bl.value().get().body() : fn.value().get().body());
+    auto const blocks =
+        build_control_flow_graph(body, annotated_body, label_map);
+
+    struct Block_state {
+        std::unique_ptr<Function_state> in;
+        std::optional<Frame_state> frame;
+
+        /*
+         * The path by which the basic block was first reached. It is used to
+         * explain how the analysis got to the place where an error was found.
+         */
+        Body_line::size_type reached_from{0};
+        Edge const* reached_by{nullptr};
+
+        bool queued = false;
+    };
+    auto states = std::vector<Block_state>(blocks.size());
+    if (blocks.empty()) {
+        return;
+    }
+
+    states.front().in =
+        std::make_unique<Function_state>(function_state.clone());
+    states.front().frame.emplace();
+    states.front().queued = true;
+
+    auto worklist = std::vector<Body_line::size_type>{0};
+
+    auto exit_state  = std::unique_ptr<Function_state>{};
+    auto throw_state = std::unique_ptr<Function_state>{};
+    auto const join_into = [](std::unique_ptr<Function_state>& into,
+                              Function_state const& state) -> void {
+        if (into) {
+            into->join(state);
+        } else {
+            into = std::make_unique<Function_state>(state.clone());
+        }
+    };
+
+    while (not worklist.empty()) {
+        auto const b = worklist.back();
+        worklist.pop_back();
+
+        auto const& block = blocks.at(b);
+        auto& block_state = states.at(b);
+        block_state.queued = false;
+
+        auto state = block_state.in->clone();
+        auto frame = block_state.frame->copy();
+
+        auto const after_conditional_branch =
+            [&blocks, &entered_after_conditional_branch, b]() -> bool {
+            return entered_after_conditional_branch()
+                   or not on_every_path(blocks, b);
+        };
+
+        try {
+            analyse_basic_block(fn,
+                                fragments,
+                                analyser_state,
+                                state,
+                                frame,
+                                after_conditional_branch,
+                                body,
+                                annotated_body,
+                                label_map,
+                                block.first,
+                                block.end,
+                                analyse_all);
+        } catch (viua::tooling::errors::compile_time::Error_wrapper& e) {
+            for (auto each = b; each != 0;
+                 each      = states.at(each).reached_from) {
+                append_path_to(e, *states.at(each).reached_by);
+            }
+            throw;
+        }
+
+        if (block.exits) {
+            join_into(exit_state, state);
+        }
+        if (block.throws) {
+            join_into(throw_state, state);
+        }
+
+        /*
+         * Successors are queued in reverse order so that the first of them
+         * (e.g. the true branch of an if) is analysed first.
+         */
+        for (auto edge = block.successors.rbegin();
+             edge != block.successors.rend();
+             ++edge) {
+            auto& next = states.at(edge->to);
+
+            auto const incoming_frame =
+                ((edge->kind == Edge_kind::Fallthrough) ? frame.copy()
+                                                        : Frame_state{});
+
+            auto changed = false;
+            if (not next.in) {
+                next.in = std::make_unique<Function_state>(state.clone());
+                next.frame.emplace(incoming_frame.copy());
+                next.reached_from = b;
+                next.reached_by   = &*edge;
+                changed           = true;
+            } else {
+                changed = next.in->join(state);
+                changed = next.frame->join(incoming_frame) or changed;
+            }
+
+            if (changed and not next.queued) {
+                next.queued = true;
+                worklist.push_back(edge->to);
+            }
+        }
     }
 
-    return arm_result;
+    /*
+     * If the function (or the block) can only be left by throwing, the state
+     * at the throw points is the best approximation of its final state.
+     */
+    if (exit_state) {
+        function_state.reset_to(*exit_state);
+    } else if (throw_state) {
+        function_state.reset_to(*throw_state);
+    }
 }
 
 static auto analyse_single_function(
@@ -3872,9 +4214,9 @@ static auto analyse_single_function(
     auto const analysed_function_name =
         fn.head().function_name + '/' + std::to_string(fn.head().arity);
 
-    std::cout << "analyse_single_function(): " << analysed_function_name;
-    std::cout << " (" << fn.body().size() << " lines)";
-    std::cout << std::endl;
+    analyser_out() << "analyse_single_function(): " << analysed_function_name;
+    analyser_out() << " (" << fn.body().size() << " lines)";
+    analyser_out() << std::endl;
 
     if (fn.head().function_name == "main") {
         if (fn.head().arity == 0) {
@@ -3925,21 +4267,21 @@ static auto analyse_single_function(
         }
     }
 
-    function_state.dump(std::cout);
+    function_state.dump(analyser_out());
 
     auto const annotated_body = annotate_body(body);
     auto const label_map      = create_label_map(body, annotated_body);
 
-    analyse_single_arm(fn,
-                       std::nullopt,
-                       fragments,
-                       as,
-                       function_state,
-                       false,
-                       annotated_body,
-                       label_map,
-                       0,
-                       false);
+    analyse_region(
+        fn,
+        std::nullopt,
+        fragments,
+        as,
+        function_state,
+        []() -> bool { return false; },
+        annotated_body,
+        label_map,
+        false);
 
     if (fn.head().function_name == "main") {
         auto target =
@@ -4001,6 +4343,24 @@ static auto analyse_single_function(
     }
 }
 
+static auto no_of_analysis_jobs() -> size_t
+{
+    /*
+     * Malformed limits are ignored, as are limits that are not positive.
+     */
+    if (auto const env_limit = getenv("VIUA_SA_JOBS"); env_limit != nullptr) {
+        auto const text = std::string_view{env_limit};
+        auto limit      = size_t{0};
+        auto const [end, error] =
+            std::from_chars(text.data(), (text.data() + text.size()), limit);
+        if (error == std::errc{} and end == (text.data() + text.size())
+            and limit > 0) {
+            return limit;
+        }
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
 static auto analyse_functions(
     viua::tooling::libs::parser::Cooked_fragments const& fragments,
     Analyser_state& analyser_state) -> void
@@ -4020,16 +4380,65 @@ static auto analyse_functions(
         throw error;
     }
 
+    /*
+     * Functions are analysed independently of each other so they are analysed
+     * in parallel. Results are reported in the order of functions, and only up
+     * to the first function in which an error was found, just as if they were
+     * analysed one after another.
+     */
+    struct Function_analysis {
+        std::string const& name;
+        viua::tooling::libs::parser::Cooked_function const& fn;
+        Analysis_log log;
+        std::exception_ptr error;
+    };
+    auto analyses = std::vector<std::unique_ptr<Function_analysis>>{};
     for (auto const& [name, fn] : functions) {
-        try {
-            analyse_single_function(fn, fragments, analyser_state);
-        } catch (viua::tooling::errors::compile_time::Error_wrapper& e) {
-            e.append(viua::tooling::errors::compile_time::Error{
-                viua::tooling::errors::compile_time::Compile_time_error::
-                    Empty_error,
-                fn.head().token(0),
-                "in function `" + name + "'"});
-            throw;
+        analyses.push_back(std::unique_ptr<Function_analysis>(
+            new Function_analysis{name, fn, {}, nullptr}));
+    }
+
+    auto next_analysis = std::atomic<decltype(analyses)::size_type>{0};
+    auto const analyse_some = [&analyses,
+                               &next_analysis,
+                               &fragments,
+                               &analyser_state]() -> void {
+        for (auto i = next_analysis++; i < analyses.size();
+             i      = next_analysis++) {
+            auto& analysis       = *analyses.at(i);
+            current_analysis_log = &analysis.log;
+            try {
+                analyse_single_function(analysis.fn, fragments, analyser_state);
+            } catch (viua::tooling::errors::compile_time::Error_wrapper& e) {
+                e.append(viua::tooling::errors::compile_time::Error{
+                    viua::tooling::errors::compile_time::Compile_time_error::
+                        Empty_error,
+                    analysis.fn.head().token(0),
+                    "in function `" + analysis.name + "'"});
+                analysis.error = std::current_exception();
+            } catch (...) {
+                analysis.error = std::current_exception();
+            }
+            current_analysis_log = nullptr;
+        }
+    };
+
+    auto const jobs = std::min<decltype(analyses)::size_type>(
+        no_of_analysis_jobs(), analyses.size());
+    auto workers = std::vector<std::thread>{};
+    for (auto i = decltype(analyses)::size_type{1}; i < jobs; ++i) {
+        workers.emplace_back(analyse_some);
+    }
+    analyse_some();
+    for (auto& each : workers) {
+        each.join();
+    }
+
+    for (auto const& each : analyses) {
+        std::cout << each->log.out.str();
+        std::cerr << each->log.err.str();
+        if (each->error) {
+            std::rethrow_exception(each->error);
         }
     }
 }
@@ -119,6 +119,7 @@ auto Value::clone(Value const& value, Value_wrapper::map_type& values)
         for (auto const& each : x.fields()) {
             cloned_struct->field(each.first, each.second.rebind(values));
         }
+        cloned = std::move(cloned_struct);
         break;
     }
     case Value_type::Pid:
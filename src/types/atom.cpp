@@ -17,9 +17,76 @@
  *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 #include <viua/support/string.h>
 #include <viua/types/atom.h>
 
+
+namespace {
+/*
+ * Names are kept in a deque so references to them stay valid while new atoms
+ * are interned. Atoms are created by processes running on many schedulers at
+ * once, but new names are rare after the program warms up so readers only
+ * take a shared lock.
+ */
+struct Atom_table {
+    std::shared_mutex mtx;
+    std::unordered_map<std::string, viua::types::Atom::id_type> ids;
+    std::deque<std::string> names;
+};
+auto atom_table() -> Atom_table&
+{
+    static Atom_table table;
+    return table;
+}
+}  // namespace
+
+auto viua::types::Atom::intern(std::string const& name) -> id_type
+{
+    auto& table = atom_table();
+    {
+        std::shared_lock<std::shared_mutex> lck{table.mtx};
+        if (auto const found = table.ids.find(name); found != table.ids.end()) {
+            return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lck{table.mtx};
+    auto const [it, inserted] =
+        table.ids.try_emplace(name, static_cast<id_type>(table.names.size()));
+    if (inserted) {
+        table.names.push_back(name);
+    }
+    return it->second;
+}
+
+auto viua::types::Atom::find(std::string const& name)
+    -> std::optional<id_type>
+{
+    auto& table = atom_table();
+    std::shared_lock<std::shared_mutex> lck{table.mtx};
+    if (auto const found = table.ids.find(name); found != table.ids.end()) {
+        return found->second;
+    }
+    return std::nullopt;
+}
+
+auto viua::types::Atom::name_of(id_type const id) -> std::string const&
+{
+    auto& table = atom_table();
+    std::shared_lock<std::shared_mutex> lck{table.mtx};
+    return table.names.at(id);
+}
+
+auto viua::types::Atom::id() const -> id_type
+{
+    return interned;
+}
+
 auto viua::types::Atom::type() const -> std::string
 {
     return type_name;
@@ -47,13 +114,15 @@ viua::types::Atom::operator std::string() const
 
 auto viua::types::Atom::copy() const -> std::unique_ptr<viua::types::Value>
 {
-    return std::make_unique<Atom>(value);
+    return std::make_unique<Atom>(interned);
 }
 
 auto viua::types::Atom::operator==(Atom const& that) const -> bool
 {
-    return (value == that.value);
+    return (interned == that.interned);
 }
 
-viua::types::Atom::Atom(std::string s) : value(s)
+viua::types::Atom::Atom(std::string s) : value(s), interned{intern(value)}
+{}
+viua::types::Atom::Atom(id_type const id) : value(name_of(id)), interned{id}
 {}
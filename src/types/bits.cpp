@@ -18,16 +18,19 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
-#include <iostream>
-#include <iterator>
 #include <memory>
-#include <numeric>
 #include <optional>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <viua/types/bits.h>
 #include <viua/types/exception.h>
 using namespace viua::types;
@@ -36,459 +39,528 @@ using namespace viua::types;
 /*
  * Here's a cool resource for binary arithmetic:
  * https://www.cs.cornell.edu/~tomf/notes/cps104/twoscomp.html
+ *
+ * All the functions below work on whole words. Bit strings are given as
+ * vectors of words together with their widths in bits, and are expected to be
+ * exactly as long as their width requires with the unused bits of the last
+ * word zeroed.
  */
-static auto to_string(std::vector<bool> const& v,
-                      bool const with_prefix = false) -> std::string
-{
-    auto oss = std::ostringstream{};
+using word_type  = Bits::word_type;
+using size_type  = Bits::size_type;
+using words_type = std::vector<word_type>;
 
-    if (with_prefix) {
-        oss << "0b";
-    }
-
-    for (auto i = v.size(); i; --i) {
-        oss << v.at(i - 1);
-    }
+static constexpr auto WORD_WIDTH = Bits::WORD_WIDTH;
+static constexpr auto ALL_ONES   = ~word_type{0};
 
-    return oss.str();
+static auto words_for(size_type const width) -> size_type
+{
+    return ((width + WORD_WIDTH - 1) / WORD_WIDTH);
+}
+static auto top_word_mask(size_type const width) -> word_type
+{
+    auto const used = (width % WORD_WIDTH);
+    return (used ? ((word_type{1} << used) - 1) : ALL_ONES);
 }
-static auto binary_expand(std::vector<bool> v, decltype(v)::size_type const n)
-    -> std::vector<bool>
+static auto clip_top_word(words_type& v, size_type const width) -> void
 {
-    auto const expanding_value = (v.size() ? v.back() : false);
-    v.reserve(n);
-    while (v.size() < n) {
-        v.push_back(expanding_value);
+    if (not v.empty()) {
+        v.back() &= top_word_mask(width);
     }
-    return v;
 }
-static auto binary_clip(
-    std::vector<bool> const& bits,
-    std::remove_reference_t<decltype(bits)>::size_type width)
-    -> std::vector<bool>
+static auto zeroes(size_type const width) -> words_type
 {
-    auto result = std::vector<bool>{};
-    result.reserve(width);
-    std::fill_n(std::back_inserter(result), width, false);
-
-    std::copy_n(bits.begin(), std::min(bits.size(), width), result.begin());
-    result = binary_expand(result, width);
-
-    return result;
+    return words_type(words_for(width), 0);
 }
-static auto binary_inversion(std::vector<bool> const& v) -> std::vector<bool>
+static auto ones(size_type const width) -> words_type
 {
-    auto inverted = std::vector<bool>{};
-    inverted.reserve(v.size());
-
-    for (auto const each : v) {
-        inverted.push_back(not each);
-    }
+    auto v = words_type(words_for(width), ALL_ONES);
+    clip_top_word(v, width);
+    return v;
+}
 
-    return inverted;
+static auto binary_bit(words_type const& v, size_type const i) -> bool
+{
+    return ((v[i / WORD_WIDTH] >> (i % WORD_WIDTH)) & 1);
 }
-static auto binary_to_bool(std::vector<bool> const& v) -> bool
+static auto binary_set_bit(words_type& v, size_type const i, bool const value)
+    -> void
 {
-    for (auto const each : v) {
-        if (each) {
-            return true;
-        }
+    auto const mask = (word_type{1} << (i % WORD_WIDTH));
+    if (value) {
+        v[i / WORD_WIDTH] |= mask;
+    } else {
+        v[i / WORD_WIDTH] &= ~mask;
     }
-    return false;
 }
-static auto binary_fill_with_zeroes(std::vector<bool> v) -> std::vector<bool>
+static auto binary_is_negative(words_type const& v, size_type const width)
+    -> bool
 {
-    for (auto i = decltype(v)::size_type{0}; i < v.size(); ++i) {
-        v[i] = false;
-    }
-    return v;
+    return (width and binary_bit(v, width - 1));
 }
-static auto binary_is_negative(std::vector<bool> const& v) -> bool
+static auto binary_to_bool(words_type const& v) -> bool
 {
-    return v.back();
+    return std::any_of(
+        v.begin(), v.end(), [](word_type const each) { return each != 0; });
 }
-static auto binary_last_bit_set(std::vector<bool> const& v)
-    -> std::optional<std::remove_reference_t<decltype(v)>::size_type>
+static auto binary_last_bit_set(words_type const& v)
+    -> std::optional<size_type>
 {
-    auto index_of_set =
-        std::optional<std::remove_reference_t<decltype(v)>::size_type>{};
-
     for (auto i = v.size(); i; --i) {
-        if (v.at(i - 1)) {
-            index_of_set = (i - 1);
-            break;
+        if (auto const each = v[i - 1]; each) {
+            auto bit = (WORD_WIDTH - 1);
+            while (not((each >> bit) & 1)) {
+                --bit;
+            }
+            return ((i - 1) * WORD_WIDTH + bit);
         }
     }
+    return {};
+}
 
-    return index_of_set;
+/*
+ * Change the width of a bit string, either padding it with zeroes or
+ * sign-extending it if it becomes wider.
+ */
+static auto binary_resize(words_type v,
+                          size_type const from,
+                          size_type const to,
+                          bool const sign_extend) -> words_type
+{
+    auto const fill = ((sign_extend and binary_is_negative(v, from))
+                           ? ALL_ONES
+                           : word_type{0});
+    if (fill and (to > from)) {
+        v.back() |= ~top_word_mask(from);
+    }
+    v.resize(words_for(to), fill);
+    clip_top_word(v, to);
+    return v;
 }
-static auto binary_eq(std::vector<bool> lhs, std::vector<bool> rhs) -> bool
+static auto binary_expand(words_type const& v,
+                          size_type const from,
+                          size_type const to) -> words_type
 {
-    lhs = binary_expand(lhs, std::max(lhs.size(), rhs.size()));
-    rhs = binary_expand(rhs, std::max(lhs.size(), rhs.size()));
-
-    for (auto i = decltype(lhs)::size_type{0}; i < lhs.size(); ++i) {
-        if (lhs.at(i) != rhs.at(i)) {
-            return false;
-        }
-    }
-
-    // yep, they are equal
-    return true;
+    return binary_resize(v, from, to, true);
+}
+static auto binary_clip(words_type const& v,
+                        size_type const from,
+                        size_type const to) -> words_type
+{
+    return binary_resize(v, from, to, false);
 }
 
-
-static auto binary_shr(std::vector<bool> v,
-                       decltype(v)::size_type const n,
-                       bool const padding = false)
-    -> std::pair<std::vector<bool>, std::vector<bool>>
+static auto binary_is_negative(Bits const& v) -> bool
 {
-    auto shifted = std::vector<bool>{};
-    shifted.reserve(n);
-    for (auto i = decltype(n){0}; i < n; ++i) {
-        shifted.push_back(false);
-    }
+    return binary_is_negative(v.data(), v.size());
+}
+static auto binary_expand(Bits const& v, size_type const width) -> Bits
+{
+    return Bits{width, binary_expand(v.data(), v.size(), width)};
+}
+static auto binary_clip(Bits const& v, size_type const width) -> Bits
+{
+    return Bits{width, binary_clip(v.data(), v.size(), width)};
+}
 
-    if (n >= v.size()) {
-        for (auto i = decltype(n){0}; i < v.size(); ++i) {
-            shifted.at(i) = v.at(i);
+/*
+ * Unsigned comparison of bit strings of equal width.
+ */
+static auto binary_compare(words_type const& lhs, words_type const& rhs)
+    -> int
+{
+    for (auto i = lhs.size(); i; --i) {
+        if (lhs[i - 1] != rhs[i - 1]) {
+            return ((lhs[i - 1] < rhs[i - 1]) ? -1 : 1);
         }
-        return {shifted, binary_fill_with_zeroes(std::move(v))};
     }
+    return 0;
+}
+static auto binary_eq(words_type const& lhs,
+                      size_type const lhs_width,
+                      words_type const& rhs,
+                      size_type const rhs_width) -> bool
+{
+    auto const width = std::max(lhs_width, rhs_width);
+    return (binary_expand(lhs, lhs_width, width)
+            == binary_expand(rhs, rhs_width, width));
+}
 
-    for (auto i = decltype(n){0}; i < v.size(); ++i) {
-        auto const index_to_set            = i;
-        auto const index_of_value          = i + n;
-        auto const index_to_set_in_shifted = i;
 
-        if (index_of_value < v.size()) {
-            if (index_to_set_in_shifted < n) {
-                shifted.at(index_to_set_in_shifted) = v.at(index_to_set);
-            }
-            v.at(index_to_set)   = v.at(index_of_value);
-            v.at(index_of_value) = padding;
-        } else {
-            if (index_to_set_in_shifted < n) {
-                shifted.at(index_to_set_in_shifted) = v.at(index_to_set);
-            }
-            v.at(index_to_set) = padding;
+/*
+ * Bitwise logic is done on whole words, and on pairs of words at a time if SSE2
+ * is available.
+ */
+struct Bitwise_and {
+    static auto word(word_type const lhs, word_type const rhs) -> word_type
+    {
+        return (lhs & rhs);
+    }
+#if defined(__SSE2__)
+    static auto pair(__m128i const lhs, __m128i const rhs) -> __m128i
+    {
+        return _mm_and_si128(lhs, rhs);
+    }
+#endif
+};
+struct Bitwise_or {
+    static auto word(word_type const lhs, word_type const rhs) -> word_type
+    {
+        return (lhs | rhs);
+    }
+#if defined(__SSE2__)
+    static auto pair(__m128i const lhs, __m128i const rhs) -> __m128i
+    {
+        return _mm_or_si128(lhs, rhs);
+    }
+#endif
+};
+struct Bitwise_xor {
+    static auto word(word_type const lhs, word_type const rhs) -> word_type
+    {
+        return (lhs ^ rhs);
+    }
+#if defined(__SSE2__)
+    static auto pair(__m128i const lhs, __m128i const rhs) -> __m128i
+    {
+        return _mm_xor_si128(lhs, rhs);
+    }
+#endif
+};
+
+template<typename Op>
+static auto binary_bitwise(word_type* result,
+                           word_type const* lhs,
+                           word_type const* rhs,
+                           size_type const n) -> void
+{
+    auto i = size_type{0};
+#if defined(__SSE2__)
+    for (; (i + 2) <= n; i += 2) {
+        auto const l = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lhs + i));
+        auto const r = _mm_loadu_si128(reinterpret_cast<__m128i const*>(rhs + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i),
+                         Op::pair(l, r));
+    }
+#endif
+    for (; i < n; ++i) {
+        result[i] = Op::word(lhs[i], rhs[i]);
+    }
+}
+static auto binary_inversion(words_type const& v, size_type const width)
+    -> words_type
+{
+    auto const mask = ones(width);
+    auto inverted   = words_type(v.size());
+    binary_bitwise<Bitwise_xor>(
+        inverted.data(), v.data(), mask.data(), v.size());
+    return inverted;
+}
+
+
+/*
+ * Shifts of bit strings of the given width. Bits shifted out are lost, and the
+ * vacated positions are filled with zeroes.
+ */
+static auto binary_shl(words_type const& v,
+                       size_type const n,
+                       size_type const width) -> words_type
+{
+    auto shifted = zeroes(width);
+    if (n >= width) {
+        return shifted;
+    }
+
+    auto const word_offset = (n / WORD_WIDTH);
+    auto const bit_offset  = (n % WORD_WIDTH);
+    for (auto i = word_offset; i < shifted.size(); ++i) {
+        auto const source = (i - word_offset);
+        shifted[i]        = (v[source] << bit_offset);
+        if (bit_offset and source) {
+            shifted[i] |= (v[source - 1] >> (WORD_WIDTH - bit_offset));
         }
     }
+    clip_top_word(shifted, width);
 
-    return {shifted, v};
+    return shifted;
 }
-static auto binary_shl(std::vector<bool> v, decltype(v)::size_type const n)
-    -> std::pair<std::vector<bool>, std::vector<bool>>
+static auto binary_shr(words_type const& v,
+                       size_type const n,
+                       size_type const width) -> words_type
 {
-    auto shifted = std::vector<bool>{};
-    shifted.reserve(n);
-    for (auto i = decltype(n){0}; i < n; ++i) {
-        shifted.push_back(false);
-    }
-
-    if (n >= v.size()) {
-        for (auto i = decltype(n){0}; i < v.size(); ++i) {
-            shifted.at(shifted.size() - 1 - i) = v.at(v.size() - 1 - i);
-        }
-        return {shifted, binary_fill_with_zeroes(std::move(v))};
+    auto shifted = zeroes(width);
+    if (n >= width) {
+        return shifted;
     }
 
-    for (auto i = decltype(n){0}; i < v.size(); ++i) {
-        auto const index_to_set            = v.size() - i - 1;
-        auto const index_of_value          = v.size() - n - i - 1;
-        auto const index_to_set_in_shifted = n - i - 1;
-
-        if (index_of_value < v.size()) {
-            if (index_to_set_in_shifted < n) {
-                shifted.at(index_to_set_in_shifted) = v.at(index_to_set);
-            }
-            v.at(index_to_set)   = v.at(index_of_value);
-            v.at(index_of_value) = false;
-        } else {
-            if (index_to_set_in_shifted < n) {
-                shifted.at(index_to_set_in_shifted) = v.at(index_to_set);
-            }
-            v.at(index_to_set) = false;
+    auto const word_offset = (n / WORD_WIDTH);
+    auto const bit_offset  = (n % WORD_WIDTH);
+    for (auto i = size_type{0}; (i + word_offset) < shifted.size(); ++i) {
+        auto const source = (i + word_offset);
+        shifted[i]        = (v[source] >> bit_offset);
+        if (bit_offset and (source + 1) < v.size()) {
+            shifted[i] |= (v[source + 1] << (WORD_WIDTH - bit_offset));
         }
     }
 
-    return {shifted, v};
+    return shifted;
 }
 
 
 namespace viua { namespace arithmetic {
 namespace wrapping {
-static auto binary_increment(std::vector<bool> const& v)
-    -> std::pair<bool, std::vector<bool>>
+static auto binary_increment(words_type v, size_type const width)
+    -> words_type
 {
-    auto carry       = true;
-    auto incremented = v;
-
-    for (auto i = decltype(incremented)::size_type{0}; carry and i < v.size();
-         ++i) {
-        if (v.at(i)) {
-            incremented.at(i) = false;
-        } else {
-            incremented.at(i) = true;
-            carry             = false;
+    for (auto& each : v) {
+        if (++each) {
+            break;
         }
     }
-
-    return {carry, incremented};
+    clip_top_word(v, width);
+    return v;
 }
-static auto binary_decrement(std::vector<bool> const& v)
-    -> std::pair<bool, std::vector<bool>>
+static auto binary_decrement(words_type v, size_type const width)
+    -> words_type
 {
-    auto borrow      = false;
-    auto decremented = v;
-
-    for (auto i = decltype(decremented)::size_type{0}; i < v.size(); ++i) {
-        if (v.at(i)) {
-            decremented.at(i) = false;
-            borrow            = false;
+    for (auto& each : v) {
+        if (each--) {
             break;
-        } else {
-            decremented.at(i) = true;
-            borrow            = true;
         }
     }
-
-    return {borrow, decremented};
+    clip_top_word(v, width);
+    return v;
 }
-static auto take_twos_complement(std::vector<bool> const& v)
-    -> std::vector<bool>
+static auto take_twos_complement(words_type const& v, size_type const width)
+    -> words_type
 {
-    return binary_increment(binary_inversion(v)).second;
+    return binary_increment(binary_inversion(v, width), width);
 }
 
-
-static auto binary_lte(std::vector<bool> lhs, std::vector<bool> rhs) -> bool
+/*
+ * Addition of bit strings of equal width. The carry out of the most
+ * significant bit is lost.
+ */
+static auto binary_addition(words_type lhs,
+                            words_type const& rhs,
+                            size_type const width) -> words_type
 {
-    lhs = binary_expand(lhs, std::max(lhs.size(), rhs.size()));
-    rhs = binary_expand(rhs, std::max(lhs.size(), rhs.size()));
-
-    for (auto i = lhs.size(); i; --i) {
-        if (lhs.at(i - 1) < rhs.at(i - 1)) {
-            // definitely lhs < rhs
-            return true;
-        } else if (lhs.at(i - 1) > rhs.at(i - 1)) {
-            // totally lhs > rhs
-            return false;
-        }
+    auto carry = false;
+    for (auto i = size_type{0}; i < lhs.size(); ++i) {
+        auto const partial = (lhs[i] + rhs[i]);
+        auto const sum     = (partial + static_cast<word_type>(carry));
+        carry              = ((partial < lhs[i]) or (sum < partial));
+        lhs[i]             = sum;
     }
-    // equal to each other
-    return true;
+    clip_top_word(lhs, width);
+    return lhs;
 }
-static auto binary_lt
-    [[maybe_unused]] (std::vector<bool> lhs, std::vector<bool> rhs) -> bool
+static auto binary_subtraction(words_type lhs,
+                               words_type const& rhs,
+                               size_type const width) -> words_type
 {
-    lhs = binary_expand(lhs, std::max(lhs.size(), rhs.size()));
-    rhs = binary_expand(rhs, std::max(lhs.size(), rhs.size()));
-
-    for (auto i = lhs.size(); i; --i) {
-        if (lhs.at(i - 1) < rhs.at(i - 1)) {
-            // definitely lhs < rhs
-            return true;
-        } else if (lhs.at(i - 1) > rhs.at(i - 1)) {
-            // totally lhs > rhs
-            return false;
-        }
+    auto borrow = false;
+    for (auto i = size_type{0}; i < lhs.size(); ++i) {
+        auto const partial = (lhs[i] - rhs[i]);
+        auto const diff    = (partial - static_cast<word_type>(borrow));
+        borrow             = ((lhs[i] < rhs[i]) or (partial < diff));
+        lhs[i]             = diff;
     }
-    // probably equal to each other
-    return false;
+    clip_top_word(lhs, width);
+    return lhs;
 }
 
-
-static auto binary_addition(std::vector<bool> const& lhs,
-                            std::vector<bool> const& rhs) -> std::vector<bool>
+/*
+ * Full 128 bit product of two words, as a pair of low and high words.
+ */
+static auto word_multiplication(word_type const lhs, word_type const rhs)
+    -> std::pair<word_type, word_type>
 {
-    auto result               = std::vector<bool>{};
-    auto const size_of_result = std::max(lhs.size(), rhs.size());
-    result.reserve(size_of_result + 1);
-    std::fill_n(std::back_inserter(result), size_of_result, false);
+    constexpr auto HALF      = (WORD_WIDTH / 2);
+    constexpr auto HALF_MASK = (ALL_ONES >> HALF);
 
-    bool carry = false;
+    auto const ll = ((lhs & HALF_MASK) * (rhs & HALF_MASK));
+    auto const lh = ((lhs & HALF_MASK) * (rhs >> HALF));
+    auto const hl = ((lhs >> HALF) * (rhs & HALF_MASK));
+    auto const hh = ((lhs >> HALF) * (rhs >> HALF));
 
-    for (auto i = decltype(size_of_result){0}; i < size_of_result; ++i) {
-        auto const from_lhs = (i < lhs.size() ? lhs.at(i) : false);
-        auto const from_rhs = (i < rhs.size() ? rhs.at(i) : false);
+    auto const middle = ((ll >> HALF) + (lh & HALF_MASK) + (hl & HALF_MASK));
+    return {((ll & HALF_MASK) | (middle << HALF)),
+            (hh + (lh >> HALF) + (hl >> HALF) + (middle >> HALF))};
+}
 
-        /*
-         * lhs + rhs -> 0 + 0 -> 0
-         *
-         * This is the easy case.
-         * Everything is zero, so we just carry the carry into the result at
-         * the current position, and reset the carry flag to zero (it was
-         * consumed).
-         */
-        if ((not from_rhs) and (not from_lhs)) {
-            result.at(i) = carry;
-            carry        = false;
-            continue;
-        }
+/*
+ * Multiplication of bit strings of equal width. Only as many low bits of the
+ * product as the width of the operands are kept.
+ */
+static auto binary_multiplication(words_type const& lhs,
+                                  words_type const& rhs,
+                                  size_type const width) -> words_type
+{
+    auto product = zeroes(width);
 
-        /*
-         * lhs + rhs -> 1 + 1 -> 10
-         *
-         * This gives us a zero on current position, and
-         * carry flag in the enabled state.
-         *
-         * If carry was enabled before we have 0 + 1 = 1, so we should
-         * enable bit on current position in the result.
-         * If carry was not enabled we have 0 + 0, so we should
-         * obviously leave the bit disabled in the result.
-         * This means that we can just copy state of the carry flag into
-         * the result bit std::string on current position.
-         */
-        if (from_rhs and from_lhs) {
-            result.at(i) = carry;
-            carry        = true;
+    for (auto i = size_type{0}; i < lhs.size(); ++i) {
+        if (not lhs[i]) {
             continue;
         }
 
-        /*
-         * At this point either the lhs or rhs is enabled, but not both.
-         * So if the carry bit is enabled this gives us 1 + 1 = 10, so
-         * zero should be put in result on the current position, and
-         * carry flag should be enabled.
-         */
-        if (carry) {
-            continue;
-        }
+        auto carry = word_type{0};
+        for (auto j = size_type{0}; (i + j) < product.size(); ++j) {
+            auto const [low, high] = word_multiplication(lhs[i], rhs[j]);
 
-        /*
-         * All other cases.
-         * Either lhs or rhs is enabled, and carry is not.
-         * So this is the 0 + 1 = 1 case.
-         * Easy.
-         * Just enable the bit in the result.
-         */
-        result.at(i) = true;
+            auto const partial = (product[i + j] + low);
+            auto const sum     = (partial + carry);
+            carry              = (high + static_cast<word_type>(partial < low)
+                     + static_cast<word_type>(sum < partial));
+            product[i + j] = sum;
+        }
     }
+    clip_top_word(product, width);
+
+    return product;
+}
+
+/*
+ * Long division of unsigned bit strings of equal width. The divisor must not
+ * be zero.
+ */
+static auto binary_unsigned_division(words_type const& dividend,
+                                     words_type const& divisor,
+                                     size_type const width) -> words_type
+{
+    auto quotinent = zeroes(width);
 
     /*
-     * If there was a carry during the last operation append it to the result.
-     * Basic binary addition is expanding.
-     * It can be made wrapping, checked, or saturating by "post-processing".
+     * Quotinent bits above the difference between the most significant bits
+     * set in the dividend and the divisor are always zero so there is no need
+     * to go through them one by one. The remainder starts with the bits of the
+     * dividend which are above that, and is less than the divisor.
      */
-    if (carry) {
-        result.push_back(carry);
+    auto const dividend_last_set = binary_last_bit_set(dividend);
+    auto const divisor_last_set  = binary_last_bit_set(divisor);
+    if ((not dividend_last_set) or (*dividend_last_set < *divisor_last_set)) {
+        return quotinent;
     }
-
-    return result;
-}
-static auto binary_subtraction(std::vector<bool> const& lhs,
-                               std::vector<bool> const& rhs)
-    -> std::vector<bool>
-{
-    return binary_clip(
-        binary_addition(binary_expand(lhs, std::max(lhs.size(), rhs.size())),
-                        take_twos_complement(binary_expand(
-                            rhs, std::max(lhs.size(), rhs.size())))),
-        lhs.size());
-}
-static auto binary_multiplication(std::vector<bool> const& lhs,
-                                  std::vector<bool> const& rhs)
-    -> std::vector<bool>
-{
-    auto intermediates = std::vector<std::vector<bool>>{};
-    intermediates.reserve(rhs.size());
+    auto const steps = (*dividend_last_set - *divisor_last_set + 1);
 
     /*
-     * Make sure the result is *always* has at least one entry (in case the rhs
-     * is all zero bits), and that the results width is *always* the sum of
-     * operands' widths.
+     * The remainder is always less than the divisor, but it is shifted left by
+     * one bit before it is compared to the divisor again so it needs one extra
+     * bit.
      */
-    intermediates.emplace_back(lhs.size() + rhs.size());
-
-    for (auto i = std::remove_reference_t<decltype(lhs)>::size_type{0};
-         i < rhs.size();
-         ++i) {
-        if (not rhs.at(i)) {
-            /*
-             * Multiplication by 0 just gives a long std::string of zeroes.
-             * There is no reason to build all these zero-filled bit strings as
-             * they will only slow things down the road when all the
-             * intermediate bit strings are accumulated.
-             */
-            continue;
+    auto const remainder_width = (width + 1);
+    auto const wide_divisor    = binary_clip(divisor, width, remainder_width);
+    auto remainder             = binary_clip(
+        binary_shr(dividend, steps, width), width, remainder_width);
+
+    for (auto i = steps; i; --i) {
+        auto carry = static_cast<word_type>(binary_bit(dividend, i - 1));
+        for (auto& each : remainder) {
+            auto const shifted_out = (each >> (WORD_WIDTH - 1));
+            each                   = ((each << 1) | carry);
+            carry                  = shifted_out;
         }
 
-        auto interm = std::vector<bool>{};
-        interm.reserve(i + lhs.size());
-        std::fill_n(std::back_inserter(interm), i, false);
-
-        std::copy(lhs.begin(), lhs.end(), std::back_inserter(interm));
-
-        intermediates.emplace_back(std::move(interm));
+        if (binary_compare(remainder, wide_divisor) >= 0) {
+            remainder = binary_subtraction(
+                std::move(remainder), wide_divisor, remainder_width);
+            binary_set_bit(quotinent, i - 1, true);
+        }
     }
 
-    return std::accumulate(intermediates.begin(),
-                           intermediates.end(),
-                           std::vector<bool>{},
-                           [](std::vector<bool> const& l,
-                              std::vector<bool> const& r) -> std::vector<bool> {
-                               return binary_addition(l, r);
-                           });
+    return quotinent;
+}
+
+/*
+ * Division of magnitudes. The divisor is sign-extended to the width of the
+ * dividend if it is narrower, and the dividend is padded with zeroes if it is
+ * narrower than the divisor. The quotinent has the width of the dividend.
+ */
+static auto binary_magnitude_division(words_type const& dividend,
+                                      size_type const dividend_width,
+                                      words_type const& divisor,
+                                      size_type const divisor_width)
+    -> words_type
+{
+    auto const width = std::max(dividend_width, divisor_width);
+    return binary_clip(
+        binary_unsigned_division(
+            binary_clip(dividend, dividend_width, width),
+            binary_expand(divisor, divisor_width, width),
+            width),
+        width,
+        dividend_width);
 }
-static auto binary_division(std::vector<bool> const& dividend,
-                            std::vector<bool> const& rhs) -> std::vector<bool>
+
+static auto binary_division(Bits const& dividend, Bits const& divisor)
+    -> words_type
 {
-    if (not binary_to_bool(rhs)) {
+    if (not divisor.boolean()) {
         throw std::make_unique<Exception>("division by zero");
     }
 
-    auto quotinent = std::vector<bool>{};
-    auto remainder = dividend;
-    auto divisor   = rhs;
-
-    quotinent.reserve(remainder.size());
-    std::fill_n(std::back_inserter(quotinent), remainder.size(), false);
+    auto const width = dividend.size();
 
-    if (binary_eq(divisor, dividend)) {
-        return binary_increment(quotinent).second;
+    if (binary_eq(
+            divisor.data(), divisor.size(), dividend.data(), dividend.size())) {
+        return binary_increment(zeroes(width), width);
     }
 
-    auto const negative_divisor  = binary_is_negative(divisor);
-    auto const negative_dividend = binary_is_negative(dividend);
-    auto negative_quotinent      = false;
+    auto const negative_divisor = binary_is_negative(divisor.data(), divisor.size());
+    auto const negative_dividend =
+        binary_is_negative(dividend.data(), dividend.size());
+    auto const negative_quotinent = (negative_divisor xor negative_dividend);
 
-    if (negative_divisor) {
-        divisor = take_twos_complement(divisor);
-    }
-    if (negative_dividend) {
-        remainder = take_twos_complement(remainder);
-    }
-    negative_quotinent = ((negative_divisor or negative_dividend)
-                          and not(negative_divisor and negative_dividend));
+    auto const divisor_magnitude =
+        (negative_divisor
+             ? take_twos_complement(divisor.data(), divisor.size())
+             : divisor.data());
+    auto const dividend_magnitude =
+        (negative_dividend ? take_twos_complement(dividend.data(), width)
+                           : dividend.data());
 
-    while (binary_lte(divisor, remainder)) {
-        remainder = binary_subtraction(remainder, divisor);
-        quotinent = binary_increment(quotinent).second;
-    }
+    auto quotinent = binary_magnitude_division(
+        dividend_magnitude, width, divisor_magnitude, divisor.size());
 
     if (negative_quotinent) {
-        quotinent = take_twos_complement(quotinent);
+        quotinent = take_twos_complement(quotinent, width);
     }
 
     return quotinent;
 }
 }  // namespace wrapping
-namespace checked {
-static auto signed_increment(std::vector<bool> v) -> std::vector<bool>
+/*
+ * Basic (unchecked, expanding) multiplication. The product is as wide as both
+ * operands together.
+ */
+static auto binary_full_multiplication(Bits const& lhs, Bits const& rhs)
+    -> words_type
 {
-    auto carry       = true;
-    auto incremented = v;
+    auto const width = (lhs.size() + rhs.size());
+    return wrapping::binary_multiplication(
+        binary_clip(lhs.data(), lhs.size(), width),
+        binary_clip(rhs.data(), rhs.size(), width),
+        width);
+}
 
-    for (auto i = decltype(incremented)::size_type{0}; carry and i < v.size();
-         ++i) {
-        if (v.at(i)) {
-            incremented.at(i) = false;
-        } else {
-            incremented.at(i) = true;
-            carry             = false;
-        }
-    }
+/*
+ * Basic (unchecked) addition. Operands are padded with zeroes to the width of
+ * the wider one.
+ */
+static auto binary_addition(Bits const& lhs, Bits const& rhs) -> Bits
+{
+    auto const width = std::max(lhs.size(), rhs.size());
+    return Bits{width,
+                wrapping::binary_addition(
+                    binary_clip(lhs.data(), lhs.size(), width),
+                    binary_clip(rhs.data(), rhs.size(), width),
+                    width)};
+}
+
+namespace checked {
+static auto signed_increment(Bits const& v) -> Bits
+{
+    auto incremented =
+        Bits{v.size(), wrapping::binary_increment(v.data(), v.size())};
 
     if ((not binary_is_negative(v)) and binary_is_negative(incremented)) {
         throw std::make_unique<Exception>(
@@ -497,18 +569,10 @@ static auto signed_increment(std::vector<bool> v) -> std::vector<bool>
 
     return incremented;
 }
-static auto signed_decrement(std::vector<bool> v) -> std::vector<bool>
+static auto signed_decrement(Bits const& v) -> Bits
 {
-    auto decremented = v;
-
-    for (auto i = decltype(decremented)::size_type{0}; i < v.size(); ++i) {
-        if (v.at(i)) {
-            decremented.at(i) = false;
-            break;
-        } else {
-            decremented.at(i) = true;
-        }
-    }
+    auto decremented =
+        Bits{v.size(), wrapping::binary_decrement(v.data(), v.size())};
 
     if (binary_is_negative(v) and not binary_is_negative(decremented)) {
         throw std::make_unique<Exception>(
@@ -517,12 +581,11 @@ static auto signed_decrement(std::vector<bool> v) -> std::vector<bool>
 
     return decremented;
 }
-static auto take_twos_complement(std::vector<bool> const& v)
-    -> std::vector<bool>
+static auto take_twos_complement(Bits const& v) -> Bits
 {
-    return signed_increment(binary_inversion(v));
+    return signed_increment(Bits{v.size(), binary_inversion(v.data(), v.size())});
 }
-static auto absolute(std::vector<bool> const& v) -> std::vector<bool>
+static auto absolute(Bits const& v) -> Bits
 {
     if (binary_is_negative(v)) {
         return take_twos_complement(v);
@@ -531,10 +594,11 @@ static auto absolute(std::vector<bool> const& v) -> std::vector<bool>
     }
 }
 
-static auto signed_lt(std::vector<bool> lhs, std::vector<bool> rhs)
+static auto signed_lt(Bits lhs, Bits rhs) -> bool
 {
-    lhs = binary_expand(lhs, std::max(lhs.size(), rhs.size()));
-    rhs = binary_expand(rhs, std::max(lhs.size(), rhs.size()));
+    auto const width = std::max(lhs.size(), rhs.size());
+    lhs              = binary_expand(lhs, width);
+    rhs              = binary_expand(rhs, width);
 
     if (binary_is_negative(lhs) and not binary_is_negative(rhs)) {
         return true;
@@ -550,30 +614,19 @@ static auto signed_lt(std::vector<bool> lhs, std::vector<bool> rhs)
         rhs = take_twos_complement(rhs);
     }
 
-    for (auto i = (lhs.size() - 1); i; --i) {
-        if (lhs.at(i - 1) < rhs.at(i - 1)) {
-            // definitely lhs < rhs
-            return true;
-        } else if (lhs.at(i - 1) > rhs.at(i - 1)) {
-            // totally lhs > rhs
-            return false;
-        }
-    }
-    // equal to each other
-    return true;
+    /*
+     * Sign bits are not compared. Equal values are reported as less than each
+     * other.
+     */
+    auto const magnitude_width = (width ? (width - 1) : 0);
+    return (binary_compare(binary_clip(lhs.data(), width, magnitude_width),
+                           binary_clip(rhs.data(), width, magnitude_width))
+            <= 0);
 }
 
 
-static auto signed_add(std::vector<bool> const& lhs,
-                       std::vector<bool> const& rhs) -> std::vector<bool>
+static auto signed_add(Bits const& lhs, Bits const& rhs) -> Bits
 {
-    auto result               = std::vector<bool>{};
-    auto const size_of_result = std::max(lhs.size(), rhs.size());
-    result.reserve(size_of_result + 1);
-    std::fill_n(std::back_inserter(result), size_of_result, false);
-
-    auto carry = false;
-
     auto const lhs_negative = binary_is_negative(lhs);
     auto const rhs_negative = binary_is_negative(rhs);
 
@@ -585,62 +638,7 @@ static auto signed_add(std::vector<bool> const& lhs,
         result_should_be_negative = true;
     }
 
-    for (auto i = decltype(size_of_result){0}; i < size_of_result; ++i) {
-        auto const from_lhs = (i < lhs.size() ? lhs.at(i) : false);
-        auto const from_rhs = (i < rhs.size() ? rhs.at(i) : false);
-
-        /*
-         * lhs + rhs -> 0 + 0 -> 0
-         *
-         * This is the easy case.
-         * Everything is zero, so we just carry the carry into the result at
-         * the current position, and reset the carry flag to zero (it was
-         * consumed).
-         */
-        if ((not from_rhs) and (not from_lhs)) {
-            result.at(i) = carry;
-            carry        = false;
-            continue;
-        }
-
-        /*
-         * lhs + rhs -> 1 + 1 -> 10
-         *
-         * This gives us a zero on current position, and
-         * carry flag in the enabled state.
-         *
-         * If carry was enabled before we have 0 + 1 = 1, so we should
-         * enable bit on current position in the result.
-         * If carry was not enabled we have 0 + 0, so we should
-         * obviously leave the bit disabled in the result.
-         * This means that we can just copy state of the carry flag into
-         * the result bit std::string on current position.
-         */
-        if (from_rhs and from_lhs) {
-            result.at(i) = carry;
-            carry        = true;
-            continue;
-        }
-
-        /*
-         * At this point either the lhs or rhs is enabled, but not both.
-         * So if the carry bit is enabled this gives us 1 + 1 = 10, so
-         * zero should be put in result on the current position, and
-         * carry flag should be enabled.
-         */
-        if (carry) {
-            continue;
-        }
-
-        /*
-         * All other cases.
-         * Either lhs or rhs is enabled, and carry is not.
-         * So this is the 0 + 1 = 1 case.
-         * Easy.
-         * Just enable the bit in the result.
-         */
-        result.at(i) = true;
-    }
+    auto const result = binary_addition(lhs, rhs);
 
     if (result_should_be_negative and not binary_is_negative(result)) {
         throw std::make_unique<Exception>(
@@ -653,109 +651,37 @@ static auto signed_add(std::vector<bool> const& lhs,
 
     return result;
 }
-static auto signed_sub(std::vector<bool> const& lhs,
-                       std::vector<bool> const& rhs) -> std::vector<bool>
+static auto signed_sub(Bits const& lhs, Bits const& rhs) -> Bits
 {
     if (lhs == rhs) {
-        auto result = std::vector<bool>{};
-        result.reserve(lhs.size());
-        std::fill_n(std::back_inserter(result), lhs.size(), false);
-        return result;
+        return Bits{lhs.size()};
     }
 
-    auto rhs_used = std::vector<bool>{};
+    auto const width = std::max(lhs.size(), rhs.size());
     try {
-        rhs_used = take_twos_complement(
-            binary_expand(rhs, std::max(lhs.size(), rhs.size())));
-    } catch (std::unique_ptr<Exception>&) {
-        throw std::make_unique<Exception>(
-            "CheckedArithmeticSubtractionSignedOverflow");
-    }
-
-    try {
-        return binary_clip(
-            signed_add(binary_expand(lhs, std::max(lhs.size(), rhs.size())),
-                       rhs_used),
-            lhs.size());
+        auto const rhs_used = take_twos_complement(binary_expand(rhs, width));
+        return binary_clip(signed_add(binary_expand(lhs, width), rhs_used),
+                           lhs.size());
     } catch (std::unique_ptr<Exception>&) {
         throw std::make_unique<Exception>(
             "CheckedArithmeticSubtractionSignedOverflow");
     }
 }
-static auto signed_mul(std::vector<bool> const& lhs,
-                       std::vector<bool> const& rhs) -> std::vector<bool>
+static auto signed_mul(Bits const& lhs, Bits const& rhs) -> Bits
 {
-    auto intermediates = std::vector<std::vector<bool>>{};
-    intermediates.reserve(rhs.size());
-
-    /*
-     * Make sure the result is *always* has at least one entry (in case the rhs
-     * is all zero bits), and that the results width is *always* the sum of
-     * operands' widths.
-     */
-    intermediates.emplace_back(lhs.size() + rhs.size());
-
     auto const lhs_negative              = binary_is_negative(lhs);
     auto const rhs_negative              = binary_is_negative(rhs);
     auto const result_should_be_negative = (lhs_negative xor rhs_negative);
 
-    for (auto i = std::remove_reference_t<decltype(lhs)>::size_type{0};
-         i < rhs.size();
-         ++i) {
-        if (not rhs.at(i)) {
-            /*
-             * Multiplication by 0 just gives a long std::string of zeroes.
-             * There is no reason to build all these zero-filled bit strings as
-             * they will only slow things down the road when all the
-             * intermediate bit strings are accumulated.
-             */
-            continue;
-        }
-
-        auto interm = std::vector<bool>{};
-        interm.reserve(i + lhs.size());
-        std::fill_n(std::back_inserter(interm), i, false);
-
-        std::copy(lhs.begin(), lhs.end(), std::back_inserter(interm));
-
-        intermediates.emplace_back(std::move(interm));
-    }
-
-    /*
-     * Result *MUST NOT* be empty.
-     * If it would be empty checking if it is negative would result in
-     * segmentation fault when binary_is_negative() would try to access last
-     * element of empty bit std::string.
-     */
-    auto result = std::vector<bool>{};
-    result.reserve(lhs.size());
-    std::fill_n(std::back_inserter(result), lhs.size(), false);
-
-    result =
-        std::accumulate(intermediates.begin(),
-                        intermediates.end(),
-                        result,
-                        [](std::vector<bool> const& l,
-                           std::vector<bool> const& r) -> std::vector<bool> {
-                            /*
-                             * Use basic (unchecked, expanding) binary addition
-                             * to accumulate the result. If you used checked
-                             * addition multiplication would throw "checked
-                             * signed addition" exceptions as overflow would be
-                             * detected during accumulation. We don't want that
-                             * so we use unchecked addition here, and check for
-                             * errors later.
-                             */
-                            return wrapping::binary_addition(l, r);
-                        });
-
     /*
      * We have to clip the result as it must remain fixed-size.
      * However, for overflow checking, we need the full unclipped result so we
      * just stash the clipped version here. The copy is not useless as it is
      * also used for error checking.
      */
-    auto clipped = binary_clip(result, lhs.size());
+    auto const result  = binary_full_multiplication(lhs, rhs);
+    auto const clipped = Bits{
+        lhs.size(), binary_clip(result, lhs.size() + rhs.size(), lhs.size())};
 
     /*
      * We can't just clip the result and be done with it because the part that
@@ -783,34 +709,23 @@ static auto signed_mul(std::vector<bool> const& lhs,
          * would be the retuned value) is not the same as the product of
          * absolute values of lhs and rhs. If they are the same, just discard
          * the extra bits - and this will yield the correct value.
-         *
-         * This works for small negative values for which abs * abs would be in
-         * range. For values that would produce out-of-range results the clipped
-         * result will be different than abs * abs, so we check for that - and
-         * throw an exception.
-         *
-         * It surely is not the most efficient algorithm, but it is simple and
-         * easy to understand. If you ever find something better - feel free to
-         * implement it. The test suite should catch your mistakes.
          */
         if ((not result_should_be_negative)
             and (lhs_negative or rhs_negative)) {
-            auto lhs_abs = std::vector<bool>{};
-            auto rhs_abs = std::vector<bool>{};
+            auto lhs_abs = Bits{0};
+            auto rhs_abs = Bits{0};
             try {
+                /*
+                 * Taking two's complement of the minimal value (a.k.a. negative
+                 * maximum, e.g. -128 for 8 bit integers) overflows.
+                 */
                 lhs_abs = absolute(lhs);
                 rhs_abs = absolute(rhs);
             } catch (std::unique_ptr<Exception>&) {
-                /*
-                 * This is why we need separate lhs_abs and rhs_abs variables
-                 * initialised under a try: because they can throw exceptions on
-                 * overflow when taking two's complement of the minimal value
-                 * (a.k.a. negative maximum, e.g. -128 for 8 bit integers).
-                 */
                 throw std::make_unique<Exception>(
                     "CheckedArithmeticMultiplicationSignedOverflow");
             }
-            if (clipped != signed_mul(lhs_abs, rhs_abs)) {
+            if (not(clipped == signed_mul(lhs_abs, rhs_abs))) {
                 throw std::make_unique<Exception>(
                     "CheckedArithmeticMultiplicationSignedOverflow");
             }
@@ -829,133 +744,74 @@ static auto signed_mul(std::vector<bool> const& lhs,
         }
     }
 
-    result = std::move(clipped);
-
-    if (result_should_be_negative != binary_is_negative(result)) {
+    if (result_should_be_negative != binary_is_negative(clipped)) {
         throw std::make_unique<Exception>(
             "CheckedArithmeticMultiplicationSignedOverflow");
     }
 
-    return result;
+    return clipped;
 }
-static auto signed_div(std::vector<bool> const& dividend,
-                       std::vector<bool> const& rhs) -> std::vector<bool>
+static auto signed_div(Bits const& dividend, Bits const& rhs) -> Bits
 {
-    if (not binary_to_bool(rhs)) {
+    if (not rhs.boolean()) {
         throw std::make_unique<Exception>("division by zero");
     }
 
-    auto quotinent = std::vector<bool>{};
-    auto remainder = dividend;
-    auto divisor   = rhs;
-
-    quotinent.reserve(remainder.size());
-    std::fill_n(std::back_inserter(quotinent), remainder.size(), false);
-
-    if (binary_eq(divisor, dividend)) {
-        return wrapping::binary_increment(quotinent).second;
+    if (binary_eq(rhs.data(), rhs.size(), dividend.data(), dividend.size())) {
+        return Bits{dividend.size(),
+                    wrapping::binary_increment(zeroes(dividend.size()),
+                                               dividend.size())};
     }
 
-    auto const negative_divisor  = binary_is_negative(divisor);
-    auto const negative_dividend = binary_is_negative(dividend);
-    auto negative_quotinent      = false;
+    auto const negative_divisor   = binary_is_negative(rhs);
+    auto const negative_dividend  = binary_is_negative(dividend);
+    auto const negative_quotinent = (negative_divisor xor negative_dividend);
 
     try {
-        divisor            = absolute(divisor);
-        remainder          = absolute(remainder);
-        negative_quotinent = (negative_divisor xor negative_dividend);
+        auto const divisor   = absolute(rhs);
+        auto const remainder = absolute(dividend);
 
-        while (wrapping::binary_lte(divisor, remainder)) {
-            remainder = wrapping::binary_subtraction(remainder, divisor);
-            quotinent = wrapping::binary_increment(quotinent).second;
-        }
+        auto quotinent = Bits{
+            dividend.size(),
+            wrapping::binary_magnitude_division(
+                remainder.data(), remainder.size(), divisor.data(), divisor.size())};
 
         if (negative_quotinent) {
             quotinent = take_twos_complement(quotinent);
         }
+
+        return quotinent;
     } catch (std::unique_ptr<Exception>&) {
         throw std::make_unique<Exception>(
             "CheckedArithmeticDivisionSignedOverflow");
     }
-
-    return quotinent;
 }
 }  // namespace checked
 namespace saturating {
-static auto signed_make_max(size_t const n) -> std::vector<bool>
+static auto signed_make_max(size_type const n) -> Bits
 {
-    auto v = std::vector<bool>{};
-    v.reserve(n);
-    v.resize(n - 1, true);
-    v.push_back(false);
+    auto v = Bits{n, ones(n)};
+    v.set(n - 1, false);
     return v;
 }
-static auto signed_make_min(size_t const n) -> std::vector<bool>
+static auto signed_make_min(size_type const n) -> Bits
 {
-    auto v = std::vector<bool>{};
-    v.reserve(n);
-    v.resize(n - 1, false);
-    v.push_back(true);
+    auto v = Bits{n};
+    v.set(n - 1, true);
     return v;
 }
-static auto signed_is_min(std::vector<bool> const v) -> bool
+static auto signed_is_min(Bits const& v) -> bool
 {
     /*
-     * Last bit must be set in two's complement for the number to be negative.
-     * If it's not then clearly the number encoded is not the minimum *signed*
-     * value.
+     * Only the sign bit may be set in two's complement for the number to be
+     * the minimum *signed* value.
      */
-    if (not v.back()) {
-        return false;
-    }
-    for (auto i = decltype(v)::size_type{0}; i < (v.size() - 1); ++i) {
-        /*
-         * If any bit except the last is set, then the value is not minimum.
-         * This works for signed integers.
-         */
-        if (v.at(i)) {
-            return false;
-        }
-    }
-    return true;
-}
-//            static auto signed_is_max(std::vector<bool> const v) -> bool {
-//                /*
-//                 * Last bit must be unset in two's complement for the number
-//                 to be positive.
-//                 * If it's not then clearly the number encoded is not the
-//                 maximum *signed* value.
-//                 */
-//                if (v.back()) {
-//                    return false;
-//                }
-//                for (auto i = decltype(v)::size_type{0}; i < (v.size() - 1);
-//                ++i) {
-//                    /*
-//                     * If any bit except the last is unset, then the value is
-//                     not maximum.
-//                     * This works for signed integers.
-//                     */
-//                    if (not v.at(i)) {
-//                        return false;
-//                    }
-//                }
-//                return true;
-//            }
-static auto signed_increment(std::vector<bool> v) -> std::vector<bool>
-{
-    auto carry       = true;
-    auto incremented = v;
-
-    for (auto i = decltype(incremented)::size_type{0}; carry and i < v.size();
-         ++i) {
-        if (v.at(i)) {
-            incremented.at(i) = false;
-        } else {
-            incremented.at(i) = true;
-            carry             = false;
-        }
-    }
+    return (v == signed_make_min(v.size()));
+}
+static auto signed_increment(Bits const& v) -> Bits
+{
+    auto incremented =
+        Bits{v.size(), wrapping::binary_increment(v.data(), v.size())};
 
     if ((not binary_is_negative(v)) and binary_is_negative(incremented)) {
         incremented = signed_make_max(v.size());
@@ -963,35 +819,24 @@ static auto signed_increment(std::vector<bool> v) -> std::vector<bool>
 
     return incremented;
 }
-static auto signed_decrement(std::vector<bool> v) -> std::vector<bool>
+static auto signed_decrement(Bits const& v) -> Bits
 {
     if (signed_is_min(v)) {
         return v;
     }
 
-    auto decremented = v;
-
-    for (auto i = decltype(decremented)::size_type{0}; i < v.size(); ++i) {
-        if (v.at(i)) {
-            decremented.at(i) = false;
-            break;
-        } else {
-            decremented.at(i) = true;
-        }
-    }
-
-    return decremented;
+    return Bits{v.size(), wrapping::binary_decrement(v.data(), v.size())};
 }
 
-static auto take_twos_complement(std::vector<bool> const& v)
-    -> std::vector<bool>
+static auto take_twos_complement(Bits const& v) -> Bits
 {
-    return signed_increment(binary_inversion(v));
+    return signed_increment(Bits{v.size(), binary_inversion(v.data(), v.size())});
 }
-static auto signed_lt(std::vector<bool> lhs, std::vector<bool> rhs)
+static auto signed_lt(Bits lhs, Bits rhs) -> bool
 {
-    lhs = binary_expand(lhs, std::max(lhs.size(), rhs.size()));
-    rhs = binary_expand(rhs, std::max(lhs.size(), rhs.size()));
+    auto const width = std::max(lhs.size(), rhs.size());
+    lhs              = binary_expand(lhs, width);
+    rhs              = binary_expand(rhs, width);
 
     if (binary_is_negative(lhs) and not binary_is_negative(rhs)) {
         return true;
@@ -1007,19 +852,16 @@ static auto signed_lt(std::vector<bool> lhs, std::vector<bool> rhs)
         rhs = take_twos_complement(rhs);
     }
 
-    for (auto i = (lhs.size() - 1); i; --i) {
-        if (lhs.at(i - 1) < rhs.at(i - 1)) {
-            // definitely lhs < rhs
-            return true;
-        } else if (lhs.at(i - 1) > rhs.at(i - 1)) {
-            // totally lhs > rhs
-            return false;
-        }
-    }
-    // equal to each other
-    return true;
+    /*
+     * Sign bits are not compared. Equal values are reported as less than each
+     * other.
+     */
+    auto const magnitude_width = (width ? (width - 1) : 0);
+    return (binary_compare(binary_clip(lhs.data(), width, magnitude_width),
+                           binary_clip(rhs.data(), width, magnitude_width))
+            <= 0);
 }
-static auto absolute(std::vector<bool> const& v) -> std::vector<bool>
+static auto absolute(Bits const& v) -> Bits
 {
     if (binary_is_negative(v)) {
         return take_twos_complement(v);
@@ -1028,16 +870,8 @@ static auto absolute(std::vector<bool> const& v) -> std::vector<bool>
     }
 }
 
-static auto signed_add(std::vector<bool> lhs, std::vector<bool> rhs)
-    -> std::vector<bool>
+static auto signed_add(Bits const& lhs, Bits const& rhs) -> Bits
 {
-    auto result               = std::vector<bool>{};
-    auto const size_of_result = std::max(lhs.size(), rhs.size());
-    result.reserve(size_of_result + 1);
-    std::fill_n(std::back_inserter(result), size_of_result, false);
-
-    auto carry = false;
-
     auto const lhs_negative = binary_is_negative(lhs);
     auto const rhs_negative = binary_is_negative(rhs);
 
@@ -1049,62 +883,7 @@ static auto signed_add(std::vector<bool> lhs, std::vector<bool> rhs)
         result_should_be_negative = true;
     }
 
-    for (auto i = decltype(size_of_result){0}; i < size_of_result; ++i) {
-        auto const from_lhs = (i < lhs.size() ? lhs.at(i) : false);
-        auto const from_rhs = (i < rhs.size() ? rhs.at(i) : false);
-
-        /*
-         * lhs + rhs -> 0 + 0 -> 0
-         *
-         * This is the easy case.
-         * Everything is zero, so we just carry the carry into the result at
-         * the current position, and reset the carry flag to zero (it was
-         * consumed).
-         */
-        if ((not from_rhs) and (not from_lhs)) {
-            result.at(i) = carry;
-            carry        = false;
-            continue;
-        }
-
-        /*
-         * lhs + rhs -> 1 + 1 -> 10
-         *
-         * This gives us a zero on current position, and
-         * carry flag in the enabled state.
-         *
-         * If carry was enabled before we have 0 + 1 = 1, so we should
-         * enable bit on current position in the result.
-         * If carry was not enabled we have 0 + 0, so we should
-         * obviously leave the bit disabled in the result.
-         * This means that we can just copy state of the carry flag into
-         * the result bit std::string on current position.
-         */
-        if (from_rhs and from_lhs) {
-            result.at(i) = carry;
-            carry        = true;
-            continue;
-        }
-
-        /*
-         * At this point either the lhs or rhs is enabled, but not both.
-         * So if the carry bit is enabled this gives us 1 + 1 = 10, so
-         * zero should be put in result on the current position, and
-         * carry flag should be enabled.
-         */
-        if (carry) {
-            continue;
-        }
-
-        /*
-         * All other cases.
-         * Either lhs or rhs is enabled, and carry is not.
-         * So this is the 0 + 1 = 1 case.
-         * Easy.
-         * Just enable the bit in the result.
-         */
-        result.at(i) = true;
-    }
+    auto result = binary_addition(lhs, rhs);
 
     if (result_should_be_negative and not binary_is_negative(result)) {
         result = signed_make_min(lhs.size());
@@ -1115,173 +894,55 @@ static auto signed_add(std::vector<bool> lhs, std::vector<bool> rhs)
 
     return result;
 }
-static auto signed_sub(std::vector<bool> lhs, std::vector<bool> rhs)
-    -> std::vector<bool>
+static auto signed_sub(Bits const& lhs, Bits const& rhs) -> Bits
 {
     if (lhs == rhs) {
-        auto result = std::vector<bool>{};
-        result.reserve(lhs.size());
-        std::fill_n(std::back_inserter(result), lhs.size(), false);
-        return result;
+        return Bits{lhs.size()};
     }
 
-    auto rhs_used = std::vector<bool>{};
-    try {
-        rhs_used = take_twos_complement(
-            binary_expand(rhs, std::max(lhs.size(), rhs.size())));
-    } catch (std::unique_ptr<Exception>&) {
-        throw std::make_unique<Exception>(
-            "SaturatingArithmeticSubtractionSignedOverflow");
-    }
+    auto const width    = std::max(lhs.size(), rhs.size());
+    auto const rhs_used = take_twos_complement(binary_expand(rhs, width));
 
-    try {
-        auto r = binary_clip(
-            signed_add(binary_expand(lhs, std::max(lhs.size(), rhs.size())),
-                       rhs_used),
-            lhs.size());
-        if (signed_is_min(rhs)) {
-            r = signed_increment(r);
-        }
-        return r;
-    } catch (std::unique_ptr<Exception>&) {
-        throw std::make_unique<Exception>(
-            "SaturatingArithmeticSubtractionSignedOverflow");
+    auto r = binary_clip(signed_add(binary_expand(lhs, width), rhs_used),
+                         lhs.size());
+    if (signed_is_min(rhs)) {
+        r = signed_increment(r);
     }
+    return r;
 }
-static auto signed_mul(std::vector<bool> const& lhs,
-                       std::vector<bool> const& rhs) -> std::vector<bool>
+static auto signed_mul(Bits const& lhs, Bits const& rhs) -> Bits
 {
-    auto intermediates = std::vector<std::vector<bool>>{};
-    intermediates.reserve(rhs.size());
-
-    /*
-     * Make sure the result is *always* has at least one entry (in case the rhs
-     * is all zero bits), and that the results width is *always* the sum of
-     * operands' widths.
-     */
-    intermediates.emplace_back(lhs.size() + rhs.size());
-
     auto const lhs_negative              = binary_is_negative(lhs);
     auto const rhs_negative              = binary_is_negative(rhs);
     auto const result_should_be_negative = (lhs_negative xor rhs_negative);
 
-    for (auto i = std::remove_reference_t<decltype(lhs)>::size_type{0};
-         i < rhs.size();
-         ++i) {
-        if (not rhs.at(i)) {
-            /*
-             * Multiplication by 0 just gives a long std::string of zeroes.
-             * There is no reason to build all these zero-filled bit strings as
-             * they will only slow things down the road when all the
-             * intermediate bit strings are accumulated.
-             */
-            continue;
-        }
-
-        auto interm = std::vector<bool>{};
-        interm.reserve(i + lhs.size());
-        std::fill_n(std::back_inserter(interm), i, false);
-
-        std::copy(lhs.begin(), lhs.end(), std::back_inserter(interm));
-
-        intermediates.emplace_back(std::move(interm));
-    }
-
-    /*
-     * Result *MUST NOT* be empty.
-     * If it would be empty checking if it is negative would result in
-     * segmentation fault when binary_is_negative() would try to access last
-     * element of empty bit std::string.
-     */
-    auto result = std::vector<bool>{};
-    result.reserve(lhs.size());
-    std::fill_n(std::back_inserter(result), lhs.size(), false);
-
-    result =
-        std::accumulate(intermediates.begin(),
-                        intermediates.end(),
-                        result,
-                        [](std::vector<bool> const& l,
-                           std::vector<bool> const& r) -> std::vector<bool> {
-                            /*
-                             * Use basic (unchecked, expanding) binary addition
-                             * to accumulate the result. If you used checked
-                             * addition multiplication would throw "checked
-                             * signed addition" exceptions as overflow would be
-                             * detected during accumulation. We don't want that
-                             * so we use unchecked addition here, and check for
-                             * errors later.
-                             */
-                            return wrapping::binary_addition(l, r);
-                        });
-
     /*
      * We have to clip the result as it must remain fixed-size.
      * However, for overflow checking, we need the full unclipped result so we
      * just stash the clipped version here. The copy is not useless as it is
      * also used for error checking.
      */
-    auto clipped = binary_clip(result, lhs.size());
+    auto const result = binary_full_multiplication(lhs, rhs);
+    auto clipped      = Bits{
+        lhs.size(), binary_clip(result, lhs.size() + rhs.size(), lhs.size())};
 
     /*
      * We can't just clip the result and be done with it because the part that
      * would be discarded may contain enabled bits. So let's check if the last
      * set bit (if there are any) is out of range for the valid result. If it
-     * is, make some extra checks to remove false positives (it would be too
-     * easy if one simple check would suffice) and only then throw exception if
-     * you must.
+     * is, make some extra checks to remove false positives.
      */
     auto last_set = binary_last_bit_set(result);
     if (last_set and *last_set >= lhs.size()) {
         /*
-         * This check is here to prevent exception being thrown for
-         * negative-negative multiplication. For example, this calculation would
-         * throw without it:
-         *
-         *      -2 * -2 = 4
-         *
-         * due to the fact that -2 is represented as 0b11111110 in two's
-         * complement. If you multiplied 0b11111110 by itself the result would
-         * be longer than 8 bits, so and last set bit would have index greater
-         * than 7 so, in theory, it should be an overflow.
-         *
-         * In such situations, though, we should check if clipped result (which
-         * would be the retuned value) is not the same as the product of
-         * absolute values of lhs and rhs. If they are the same, just discard
-         * the extra bits - and this will yield the correct value.
-         *
-         * This works for small negative values for which abs * abs would be in
-         * range. For values that would produce out-of-range results the clipped
-         * result will be different than abs * abs, so we check for that - and
-         * throw an exception.
-         *
-         * It surely is not the most efficient algorithm, but it is simple and
-         * easy to understand. If you ever find something better - feel free to
-         * implement it. The test suite should catch your mistakes.
+         * See the comment in checked::signed_mul() for the explanation of
+         * this check. Taking absolute values saturates instead of overflowing
+         * here, so the minimum negative value simply does not give the same
+         * product as the clipped result.
          */
         if ((not result_should_be_negative)
             and (lhs_negative or rhs_negative)) {
-            auto lhs_abs = std::vector<bool>{};
-            auto rhs_abs = std::vector<bool>{};
-            try {
-                lhs_abs = absolute(lhs);
-                rhs_abs = absolute(rhs);
-            } catch (Exception* e) {
-                /*
-                 * This is why we need separate lhs_abs and rhs_abs variables
-                 * initialised under a try: because they can throw exceptions on
-                 * overflow when taking two's complement of the minimal value
-                 * (a.k.a. negative maximum, e.g. -128 for 8 bit integers).
-                 *
-                 * In this case, the negative-positive multiplication, we need
-                 * to return the minimum representable value (as the result is
-                 * deep into the negative integers teritory).
-                 */
-                result  = signed_make_min(lhs.size());
-                clipped = signed_make_min(lhs.size());
-            }
-            if (clipped != signed_mul(lhs_abs, rhs_abs)) {
-                result  = signed_make_min(lhs.size());
+            if (not(clipped == signed_mul(absolute(lhs), absolute(rhs)))) {
                 clipped = signed_make_min(lhs.size());
             }
         }
@@ -1289,41 +950,28 @@ static auto signed_mul(std::vector<bool> const& lhs,
         /*
          * This is to catch overflows in positive-positive multiplications where
          * both operands are quite large, e.g. 64 * 64 for for 8 bit integers.
-         * It is necessary to put it here because the previous check would
-         * suppress these errors, as it only fires if at least one operand is
-         * negative and this check fires when neither is.
          */
         if (not(lhs_negative or rhs_negative)) {
-            result  = signed_make_max(lhs.size());
             clipped = signed_make_max(lhs.size());
         }
     }
 
-    result = std::move(clipped);
-
-    if (result_should_be_negative != binary_is_negative(result)) {
+    if (result_should_be_negative != binary_is_negative(clipped)) {
         if (result_should_be_negative) {
-            result = signed_make_min(lhs.size());
+            clipped = signed_make_min(lhs.size());
         } else {
-            result = signed_make_max(lhs.size());
+            clipped = signed_make_max(lhs.size());
         }
     }
 
-    return result;
+    return clipped;
 }
-static auto signed_div(std::vector<bool> dividend, std::vector<bool> divisor)
-    -> std::vector<bool>
+static auto signed_div(Bits const& dividend, Bits const& divisor) -> Bits
 {
-    if (not binary_to_bool(divisor)) {
+    if (not divisor.boolean()) {
         throw std::make_unique<Exception>("division by zero");
     }
 
-    auto quotinent = std::vector<bool>{};
-    auto remainder = dividend;
-
-    quotinent.reserve(remainder.size());
-    std::fill_n(std::back_inserter(quotinent), remainder.size(), false);
-
     if (signed_is_min(divisor)) {
         /*
          * Remember that we operate on arbitrary but fixed-size integers.
@@ -1331,24 +979,29 @@ static auto signed_div(std::vector<bool> dividend, std::vector<bool> divisor)
          * the most negative value is greater (in absolute terms) than the most
          * positive value. Thus, (x / minimum) equals 0 even if 'x' is maximum.
          */
-        return quotinent;
+        return Bits{dividend.size()};
     }
 
-    if (binary_eq(divisor, dividend)) {
-        return wrapping::binary_increment(quotinent).second;
+    if (binary_eq(
+            divisor.data(), divisor.size(), dividend.data(), dividend.size())) {
+        return Bits{dividend.size(),
+                    wrapping::binary_increment(zeroes(dividend.size()),
+                                               dividend.size())};
     }
 
     auto const negative_divisor   = binary_is_negative(divisor);
     auto const negative_dividend  = binary_is_negative(dividend);
     auto const negative_quotinent = (negative_divisor xor negative_dividend);
 
-    divisor   = absolute(divisor);
-    remainder = absolute(remainder);
+    auto const divisor_magnitude  = absolute(divisor);
+    auto const dividend_magnitude = absolute(dividend);
 
-    while (wrapping::binary_lte(divisor, remainder)) {
-        remainder = wrapping::binary_subtraction(remainder, divisor);
-        quotinent = wrapping::binary_increment(quotinent).second;
-    }
+    auto quotinent = Bits{dividend.size(),
+                          wrapping::binary_magnitude_division(
+                              dividend_magnitude.data(),
+                              dividend_magnitude.size(),
+                              divisor_magnitude.data(),
+                              divisor_magnitude.size())};
 
     if (negative_quotinent) {
         quotinent = take_twos_complement(quotinent);
@@ -1367,56 +1020,109 @@ auto viua::types::Bits::type() const -> std::string
 
 auto viua::types::Bits::str() const -> std::string
 {
-    return to_string(underlying_array);
+    auto s = std::string(width, '0');
+    for (auto i = size_type{0}; i < width; ++i) {
+        if (binary_bit(data(), i)) {
+            s[width - 1 - i] = '1';
+        }
+    }
+    return s;
 }
 
 auto viua::types::Bits::boolean() const -> bool
 {
-    return binary_to_bool(underlying_array);
+    return binary_to_bool(data());
 }
 
 auto viua::types::Bits::copy() const -> std::unique_ptr<viua::types::Value>
 {
-    return std::make_unique<Bits>(underlying_array);
+    return std::make_unique<Bits>(*this);
 }
 
 auto viua::types::Bits::size() const -> size_type
 {
-    return underlying_array.size();
+    return width;
+}
+
+auto viua::types::Bits::data() const -> std::vector<word_type> const&
+{
+    return *underlying_array;
+}
+
+auto viua::types::Bits::words() -> std::vector<word_type>&
+{
+    if (underlying_array.use_count() > 1) {
+        underlying_array =
+            std::make_shared<std::vector<word_type>>(*underlying_array);
+    } else {
+        /*
+         * Whoever shared the words with us has let go of them. Make sure their
+         * last reads happened before our writes.
+         */
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *underlying_array;
+}
+
+auto viua::types::Bits::replace(std::vector<word_type> fresh) -> void
+{
+    underlying_array =
+        std::make_shared<std::vector<word_type>>(std::move(fresh));
 }
 
 auto viua::types::Bits::at(size_type i) const -> bool
 {
-    return underlying_array.at(i);
+    if (i >= width) {
+        throw std::out_of_range{"Bits::at"};
+    }
+    return binary_bit(data(), i);
 }
 
 auto viua::types::Bits::set(size_type i, bool const value) -> bool
 {
-    auto const was         = at(i);
-    underlying_array.at(i) = value;
+    auto const was = at(i);
+    binary_set_bit(words(), i, value);
     return was;
 }
 
 auto viua::types::Bits::clear() -> void
 {
-    for (auto i = size_type{0}; i < underlying_array.size(); ++i) {
-        set(i, false);
-    }
+    replace(zeroes(width));
 }
 
 auto viua::types::Bits::shl(size_type n) -> std::unique_ptr<Bits>
 {
-    auto const result = binary_shl(underlying_array, n);
-    underlying_array  = std::move(result.second);
-    return std::make_unique<Bits>(result.first);
+    /*
+     * The bits shifted out are returned as a bit string of width n, so if the
+     * shift is wider than the bit string they are padded with zeroes on the
+     * right.
+     */
+    auto shifted =
+        ((n <= width)
+             ? binary_clip(binary_shr(data(), width - n, width), width, n)
+             : binary_shl(binary_clip(data(), width, n), n - width, n));
+    replace(binary_shl(data(), n, width));
+    return std::make_unique<Bits>(n, std::move(shifted));
 }
 
 auto viua::types::Bits::shr(size_type n, bool const padding)
     -> std::unique_ptr<Bits>
 {
-    auto const result = binary_shr(underlying_array, n, padding);
-    underlying_array  = std::move(result.second);
-    return std::make_unique<Bits>(result.first);
+    auto shifted = binary_clip(data(), width, n);
+    if (n >= width) {
+        clear();
+    } else {
+        auto shifted_words = binary_shr(data(), n, width);
+        if (padding) {
+            auto const fill = binary_shl(ones(width), width - n, width);
+            binary_bitwise<Bitwise_or>(shifted_words.data(),
+                                       shifted_words.data(),
+                                       fill.data(),
+                                       fill.size());
+        }
+        replace(std::move(shifted_words));
+    }
+    return std::make_unique<Bits>(n, std::move(shifted));
 }
 
 auto viua::types::Bits::shr(size_type n) -> std::unique_ptr<Bits>
@@ -1426,9 +1132,9 @@ auto viua::types::Bits::shr(size_type n) -> std::unique_ptr<Bits>
 
 auto viua::types::Bits::ashl(size_type n) -> std::unique_ptr<Bits>
 {
-    auto const sign = at(underlying_array.size() - 1);
+    auto const sign = at(width - 1);
     auto shifted    = shl(n);
-    set(underlying_array.size() - 1, sign);
+    set(width - 1, sign);
     return shifted;
 }
 
@@ -1439,224 +1145,226 @@ auto viua::types::Bits::ashr(size_type n) -> std::unique_ptr<Bits>
 
 auto viua::types::Bits::rol(size_type n) -> void
 {
-    auto const shifted = shl(n);
-    const auto offset  = shifted->underlying_array.size();
-    for (size_type i = 0; i < offset; ++i) {
-        set(i, shifted->at(i));
+    if (n > width) {
+        throw std::out_of_range{"Bits::rol"};
     }
+    auto const wrapped = binary_shr(data(), width - n, width);
+    auto rotated       = binary_shl(data(), n, width);
+    binary_bitwise<Bitwise_or>(
+        rotated.data(), rotated.data(), wrapped.data(), wrapped.size());
+    replace(std::move(rotated));
 }
 
 auto viua::types::Bits::ror(size_type n) -> void
 {
-    auto const shifted = shr(n);
-    const auto offset  = shifted->underlying_array.size();
-    for (size_type i = 0; i < offset; ++i) {
-        auto const target_index = (underlying_array.size() - 1 - i);
-        auto const source_index = (offset - 1 - i);
-        set(target_index, shifted->at(source_index));
+    if (n > width) {
+        throw std::out_of_range{"Bits::ror"};
     }
+    auto const wrapped = binary_shl(data(), width - n, width);
+    auto rotated       = binary_shr(data(), n, width);
+    binary_bitwise<Bitwise_or>(
+        rotated.data(), rotated.data(), wrapped.data(), wrapped.size());
+    replace(std::move(rotated));
 }
 
 auto viua::types::Bits::inverted() const -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(binary_inversion(underlying_array));
+    return std::make_unique<Bits>(width, binary_inversion(data(), width));
 }
 
 auto viua::types::Bits::increment() -> void
 {
-    underlying_array =
-        viua::arithmetic::wrapping::binary_increment(underlying_array).second;
+    auto& w = words();
+    w       = viua::arithmetic::wrapping::binary_increment(std::move(w), width);
 }
 
 auto viua::types::Bits::decrement() -> void
 {
-    underlying_array =
-        viua::arithmetic::wrapping::binary_decrement(underlying_array).second;
+    auto& w = words();
+    w       = viua::arithmetic::wrapping::binary_decrement(std::move(w), width);
 }
 
 auto viua::types::Bits::wrapadd(Bits const& that) const -> std::unique_ptr<Bits>
 {
     return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::wrapping::binary_addition(
-                        underlying_array, that.underlying_array),
-                    size()));
+        width,
+        viua::arithmetic::wrapping::binary_addition(
+            data(),
+            binary_clip(that.data(), that.width, width),
+            width));
 }
 auto viua::types::Bits::wrapsub(Bits const& that) const -> std::unique_ptr<Bits>
 {
     return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::wrapping::binary_subtraction(
-                        underlying_array, that.underlying_array),
-                    size()));
+        width,
+        viua::arithmetic::wrapping::binary_addition(
+            data(),
+            viua::arithmetic::wrapping::take_twos_complement(
+                binary_expand(that.data(), that.width, width),
+                width),
+            width));
 }
 auto viua::types::Bits::wrapmul(Bits const& that) const -> std::unique_ptr<Bits>
 {
     return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::wrapping::binary_multiplication(
-                        underlying_array, that.underlying_array),
-                    size()));
+        width,
+        viua::arithmetic::wrapping::binary_multiplication(
+            data(),
+            binary_clip(that.data(), that.width, width),
+            width));
 }
 auto viua::types::Bits::wrapdiv(Bits const& that) const -> std::unique_ptr<Bits>
 {
     return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::wrapping::binary_division(
-                        underlying_array, that.underlying_array),
-                    size()));
+        width, viua::arithmetic::wrapping::binary_division(*this, that));
 }
 
 
 auto viua::types::Bits::checked_signed_increment() -> void
 {
-    underlying_array =
-        viua::arithmetic::checked::signed_increment(underlying_array);
+    *this = viua::arithmetic::checked::signed_increment(*this);
 }
 auto viua::types::Bits::checked_signed_decrement() -> void
 {
-    underlying_array =
-        viua::arithmetic::checked::signed_decrement(underlying_array);
+    *this = viua::arithmetic::checked::signed_decrement(*this);
 }
 auto viua::types::Bits::checked_signed_add(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::checked::signed_add(
-                        underlying_array, that.underlying_array),
-                    size()));
+    return std::make_unique<Bits>(binary_clip(
+        viua::arithmetic::checked::signed_add(*this, that), size()));
 }
 auto viua::types::Bits::checked_signed_sub(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::checked::signed_sub(
-                        underlying_array, that.underlying_array),
-                    size()));
+    return std::make_unique<Bits>(binary_clip(
+        viua::arithmetic::checked::signed_sub(*this, that), size()));
 }
 auto viua::types::Bits::checked_signed_mul(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(viua::arithmetic::checked::signed_mul(
-        underlying_array, that.underlying_array));
+    return std::make_unique<Bits>(
+        viua::arithmetic::checked::signed_mul(*this, that));
 }
 auto viua::types::Bits::checked_signed_div(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(viua::arithmetic::checked::signed_div(
-        underlying_array, that.underlying_array));
+    return std::make_unique<Bits>(
+        viua::arithmetic::checked::signed_div(*this, that));
 }
 
 
 auto viua::types::Bits::saturating_signed_increment() -> void
 {
-    underlying_array =
-        viua::arithmetic::saturating::signed_increment(underlying_array);
+    *this = viua::arithmetic::saturating::signed_increment(*this);
 }
 auto viua::types::Bits::saturating_signed_decrement() -> void
 {
-    underlying_array =
-        viua::arithmetic::saturating::signed_decrement(underlying_array);
+    *this = viua::arithmetic::saturating::signed_decrement(*this);
 }
 auto viua::types::Bits::saturating_signed_add(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::saturating::signed_add(
-                        underlying_array, that.underlying_array),
-                    size()));
+    return std::make_unique<Bits>(binary_clip(
+        viua::arithmetic::saturating::signed_add(*this, that), size()));
 }
 auto viua::types::Bits::saturating_signed_sub(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(
-        binary_clip(viua::arithmetic::saturating::signed_sub(
-                        underlying_array, that.underlying_array),
-                    size()));
+    return std::make_unique<Bits>(binary_clip(
+        viua::arithmetic::saturating::signed_sub(*this, that), size()));
 }
 auto viua::types::Bits::saturating_signed_mul(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(viua::arithmetic::saturating::signed_mul(
-        underlying_array, that.underlying_array));
+    return std::make_unique<Bits>(
+        viua::arithmetic::saturating::signed_mul(*this, that));
 }
 auto viua::types::Bits::saturating_signed_div(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return std::make_unique<Bits>(viua::arithmetic::saturating::signed_div(
-        underlying_array, that.underlying_array));
+    return std::make_unique<Bits>(
+        viua::arithmetic::saturating::signed_div(*this, that));
 }
 
 auto viua::types::Bits::operator==(Bits const& that) const -> bool
 {
-    return (size() == that.size()
-            and underlying_array == that.underlying_array);
+    return (size() == that.size() and data() == that.data());
 }
 
-template<typename T>
+/*
+ * The result is as wide as the left-hand side operand. Bits beyond the width of
+ * the narrower operand are zero.
+ */
+template<typename Op>
 static auto perform_bitwise_logic(viua::types::Bits const& lhs,
                                   viua::types::Bits const& rhs)
     -> std::unique_ptr<viua::types::Bits>
 {
-    auto result = std::make_unique<viua::types::Bits>(lhs.size());
+    auto const common_width = std::min(lhs.size(), rhs.size());
 
-    for (auto i = viua::types::Bits::size_type{0};
-         i < std::min(lhs.size(), rhs.size());
-         ++i) {
-        result->set(i, T()(lhs.at(i), rhs.at(i)));
+    auto result = std::vector<word_type>(words_for(lhs.size()), 0);
+    binary_bitwise<Op>(result.data(),
+                       lhs.data().data(),
+                       rhs.data().data(),
+                       words_for(common_width));
+    if (common_width) {
+        result[words_for(common_width) - 1] &= top_word_mask(common_width);
     }
 
-    return result;
+    return std::make_unique<viua::types::Bits>(lhs.size(), std::move(result));
 }
 auto viua::types::Bits::operator|(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return perform_bitwise_logic<std::bit_or<bool>>(*this, that);
+    return perform_bitwise_logic<Bitwise_or>(*this, that);
 }
 
 auto viua::types::Bits::operator&(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return perform_bitwise_logic<std::bit_and<bool>>(*this, that);
+    return perform_bitwise_logic<Bitwise_and>(*this, that);
 }
 
 auto viua::types::Bits::operator^(Bits const& that) const
     -> std::unique_ptr<Bits>
 {
-    return perform_bitwise_logic<std::bit_xor<bool>>(*this, that);
-}
-
-viua::types::Bits::Bits(std::vector<bool>&& bs)
-{
-    underlying_array = std::move(bs);
+    return perform_bitwise_logic<Bitwise_xor>(*this, that);
 }
 
 viua::types::Bits::Bits(std::vector<bool> const& bs)
+        : underlying_array{std::make_shared<std::vector<word_type>>(
+            words_for(bs.size()), 0)}
+        , width{bs.size()}
 {
-    underlying_array = bs;
+    for (auto i = size_type{0}; i < width; ++i) {
+        binary_set_bit(*underlying_array, i, bs[i]);
+    }
 }
 
-viua::types::Bits::Bits(size_type i)
+viua::types::Bits::Bits(size_type const i)
+        : underlying_array{std::make_shared<std::vector<word_type>>(
+            words_for(i), 0)}
+        , width{i}
+{}
+
+viua::types::Bits::Bits(size_type const w, std::vector<word_type> words)
+        : underlying_array{std::make_shared<std::vector<word_type>>(
+            std::move(words))}
+        , width{w}
 {
-    underlying_array.reserve(i);
-    for (; i; --i) {
-        underlying_array.push_back(false);
-    }
+    underlying_array->resize(words_for(width), 0);
+    clip_top_word(*underlying_array, width);
 }
 
 viua::types::Bits::Bits(std::vector<uint8_t> const data)
-{
-    auto const bits_size = (data.size() * 8);
-    underlying_array.reserve(bits_size);
-    for (auto i = bits_size; i; --i) {
-        underlying_array.push_back(false);
-    }
-
-    constexpr auto const one = uint8_t{1};
-    for (auto byte_index = size_type{0}; byte_index < data.size();
-         ++byte_index) {
-        auto const a_byte = data.at(byte_index);
-
-        for (auto i = 0u; i < 8; ++i) {
-            auto const mask =
-                static_cast<std::remove_const_t<decltype(one)>>(one << i);
-            underlying_array.at((byte_index * 8) + i) = (a_byte & mask);
-        }
+        : underlying_array{std::make_shared<std::vector<word_type>>(
+            words_for(data.size() * 8), 0)}
+        , width{data.size() * 8}
+{
+    constexpr auto BYTES_PER_WORD = (WORD_WIDTH / 8);
+    for (auto i = size_type{0}; i < data.size(); ++i) {
+        (*underlying_array)[i / BYTES_PER_WORD] |=
+            (word_type{data[i]} << ((i % BYTES_PER_WORD) * 8));
     }
 }
@@ -20,6 +20,7 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -71,6 +72,31 @@ IO_interaction::Interaction_result::Interaction_result(State const st,
         : state{st}, status{su}, result{std::move(r)}
 {}
 
+namespace {
+auto cancelled_interaction() -> IO_interaction::Interaction_result
+{
+    return IO_interaction::Interaction_result{
+        IO_interaction::State::Complete,
+        IO_interaction::Status::Cancelled,
+        std::make_unique<viua::types::Exception>(
+            viua::types::Exception::Tag{"IO_cancel"}, "I/O cancelled")};
+}
+auto failed_interaction(int64_t const n) -> IO_interaction::Interaction_result
+{
+    /*
+     * Operations may also be cancelled by the I/O engine performing them, in
+     * which case they fail with ECANCELED.
+     */
+    if (n == -ECANCELED) {
+        return cancelled_interaction();
+    }
+    return IO_interaction::Interaction_result{
+        IO_interaction::State::Complete,
+        IO_interaction::Status::Error,
+        std::make_unique<viua::types::Integer>(-n)};
+}
+}  // namespace
+
 IO_read_interaction::IO_read_interaction(id_type const x,
                                          int const fd,
                                          size_t const limit)
@@ -79,21 +105,20 @@ IO_read_interaction::IO_read_interaction(id_type const x,
 auto IO_read_interaction::interact() -> Interaction_result
 {
     if (cancelled()) {
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Cancelled,
-            std::make_unique<viua::types::Exception>(
-                viua::types::Exception::Tag{"IO_cancel"}, "I/O cancelled")};
+        return cancelled_interaction();
     }
 
     auto const n = ::read(file_descriptor, buffer.data(), buffer.size());
-
-    if (n == -1) {
-        auto const saved_errno = errno;
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Error,
-            std::make_unique<viua::types::Integer>(saved_errno)};
+    return finish((n == -1) ? -errno : n);
+}
+auto IO_read_interaction::transfer_buffer() -> std::pair<char*, size_t>
+{
+    return {buffer.data(), buffer.size()};
+}
+auto IO_read_interaction::finish(int64_t const n) -> Interaction_result
+{
+    if (n < 0) {
+        return failed_interaction(n);
     }
     if (n == 0) {
         return Interaction_result{IO_interaction::State::Complete,
@@ -115,21 +140,20 @@ IO_write_interaction::IO_write_interaction(id_type const x,
 auto IO_write_interaction::interact() -> Interaction_result
 {
     if (cancelled()) {
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Cancelled,
-            std::make_unique<viua::types::Exception>(
-                viua::types::Exception::Tag{"IO_cancel"}, "I/O cancelled")};
+        return cancelled_interaction();
     }
 
     auto const n = ::write(file_descriptor, buffer.data(), buffer.size());
-
-    if (n == -1) {
-        auto const saved_errno = errno;
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Error,
-            std::make_unique<viua::types::Integer>(saved_errno)};
+    return finish((n == -1) ? -errno : n);
+}
+auto IO_write_interaction::transfer_buffer() -> std::pair<char*, size_t>
+{
+    return {buffer.data(), buffer.size()};
+}
+auto IO_write_interaction::finish(int64_t const n) -> Interaction_result
+{
+    if (n < 0) {
+        return failed_interaction(n);
     }
     return Interaction_result{IO_interaction::State::Complete,
                               IO_interaction::Status::Success,
@@ -143,21 +167,16 @@ IO_close_interaction::IO_close_interaction(id_type const x, int const fd)
 auto IO_close_interaction::interact() -> Interaction_result
 {
     if (cancelled()) {
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Cancelled,
-            std::make_unique<viua::types::Exception>(
-                viua::types::Exception::Tag{"IO_cancel"}, "I/O cancelled")};
+        return cancelled_interaction();
     }
 
     auto const n = ::close(file_descriptor);
-
-    if (n == -1) {
-        auto const saved_errno = errno;
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Error,
-            std::make_unique<viua::types::Integer>(saved_errno)};
+    return finish((n == -1) ? -errno : n);
+}
+auto IO_close_interaction::finish(int64_t const n) -> Interaction_result
+{
+    if (n < 0) {
+        return failed_interaction(n);
     }
     return Interaction_result{IO_interaction::State::Complete,
                               IO_interaction::Status::Success,
@@ -167,13 +186,13 @@ auto IO_close_interaction::interact() -> Interaction_result
 auto IO_empty_interaction::interact() -> Interaction_result
 {
     if (cancelled()) {
-        return Interaction_result{
-            IO_interaction::State::Complete,
-            IO_interaction::Status::Cancelled,
-            std::make_unique<viua::types::Exception>(
-                viua::types::Exception::Tag{"IO_cancel"}, "I/O cancelled")};
+        return cancelled_interaction();
     }
 
+    return finish(0);
+}
+auto IO_empty_interaction::finish(int64_t const) -> Interaction_result
+{
     return Interaction_result{IO_interaction::State::Complete,
                               IO_interaction::Status::Success,
                               std::make_unique<viua::types::Boolean>(true)};
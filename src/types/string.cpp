@@ -44,31 +44,31 @@ std::string String::type() const
 }
 std::string String::str() const
 {
-    return svalue;
+    return *svalue;
 }
 std::string String::repr() const
 {
-    return "b" + str::enquote(svalue);
+    return "b" + str::enquote(*svalue);
 }
 bool String::boolean() const
 {
-    return svalue.size() != 0;
+    return svalue->size() != 0;
 }
 
 std::unique_ptr<Value> String::copy() const
 {
-    return std::make_unique<String>(svalue);
+    return std::make_unique<String>(*this);
 }
 
 auto viua::types::String::operator==(viua::types::String const& other) const
     -> bool
 {
-    return (svalue == other.svalue);
+    return (svalue == other.svalue or *svalue == *other.svalue);
 }
 
 auto String::value() const -> std::string const&
 {
-    return svalue;
+    return *svalue;
 }
 
 // foreign methods
@@ -80,7 +80,7 @@ void String::format(Frame* frame,
 {
     std::regex key_regex("#\\{(?:(?:0|[1-9][0-9]*)|[a-zA-Z_][a-zA-Z0-9_]*)\\}");
 
-    std::string result = svalue;
+    std::string result = *svalue;
 
     if (std::regex_search(result, key_regex)) {
         auto matches = std::vector<std::string>{};
@@ -118,7 +118,10 @@ void String::format(Frame* frame,
     frame->local_register_set->set(0, std::make_unique<String>(result));
 }
 
-String::String(std::string s) : svalue(s)
+String::String(std::string s)
+        : svalue(std::make_shared<std::string const>(std::move(s)))
+{}
+String::String(String const& that) : Value(), svalue(that.svalue)
 {}
 
 auto String::make(std::string s) -> std::unique_ptr<String>
@@ -17,6 +17,8 @@
  *  along with Viua VM.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 
 #include <viua/exceptions.h>
@@ -25,6 +27,131 @@
 #include <viua/util/exceptions.h>
 
 
+auto viua::types::Struct::Shape::empty() -> Shape const*
+{
+    static Shape const root;
+    return &root;
+}
+
+auto viua::types::Struct::Shape::size() const -> size_type
+{
+    return keys.size();
+}
+
+auto viua::types::Struct::Shape::slot_of(key_type const key) const
+    -> std::optional<size_type>
+{
+    if (index.empty()) {
+        for (auto i = size_type{0}; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    if (auto const found = index.find(key); found != index.end()) {
+        return found->second;
+    }
+    return std::nullopt;
+}
+
+auto viua::types::Struct::Shape::key_at(size_type const slot) const
+    -> key_type
+{
+    return keys.at(slot);
+}
+
+auto viua::types::Struct::Shape::in_order() const
+    -> std::vector<size_type> const&
+{
+    return ordered;
+}
+
+auto viua::types::Struct::Shape::with(key_type const key) const
+    -> Shape const*
+{
+    {
+        std::shared_lock<std::shared_mutex> lck{transitions_mtx};
+        if (auto const found = transitions.find(key);
+            found != transitions.end()) {
+            return found->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lck{transitions_mtx};
+    if (auto const found = transitions.find(key); found != transitions.end()) {
+        return found->second.get();
+    }
+    if (transitions.size() >= TRANSITION_LIMIT) {
+        return nullptr;
+    }
+    auto& child = transitions[key];
+    child       = std::make_unique<Shape>(*this);
+    child->add(key);
+    return child.get();
+}
+
+auto viua::types::Struct::Shape::without(size_type const slot) const
+    -> Shape const*
+{
+    auto shape = empty();
+    for (auto i = size_type{0}; shape and i < keys.size(); ++i) {
+        if (i != slot) {
+            shape = shape->with(keys[i]);
+        }
+    }
+    return shape;
+}
+
+auto viua::types::Struct::Shape::add(key_type const key) -> void
+{
+    auto const& name = Atom::name_of(key);
+    auto const position =
+        std::lower_bound(ordered.begin(),
+                         ordered.end(),
+                         name,
+                         [this](size_type const slot, std::string const& n) {
+                             return (Atom::name_of(keys[slot]) < n);
+                         });
+
+    auto const slot = keys.size();
+    keys.push_back(key);
+    ordered.insert(position, slot);
+
+    if (not index.empty()) {
+        index.emplace(key, slot);
+    } else if (keys.size() > LINEAR_LOOKUP_LIMIT) {
+        for (auto i = size_type{0}; i < keys.size(); ++i) {
+            index.emplace(keys[i], i);
+        }
+    }
+}
+
+auto viua::types::Struct::Shape::remove(size_type const slot) -> void
+{
+    keys.erase(keys.begin() + static_cast<std::ptrdiff_t>(slot));
+
+    ordered.erase(std::find(ordered.begin(), ordered.end(), slot));
+    for (auto& each : ordered) {
+        if (each > slot) {
+            --each;
+        }
+    }
+
+    index.clear();
+    if (keys.size() > LINEAR_LOOKUP_LIMIT) {
+        for (auto i = size_type{0}; i < keys.size(); ++i) {
+            index.emplace(keys[i], i);
+        }
+    }
+}
+
+viua::types::Struct::Shape::Shape(Shape const& that)
+        : keys{that.keys}, ordered{that.ordered}, index{that.index}
+{}
+
+
 std::string viua::types::Struct::type() const
 {
     return type_name;
@@ -32,7 +159,7 @@ std::string viua::types::Struct::type() const
 
 bool viua::types::Struct::boolean() const
 {
-    return (not attributes.empty());
+    return (not values.empty());
 }
 
 std::string viua::types::Struct::str() const
@@ -41,9 +168,10 @@ std::string viua::types::Struct::str() const
 
     oss << '{';
 
-    auto i = attributes.size();
-    for (auto const& each : attributes) {
-        oss << str::enquote(each.first, '\'') << ": " << each.second->repr();
+    auto i = values.size();
+    for (auto const slot : shape->in_order()) {
+        oss << str::enquote(Atom::name_of(shape->key_at(slot)), '\'')
+            << ": " << values[slot]->repr();
         if (--i) {
             oss << ", ";
         }
@@ -59,73 +187,144 @@ std::string viua::types::Struct::repr() const
     return str();
 }
 
-void viua::types::Struct::insert(std::string const& key,
-                                 std::unique_ptr<viua::types::Value> value)
+auto viua::types::Struct::slot_of(key_type const key) const -> size_type
 {
-    attributes[key] = std::move(value);
+    if (auto const slot = shape->slot_of(key); slot.has_value()) {
+        return *slot;
+    }
+
+    using viua::util::exceptions::make_unique_exception;
+    throw make_unique_exception<
+        viua::runtime::exceptions::Invalid_field_access>(Atom::name_of(key));
 }
 
-std::unique_ptr<viua::types::Value> viua::types::Struct::remove(
-    std::string const& key)
+auto viua::types::Struct::insert(key_type const key,
+                                 std::unique_ptr<viua::types::Value> value)
+    -> void
 {
-    if (attributes.count(key) == 0) {
-        using viua::util::exceptions::make_unique_exception;
-        throw make_unique_exception<
-            viua::runtime::exceptions::Invalid_field_access>(key);
+    if (auto const slot = shape->slot_of(key); slot.has_value()) {
+        values[*slot] = std::move(value);
+        return;
     }
 
-    auto value = std::move(attributes.at(key));
-    attributes.erase(key);
-    return value;
+    if (own_shape) {
+        own_shape->add(key);
+    } else if (auto const shared =
+                   ((shape->size() < SHARED_SHAPE_LIMIT) ? shape->with(key)
+                                                         : nullptr);
+               shared) {
+        shape = shared;
+    } else {
+        own_shape = std::make_unique<Shape>(*shape);
+        own_shape->add(key);
+        shape = own_shape.get();
+    }
+    values.push_back(std::move(value));
 }
 
-auto viua::types::Struct::at(std::string const& key) -> viua::types::Value*
+auto viua::types::Struct::remove(key_type const key)
+    -> std::unique_ptr<viua::types::Value>
 {
-    if (attributes.count(key) == 0) {
-        using viua::util::exceptions::make_unique_exception;
-        throw make_unique_exception<
-            viua::runtime::exceptions::Invalid_field_access>(key);
+    auto const slot = slot_of(key);
+
+    auto value = std::move(values[slot]);
+    values.erase(values.begin() + static_cast<std::ptrdiff_t>(slot));
+
+    if (own_shape) {
+        own_shape->remove(slot);
+    } else if (auto const shared = shape->without(slot); shared) {
+        shape = shared;
+    } else {
+        own_shape = std::make_unique<Shape>(*shape);
+        own_shape->remove(slot);
+        shape = own_shape.get();
     }
 
-    auto& value = attributes.at(key);
-    return value.get();
+    return value;
 }
 
-auto viua::types::Struct::at(std::string const& key) const
+auto viua::types::Struct::at(key_type const key) -> viua::types::Value*
+{
+    return values[slot_of(key)].get();
+}
+
+auto viua::types::Struct::at(key_type const key) const
     -> viua::types::Value const*
 {
-    if (attributes.count(key) == 0) {
-        using viua::util::exceptions::make_unique_exception;
-        throw make_unique_exception<
-            viua::runtime::exceptions::Invalid_field_access>(key);
+    return values[slot_of(key)].get();
+}
+
+auto viua::types::Struct::keys() const -> std::vector<key_type>
+{
+    auto ks = std::vector<key_type>{};
+    ks.reserve(values.size());
+    for (auto const slot : shape->in_order()) {
+        ks.push_back(shape->key_at(slot));
     }
+    return ks;
+}
 
-    auto& value = attributes.at(key);
-    return value.get();
+auto viua::types::Struct::insert(std::string const& key,
+                                 std::unique_ptr<viua::types::Value> value)
+    -> void
+{
+    insert(Atom::intern(key), std::move(value));
 }
 
-std::vector<std::string> viua::types::Struct::keys() const
+/*
+ * Only inserting a field may create a new atom. A name that is not an atom
+ * cannot be the key of any field.
+ */
+static auto existing_key(std::string const& key)
+    -> viua::types::Struct::key_type
 {
-    auto ks = std::vector<std::string>{};
-    for (auto const& each : attributes) {
-        ks.push_back(each.first);
+    if (auto const id = viua::types::Atom::find(key); id.has_value()) {
+        return *id;
     }
-    return ks;
+
+    using viua::util::exceptions::make_unique_exception;
+    throw make_unique_exception<
+        viua::runtime::exceptions::Invalid_field_access>(key);
+}
+
+auto viua::types::Struct::remove(std::string const& key)
+    -> std::unique_ptr<viua::types::Value>
+{
+    return remove(existing_key(key));
+}
+
+auto viua::types::Struct::at(std::string const& key) -> viua::types::Value*
+{
+    return at(existing_key(key));
+}
+
+auto viua::types::Struct::at(std::string const& key) const
+    -> viua::types::Value const*
+{
+    return at(existing_key(key));
 }
 
 std::unique_ptr<viua::types::Value> viua::types::Struct::copy() const
 {
     auto copied = std::make_unique<Struct>();
-    for (auto const& each : attributes) {
-        copied->insert(each.first, each.second->copy());
+    if (own_shape) {
+        copied->own_shape = std::make_unique<Shape>(*own_shape);
+        copied->shape     = copied->own_shape.get();
+    } else {
+        copied->shape = shape;
+    }
+
+    copied->values.reserve(values.size());
+    for (auto const& each : values) {
+        copied->values.push_back(each->copy());
     }
     return copied;
 }
 
 auto viua::types::Struct::expire() -> void
 {
-    for (auto& each : attributes) {
-        each.second->expire();
+    for (auto& each : values) {
+        each->expire();
     }
 }
 
@@ -18,7 +18,7 @@
  */
 
 #include <algorithm>
-#include <sstream>
+#include <stdexcept>
 
 #include <viua/support/string.h>
 #include <viua/types/text.h>
@@ -46,67 +46,78 @@ static auto is_continuation_byte(char b) -> bool
 {
     return is_continuation_byte(static_cast<uint8_t>(b));
 }
-auto viua::types::Text::parse(std::string s) -> decltype(text)
-{
-    auto parsed_text = std::vector<Character>{};
-
-    char ss[5];
-    ss[4] = '\0';
-
-    for (decltype(s)::size_type i = 0; i < s.size(); ++i) {
-        const auto each{s.at(i)};
-        ss[0] = each;
-        ss[1] = '\0';
-        ss[2] = '\0';
-        ss[3] = '\0';
-
-        if ((UTF8_1ST_ROW_NORMALISER & each) == UTF8_1ST_ROW) {
-            // do nothing
-        } else if ((UTF8_2ND_ROW_NORMALISER & each) == UTF8_2ND_ROW) {
-            ss[1] = s.at(i + 1);
-        } else if ((UTF8_3RD_ROW_NORMALISER & each) == UTF8_3RD_ROW) {
-            ss[1] = s.at(i + 1);
-            ss[2] = s.at(i + 2);
-        } else if ((UTF8_4TH_ROW_NORMALISER & each) == UTF8_4TH_ROW) {
-            ss[1] = s.at(i + 1);
-            ss[2] = s.at(i + 2);
-            ss[3] = s.at(i + 3);
-        }
 
-        if ((UTF8_1ST_ROW_NORMALISER & ss[0]) == UTF8_1ST_ROW) {
-            // do nothing
-        } else if ((UTF8_2ND_ROW_NORMALISER & ss[0]) == UTF8_2ND_ROW
-                   and is_continuation_byte(ss[1])) {
-            ++i;
-        } else if ((UTF8_3RD_ROW_NORMALISER & ss[0]) == UTF8_3RD_ROW
-                   and is_continuation_byte(ss[1])
-                   and is_continuation_byte(ss[2])) {
-            ++i;
-            ++i;
-        } else if ((UTF8_4TH_ROW_NORMALISER & ss[0]) == UTF8_4TH_ROW
-                   and is_continuation_byte(ss[1])
-                   and is_continuation_byte(ss[2])
-                   and is_continuation_byte(ss[3])) {
-            ++i;
-            ++i;
-            ++i;
-        } else {
+auto viua::types::Text::width_of(char const c) -> size_type
+{
+    auto const lead = static_cast<uint8_t>(c);
+    if ((UTF8_1ST_ROW_NORMALISER & lead) == UTF8_1ST_ROW) {
+        return 1;
+    } else if ((UTF8_2ND_ROW_NORMALISER & lead) == UTF8_2ND_ROW) {
+        return 2;
+    } else if ((UTF8_3RD_ROW_NORMALISER & lead) == UTF8_3RD_ROW) {
+        return 3;
+    } else if ((UTF8_4TH_ROW_NORMALISER & lead) == UTF8_4TH_ROW) {
+        return 4;
+    }
+    return 0;
+}
+auto viua::types::Text::validate(std::string const& s) -> size_type
+{
+    auto code_points = size_type{0};
+    for (auto i = size_type{0}; i < s.size(); ++code_points) {
+        auto const width = width_of(s[i]);
+        if (width == 0 or (i + width) > s.size()) {
             throw std::domain_error(s);
         }
+        for (auto j = size_type{1}; j < width; ++j) {
+            if (not is_continuation_byte(s[i + j])) {
+                throw std::domain_error(s);
+            }
+        }
+        i += width;
+    }
+    return code_points;
+}
+auto viua::types::Text::offset_of(size_type const n) const -> size_type
+{
+    if (n >= length) {
+        return text->size();
+    }
 
-        parsed_text.emplace_back(ss);
+    if ((not index) and length > INDEX_SAMPLING) {
+        auto offsets = std::vector<size_type>{};
+        offsets.reserve((length / INDEX_SAMPLING) + 1);
+        auto offset = size_type{0};
+        for (auto i = size_type{0}; i < length; ++i) {
+            if ((i % INDEX_SAMPLING) == 0) {
+                offsets.push_back(offset);
+            }
+            offset += width_of((*text)[offset]);
+        }
+        index = std::make_shared<std::vector<size_type> const>(
+            std::move(offsets));
     }
 
-    return parsed_text;
+    auto offset = (index ? (*index)[n / INDEX_SAMPLING] : size_type{0});
+    for (auto i = size_type{0}; i < (n % INDEX_SAMPLING); ++i) {
+        offset += width_of((*text)[offset]);
+    }
+    return offset;
 }
 
-viua::types::Text::Text(std::string s) : text{parse(s)}, text_str{std::move(s)}
+viua::types::Text::Text(std::string s, size_type const n)
+        : text{std::make_shared<std::string const>(std::move(s))}
+        , length{n}
+{}
+viua::types::Text::Text(std::string s)
+        : text{std::make_shared<std::string const>(std::move(s))}
+        , length{validate(*text)}
 {}
-viua::types::Text::Text(std::vector<Character> s)
-        : text(std::move(s)), text_str{str()}
+viua::types::Text::Text(Text const& s)
+        : Value(), text{s.text}, length{s.length}, index{s.index}
 {}
 viua::types::Text::Text(Text&& s)
-        : text{std::move(s.text)}, text_str{std::move(s.text_str)}
+        : text{std::move(s.text)}, length{s.length}, index{std::move(s.index)}
 {}
 
 auto viua::types::Text::type() const -> std::string
@@ -116,11 +127,7 @@ auto viua::types::Text::type() const -> std::string
 
 auto viua::types::Text::str() const -> std::string
 {
-    auto oss = std::ostringstream{};
-    for (auto const& each : text) {
-        oss << each;
-    }
-    return oss.str();
+    return *text;
 }
 
 auto viua::types::Text::repr() const -> std::string
@@ -135,64 +142,70 @@ auto viua::types::Text::boolean() const -> bool
 
 auto viua::types::Text::copy() const -> std::unique_ptr<viua::types::Value>
 {
-    return std::make_unique<Text>(text);
+    return std::make_unique<Text>(*this);
 }
 
 auto viua::types::Text::operator==(viua::types::Text const& other) const -> bool
 {
-    return (text == other.text);
+    return (text == other.text or *text == *other.text);
 }
 
 auto viua::types::Text::operator+(viua::types::Text const& other) const -> Text
 {
-    auto copied = decltype(text){};
-    for (size_type i = 0; i < size(); ++i) {
-        copied.push_back(text.at(i));
-    }
-    for (size_type i = 0; i < other.size(); ++i) {
-        copied.push_back(other.at(i));
-    }
-    return copied;
+    return Text{*text + *other.text, length + other.length};
 }
 
 auto viua::types::Text::at(const size_type i) const -> Character
 {
-    return text.at(i);
+    if (i >= length) {
+        throw std::out_of_range("viua::types::Text::at");
+    }
+    auto const offset = offset_of(i);
+    return text->substr(offset, width_of((*text)[offset]));
 }
 
 auto viua::types::Text::signed_size() const -> int64_t
 {
-    return static_cast<int64_t>(text.size());
+    return static_cast<int64_t>(length);
 }
 auto viua::types::Text::size() const -> size_type
 {
-    return text.size();
+    return length;
 }
 
 
 auto viua::types::Text::sub(size_type first_index, size_type last_index) const
-    -> decltype(text)
+    -> Text
 {
-    auto copied = decltype(text){};
-    for (size_type i = first_index; i < size() and i < last_index; ++i) {
-        copied.push_back(text.at(i));
+    last_index = std::min(last_index, length);
+    if (first_index >= last_index) {
+        return Text{std::string{}, 0};
     }
-    return copied;
+
+    auto const first = offset_of(first_index);
+    auto const last  = offset_of(last_index);
+    return Text{text->substr(first, last - first), last_index - first_index};
 }
-auto viua::types::Text::sub(size_type first_index) const -> decltype(text)
+auto viua::types::Text::sub(size_type first_index) const -> Text
 {
-    return sub(first_index, text.size());
+    return sub(first_index, length);
 }
 
 
 auto viua::types::Text::common_prefix(Text const& other) const -> size_type
 {
+    /*
+     * Both texts are valid UTF-8 so as long as their code points are equal
+     * they are at the same byte offsets in both.
+     */
     auto length_of_common_prefix = size_type{0};
-    auto limit                   = std::max(size(), other.size());
-
-    while (length_of_common_prefix < limit
-           and text.at(length_of_common_prefix)
-                   == other.at(length_of_common_prefix)) {
+    auto offset                  = size_type{0};
+    while (offset < text->size() and offset < other.text->size()) {
+        auto const width = width_of((*text)[offset]);
+        if (text->compare(offset, width, *other.text, offset, width) != 0) {
+            break;
+        }
+        offset += width;
         ++length_of_common_prefix;
     }
 
@@ -200,16 +213,39 @@ auto viua::types::Text::common_prefix(Text const& other) const -> size_type
 }
 auto viua::types::Text::common_suffix(Text const& other) const -> size_type
 {
+    if (length == 0 or other.length == 0) {
+        return 0;
+    }
+
+    /*
+     * The first code points of the texts are never compared.
+     */
+    auto const limit = (std::min(length, other.length) - 1);
+
     auto length_of_common_suffix = size_type{0};
 
-    auto this_index  = size_type{size() - 1};
-    auto other_index = size_type{other.size() - 1};
+    auto this_end  = text->size();
+    auto other_end = other.text->size();
+    while (length_of_common_suffix < limit) {
+        auto this_begin = this_end - 1;
+        while (is_continuation_byte((*text)[this_begin])) {
+            --this_begin;
+        }
+        auto other_begin = other_end - 1;
+        while (is_continuation_byte((*other.text)[other_begin])) {
+            --other_begin;
+        }
+
+        auto const width = (this_end - this_begin);
+        if (width != (other_end - other_begin)
+            or text->compare(this_begin, width, *other.text, other_begin, width)
+                   != 0) {
+            break;
+        }
 
-    while ((this_index and other_index)
-           and text.at(this_index) == other.at(other_index)) {
         ++length_of_common_suffix;
-        --this_index;
-        --other_index;
+        this_end  = this_begin;
+        other_end = other_begin;
     }
 
     return length_of_common_suffix;
@@ -217,5 +253,5 @@ auto viua::types::Text::common_suffix(Text const& other) const -> size_type
 
 auto viua::types::Text::data() const -> std::string const&
 {
-    return text_str;
+    return *text;
 }
@@ -0,0 +1,13 @@
+.function: main/1
+    allocate_registers %5 local
+    integer %1 local -17
+    integer %2 local 0
+    lt %3 local %1 local %2 local
+    not %3 local %3 local
+    if %3 local 0x5b 0x44
+    integer %4 local -1
+    mul %1 local %1 local %4 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,10 @@
+.function: main/1
+    allocate_registers %3 local
+    string %1 local "Hello World"
+    integer %2 local 42
+    if %2 local 0x5d 0x36
+    string %1 local "Goodby World, you fail this test"
+    print %1 local
+    izero %0 local
+    return
+.end
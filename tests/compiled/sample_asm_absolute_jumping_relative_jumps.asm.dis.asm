@@ -0,0 +1,11 @@
+.function: main/1
+    allocate_registers %2 local
+    string %1 local "Hello World"
+    jump 0x2e
+    print %1 local
+    jump 0x37
+    jump 0x20
+    delete %1 local
+    izero %0 local
+    return
+.end
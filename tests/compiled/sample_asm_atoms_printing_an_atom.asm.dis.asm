@@ -0,0 +1,7 @@
+.function: main/0
+    allocate_registers %2 local
+    atom %1 local 'an_atom'
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,8 @@
+.function: main/0
+    allocate_registers %2 local
+    bits %1 local 0b10000000
+    checkedsdecrement %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
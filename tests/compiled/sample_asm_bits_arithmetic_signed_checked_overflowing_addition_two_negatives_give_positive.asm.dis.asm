@@ -0,0 +1,15 @@
+.function: main/0
+    allocate_registers %4 local
+    bits %1 local 0b01111111
+    bits %2 local 0b00000010
+    bitnot %1 local %1 local
+    checkedsincrement %1 local
+    bitnot %2 local %2 local
+    checkedsincrement %2 local
+    checkedsadd %3 local %1 local %2 local
+    print %1 local
+    print %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %2 local
+    bits %1 local 0b10000000
+    print %1 local
+    saturatingsdecrement %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,16 @@
+.function: main/0
+    allocate_registers %5 local
+    bits %1 local 0x00ffffffffffffffff
+    bits %2 local 0x000000000000000001
+    bits %3 local 0x010000000000000000
+    wrapadd %4 local %1 local %2 local
+    print %4 local
+    wrapsub %4 local %4 local %2 local
+    print %4 local
+    wrapmul %4 local %4 local %3 local
+    print %4 local
+    wrapdiv %4 local %4 local %3 local
+    print %4 local
+    izero %0 local
+    return
+.end
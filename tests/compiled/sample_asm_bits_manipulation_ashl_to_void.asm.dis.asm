@@ -0,0 +1,10 @@
+.function: main/0
+    allocate_registers %3 local
+    bits %1 local 0x80000060
+    integer %2 local 4
+    print %1 local
+    ashl void %1 local %2 local
+    print %1 local
+    izero %0 local
+    return
+.end
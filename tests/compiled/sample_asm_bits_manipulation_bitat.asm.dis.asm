@@ -0,0 +1,13 @@
+.function: main/0
+    allocate_registers %4 local
+    bits %1 local 0b10011101
+    print %1 local
+    integer %2 local 2
+    bitat %3 local %1 local %2 local
+    print %3 local
+    integer %2 local 1
+    bitat %3 local %1 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,10 @@
+.function: main/0
+    allocate_registers %4 local
+    integer %1 local 8
+    bits %2 local %1 local
+    print %2 local
+    bitnot %3 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,13 @@
+.function: main/0
+    allocate_registers %5 local
+    bits %1 local 0b1101000100100111
+    bits %2 local 0b00001101
+    print %1 local
+    print %2 local
+    bitor %3 local %1 local %2 local
+    print %3 local
+    bitor %4 local %2 local %1 local
+    print %4 local
+    izero %0 local
+    return
+.end
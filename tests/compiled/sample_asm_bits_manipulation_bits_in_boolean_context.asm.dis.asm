@@ -0,0 +1,13 @@
+.function: main/0
+    allocate_registers %4 local
+    bits %1 local 0b00000000
+    if %1 local 0x29 0x3c
+    text %2 local "OH NOES"
+    print %2 local
+    bits %1 local 0b00000001
+    if %1 local 0x60 0x73
+    text %3 local "OH YEAH"
+    print %3 local
+    izero %0 local
+    return
+.end
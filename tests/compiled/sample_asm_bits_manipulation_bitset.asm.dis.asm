@@ -0,0 +1,12 @@
+.function: main/0
+    allocate_registers %3 local
+    bits %1 local 0b10000000
+    print %1 local
+    integer %2 local 0
+    bitset %1 local %2 local true
+    integer %2 local 7
+    bitset %1 local %2 local false
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %4 local
+    bits %1 local 0b00001100
+    bits %2 local 0b00001010
+    print %1 local
+    print %2 local
+    bitxor %3 local %1 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,15 @@
+.function: main/0
+    allocate_registers %5 local
+    bits %1 local 0b10000000
+    copy %2 local %1 local
+    integer %3 local 0
+    bitset %2 local %3 local true
+    copy %4 local %1 local
+    wrapincrement %4 local
+    wrapincrement %4 local
+    print %1 local
+    print %2 local
+    print %4 local
+    izero %0 local
+    return
+.end
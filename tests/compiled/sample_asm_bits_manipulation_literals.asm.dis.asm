@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %2 local
+    bits %1 local 0xdeadbeef
+    print %1 local
+    bits %1 local 0xdeadbeef
+    print %1 local
+    bits %1 local 0xdeadbeef
+    print %1 local
+    izero %0 local
+    return
+.end
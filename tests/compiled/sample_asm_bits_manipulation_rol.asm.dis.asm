@@ -0,0 +1,10 @@
+.function: main/0
+    allocate_registers %3 local
+    bits %1 local 0b10011101
+    integer %2 local 2
+    print %1 local
+    rol %1 local %2 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %4 local
+    bits %1 local 0b10010111
+    integer %2 local 16
+    print %1 local
+    shr %3 local %1 local %2 local
+    print %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
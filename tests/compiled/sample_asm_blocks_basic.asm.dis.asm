@@ -0,0 +1,13 @@
+.block: main_block
+    integer %1 local 42
+    leave
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    try
+    enter main_block
+    print %1 local
+    izero %0 local
+    return
+.end
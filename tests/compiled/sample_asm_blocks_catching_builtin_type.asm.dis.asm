@@ -0,0 +1,20 @@
+.block: handle_integer
+    draw %2 local
+    print %2 local
+    leave
+.end
+
+.block: main_block
+    integer %1 local 42
+    throw %1 local
+    leave
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    try
+    catch "Integer" handle_integer
+    enter main_block
+    izero %0 local
+    return
+.end
@@ -0,0 +1,21 @@
+.function: boolean/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    not %1 local %1 local
+    not %1 local %1 local
+    move %0 local %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    izero %1 local
+    frame %1 local
+    copy %0 arguments %1 local
+    call %1 local boolean/1
+    print %1 local
+    not %1 local %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
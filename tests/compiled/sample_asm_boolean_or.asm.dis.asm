@@ -0,0 +1,26 @@
+.function: boolean/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    not %1 local %1 local
+    not %1 local %1 local
+    move %0 local %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %4 local
+    frame %1 local
+    izero %1 local
+    move %0 arguments %1 local
+    call %1 local boolean/1
+    frame %1 local
+    integer %2 local 1
+    move %0 arguments %2 local
+    call %2 local boolean/1
+    or %3 local %1 local %2 local
+    print %1 local
+    print %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,8 @@
+.function: main/1
+    allocate_registers %3 local
+    float %1 local 3.14159
+    ftoi %2 local %1 local
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,8 @@
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 4
+    itof %2 local %1 local
+    print %2 local
+    izero %0 local
+    return
+.end
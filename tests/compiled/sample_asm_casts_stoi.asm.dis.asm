@@ -0,0 +1,10 @@
+.function: main/1
+    allocate_registers %4 local
+    string %1 local "42"
+    integer %2 local 27
+    stoi %3 local %1 local
+    add %3 local %2 local %3 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,40 @@
+.function: running_detached/0
+    allocate_registers %9 local
+    izero %1 local
+    integer %2 local 4
+    text %3 local "Hello World! (from long-running detached process) "
+    gte %8 local %1 local %2 local
+    if %8 local 0x98 0x6f
+    text %6 local  %1 local
+    textconcat %7 local %3 local %6 local
+    print %7 local
+    iinc %1 local
+    jump 0x4d
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    frame %0 local
+    process void running_detached/0
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    string %1 local "main/1 exited"
+    print %1 local
+    izero %0 local
+    return
+.end
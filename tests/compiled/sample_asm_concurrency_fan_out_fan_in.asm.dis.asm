@@ -0,0 +1,49 @@
+.function: worker/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    add %0 local %1 local %1 local
+    return
+.end
+
+.function: fan_out/1
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    vector %2 local %0 local %0 local
+    if %1 local 0x4c 0x7f
+    frame %1 local
+    copy %0 arguments %1 local
+    process %3 local worker/1
+    vpush %2 local %3 local
+    idec %1 local
+    jump 0x37
+    move %0 local %2 local
+    return
+.end
+
+.function: fan_in/1
+    allocate_registers %6 local
+    move %1 local %0 parameters
+    izero %2 local
+    vlen %5 local %1 local
+    if %5 local 0xba 0xe8
+    vpop %3 local %1 local void
+    join %4 local %3 local infinity
+    add %2 local %2 local %4 local
+    jump 0x9c
+    move %0 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %1 local
+    integer %1 local 64
+    move %0 arguments %1 local
+    call %1 local fan_out/1
+    frame %1 local
+    move %0 arguments %1 local
+    call %2 local fan_in/1
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,34 @@
+.function: print_lazy/1
+    allocate_registers %2 local
+    nop
+    nop
+    nop
+    nop
+    nop
+    move %1 local %0 parameters
+    print %1 local
+    return
+.end
+
+.function: print_eager/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    frame %1 local
+    string %1 local "Hello concurrent World! (1)"
+    copy %0 arguments %1 local
+    process %2 local print_lazy/1
+    frame %1 local
+    string %3 local "Hello concurrent World! (2)"
+    copy %0 arguments %3 local
+    process %4 local print_eager/1
+    join void %2 local infinity
+    join void %4 local infinity
+    izero %0 local
+    return
+.end
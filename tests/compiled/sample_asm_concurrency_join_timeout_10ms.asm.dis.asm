@@ -0,0 +1,30 @@
+.function: child_process/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    idec %1 local
+    if %1 local 0x28 0x47
+    frame %1 local
+    move %0 arguments %1 local
+    tailcall child_process/1
+    string %0 local "child process done"
+    return
+.end
+
+.function: child_process/0
+    allocate_registers %2 local
+    frame %1 local
+    integer %1 local 65536
+    move %0 arguments %1 local
+    tailcall child_process/1
+    return
+.end
+
+.function: main/0
+    allocate_registers %3 local
+    frame %0 local
+    process %1 local child_process/0
+    join %2 local %1 local 10ms
+    print %2 local
+    izero %0 local
+    return
+.end
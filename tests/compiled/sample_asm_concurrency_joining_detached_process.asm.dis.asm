@@ -0,0 +1,46 @@
+.function: running_detached/1
+    allocate_registers %7 local
+    izero %1 local
+    integer %2 local 4
+    move %3 local %0 parameters
+    self %4 local
+    send %3 local %4 local
+    string %5 local "Hello World! (from long-running detached process) "
+    gte %6 local %1 local %2 local
+    if %6 local 0x9e 0x86
+    echo %5 local
+    print %1 local
+    iinc %1 local
+    jump 0x64
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %1 local
+    self %1 local
+    move %0 arguments %1 local
+    process void running_detached/1
+    receive %1 local infinity
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    join void %1 local infinity
+    string %2 local "main/1 exited"
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,33 @@
+.function: print_lazy/1
+    allocate_registers %2 local
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    move %1 local %0 parameters
+    print %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %1 local
+    string %1 local "Hello concurrent World! (1)"
+    copy %0 arguments %1 local
+    process %2 local print_lazy/1
+    join void %2 local infinity
+    join void %2 local infinity
+    izero %0 local
+    return
+.end
@@ -0,0 +1,22 @@
+.function: run_in_a_process/1
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    self %2 local
+    send %1 local %2 local
+    receive %3 local 10000ms
+    print %3 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %1 local
+    self %1 local
+    move %0 arguments %1 local
+    process void run_in_a_process/1
+    receive %1 local 10000ms
+    string %2 local "Hello message passing World!"
+    send %1 local %2 local
+    izero %0 local
+    return
+.end
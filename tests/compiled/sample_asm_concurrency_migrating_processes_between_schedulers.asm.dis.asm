@@ -0,0 +1,52 @@
+; external function signatures
+.signature: std::misc::cycle/1
+
+.function: print_hello/1
+    allocate_registers %6 local
+    frame %1 local
+    integer %1 local 64
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    text %1 local "Hello "
+    text %2 local "!"
+    move %3 local %0 parameters
+    text %4 local  %3 local
+    textconcat %5 local %1 local %4 local
+    textconcat %5 local %5 local %2 local
+    print %5 local
+    return
+.end
+
+.function: process_spawner/1
+    allocate_registers %2 local
+    frame %1 local
+    move %1 local %0 parameters
+    move %0 arguments %1 local
+    process void print_hello/1
+    return
+.end
+
+.function: spawn_processes/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    if %1 local 0xc9 0x111
+    frame %1 local
+    copy %0 arguments %1 local
+    call void process_spawner/1
+    idec %1 local
+    frame %1 local
+    move %0 arguments %1 local
+    tailcall spawn_processes/1
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    import std::misc
+    integer %1 local 64
+    frame %1 local
+    move %0 arguments %1 local
+    call void spawn_processes/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,10 @@
+.function: main/0
+    allocate_registers %3 local
+    self %1 local
+    string %2 local "Hello World (from self)!"
+    send %1 local %2 local
+    receive %2 local infinity
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,12 @@
+; external function signatures
+.signature: test_module::test_function/0
+
+.function: main/0
+    allocate_registers %2 local
+    import test_module
+    frame %0 local
+    process %1 local test_module::test_function/0
+    join void %1 local infinity
+    izero %0 local
+    return
+.end
@@ -0,0 +1,6 @@
+.function: main/0
+    allocate_registers %1 local
+    receive void 1000ms
+    izero %0 local
+    return
+.end
@@ -0,0 +1,42 @@
+.block: pull_and_do_nothing
+    draw %3 local
+    leave
+.end
+
+.block: await_message
+    idec %1 local
+    receive %3 local 100ms
+    leave
+.end
+
+.function: message_sender/2
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    try
+    catch "Exception" pull_and_do_nothing
+    enter await_message
+    if %1 local 0x8e 0x71
+    string %3 local "Hello World!"
+    send %2 local %3 local
+    return
+    frame %2 local
+    move %0 arguments %1 local
+    move %1 arguments %2 local
+    tailcall message_sender/2
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %2 local
+    integer %1 local 5
+    move %0 arguments %1 local
+    self %1 local
+    move %1 arguments %1 local
+    process void message_sender/2
+    receive %1 local infinity
+    print %1 local
+    izero %0 local
+    return
+.end
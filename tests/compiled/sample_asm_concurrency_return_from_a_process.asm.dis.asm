@@ -0,0 +1,15 @@
+.function: run_in_a_process/0
+    allocate_registers %1 local
+    integer %0 local 42
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %0 local
+    process %1 local run_in_a_process/0
+    join %2 local %1 local infinity
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,35 @@
+.block: try_process_exception
+    join void %1 local infinity
+    leave
+.end
+
+.block: handle_process_exception
+    string %3 local "exception transferred from process "
+    echo %3 local
+    echo %1 local
+    string %3 local ": "
+    echo %3 local
+    draw %3 local
+    print %3 local
+    leave
+.end
+
+.function: run_in_a_process/0
+    allocate_registers %2 local
+    receive %1 local infinity
+    throw %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %4 local
+    frame %0 local
+    process %1 local run_in_a_process/0
+    string %2 local "Hello exception transferring World!"
+    send %1 local %2 local
+    try
+    catch "String" handle_process_exception
+    enter try_process_exception
+    izero %0 local
+    return
+.end
@@ -0,0 +1,30 @@
+.function: bar/0
+    allocate_registers %0 local
+    return
+.end
+
+.function: print_this_pointer/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print *1 local
+    return
+.end
+
+.function: foo/0
+    allocate_registers %3 local
+    text %1 local "Hello World!"
+    ptr %2 local %1 local
+    frame %1 local
+    move %0 arguments %2 local
+    defer print_this_pointer/1
+    frame %0 local
+    tailcall bar/0
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,46 @@
+.block: main/0__nested__catch_Integer
+    draw %2 local
+    print %2 local
+    leave
+.end
+
+.block: main/0__nested__try_this
+    frame %0 local
+    call void unfortunate/0
+    leave
+.end
+
+.function: print_me/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print *1 local
+    return
+.end
+
+.function: throwing/0
+    allocate_registers %2 local
+    integer %1 local 666
+    throw %1 local
+    return
+.end
+
+.function: unfortunate/0
+    allocate_registers %3 local
+    text %1 local "Hello World before stack unwinding!"
+    frame %1 local
+    ptr %2 local %1 local
+    move %0 arguments %2 local
+    defer print_me/1
+    frame %0 local
+    call void throwing/0
+    return
+.end
+
+.function: main/0
+    allocate_registers %3 local
+    try
+    catch "Integer" main/0__nested__catch_Integer
+    enter main/0__nested__try_this
+    izero %0 local
+    return
+.end
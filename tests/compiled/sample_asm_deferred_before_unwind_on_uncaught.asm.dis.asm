@@ -0,0 +1,33 @@
+.function: print_me/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print *1 local
+    return
+.end
+
+.function: throwing/0
+    allocate_registers %2 local
+    integer %1 local 666
+    throw %1 local
+    return
+.end
+
+.function: unfortunate/0
+    allocate_registers %3 local
+    text %1 local "Hello World before stack unwinding!"
+    frame %1 local
+    ptr %2 local %1 local
+    move %0 arguments %2 local
+    defer print_me/1
+    frame %0 local
+    call void throwing/0
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void unfortunate/0
+    izero %0 local
+    return
+.end
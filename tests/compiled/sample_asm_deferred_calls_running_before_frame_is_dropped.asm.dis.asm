@@ -0,0 +1,17 @@
+.function: print_me/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print *1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %3 local
+    text %1 local "Hello World!"
+    ptr %2 local %1 local
+    frame %1 local
+    move %0 arguments %2 local
+    defer print_me/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,112 @@
+.function: by_quux/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_quux/0"
+    print %1 local
+    return
+.end
+
+.function: quux/0
+    allocate_registers %2 local
+    frame %0 local
+    defer by_quux/0
+    integer %1 local 666
+    throw %1 local
+    return
+.end
+
+.function: by_bax/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_bax/0"
+    print %1 local
+    return
+.end
+
+.function: bax/0
+    allocate_registers %0 local
+    frame %0 local
+    defer by_bax/0
+    frame %0 local
+    call void quux/0
+    return
+.end
+
+.function: by_bay/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_bay/0"
+    print %1 local
+    return
+.end
+
+.function: bay/0
+    allocate_registers %0 local
+    frame %0 local
+    defer by_bay/0
+    frame %0 local
+    call void bax/0
+    return
+.end
+
+.function: by_baz/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_baz/0"
+    print %1 local
+    return
+.end
+
+.function: baz/0
+    allocate_registers %0 local
+    frame %0 local
+    defer by_baz/0
+    frame %0 local
+    call void bay/0
+    return
+.end
+
+.function: by_bar/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_bar/0"
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %0 local
+    frame %0 local
+    defer by_bar/0
+    frame %0 local
+    call void baz/0
+    return
+.end
+
+.function: by_foo/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_foo/0"
+    print %1 local
+    return
+.end
+
+.function: foo/0
+    allocate_registers %0 local
+    frame %0 local
+    defer by_foo/0
+    frame %0 local
+    call void bar/0
+    return
+.end
+
+.function: by_main/0
+    allocate_registers %2 local
+    text %1 local "Hello from by_main/0"
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    defer by_main/0
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
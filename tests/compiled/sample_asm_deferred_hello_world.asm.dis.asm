@@ -0,0 +1,14 @@
+.function: hello_world/0
+    allocate_registers %2 local
+    text %1 local "Hello World!"
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    defer hello_world/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,41 @@
+.function: foo/0
+    allocate_registers %2 local
+    text %1 local "foo"
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    frame %0 local
+    defer baz/0
+    text %1 local "bar"
+    print %1 local
+    return
+.end
+
+.function: baz/0
+    allocate_registers %2 local
+    frame %0 local
+    defer bay/0
+    text %1 local "baz"
+    print %1 local
+    return
+.end
+
+.function: bay/0
+    allocate_registers %2 local
+    text %1 local "bay"
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    defer foo/0
+    frame %0 local
+    defer bar/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,25 @@
+.function: foo/0
+    allocate_registers %2 local
+    text %1 local "Hello deferred Foo!"
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    text %1 local "Hello deferred Bar!"
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %0 local
+    defer bar/0
+    frame %0 local
+    defer foo/0
+    integer %1 local 42
+    throw %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,23 @@
+.function: foo/0
+    allocate_registers %2 local
+    text %1 local "foo"
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    text %1 local "bar"
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    defer foo/0
+    frame %0 local
+    defer bar/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,29 @@
+.function: deferred/0
+    allocate_registers %2 local
+    text %1 local "Hello from deferred!"
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    integer %1 local 42
+    print %1 local
+    return
+.end
+
+.function: foo/0
+    allocate_registers %0 local
+    frame %0 local
+    defer deferred/0
+    frame %0 local
+    tailcall bar/0
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,6 @@
+.function: main/0
+    allocate_registers %2 local
+    throw %1 local
+    izero %0 local
+    return
+.end
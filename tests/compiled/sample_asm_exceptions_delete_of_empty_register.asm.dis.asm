@@ -0,0 +1,6 @@
+.function: main/0
+    allocate_registers %2 local
+    delete %1 static
+    izero %0 local
+    return
+.end
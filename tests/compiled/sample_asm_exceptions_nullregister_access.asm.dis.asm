@@ -0,0 +1,21 @@
+.block: main/1__nested__exception_handler
+    string %1 local "exception encountered: "
+    echo %1 local
+    draw %2 local
+    print %2 local
+    leave
+.end
+
+.block: main/1__nested__print_block
+    print %1 local
+    leave
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    try
+    catch "Exception" main/1__nested__exception_handler
+    enter main/1__nested__print_block
+    izero %0 local
+    return
+.end
@@ -0,0 +1,78 @@
+; external function signatures
+.signature: std::misc::cycle/1
+
+.function: will_be_terminated/0
+    allocate_registers %2 local
+    frame %1 local
+    integer %1 local 512
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    integer %1 local 42
+    throw %1 local
+    return
+.end
+
+.function: cycle_burner/2
+    allocate_registers %3 local
+    frame %1 local
+    move %1 local %1 parameters
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    text %1 local "Hello World from process "
+    move %2 local %0 parameters
+    text %2 local  %2 local
+    textconcat %1 local %1 local %2 local
+    print %1 local
+    return
+.end
+
+.function: spawn_process/1
+    allocate_registers %3 local
+    isnull %2 local %1 static
+    if %2 local 0xdb 0xe5
+    integer %1 static -1
+    iinc %1 static
+    frame %2 local
+    copy %0 arguments %1 static
+    move %1 local %0 parameters
+    copy %1 arguments %1 local
+    process void cycle_burner/2
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    import std::misc
+    frame %0 local
+    process void will_be_terminated/0
+    frame %1 local
+    integer %1 local 1000
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 100
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 400
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 600
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 128
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 64
+    move %0 arguments %1 local
+    call void spawn_process/1
+    frame %1 local
+    integer %1 local 312
+    move %0 arguments %1 local
+    call void spawn_process/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,32 @@
+; external function signatures
+.signature: test_module::test_fun/0
+
+.block: try_calling
+    frame %0 local
+    call void test_module::test_fun/0
+    leave
+.end
+
+.block: handle_Integer
+    draw %1 local
+    string %2 local "looks "
+    echo %2 local
+    if %1 local 0x59 0x4c
+    string %2 local "truthy"
+    string %2 local "falsey"
+    echo %2 local
+    string %2 local ": "
+    echo %2 local
+    print %1 local
+    leave
+.end
+
+.function: main/0
+    allocate_registers %3 local
+    import test_module
+    try
+    catch "Integer" handle_Integer
+    enter try_calling
+    izero %0 local
+    return
+.end
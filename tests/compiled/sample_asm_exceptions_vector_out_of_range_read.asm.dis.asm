@@ -0,0 +1,11 @@
+.function: main/1
+    allocate_registers %5 local
+    vector %1 local %0 local %0 local
+    integer %3 local 42
+    vpush %1 local %3 local
+    integer %4 local 4
+    vat %2 local %1 local %4 local
+    print *2 local
+    izero %0 local
+    return
+.end
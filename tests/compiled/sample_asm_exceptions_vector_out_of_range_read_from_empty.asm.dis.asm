@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %3 local
+    vector %1 local %0 local %0 local
+    izero %0 local
+    vat %2 local %1 local %0 local
+    print *2 local
+    izero %0 local
+    return
+.end
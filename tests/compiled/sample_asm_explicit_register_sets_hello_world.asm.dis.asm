@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %2 local
+    string %1 local "Hello local World!"
+    string %1 static "Hello static World!"
+    string %1 global "Hello global World!"
+    print %1 local
+    print %1 static
+    print %1 global
+    izero %0 local
+    return
+.end
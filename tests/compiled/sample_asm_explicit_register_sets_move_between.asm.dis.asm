@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %2 local
+    string %1 local "Hello World!"
+    print %1 local
+    move %2 static %1 local
+    print %2 static
+    move %3 global %2 static
+    print %3 global
+    izero %0 local
+    return
+.end
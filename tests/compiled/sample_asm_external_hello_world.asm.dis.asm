@@ -0,0 +1,11 @@
+; external function signatures
+.signature: World::print_hello/0
+
+.function: main/1
+    allocate_registers %1 local
+    import World
+    frame %0 local
+    call void World::print_hello/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,75 @@
+; external function signatures
+.signature: printer::print/1
+
+.function: printer_wrapper/1
+    allocate_registers %2 local
+    frame %1 local
+    move %1 local %0 parameters
+    move %0 arguments %1 local
+    call void printer::print/1
+    return
+.end
+
+.function: process_spawner/1
+    allocate_registers %2 local
+    frame %1 local
+    move %1 local %0 parameters
+    move %0 arguments %1 local
+    process void printer_wrapper/1
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    import printer
+    frame %1 local
+    text %1 local "Joe"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Robert"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Mike"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Bjarne"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Guido"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Dennis"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Bram"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Herb"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Anthony"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Alan"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Ada"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    frame %1 local
+    text %1 local "Charles"
+    move %0 arguments %1 local
+    call void process_spawner/1
+    izero %0 local
+    return
+.end
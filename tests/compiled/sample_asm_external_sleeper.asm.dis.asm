@@ -0,0 +1,155 @@
+; external function signatures
+.signature: printer::print/1
+.signature: printer::format/1
+.signature: sleeper::lazy_print/0
+
+.block: main/0__nested__catch_0
+    draw %5 local
+    delete %5 local
+    leave
+.end
+
+.block: main/0__nested__enter_0
+    io_wait void %4 local 10ms
+    leave
+.end
+
+.function: printer/0
+    allocate_registers %4 local
+    receive %1 local infinity
+    atom %2 local 'has_value'
+    structat %3 local %1 local %2 local
+    if *3 local 0x57 0xa0
+    atom %2 local 'value'
+    structat %3 local %1 local %2 local
+    frame %1 local
+    copy %0 arguments *3 local
+    call void printer::print/1
+    frame %0 local
+    tailcall printer/0
+    return
+.end
+
+.function: printer_wrapper/2
+    allocate_registers %6 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    struct %3 local
+    atom %4 local 'has_value'
+    izero %5 local
+    not %5 local %5 local
+    structinsert %3 local %4 local %5 local
+    atom %4 local 'value'
+    structinsert %3 local %4 local %1 local
+    send %2 local %3 local
+    return
+.end
+
+.function: process_spawner/2
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    frame %2 local
+    move %0 arguments %1 local
+    move %1 arguments %2 local
+    process void printer_wrapper/2
+    return
+.end
+
+.function: lazy_print_process/0
+    allocate_registers %1 local
+    frame %0 local
+    call void sleeper::lazy_print/0
+    return
+.end
+
+.function: lazy_print_spawner/0
+    allocate_registers %1 local
+    frame %0 local
+    process void lazy_print_process/0
+    return
+.end
+
+.function: main/0
+    allocate_registers %6 local
+    import printer
+    import sleeper
+    frame %0 local
+    call void lazy_print_spawner/0
+    frame %0 local
+    process %2 local printer/0
+    frame %2 local
+    text %1 local "Joe"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Robert"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Mike"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Bjarne"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Guido"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Dennis"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Bram"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Anthony"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Alan"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Ada"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    frame %2 local
+    text %1 local "Charles"
+    move %0 arguments %1 local
+    copy %1 arguments %2 local
+    call void process_spawner/2
+    integer %3 local 0
+    integer %5 local 42
+    io_read %4 local %3 local %5 local
+    try
+    catch "Exception" main/0__nested__catch_0
+    enter main/0__nested__enter_0
+    io_cancel %4 local
+    delete %4 local
+    delete %3 local
+    struct %3 local
+    atom %4 local 'has_value'
+    izero %5 local
+    not %5 local %5 local
+    not %5 local %5 local
+    structinsert %3 local %4 local %5 local
+    send %2 local %3 local
+    join void %2 local infinity
+    izero %0 local
+    return
+.end
@@ -0,0 +1,14 @@
+; external function signatures
+.signature: math::sqrt/1
+
+.function: main/1
+    allocate_registers %3 local
+    import math
+    frame %1 local
+    float %1 local 3
+    copy %0 arguments %1 local
+    call %2 local math::sqrt/1
+    print %2 local
+    izero %0 local
+    return
+.end
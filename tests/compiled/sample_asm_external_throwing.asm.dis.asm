@@ -0,0 +1,35 @@
+; external function signatures
+.signature: throwing::oh_noes/0
+
+.block: __try
+    frame %0 local
+    call void throwing::oh_noes/0
+    leave
+.end
+
+.block: __catch_Exception
+    draw %1 local
+    print %1 local
+    leave
+.end
+
+.function: watchdog_process/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    atom %2 local 'exception'
+    structremove %2 local %1 local %2 local
+    print %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    frame %1 local
+    watchdog watchdog_process/1
+    import throwing
+    try
+    catch "ExceptionX" __catch_Exception
+    enter __try
+    izero %0 local
+    return
+.end
@@ -0,0 +1,29 @@
+.function: factorial/2
+    allocate_registers %5 local
+    move %2 local %1 parameters
+    move %1 local %0 parameters
+    mul %2 local %2 local %1 local
+    idec %1 local
+    integer %3 local 0
+    eq %4 local %1 local %3 local
+    if %4 local 0x7d 0x55
+    frame %2 local
+    copy %0 arguments %1 local
+    copy %1 arguments %2 local
+    call %2 local factorial/2
+    move %0 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 8
+    integer %2 local 1
+    frame %2 local
+    copy %0 arguments %1 local
+    copy %1 arguments %2 local
+    call %2 local factorial/2
+    print %2 local
+    izero %0 local
+    return
+.end
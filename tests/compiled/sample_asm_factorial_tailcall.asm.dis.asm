@@ -0,0 +1,28 @@
+.function: factorial/2
+    allocate_registers %4 local
+    move %0 local %1 parameters
+    move %1 local %0 parameters
+    mul %0 local %0 local %1 local
+    idec %1 local
+    integer %2 local 0
+    eq %3 local %1 local %2 local
+    if %3 local 0x79 0x55
+    frame %2 local
+    move %0 arguments %1 local
+    move %1 arguments %0 local
+    tailcall factorial/2
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 8
+    frame %2 local
+    copy %0 arguments %1 local
+    integer %2 local 1
+    move %1 arguments %2 local
+    call %2 local factorial/2
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/1
+    allocate_registers %5 local
+    float %1 local 4
+    float %2 local -3.5
+    add %3 local %1 local %2 local
+    float %4 local 0
+    add %3 local %3 local %4 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %4 local
+    float %1 local 3.14
+    float %2 local 2
+    div %3 local %1 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
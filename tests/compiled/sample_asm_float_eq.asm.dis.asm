@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %3 local
+    float %1 local 0.69
+    float %2 local 0.69
+    eq %1 local %1 local %2 local
+    print %1 local
+    izero %0 local
+    return
+.end
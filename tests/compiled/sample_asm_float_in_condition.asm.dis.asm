@@ -0,0 +1,12 @@
+.function: main/1
+    allocate_registers %4 local
+    float %1 local 0.0001
+    integer %2 local 0
+    integer %3 local 1
+    eq %2 local %2 local %3 local
+    if %1 local 0x48 0x51
+    not %2 local %2 local
+    print %2 local
+    izero %0 local
+    return
+.end
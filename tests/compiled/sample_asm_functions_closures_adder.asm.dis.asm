@@ -0,0 +1,39 @@
+.function: make_adder/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    closure %2 local adder/1
+    capture %2 local %1  %1 local
+    move %0 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    frame %1 local
+    integer %1 local 3
+    copy %0 arguments %1 local
+    call %2 local make_adder/1
+    frame %1 local
+    integer %3 local 2
+    copy %0 arguments %3 local
+    call %4 local  %2 local
+    print %4 local
+    frame %1 local
+    integer %3 local 5
+    copy %0 arguments %3 local
+    call %4 local  %2 local
+    print %4 local
+    frame %1 local
+    integer %3 local 13
+    copy %0 arguments %3 local
+    call %4 local  %2 local
+    print %4 local
+    izero %0 local
+    return
+.end
+
+.function: adder/1
+    move %2 local %0 parameters
+    add %0 local %2 local %1 local
+    return
+.end
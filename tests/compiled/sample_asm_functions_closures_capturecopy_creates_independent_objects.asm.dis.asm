@@ -0,0 +1,20 @@
+.function: main/1
+    allocate_registers %3 local
+    string %1 local "Hello World!"
+    closure %2 local a_closure/0
+    capturecopy %2 local @1  %1 local
+    print %1 local
+    frame %0 local
+    call void  %2 local
+    integer %1 local 42
+    print %1 local
+    frame %0 local
+    call void  %2 local
+    izero %0 local
+    return
+.end
+
+.function: a_closure/0
+    print %1 local
+    return
+.end
@@ -0,0 +1,18 @@
+.function: main/1
+    allocate_registers %3 local
+    closure %2 local printer_function/0
+    string %1 local "Hello World!"
+    capture %2 local %1  %1 local
+    frame %0 local
+    call void  %2 local
+    integer %1 local 42
+    frame %0 local
+    call void  %2 local
+    izero %0 local
+    return
+.end
+
+.function: printer_function/0
+    print %1 local
+    return
+.end
@@ -0,0 +1,17 @@
+.function: main/1
+    allocate_registers %3 local
+    closure %2 local variable_changing_function/0
+    string %1 local "Hello World!"
+    capture %2 local %1  %1 local
+    print %1 local
+    frame %0 local
+    call void  %2 local
+    print %1 local
+    izero %0 local
+    return
+.end
+
+.function: variable_changing_function/0
+    integer %1 local 42
+    return
+.end
@@ -0,0 +1,56 @@
+.function: closure_maker/1
+    allocate_registers %6 local
+    closure %0 local closure_level_1/1
+    move %1 local %0 parameters
+    capture %0 local %1  %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %6 local
+    frame %1 local
+    integer %1 local 1
+    copy %0 arguments %1 local
+    call %2 local closure_maker/1
+    frame %1 local
+    integer %1 local 2
+    copy %0 arguments %1 local
+    call %3 local  %2 local
+    frame %1 local
+    integer %1 local 3
+    copy %0 arguments %1 local
+    call %4 local  %3 local
+    frame %1 local
+    integer %1 local 4
+    copy %0 arguments %1 local
+    call %5 local  %4 local
+    print %5 local
+    izero %0 local
+    return
+.end
+
+.function: closure_level_3/1
+    move %4 local %0 parameters
+    add %5 local %1 local %2 local
+    add %5 local %3 local %5 local
+    add %5 local %4 local %5 local
+    move %0 local %5 local
+    return
+.end
+
+.function: closure_level_2/1
+    closure %0 local closure_level_3/1
+    capture %0 local %1  %1 local
+    capture %0 local %2  %2 local
+    move %3 local %0 parameters
+    capture %0 local %3  %3 local
+    return
+.end
+
+.function: closure_level_1/1
+    closure %0 local closure_level_2/1
+    capture %0 local %1  %1 local
+    move %2 local %0 parameters
+    capture %0 local %2  %2 local
+    return
+.end
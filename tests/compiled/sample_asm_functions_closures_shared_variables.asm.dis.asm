@@ -0,0 +1,44 @@
+.function: returns_closures/0
+    allocate_registers %5 local
+    vector %1 local %0 local %0 local
+    integer %2 local 42
+    closure %3 local closure_printer/0
+    capture %3 local %2  %2 local
+    closure %4 local closure_setter/1
+    capture %4 local %2  %2 local
+    vpush %1 local %3 local
+    vpush %1 local %4 local
+    move %0 local %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %6 local
+    frame %0 local
+    call %1 local returns_closures/0
+    frame %0 local
+    izero %3 local
+    vat %2 local %1 local %3 local
+    call void  *2 local
+    frame %1 local
+    integer %0 local 69
+    copy %0 arguments %0 local
+    integer %5 local 1
+    vat %4 local %1 local %5 local
+    call void  *4 local
+    frame %0 local
+    call void  *2 local
+    izero %0 local
+    return
+.end
+
+.function: closure_printer/0
+    print %2 local
+    return
+.end
+
+.function: closure_setter/1
+    move %1 local %0 parameters
+    copy %2 local %1 local
+    return
+.end
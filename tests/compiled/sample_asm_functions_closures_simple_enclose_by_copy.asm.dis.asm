@@ -0,0 +1,23 @@
+.function: returns_closure/0
+    allocate_registers %3 local
+    closure %2 local foo/0
+    integer %1 local 42
+    capturecopy %2 local @1  %1 local
+    move %0 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    frame %0 local
+    call %1 local returns_closure/0
+    frame %0 local
+    call void  %1 local
+    izero %0 local
+    return
+.end
+
+.function: foo/0
+    print %1 local
+    return
+.end
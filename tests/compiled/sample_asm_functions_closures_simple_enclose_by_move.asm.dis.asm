@@ -0,0 +1,17 @@
+.function: main/1
+    allocate_registers %4 local
+    closure %1 local a_closure/0
+    string %2 local "Hello World!"
+    capturemove %1 local @1  %2 local
+    isnull %3 local %2 local
+    print %3 local
+    frame %0 local
+    call void  %1 local
+    izero %0 local
+    return
+.end
+
+.function: a_closure/0
+    print %1 local
+    return
+.end
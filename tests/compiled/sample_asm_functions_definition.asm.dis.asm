@@ -0,0 +1,7 @@
+.function: main/1
+    allocate_registers %2 local
+    integer %1 local 42
+    print %1 local
+    izero %0 local
+    return
+.end
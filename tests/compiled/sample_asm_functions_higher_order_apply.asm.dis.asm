@@ -0,0 +1,30 @@
+.function: square/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    mul %0 local %1 local %1 local
+    return
+.end
+
+.function: apply/2
+    allocate_registers %4 local
+    frame %1 local
+    move %2 local %1 parameters
+    move %0 arguments %2 local
+    move %1 local %0 parameters
+    call %3 local  %1 local
+    move %0 local %3 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 5
+    function %2 local square/1
+    frame %2 local
+    copy %0 arguments %2 local
+    copy %1 arguments %1 local
+    call %3 local apply/2
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,57 @@
+.function: is_divisible_by_2/1
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    integer %2 local 2
+    lt %3 local %1 local %2 local
+    if %3 local 0x50 0x3a
+    sub %1 local %1 local %2 local
+    jump 0x18
+    move %0 local %1 local
+    not %0 local %0 local
+    return
+.end
+
+.function: filter/2
+    allocate_registers %9 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    vector %3 local %0 local %0 local
+    izero %4 local
+    vlen %5 local %2 local
+    gte %6 local %4 local %5 local
+    if %6 local 0x107 0xb7
+    frame %1 local
+    vat %7 local %2 local %4 local
+    copy %0 arguments *7 local
+    call %8 local  %1 local
+    if %8 local 0xf0 0xf9
+    vpush %3 local *7 local
+    iinc %4 local
+    jump 0x95
+    move %0 local %3 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    vector %1 local %0 local %0 local
+    integer %2 local 1
+    vpush %1 local %2 local
+    integer %2 local 2
+    vpush %1 local %2 local
+    integer %2 local 3
+    vpush %1 local %2 local
+    integer %2 local 4
+    vpush %1 local %2 local
+    integer %2 local 5
+    vpush %1 local %2 local
+    print %1 local
+    frame %2 local
+    function %3 local is_divisible_by_2/1
+    copy %0 arguments %3 local
+    copy %1 arguments %1 local
+    call %4 local filter/2
+    print %4 local
+    izero %0 local
+    return
+.end
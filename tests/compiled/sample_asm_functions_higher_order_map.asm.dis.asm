@@ -0,0 +1,61 @@
+.function: square/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    mul %0 local %1 local %1 local
+    return
+.end
+
+.function: apply/2
+    allocate_registers %4 local
+    frame %1 local
+    move %2 local %1 parameters
+    copy %0 arguments %2 local
+    move %1 local %0 parameters
+    call %3 local  %1 local
+    move %0 local %3 local
+    return
+.end
+
+.function: map/2
+    allocate_registers %9 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    vector %3 local %0 local %0 local
+    izero %4 local
+    vlen %5 local %2 local
+    gte %6 local %4 local %5 local
+    if %6 local 0xe3 0xa8
+    frame %1 local
+    vat %7 local %2 local %4 local
+    copy %0 arguments *7 local
+    call %8 local  %1 local
+    vpush %3 local %8 local
+    iinc %4 local
+    jump 0x86
+    move %0 local %3 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    vector %1 local %0 local %0 local
+    integer %2 local 1
+    vpush %1 local %2 local
+    integer %2 local 2
+    vpush %1 local %2 local
+    integer %2 local 3
+    vpush %1 local %2 local
+    integer %2 local 4
+    vpush %1 local %2 local
+    integer %2 local 5
+    vpush %1 local %2 local
+    print %1 local
+    frame %2 local
+    function %3 local square/1
+    copy %0 arguments %3 local
+    copy %1 arguments %1 local
+    call %4 local map/2
+    print %4 local
+    izero %0 local
+    return
+.end
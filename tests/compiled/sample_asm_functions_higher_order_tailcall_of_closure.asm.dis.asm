@@ -0,0 +1,21 @@
+.function: test/0
+    allocate_registers %3 local
+    integer %2 local 42
+    closure %1 local closure/0
+    capturemove %1 local @1  %2 local
+    frame %0 local
+    tailcall  %1 local
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void test/0
+    izero %0 local
+    return
+.end
+
+.function: closure/0
+    throw %1 local
+    return
+.end
@@ -0,0 +1,21 @@
+.function: foo/0
+    allocate_registers %2 local
+    function %1 local bar/0
+    frame %0 local
+    tailcall  %1 local
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    integer %1 local 42
+    throw %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,16 @@
+.function: set_666/0
+    allocate_registers %0 local
+    integer %2 global 666
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    integer %2 local 42
+    frame %0 local
+    call void set_666/0
+    print %2 local
+    print %2 global
+    izero %0 local
+    return
+.end
@@ -0,0 +1,41 @@
+.function: foo/0
+    allocate_registers %2 local
+    integer %1 local 42
+    print %1 local
+    return
+.end
+
+.function: bar/0
+    allocate_registers %2 local
+    integer %1 local 69
+    print %1 local
+    frame %0 local
+    call void foo/0
+    return
+.end
+
+.function: baz/0
+    allocate_registers %2 local
+    integer %1 local 1995
+    print %1 local
+    frame %0 local
+    call void bar/0
+    return
+.end
+
+.function: bay/0
+    allocate_registers %2 local
+    integer %1 local 2015
+    print %1 local
+    frame %0 local
+    call void baz/0
+    return
+.end
+
+.function: main/1
+    allocate_registers %1 local
+    frame %0 local
+    call void bay/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,19 @@
+.function: foo/1
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print %1 local
+    move %0 local %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    integer %1 local 42
+    print %1 local
+    frame %1 local
+    move %0 arguments %1 local
+    call %1 local foo/1
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,26 @@
+.function: recursive/2
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    idec %1 local
+    lt %3 local %1 local %2 local
+    if %3 local 0x68 0x3e
+    print %1 local
+    frame %2 local
+    move %0 arguments %1 local
+    move %1 arguments %2 local
+    call void recursive/2
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %2 local
+    integer %1 local 10
+    copy %0 arguments %1 local
+    integer %2 local 0
+    move %1 arguments %2 local
+    call void recursive/2
+    izero %0 local
+    return
+.end
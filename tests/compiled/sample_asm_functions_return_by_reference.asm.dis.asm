@@ -0,0 +1,17 @@
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 69
+    closure %2 local by_reference/0
+    capture %2 local %1  %1 local
+    frame %0 local
+    call %3 local  %2 local
+    integer %3 local 42
+    print %1 local
+    izero %0 local
+    return
+.end
+
+.function: by_reference/0
+    move %0 local %1 local
+    return
+.end
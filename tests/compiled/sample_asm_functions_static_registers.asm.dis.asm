@@ -0,0 +1,30 @@
+.function: counter/1
+    allocate_registers %5 local
+    isnull %2 local %1 static
+    not %2 local %2 local
+    if %2 local 0x52 0x2c
+    integer %1 static 0
+    integer %1 local 0
+    move %3 local %0 parameters
+    jump 0x8b
+    iinc %1 static
+    move %3 local %0 parameters
+    lt %4 local %1 static %3 local
+    not %4 local %4 local
+    if %4 local 0xa9 0x8b
+    print %1 static
+    frame %1 local
+    copy %0 arguments %3 local
+    tailcall counter/1
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    frame %1 local
+    integer %1 local 10
+    copy %0 arguments %1 local
+    call void counter/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/1
+    allocate_registers %5 local
+    integer %1 local 4
+    integer %2 local -3
+    add %3 local %1 local %2 local
+    integer %4 local 0
+    add %3 local %3 local %4 local
+    print %3 local
+    izero %0 local
+    return
+.end
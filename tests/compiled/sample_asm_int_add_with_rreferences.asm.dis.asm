@@ -0,0 +1,10 @@
+.function: main/1
+    allocate_registers %5 local
+    integer %1 local -1
+    integer %2 local 1
+    integer %3 local 2
+    add %4 local %1 local @3 local
+    print %4 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,19 @@
+.function: main/0
+    allocate_registers %6 local
+    integer %1 local 0
+    integer %2 local 10
+    ptr %3 local %1 local
+    gte %4 local %1 local %2 local
+    if %4 local 0x52 0x44
+    iinc *3 local
+    jump 0x22
+    print %1 local
+    ptrlive %5 local %3 local
+    print %5 local
+    add %1 local %1 local %2 local
+    print %1 local
+    ptrlive %5 local %3 local
+    print %5 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,8 @@
+.function: main/1
+    allocate_registers %2 local
+    integer %1 local 2
+    idec %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
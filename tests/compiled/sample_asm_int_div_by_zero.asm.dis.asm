@@ -0,0 +1,8 @@
+.function: main/0
+    allocate_registers %3 local
+    integer %1 local 1
+    integer %2 local 0
+    div %1 local %1 local %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 4
+    integer %2 local 1
+    gt %1 local %1 local %2 local
+    print %1 local
+    izero %0 local
+    return
+.end
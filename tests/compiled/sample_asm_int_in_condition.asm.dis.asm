@@ -0,0 +1,12 @@
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 1
+    integer %2 local 0
+    integer %3 local 1
+    eq %2 local %2 local %3 local
+    if %1 local 0x45 0x4e
+    not %2 local %2 local
+    print %2 local
+    izero %0 local
+    return
+.end
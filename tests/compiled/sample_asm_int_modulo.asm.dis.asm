@@ -0,0 +1,14 @@
+.function: main/1
+    allocate_registers %5 local
+    integer %1 local 166737
+    integer %2 local 176
+    copy %3 local %1 local
+    lt %4 local %1 local %2 local
+    if %4 local 0x6b 0x44
+    div %1 local %1 local %2 local
+    mul %1 local %1 local %2 local
+    sub %3 local %3 local %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
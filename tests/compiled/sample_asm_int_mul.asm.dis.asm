@@ -0,0 +1,11 @@
+.function: main/1
+    allocate_registers %5 local
+    integer %1 local 4
+    integer %2 local 4
+    integer %3 local -15
+    mul %4 local %1 local %2 local
+    add %3 local %4 local %3 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 1
+    string %2 local "Oh, look, a bug"
+    add %3 local %1 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
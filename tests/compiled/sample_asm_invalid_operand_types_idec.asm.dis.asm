@@ -0,0 +1,7 @@
+.function: main/1
+    allocate_registers %2 local
+    function %1 local main/1
+    idec %1 local
+    izero %0 local
+    return
+.end
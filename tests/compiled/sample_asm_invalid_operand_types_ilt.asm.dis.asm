@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %4 local
+    string %1 local "Hello"
+    string %2 local "World!"
+    lt %3 local %2 local %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
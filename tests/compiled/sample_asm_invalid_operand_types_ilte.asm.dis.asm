@@ -0,0 +1,9 @@
+.function: main/1
+    allocate_registers %4 local
+    text %1 local "Hello World!"
+    integer %2 local 42
+    lte %3 local %2 local %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,34 @@
+.function: iterfib/1
+    allocate_registers %12 local
+    integer %2 local -1
+    integer %3 local -2
+    vector %1 local %0 local %0 local
+    integer %4 local 1
+    vpush %1 local %4 local
+    integer %4 local 1
+    vpush %1 local %4 local
+    move %5 local %0 parameters
+    vlen %6 local %1 local
+    lt %8 local %6 local %5 local
+    not %8 local %8 local
+    if %8 local 0xc2 0x89
+    vat %9 local %1 local %2 local
+    vat %10 local %1 local %3 local
+    add %7 local *9 local *10 local
+    vpush %1 local %7 local
+    jump 0x55
+    vat %11 local %1 local %2 local
+    copy %0 local *11 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %1 local
+    integer %1 local 45
+    copy %0 arguments %1 local
+    call %2 local iterfib/1
+    print %2 local
+    izero %0 local
+    return
+.end
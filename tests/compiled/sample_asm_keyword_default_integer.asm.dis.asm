@@ -0,0 +1,7 @@
+.function: main/0
+    allocate_registers %2 local
+    integer %1 local 0
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,20 @@
+.function: sample/2
+    allocate_registers %2 local
+    move %1 local %0 parameters
+    print %1 local
+    move %1 local %1 parameters
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %2 local
+    string %1 local "Hello World!"
+    move %0 arguments %1 local
+    integer %1 local 42
+    move %1 arguments %1 local
+    call void sample/2
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %3 local
+    string %1 local "Hello World!"
+    integer %2 local 42
+    print %1 local
+    print %2 local
+    izero %0 local
+    return
+.end
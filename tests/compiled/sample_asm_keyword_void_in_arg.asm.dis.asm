@@ -0,0 +1,15 @@
+.function: foo/1
+    allocate_registers %1 local
+    move void %0 parameters
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %1 local
+    izero %1 local
+    move %0 arguments %1 local
+    call void foo/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,12 @@
+.function: foo/0
+    allocate_registers %0 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
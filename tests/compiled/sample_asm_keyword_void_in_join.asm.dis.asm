@@ -0,0 +1,13 @@
+.function: foo/0
+    allocate_registers %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %0 local
+    process %1 local foo/0
+    join void %1 local infinity
+    izero %0 local
+    return
+.end
@@ -0,0 +1,18 @@
+.function: sender/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    string %2 local "Hello World!"
+    send %1 local %2 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %1 local
+    self %1 local
+    move %0 arguments %1 local
+    process void sender/1
+    receive void infinity
+    izero %0 local
+    return
+.end
@@ -0,0 +1,14 @@
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 0
+    integer %2 local 10
+    lt %3 local %1 local %2 local
+    not %3 local %3 local
+    if %3 local 0x57 0x44
+    print %1 local
+    iinc %1 local
+    jump 0x19
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,43 @@
+.function: supervisor_function/1
+    allocate_registers %0 local
+    return
+.end
+
+.function: will_be_killed_by_a_runaway_exception/0
+    allocate_registers %4 local
+    integer %1 local 80
+    string %3 local "iterations left: "
+    if %1 local 0x42 0x5a
+    echo %3 local
+    idec %1 local
+    print %1 local
+    jump 0x2d
+    string %2 local "Hello runaway World!"
+    throw %2 local
+    return
+.end
+
+.function: std::util::cpu::cycle/1
+    allocate_registers %5 local
+    move %1 local %0 parameters
+    integer %4 local 9
+    sub %1 local %1 local %4 local
+    integer %4 local 2
+    div %1 local %1 local %4 local
+    izero %2 local
+    lte %3 local %1 local %2 local
+    if %3 local 0xec 0xde
+    idec %1 local
+    jump 0xbc
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    frame %1 local
+    watchdog supervisor_function/1
+    string %1 local "main/1 exiting"
+    print %1 local
+    izero %0 local
+    return
+.end
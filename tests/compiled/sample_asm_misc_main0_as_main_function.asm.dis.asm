@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %2 local
+    text %1 local "Hello World!"
+    print %1 local
+    text %1 local "received 0 arguments"
+    print %1 local
+    izero %0 local
+    return
+.end
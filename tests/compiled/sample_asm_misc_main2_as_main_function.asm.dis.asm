@@ -0,0 +1,7 @@
+.function: main/2
+    allocate_registers %1 local
+    move void %0 parameters
+    move void %1 parameters
+    izero %0 local
+    return
+.end
@@ -0,0 +1,22 @@
+.block: foo/0__nested__bar
+    leave
+.end
+
+.block: main/0__nested__bar
+    leave
+.end
+
+.function: foo/0
+    allocate_registers %0 local
+    try
+    enter foo/0__nested__bar
+    return
+.end
+
+.function: main/0
+    allocate_registers %1 local
+    try
+    enter main/0__nested__bar
+    izero %0 local
+    return
+.end
@@ -0,0 +1,16 @@
+.function: main/0
+    allocate_registers %4 local
+    string %2 local "Hello World!"
+    ptr %1 local %2 local
+    closure %3 local printer/0
+    capturecopy %3 local @1  *1 local
+    frame %0 local
+    call void  %3 local
+    izero %0 local
+    return
+.end
+
+.function: printer/0
+    print %1 local
+    return
+.end
@@ -0,0 +1,36 @@
+.function: add/2
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    add %0 local %1 local %2 local
+    return
+.end
+
+.function: multiply/2
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    mul %0 local %1 local %2 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %6 local
+    function %1 local add/2
+    function %2 local multiply/2
+    integer %3 local 1
+    ptr %4 local %1 local
+    frame %2 local
+    copy %0 arguments %3 local
+    copy %1 arguments %3 local
+    call %5 local  *4 local
+    print %5 local
+    ptr %4 local %2 local
+    frame %2 local
+    copy %0 arguments %3 local
+    copy %1 arguments %3 local
+    call %5 local  *4 local
+    print %5 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %6 local
+    float %2 local 2.14
+    ptr %1 local %2 local
+    float %4 local 1.41
+    ptr %3 local %4 local
+    add %5 local *1 local *3 local
+    print %5 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,8 @@
+.function: main/0
+    allocate_registers %3 local
+    string %2 local "Hello World!"
+    ptr %1 local %2 local
+    print *1 local
+    izero %0 local
+    return
+.end
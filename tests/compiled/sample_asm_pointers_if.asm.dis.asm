@@ -0,0 +1,12 @@
+.function: main/0
+    allocate_registers %4 local
+    integer %2 local 0
+    ptr %1 local %2 local
+    if *1 local 0x2d 0x41
+    string %3 local "Yeah"
+    jump 0x4c
+    string %3 local "Nope"
+    print %3 local
+    izero %0 local
+    return
+.end
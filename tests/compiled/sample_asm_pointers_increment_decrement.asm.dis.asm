@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %3 local
+    integer %2 local 42
+    ptr %1 local %2 local
+    iinc *1 local
+    print %2 local
+    idec *1 local
+    print %2 local
+    izero %0 local
+    return
+.end
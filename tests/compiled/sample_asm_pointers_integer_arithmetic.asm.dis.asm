@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %6 local
+    integer %2 local 23
+    ptr %1 local %2 local
+    integer %4 local 19
+    ptr %3 local %4 local
+    add %5 local *1 local *3 local
+    print %5 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %4 local
+    string %2 local "42"
+    ptr %1 local %2 local
+    stoi %3 local *1 local
+    print %3 local
+    izero %0 local
+    return
+.end
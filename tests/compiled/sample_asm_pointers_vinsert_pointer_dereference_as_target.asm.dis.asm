@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %4 local
+    vector %2 local %0 local %0 local
+    ptr %1 local %2 local
+    integer %3 local 0
+    izero %0 local
+    vinsert *1 local %3 local %0 local
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,11 @@
+.function: main/0
+    allocate_registers %4 local
+    vector %1 local %0 local %0 local
+    integer %3 local 0
+    ptr %2 local %3 local
+    vpush %1 local *2 local
+    print %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,40 @@
+.function: dummy/0
+    allocate_registers %1 local
+    izero %0 local
+    return
+.end
+
+.function: power_of/2
+    allocate_registers %7 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    izero %3 local
+    eq %4 local %2 local %3 local
+    not %4 local %4 local
+    if %4 local 0x65 0x52
+    integer %6 local 1
+    jump 0xb6
+    integer %5 local 1
+    copy %6 local %1 local
+    lt %4 local %5 local %2 local
+    if %4 local 0x9a 0xb6
+    mul %6 local %6 local %1 local
+    nop
+    iinc %5 local
+    jump 0x78
+    move %0 local %6 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %2 local
+    integer %1 local 4
+    copy %0 arguments %1 local
+    integer %2 local 3
+    copy %1 arguments %2 local
+    call %1 local power_of/2
+    print %1 local
+    izero %0 local
+    return
+.end
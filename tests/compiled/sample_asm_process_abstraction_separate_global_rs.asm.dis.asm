@@ -0,0 +1,43 @@
+; external function signatures
+.signature: std::misc::cycle/1
+
+.function: global_printer/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    self %2 local
+    send %1 local %2 local
+    receive %2 global 10000ms
+    print %1 global
+    return
+.end
+
+.function: global_writer/2
+    allocate_registers %4 local
+    move %1 global %1 parameters
+    move %1 local %0 parameters
+    izero %3 local
+    send %1 local %3 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %3 local
+    frame %1 local
+    self %0 local
+    move %0 arguments %0 local
+    process void global_printer/1
+    receive %1 local 10000ms
+    print %1 local
+    frame %2 local
+    copy %0 arguments %1 local
+    string %2 local "Hello World"
+    move %1 arguments %2 local
+    process void global_writer/2
+    frame %2 local
+    copy %0 arguments %1 local
+    string %2 local "broken"
+    move %1 arguments %2 local
+    process void global_writer/2
+    izero %0 local
+    return
+.end
@@ -0,0 +1,18 @@
+.function: foo/0
+    allocate_registers %3 local
+    integer %1 local 2
+    integer %2 local 1
+    print %1 local
+    print @1 local
+    print %2 local
+    print @2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %1 local
+    frame %0 local
+    call void foo/0
+    izero %0 local
+    return
+.end
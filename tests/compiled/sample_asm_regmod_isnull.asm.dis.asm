@@ -0,0 +1,7 @@
+.function: main/1
+    allocate_registers %2 local
+    isnull %1 local %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,10 @@
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 0
+    integer %2 local 1
+    swap %1 local %2 local
+    print %1 local
+    print %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,7 @@
+.function: main/1
+    allocate_registers %2 local
+    string %1 local "Hello \aWorld!"
+    print %1 local
+    izero %0 local
+    return
+.end
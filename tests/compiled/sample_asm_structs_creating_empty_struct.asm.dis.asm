@@ -0,0 +1,7 @@
+.function: main/0
+    allocate_registers %2 local
+    struct %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
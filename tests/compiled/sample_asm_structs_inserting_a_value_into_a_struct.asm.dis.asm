@@ -0,0 +1,10 @@
+.function: main/0
+    allocate_registers %4 local
+    struct %1 local
+    atom %2 local 'answer'
+    integer %3 local 42
+    structinsert %1 local %2 local %3 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,23 @@
+.function: main/0
+    allocate_registers %5 local
+    struct %1 local
+    atom %2 local 'c'
+    integer %3 local 3
+    structinsert %1 local %2 local %3 local
+    atom %2 local 'a'
+    integer %3 local 1
+    structinsert %1 local %2 local %3 local
+    atom %2 local 'b'
+    integer %3 local 2
+    structinsert %1 local %2 local %3 local
+    atom %2 local 'a'
+    structremove void %1 local %2 local
+    print %1 local
+    atom %2 local 'c'
+    structat %4 local %1 local %2 local
+    print *4 local
+    structkeys %3 local %1 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,179 @@
+.function: with_key/1
+    allocate_registers %5 local
+    struct %1 local
+    atom %2 local 'common'
+    move %3 local %0 parameters
+    integer %4 local 1
+    structinsert %1 local %2 local %4 local
+    integer %4 local 2
+    structinsert %1 local %3 local %4 local
+    structremove void %1 local %2 local
+    print %1 local
+    return
+.end
+
+.function: main/0
+    allocate_registers %2 local
+    frame %1 local
+    atom %1 local 'key_00'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_01'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_02'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_03'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_04'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_05'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_06'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_07'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_08'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_09'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_10'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_11'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_12'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_13'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_14'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_15'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_16'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_17'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_18'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_19'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_20'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_21'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_22'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_23'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_24'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_25'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_26'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_27'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_28'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_29'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_30'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_31'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_32'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_33'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_34'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_35'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_36'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_37'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_38'
+    move %0 arguments %1 local
+    call void with_key/1
+    frame %1 local
+    atom %1 local 'key_39'
+    move %0 arguments %1 local
+    call void with_key/1
+    izero %0 local
+    return
+.end
@@ -0,0 +1,18 @@
+.function: main/0
+    allocate_registers %9 local
+    text %1 local "Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. Zażółć gęślą jaźń. "
+    textlength %2 local %1 local
+    print %2 local
+    integer %3 local 100
+    textat %4 local %1 local %3 local
+    print %4 local
+    integer %3 local -2
+    textat %5 local %1 local %3 local
+    print %5 local
+    integer %6 local 61
+    integer %7 local 69
+    textsub %8 local %1 local %6 local %7 local
+    print %8 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,17 @@
+.function: main/0
+    allocate_registers %3 local
+    vector %1 local %0 local %0 local
+    integer %0 local 0
+    vpush %1 local %0 local
+    integer %0 local 1
+    vpush %1 local %0 local
+    integer %0 local 2
+    vpush %1 local %0 local
+    integer %0 local 3
+    vpush %1 local %0 local
+    integer %2 local 5
+    integer %0 local 4
+    vinsert %1 local %0 local %2 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,17 @@
+.function: main/1
+    allocate_registers %6 local
+    vector %1 local %0 local %0 local
+    vlen %2 local %1 local
+    print %2 local
+    string %3 local "Hello World!"
+    vpush %1 local %3 local
+    vlen %2 local %1 local
+    print %2 local
+    integer %5 local -1
+    vat %4 local %1 local %5 local
+    vlen %2 local %1 local
+    print %2 local
+    print *4 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,9 @@
+.function: main/0
+    allocate_registers %4 local
+    string %2 local "answer to life"
+    integer %3 local 42
+    vector %1 local %2 local %20 local
+    print %1 local
+    izero %0 local
+    return
+.end
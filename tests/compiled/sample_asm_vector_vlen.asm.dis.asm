@@ -0,0 +1,24 @@
+.function: main/1
+    allocate_registers %4 local
+    integer %1 local 0
+    vector %2 local %0 local %0 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    copy %3 local %1 local
+    vpush %2 local %3 local
+    vpush %2 local %1 local
+    vlen %3 local %2 local
+    print %3 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,12 @@
+.function: main/0
+    allocate_registers %4 local
+    vector %1 local %0 local %0 local
+    integer %2 local 0
+    vpush %1 local %2 local
+    integer %3 local 1
+    vpush %1 local %3 local
+    vpop void %1 local void
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,14 @@
+.function: main/1
+    allocate_registers %5 local
+    vector %2 local %0 local %0 local
+    vlen %3 local %2 local
+    print %3 local
+    string %1 local "Hello World!"
+    vpush %2 local %1 local
+    vlen %3 local %2 local
+    print %3 local
+    vpop %4 local %2 local void
+    print %4 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,69 @@
+.function: watchdog_process/1
+    allocate_registers %5 local
+    move %1 local %0 parameters
+    atom %2 local 'exception'
+    structremove %2 local %1 local %2 local
+    atom %3 local 'function'
+    structremove %3 local %1 local %3 local
+    string %4 local "process spawned with <"
+    echo %4 local
+    echo %3 local
+    string %4 local "> killed by >>>"
+    echo %4 local
+    echo %2 local
+    string %4 local "<<<"
+    print %4 local
+    return
+.end
+
+.function: broken_process/0
+    allocate_registers %2 local
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    integer %1 local 42
+    throw %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %1 local
+    frame %1 local
+    watchdog watchdog_process/1
+    frame %1 local
+    watchdog watchdog_process/1
+    frame %0 local
+    process void broken_process/0
+    izero %0 local
+    return
+.end
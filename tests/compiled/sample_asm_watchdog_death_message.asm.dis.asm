@@ -0,0 +1,107 @@
+; external function signatures
+.signature: std::misc::cycle/1
+
+.function: watchdog_process/1
+    allocate_registers %5 local
+    move %1 local %0 parameters
+    atom %2 local 'exception'
+    structremove %2 local %1 local %2 local
+    atom %3 local 'function'
+    structremove %3 local %1 local %3 local
+    string %4 local "[WARNING] process '"
+    echo %4 local
+    echo %3 local
+    string %4 local "' killed by >>>"
+    echo %4 local
+    echo %2 local
+    string %4 local "<<<"
+    print %4 local
+    return
+.end
+
+.function: a_detached_concurrent_process/0
+    allocate_registers %2 local
+    frame %1 local
+    integer %1 local 32
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    string %1 local "Hello World (from detached process)!"
+    print %1 local
+    frame %1 local
+    integer %1 local 512
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    string %1 local "Hello World (from detached process) after a runaway exception!"
+    print %1 local
+    frame %1 local
+    integer %1 local 512
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    frame %1 local
+    string %1 local "a_detached_concurrent_process"
+    move %0 arguments %1 local
+    call void log_exiting_detached/1
+    return
+.end
+
+.function: a_joined_concurrent_process/0
+    allocate_registers %3 local
+    frame %1 local
+    integer %1 local 128
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    string %1 local "Hello World (from joined process)!"
+    print %1 local
+    frame %1 local
+    string %1 local "a_joined_concurrent_process"
+    move %0 arguments %1 local
+    call void log_exiting_joined/1
+    string %2 local "OH NOES!"
+    throw %2 local
+    return
+.end
+
+.function: log_exiting_main/0
+    allocate_registers %2 local
+    string %1 local "process [  main  ]: 'main' exiting"
+    print %1 local
+    return
+.end
+
+.function: log_exiting_detached/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    string %2 local "process [detached]: '"
+    echo %2 local
+    echo %1 local
+    string %2 local "' exiting"
+    print %2 local
+    return
+.end
+
+.function: log_exiting_joined/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    string %2 local "process [ joined ]: '"
+    echo %2 local
+    echo %1 local
+    string %2 local "' exiting"
+    print %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    import std::misc
+    frame %1 local
+    watchdog watchdog_process/1
+    frame %0 local
+    process void a_detached_concurrent_process/0
+    frame %0 local
+    process %1 local a_joined_concurrent_process/0
+    join void %1 local infinity
+    frame %0 local
+    call void log_exiting_main/0
+    izero %0 local
+    return
+.end
@@ -0,0 +1,52 @@
+; external function signatures
+.signature: undefined_function/1
+
+.function: broken_process/0
+    allocate_registers %2 local
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    nop
+    integer %1 local 42
+    throw %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %1 local
+    frame %1 local
+    watchdog undefined_function/1
+    frame %0 local
+    process void broken_process/0
+    izero %0 local
+    return
+.end
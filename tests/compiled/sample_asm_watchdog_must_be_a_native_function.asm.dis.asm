@@ -0,0 +1,11 @@
+; external function signatures
+.signature: World::print_hello/1
+
+.function: main/1
+    allocate_registers %1 local
+    import World
+    frame %1 local
+    watchdog World::print_hello/1
+    izero %0 local
+    return
+.end
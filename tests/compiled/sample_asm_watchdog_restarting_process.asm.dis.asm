@@ -0,0 +1,141 @@
+; external function signatures
+.signature: std::misc::cycle/1
+
+; dynamic imports
+.import: [[dynamic]] std::misc
+
+.function: watchdog_process/2
+    allocate_registers %8 local
+    move %1 local %0 parameters
+    atom %2 local 'exception'
+    structremove %2 local %1 local %2 local
+    atom %3 local 'function'
+    structremove %3 local %1 local %3 local
+    atom %4 local 'parameters'
+    structremove %4 local %1 local %4 local
+    string %5 local "[WARNING] process '"
+    echo %5 local
+    echo %3 local
+    echo %4 local
+    string %5 local "' killed by >>>"
+    echo %5 local
+    echo %2 local
+    string %5 local "<<<"
+    print %5 local
+    move %6 local %1 parameters
+    frame %2 local
+    move %0 arguments %6 local
+    integer %7 local 1
+    move %1 arguments %7 local
+    process void a_division_executing_process/2
+    return
+.end
+
+.function: a_detached_concurrent_process/0
+    allocate_registers %2 local
+    frame %1 local
+    integer %1 local 32
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    string %1 local "Hello World (from detached process)!"
+    print %1 local
+    frame %1 local
+    integer %1 local 512
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    string %1 local "Hello World (from detached process) after a runaway exception!"
+    print %1 local
+    frame %1 local
+    integer %1 local 512
+    move %0 arguments %1 local
+    call void std::misc::cycle/1
+    frame %1 local
+    string %1 local "a_detached_concurrent_process"
+    move %0 arguments %1 local
+    call void log_exiting_detached/1
+    return
+.end
+
+.function: formatting/2
+    allocate_registers %5 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    text %1 local  %1 local
+    text %2 local  %2 local
+    text %3 local " / "
+    textconcat %4 local %1 local %3 local
+    textconcat %4 local %4 local %2 local
+    return
+.end
+
+.function: a_division_executing_process/2
+    allocate_registers %5 local
+    move %1 local %0 parameters
+    move %2 local %1 parameters
+    izero %3 local
+    frame %2 local
+    copy %1 arguments %1 local
+    watchdog watchdog_process/2
+    frame %1 local
+    integer %4 local 128
+    move %0 arguments %4 local
+    call void std::misc::cycle/1
+    eq %4 local %2 local %3 local
+    if %4 local 0x333 0x354
+    string %4 local "cannot divide by zero"
+    throw %4 local
+    div %0 local %1 local %2 local
+    echo %1 local
+    string %4 local " / "
+    echo %4 local
+    echo %2 local
+    string %4 local " = "
+    echo %4 local
+    print %0 local
+    return
+.end
+
+.function: log_exiting_main/0
+    allocate_registers %2 local
+    string %1 local "process [  main  ]: 'main' exiting"
+    print %1 local
+    return
+.end
+
+.function: log_exiting_detached/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    string %2 local "process [detached]: '"
+    echo %2 local
+    echo %1 local
+    string %2 local "' exiting"
+    print %2 local
+    return
+.end
+
+.function: log_exiting_joined/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    string %2 local "process [ joined ]: '"
+    echo %2 local
+    echo %1 local
+    string %2 local "' exiting"
+    print %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    frame %0 local
+    process void a_detached_concurrent_process/0
+    frame %2 local
+    integer %1 local 42
+    copy %0 arguments %1 local
+    integer %2 local 0
+    copy %1 arguments %2 local
+    process void a_division_executing_process/2
+    frame %0 local
+    call void log_exiting_main/0
+    izero %0 local
+    return
+.end
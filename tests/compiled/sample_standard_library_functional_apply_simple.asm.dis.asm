@@ -0,0 +1,24 @@
+; external function signatures
+.signature: std::functional::apply/2
+
+.function: adder/1
+    allocate_registers %2 local
+    move %0 local %0 parameters
+    integer %1 local 21
+    add %0 local %0 local %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    import std::functional
+    frame %2 local
+    function %1 local adder/1
+    move %0 arguments %1 local
+    integer %1 local 21
+    move %1 arguments %1 local
+    call %1 local std::functional::apply/2
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,36 @@
+; external function signatures
+.signature: std::functional::apply/2
+
+.function: greetings/1
+    allocate_registers %2 local
+    string %1 local "Hello "
+    echo %1 local
+    move %1 local %0 parameters
+    echo %1 local
+    string %1 local "!"
+    print %1 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    import std::functional
+    function %1 local greetings/1
+    frame %2 local
+    copy %0 arguments %1 local
+    string %2 local "World"
+    copy %1 arguments %2 local
+    call void std::functional::apply/2
+    frame %2 local
+    copy %0 arguments %1 local
+    string %2 local "Joe"
+    copy %1 arguments %2 local
+    call void std::functional::apply/2
+    frame %2 local
+    copy %0 arguments %1 local
+    string %2 local "Mike"
+    copy %1 arguments %2 local
+    call void std::functional::apply/2
+    izero %0 local
+    return
+.end
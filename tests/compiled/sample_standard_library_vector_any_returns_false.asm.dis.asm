@@ -0,0 +1,30 @@
+; external function signatures
+.signature: std::vector::any/2
+
+.function: is_not_negative/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    izero %2 local
+    gte %0 local %1 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    import std::vector
+    vector %2 local %0 local %0 local
+    integer %1 local -1
+    vpush %2 local %1 local
+    integer %1 local -2
+    vpush %2 local %1 local
+    integer %1 local -3
+    vpush %2 local %1 local
+    frame %2 local
+    copy %0 arguments %2 local
+    function %3 local is_not_negative/1
+    move %1 arguments %3 local
+    call %4 local std::vector::any/2
+    print %4 local
+    izero %0 local
+    return
+.end
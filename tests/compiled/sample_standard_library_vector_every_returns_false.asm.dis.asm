@@ -0,0 +1,30 @@
+; external function signatures
+.signature: std::vector::every/2
+.signature: std::vector::of_ints/1
+
+.function: is_not_negative/1
+    allocate_registers %3 local
+    move %1 local %0 parameters
+    izero %2 local
+    gte %0 local %1 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %5 local
+    import std::vector
+    frame %1 local
+    integer %1 local 20
+    copy %0 arguments %1 local
+    call %2 local std::vector::of_ints/1
+    integer %1 local -1
+    vpush %2 local %1 local
+    frame %2 local
+    copy %0 arguments %2 local
+    function %3 local is_not_negative/1
+    move %1 arguments %3 local
+    call %4 local std::vector::every/2
+    print %4 local
+    izero %0 local
+    return
+.end
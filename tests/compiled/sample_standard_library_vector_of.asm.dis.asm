@@ -0,0 +1,22 @@
+; external function signatures
+.signature: std::vector::of/2
+
+.function: return_integer/1
+    allocate_registers %1 local
+    move %0 local %0 parameters
+    return
+.end
+
+.function: main/1
+    allocate_registers %2 local
+    import std::vector
+    frame %2 local
+    integer %1 local 8
+    move %0 arguments %1 local
+    function %1 local return_integer/1
+    move %1 arguments %1 local
+    call %1 local std::vector::of/2
+    print %1 local
+    izero %0 local
+    return
+.end
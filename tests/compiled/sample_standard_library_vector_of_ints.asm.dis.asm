@@ -0,0 +1,14 @@
+; external function signatures
+.signature: std::vector::of_ints/1
+
+.function: main/1
+    allocate_registers %2 local
+    import std::vector
+    frame %1 local
+    integer %1 local 8
+    move %0 arguments %1 local
+    call %1 local std::vector::of_ints/1
+    print %1 local
+    izero %0 local
+    return
+.end
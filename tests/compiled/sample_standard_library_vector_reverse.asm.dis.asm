@@ -0,0 +1,19 @@
+; external function signatures
+.signature: std::vector::of_ints/1
+.signature: std::vector::reverse/1
+
+.function: main/1
+    allocate_registers %3 local
+    import std::vector
+    frame %1 local
+    integer %1 local 8
+    move %0 arguments %1 local
+    call %1 local std::vector::of_ints/1
+    print %1 local
+    frame %1 local
+    copy %0 arguments %1 local
+    call %2 local std::vector::reverse/1
+    print %2 local
+    izero %0 local
+    return
+.end
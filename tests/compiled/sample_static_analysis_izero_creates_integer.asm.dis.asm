@@ -0,0 +1,8 @@
+.function: main/0
+    allocate_registers %2 local
+    izero %1 local
+    iinc %1 local
+    print %1 local
+    izero %0 local
+    return
+.end
@@ -0,0 +1,26 @@
+.function: isExpired/1
+    allocate_registers %4 local
+    move %1 local %0 parameters
+    ptrlive %2 local %1 local
+    not %2 local %2 local
+    string %3 local "expired: "
+    echo %3 local
+    print %2 local
+    move %0 local %2 local
+    return
+.end
+
+.function: main/1
+    allocate_registers %3 local
+    integer %1 local 42
+    ptr %2 local %1 local
+    frame %1 local
+    copy %0 arguments %2 local
+    call void isExpired/1
+    delete %1 local
+    frame %1 local
+    copy %0 arguments %2 local
+    call void isExpired/1
+    izero %0 local
+    return
+.end
@@ -50,6 +50,8 @@ COMPILED_SAMPLES_PATH = './tests/compiled'
 VIUA_KERNEL_PATH = './build/bin/vm/kernel'
 VIUA_ASSEMBLER_PATH_DEFAULT = './build/bin/vm/asm'
 VIUA_ASSEMBLER_PATH = os.environ.get('VIUA_ASM', VIUA_ASSEMBLER_PATH_DEFAULT)
+VIUA_TOOLING_ASSEMBLER_PATH_DEFAULT = './build/tooling/exec/assembler.bin'
+VIUA_TOOLING_ASSEMBLER_PATH = os.environ.get('VIUA_TOOLING_ASM', VIUA_TOOLING_ASSEMBLER_PATH_DEFAULT)
 
 
 class ViuaError(Exception):
@@ -108,6 +110,20 @@ def assemble(asm, out=None, links=(), opts=(), okcodes=(0,)):
         raise ViuaAssemblerError('{0}: {1}'.format(asm, output.strip()))
     return (output, error, exit_code)
 
+def analyse(asm, jobs=None):
+    """Run static analyser of the tooling assembler on path given as `asm`.
+    Functions are analysed by `jobs` threads (or as many as there are CPUs).
+    """
+    env = dict(os.environ)
+    # The tooling parser leaks operands; leaks are not what is tested here.
+    env['LSAN_OPTIONS'] = 'detect_leaks=0'
+    if jobs is not None:
+        env['VIUA_SA_JOBS'] = str(jobs)
+    p = subprocess.Popen((VIUA_TOOLING_ASSEMBLER_PATH, '-C', asm), stdout=subprocess.PIPE, stderr=subprocess.PIPE, env=env)
+    output, error = p.communicate()
+    exit_code = p.wait()
+    return (output.decode('utf-8'), error.decode('utf-8'), exit_code)
+
 def disassemble(path, out=None):
     """Disassemle path given as `path` and put resulting assembly code in `out`.
     Raises exception if disassembly is not successful.
@@ -466,6 +482,19 @@ def runTestFailsToAssembleDetailed(self, name, expected_output, asm_opts=()):
                 output.strip().splitlines()))
     self.assertEqual(list(lines), expected_output)
 
+def runTestPassesToolingAnalysis(self, name):
+    assembly_path = os.path.join(self.PATH, name)
+    output, error, exit_code = analyse(assembly_path)
+    self.assertEqual(0, exit_code, error)
+
+def runTestFailsToolingAnalysis(self, name, expected_output):
+    assembly_path = os.path.join(self.PATH, name)
+    output, error, exit_code = analyse(assembly_path)
+    self.assertEqual(1, exit_code)
+    lines = map(lambda l: l[len(assembly_path)+1:],
+            filter(lambda l: l.startswith(assembly_path), error.strip().splitlines()))
+    self.assertEqual(list(lines), expected_output)
+
 
 def sameLines(self, excode, output, no_of_lines):
     lines = output.splitlines()
@@ -529,6 +558,9 @@ class IntegerInstructionsTests(unittest.TestCase):
     def testIntegersInCondition(self):
         runTest(self, 'in_condition.asm', 'true', 0)
 
+    def testBoxedAndUnboxedIntegers(self):
+        runTestSplitlines(self, 'boxed_and_unboxed.asm', ['10', 'true', '20', 'false'])
+
 
 class BooleanInstructionsTests(unittest.TestCase):
     """Tests for boolean instructions.
@@ -658,6 +690,9 @@ class TextInstructionsTests(unittest.TestCase):
     def testTextconcat(self):
         runTest(self, 'textconcat.asm', 'Hello World!', 0)
 
+    def testLongText(self):
+        runTestSplitlines(self, 'long_text.asm', ['152', 'ć', '.', 'łć gęślą'])
+
 
 class TextInstructionsEscapeSequencesTests(unittest.TestCase):
     """Tests for escape sequence decoding.
@@ -758,6 +793,9 @@ class BitsManipulationTests(unittest.TestCase):
     def testShrOvershift(self):
         runTestSplitlines(self, 'shr_overshift.asm', ['10010111', '00000000', '0000000010010111'])
 
+    def testCopiesAreIndependent(self):
+        runTestSplitlines(self, 'copies_are_independent.asm', ['10000000', '10000001', '10000010',])
+
     def testLiterals(self):
         runTestSplitlines(self, 'literals.asm', [
             '11011110101011011011111011101111',
@@ -978,6 +1016,14 @@ class BitsSignedWrappingArithmeticTests(unittest.TestCase):
             '00000000',
         ])
 
+    def test_wide_operands(self):
+        runTestSplitlines(self, 'wide_operands.asm', [
+            ('0' * 7) + '1' + ('0' * 64),
+            ('0' * 8) + ('1' * 64),
+            ('1' * 8) + ('0' * 64),
+            ('1' * 72),
+        ])
+
 class BitsUnsignedWrappingArithmeticTests(unittest.TestCase):
     PATH = './sample/asm/bits/arithmetic/unsigned_wrapping'
 
@@ -1544,6 +1590,9 @@ class HigherOrderFunctionTests(unittest.TestCase):
     def testApplyByMove(self):
         runTest(self, 'apply_by_move.asm', '25')
 
+    def testApplyDifferentFunctions(self):
+        runTestSplitlines(self, 'apply_different_functions.asm', ['25', '6', '25'])
+
     def testMap(self):
         runTest(self, 'map.asm', [[1, 2, 3, 4, 5], [1, 4, 9, 16, 25]], 0, lambda o: [json.loads(i) for i in o.splitlines()])
 
@@ -2198,6 +2247,70 @@ class StaticAnalysis(unittest.TestCase):
 
 
 
+class ToolingStaticAnalysis(unittest.TestCase):
+    """Tests for static analyser of the tooling assembler.
+    """
+    PATH = './sample/static_analysis/tooling'
+
+    def testLoop(self):
+        runTestPassesToolingAnalysis(self, 'loop.asm')
+
+    def testLoopUsesRegisterErasedInBody(self):
+        # The register is only empty when the loop body is entered for the
+        # second time, ie. after following the back edge.
+        runTestFailsToolingAnalysis(self, 'loop_uses_register_erased_in_body.asm', [
+            '30:12: error: EC0013: read from empty register: 3',
+            '31:5: note: erased here',
+            '29:5: error: after taking true branch',
+            '20:1: error: in function `print_n/1\'',
+        ])
+
+    def testBranchesRejoin(self):
+        runTestPassesToolingAnalysis(self, 'branches_rejoin.asm')
+
+    def testBranchesRejoinRegisterDefinedInOneArm(self):
+        runTestFailsToolingAnalysis(self, 'branches_rejoin_register_defined_in_one_arm.asm', [
+            '28:12: error: EC0013: read from empty register: 2',
+            '24:5: error: after taking false branch',
+            '20:1: error: in function `main/0\'',
+        ])
+
+    def testRecursionInOneArm(self):
+        runTestPassesToolingAnalysis(self, 'recursion_in_one_arm.asm')
+
+    def testEndlessRecursionAfterBranchesRejoin(self):
+        # The call is reported because every path through the function leads
+        # to it, even though it is only reached after a conditional branch.
+        runTestFailsToolingAnalysis(self, 'endless_recursion_after_branches_rejoin.asm', [
+            '33:5: error: endless recursion detected',
+            '33:5: note: every path through this function leads to this call',
+            '24:5: error: after taking true branch',
+            '20:1: error: in function `countdown/1\'',
+        ])
+
+    def testSeveralFunctions(self):
+        runTestPassesToolingAnalysis(self, 'several_functions.asm')
+
+    def testSeveralFunctionsWithErrors(self):
+        # Only the error from the first function (in order of names) is
+        # reported, no matter how many functions were analysed at once.
+        runTestFailsToolingAnalysis(self, 'several_functions_with_errors.asm', [
+            '26:12: error: EC0013: read from empty register: 2',
+            '24:5: error: after taking false branch',
+            '20:1: error: in function `first/0\'',
+        ])
+
+    def testParallelAnalysisGivesSameResultsAsSequential(self):
+        for name in ('several_functions.asm', 'several_functions_with_errors.asm',):
+            assembly_path = os.path.join(self.PATH, name)
+            self.assertEqual(analyse(assembly_path, jobs=1), analyse(assembly_path, jobs=4))
+
+    def testMalformedNumberOfJobsIsIgnored(self):
+        assembly_path = os.path.join(self.PATH, 'several_functions_with_errors.asm')
+        for jobs in ('many', '4x', '-1', '',):
+            self.assertEqual(analyse(assembly_path, jobs=1), analyse(assembly_path, jobs=jobs))
+
+
 class AssemblerErrorTests(unittest.TestCase):
     """Tests for error-checking and reporting functionality.
     """
@@ -2830,6 +2943,9 @@ class ConcurrencyTests(unittest.TestCase):
         expected_output = ['Hello {}!'.format(i) for i in range(1, 65)]
         runTestReturnsUnorderedLines(self, 'migrating_processes_between_schedulers.asm', expected_output)
 
+    def testFanOutFanIn(self):
+        runTest(self, 'fan_out_fan_in.asm', '4160')
+
     def testObtainingSelfPid(self):
         runTest(self, 'obtaining_self_pid.asm', 'Hello World (from self)!')
 
@@ -2868,6 +2984,40 @@ class ConcurrencyTests(unittest.TestCase):
         runTestThrowsException(self, 'join_timeout_0ms.asm', ('Exception', 'process did not join',))
 
 
+class IOTests(unittest.TestCase):
+    PATH = './sample/asm/io'
+
+    def runWithEmptyInput(self, name, engine):
+        """Run the sample with standard input being an empty, non-blocking pipe
+        so reads from it do not complete until they are cancelled.
+        """
+        assembly_path = os.path.join(self.PATH, name)
+        compiled_path = os.path.join(COMPILED_SAMPLES_PATH, '{0}_{1}.bin'.format(self.PATH[2:].replace('/', '_'), name))
+        assemble(assembly_path, compiled_path)
+        if FLAG_TEST_ONLY_ASSEMBLING:
+            return None
+        env = dict(os.environ)
+        env['VIUA_IO_ENGINE'] = engine
+        read_end, write_end = os.pipe()
+        try:
+            os.set_blocking(read_end, False)
+            p = subprocess.run((VIUA_KERNEL_PATH, compiled_path), stdin=read_end, stdout=subprocess.PIPE, env=env, timeout=10)
+        finally:
+            os.close(read_end)
+            os.close(write_end)
+        return (p.returncode, p.stdout.decode('utf-8').strip())
+
+    def testCancellingAPolledReadWithEpoll(self):
+        result = self.runWithEmptyInput('cancelling_a_polled_read.asm', 'epoll')
+        if result is not None:
+            self.assertEqual((0, 'I/O cancelled',), result)
+
+    def testCancellingAPolledReadWithIOUring(self):
+        result = self.runWithEmptyInput('cancelling_a_polled_read.asm', 'uring')
+        if result is not None:
+            self.assertEqual((0, 'I/O cancelled',), result)
+
+
 class WatchdogTests(unittest.TestCase):
     PATH = './sample/asm/watchdog'
 
@@ -2934,6 +3084,9 @@ class StructTests(unittest.TestCase):
     def testRemovingAValueFromAStruct(self):
         runTestSplitlines(self, 'removing_a_value_from_a_struct.asm', ["{'answer': 42}", '{}'])
 
+    def testRemovingAValueFromTheMiddleOfAStruct(self):
+        runTestSplitlines(self, 'removing_a_value_from_the_middle_of_a_struct.asm', ["{'b': 2, 'c': 3}", '3', "['b', 'c']"])
+
     def testOverwritingAValueInAStruct(self):
         runTestSplitlines(self, 'overwriting_a_value_in_a_struct.asm', ["{'answer': 666}", "{'answer': 42}"])
 
@@ -2943,6 +3096,11 @@ class StructTests(unittest.TestCase):
     def testStructOfStructs(self):
         runTest(self, 'struct_of_structs.asm', "{'bad': {'answer': 666}, 'good': {'answer': 42}}")
 
+    def testStructsWithManyDistinctKeys(self):
+        runTestSplitlines(self, 'structs_with_many_distinct_keys.asm', [
+            "{{'key_{:02}': 2}}".format(i) for i in range(40)
+        ])
+
 
 class AtomTests(unittest.TestCase):
     PATH = './sample/asm/atoms'